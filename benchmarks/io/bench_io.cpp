@@ -0,0 +1,404 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/geometry/algos/normal.h>
+#include <cgogn/modeling/tiling/triangular_grid.h>
+#include <cgogn/io/map_import.h>
+#include <cgogn/io/map_export.h>
+
+#include <libmesh6.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace cgogn::numerics;
+
+using Map2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Map3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+using Vec3 = Eigen::Vector3d;
+
+using Vertex2 = Map2::Vertex;
+using Face2 = Map2::Face;
+using Vertex3 = Map3::Vertex;
+
+// the meshes are generated in main, their size can be given on the command line
+uint32 surface_grid_size = 256u;
+uint32 volume_grid_size = 24u;
+
+Map2 surface_map;
+Map3 tetra_map;
+Map3 hexa_map;
+
+struct Format
+{
+	std::string extension;
+	bool binary;
+	bool compress;
+	bool has_export; // false for the formats written by this benchmark (no exporter in cgogn_io)
+};
+
+const std::vector<Format> surface_formats = {
+	{"off", false, false, true},
+	{"off", true, false, true},
+	{"obj", false, false, true},
+	{"ply", false, false, true},
+	{"ply", true, false, true},
+	{"stl", false, false, true},
+	{"stl", true, false, true},
+	{"vtk", false, false, true},
+	{"vtk", true, false, true},
+	{"vtp", false, false, true},
+	{"vtp", true, false, true},
+	{"vtp", true, true, true},
+	{"msh", false, false, true}
+};
+
+const std::vector<Format> volume_formats = {
+	{"vtk", false, false, true},
+	{"vtk", true, false, true},
+	{"vtu", false, false, true},
+	{"vtu", true, false, true},
+	{"vtu", true, true, true},
+	{"msh", false, false, true},
+	{"nas", false, false, true},
+	{"tet", false, false, true},
+	{"meshb", true, false, false},
+	{"ele", false, false, false}
+};
+
+inline std::string format_name(const Format& f)
+{
+	return f.extension + (f.binary ? (f.compress ? "/zlib" : "/binary") : "/ascii");
+}
+
+inline std::string format_filename(const std::string& prefix, const Format& f)
+{
+	return "bench_io_" + prefix + "_" + (f.binary ? (f.compress ? "zlib" : "bin") : "ascii") + "." + f.extension;
+}
+
+inline std::size_t file_size(const std::string& filename)
+{
+	std::ifstream fp(filename, std::ios::in | std::ios::binary | std::ios::ate);
+	return fp.good() ? std::size_t(fp.tellg()) : 0ul;
+}
+
+inline std::size_t files_size(const std::string& filename)
+{
+	// tetgen meshes are made of 2 files
+	if (cgogn::io::file_type(filename) == cgogn::io::FileType::FileType_TETGEN)
+		return file_size(cgogn::remove_extension(filename) + ".node") + file_size(cgogn::remove_extension(filename) + ".ele");
+	return file_size(filename);
+}
+
+/**
+ * @brief generate_volume, builds a regular grid of n^3 cubes, split in 6 tetrahedra each or kept as hexahedra
+ */
+void generate_volume(Map3& map, uint32 n, bool tetra)
+{
+	cgogn::io::VolumeImport<cgogn::DefaultMapTraits, Vec3> builder;
+	builder.reserve(tetra ? 6u * n * n * n : n * n * n);
+	auto position = builder.add_position_attribute();
+	auto vid = [n] (uint32 i, uint32 j, uint32 k) { return (k * (n + 1u) + j) * (n + 1u) + i; };
+
+	for (uint32 k = 0u; k <= n; ++k)
+		for (uint32 j = 0u; j <= n; ++j)
+			for (uint32 i = 0u; i <= n; ++i)
+				(*position)[builder.insert_line_vertex_container()] = Vec3(float64(i) / n, float64(j) / n, float64(k) / n);
+
+	for (uint32 k = 0u; k < n; ++k)
+		for (uint32 j = 0u; j < n; ++j)
+			for (uint32 i = 0u; i < n; ++i)
+			{
+				const uint32 p0 = vid(i, j, k), p1 = vid(i + 1u, j, k), p2 = vid(i + 1u, j + 1u, k), p3 = vid(i, j + 1u, k);
+				const uint32 p4 = vid(i, j, k + 1u), p5 = vid(i + 1u, j, k + 1u), p6 = vid(i + 1u, j + 1u, k + 1u), p7 = vid(i, j + 1u, k + 1u);
+				if (tetra)
+				{
+					// the 6 tetrahedra around the diagonal p0-p6
+					builder.add_tetra(p0, p1, p2, p6, true);
+					builder.add_tetra(p0, p2, p3, p6, true);
+					builder.add_tetra(p0, p3, p7, p6, true);
+					builder.add_tetra(p0, p7, p4, p6, true);
+					builder.add_tetra(p0, p4, p5, p6, true);
+					builder.add_tetra(p0, p5, p1, p6, true);
+				}
+				else
+					builder.add_hexa(p0, p1, p2, p3, p4, p5, p6, p7, true);
+			}
+
+	builder.create_map(map);
+}
+
+// writes the tetra map in a medit (.meshb) file
+void write_meshb(const Map3& map, const std::string& filename)
+{
+	auto position = map.get_attribute<Vec3, Vertex3::ORBIT>("position");
+	auto ids = const_cast<Map3&>(map).add_attribute<uint32, Vertex3::ORBIT>("bench_io_ids");
+	const int mesh = GmfOpenMesh(filename.c_str(), GmfWrite, 2, 3);
+	if (mesh == 0)
+		return;
+
+	GmfSetKwd(mesh, GmfVertices, map.nb_cells<Vertex3::ORBIT>());
+	uint32 count = 0u;
+	map.foreach_cell([&] (Vertex3 v)
+	{
+		ids[v] = ++count;
+		GmfSetLin(mesh, GmfVertices, position[v][0], position[v][1], position[v][2], 0);
+	});
+
+	GmfSetKwd(mesh, GmfTetrahedra, map.nb_cells<Map3::Volume::ORBIT>());
+	map.foreach_cell([&] (Map3::Volume w)
+	{
+		std::vector<uint32> vertices;
+		map.foreach_incident_vertex(w, [&] (Vertex3 v) { vertices.push_back(ids[v]); });
+		GmfSetLin(mesh, GmfTetrahedra, vertices[0], vertices[1], vertices[2], vertices[3], 0);
+	});
+	GmfCloseMesh(mesh);
+	const_cast<Map3&>(map).remove_attribute(ids);
+}
+
+// writes the tetra map in tetgen .node and .ele files
+void write_tetgen(const Map3& map, const std::string& filename)
+{
+	auto position = map.get_attribute<Vec3, Vertex3::ORBIT>("position");
+	auto ids = const_cast<Map3&>(map).add_attribute<uint32, Vertex3::ORBIT>("bench_io_ids");
+
+	std::ofstream node(cgogn::remove_extension(filename) + ".node");
+	node << map.nb_cells<Vertex3::ORBIT>() << " 3 0 0" << std::endl;
+	uint32 count = 0u;
+	map.foreach_cell([&] (Vertex3 v)
+	{
+		ids[v] = count;
+		node << count++ << " " << position[v][0] << " " << position[v][1] << " " << position[v][2] << std::endl;
+	});
+
+	std::ofstream ele(cgogn::remove_extension(filename) + ".ele");
+	ele << map.nb_cells<Map3::Volume::ORBIT>() << " 4 0" << std::endl;
+	count = 0u;
+	map.foreach_cell([&] (Map3::Volume w)
+	{
+		ele << count++;
+		map.foreach_incident_vertex(w, [&] (Vertex3 v) { ele << " " << ids[v]; });
+		ele << std::endl;
+	});
+	const_cast<Map3&>(map).remove_attribute(ids);
+}
+
+inline cgogn::io::ExportOptions surface_export_options(const Format& f)
+{
+	return cgogn::io::ExportOptions(format_filename("surface", f), {cgogn::Orbit(Vertex2::ORBIT), "position"}, {{cgogn::Orbit(Face2::ORBIT), "normal"}}, f.binary, f.compress);
+}
+
+inline cgogn::io::ExportOptions volume_export_options(const Format& f, bool tetra)
+{
+	return cgogn::io::ExportOptions(format_filename(tetra ? "tetra" : "hexa", f), {cgogn::Orbit(Vertex3::ORBIT), "position"}, {}, f.binary, f.compress);
+}
+
+// volume formats that only store tetrahedra
+inline bool tetra_only(const Format& f)
+{
+	return f.extension == "tet" || f.extension == "meshb" || f.extension == "ele";
+}
+
+void write_volume_file(const Format& f, bool tetra)
+{
+	const Map3& map = tetra ? tetra_map : hexa_map;
+	const std::string filename = format_filename(tetra ? "tetra" : "hexa", f);
+	if (f.has_export)
+		cgogn::io::export_volume(const_cast<Map3&>(map), volume_export_options(f, tetra));
+	else if (f.extension == "meshb")
+		write_meshb(map, filename);
+	else
+		write_tetgen(map, filename);
+}
+
+static void BENCH_surface_export(benchmark::State& state)
+{
+	const Format& f = surface_formats[state.range_x()];
+	while (state.KeepRunning())
+		cgogn::io::export_surface(surface_map, surface_export_options(f));
+	state.SetBytesProcessed(int64(state.iterations()) * int64(file_size(format_filename("surface", f))));
+	state.SetLabel(format_name(f));
+}
+
+static void BENCH_surface_import(benchmark::State& state)
+{
+	const Format& f = surface_formats[state.range_x()];
+	const std::string filename = format_filename("surface", f);
+	while (state.KeepRunning())
+	{
+		auto si = cgogn::io::newSurfaceImport<cgogn::DefaultMapTraits, Vec3>(filename);
+		si->import_file(filename);
+	}
+	state.SetBytesProcessed(int64(state.iterations()) * int64(file_size(filename)));
+	state.SetLabel(format_name(f));
+}
+
+static void BENCH_surface_create_map(benchmark::State& state)
+{
+	const Format& f = surface_formats[state.range_x()];
+	const std::string filename = format_filename("surface", f);
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		auto si = cgogn::io::newSurfaceImport<cgogn::DefaultMapTraits, Vec3>(filename);
+		si->import_file(filename);
+		Map2 map;
+		state.ResumeTiming();
+		si->create_map(map);
+	}
+	state.SetLabel(format_name(f));
+}
+
+// volume benchmarks : the 2nd argument selects the tetra (1) or hexa (0) mesh
+static void BENCH_volume_export(benchmark::State& state)
+{
+	const Format& f = volume_formats[state.range_x()];
+	const bool tetra = state.range_y() == 1;
+	while (state.KeepRunning())
+		write_volume_file(f, tetra);
+	state.SetBytesProcessed(int64(state.iterations()) * int64(files_size(format_filename(tetra ? "tetra" : "hexa", f))));
+	state.SetLabel(format_name(f) + (tetra ? " tetra" : " hexa"));
+}
+
+static void BENCH_volume_import(benchmark::State& state)
+{
+	const Format& f = volume_formats[state.range_x()];
+	const bool tetra = state.range_y() == 1;
+	const std::string filename = format_filename(tetra ? "tetra" : "hexa", f);
+	while (state.KeepRunning())
+	{
+		auto vi = cgogn::io::newVolumeImport<cgogn::DefaultMapTraits, Vec3>(filename);
+		vi->import_file(filename);
+	}
+	state.SetBytesProcessed(int64(state.iterations()) * int64(files_size(filename)));
+	state.SetLabel(format_name(f) + (tetra ? " tetra" : " hexa"));
+}
+
+static void BENCH_volume_create_map(benchmark::State& state)
+{
+	const Format& f = volume_formats[state.range_x()];
+	const bool tetra = state.range_y() == 1;
+	const std::string filename = format_filename(tetra ? "tetra" : "hexa", f);
+	while (state.KeepRunning())
+	{
+		state.PauseTiming();
+		auto vi = cgogn::io::newVolumeImport<cgogn::DefaultMapTraits, Vec3>(filename);
+		vi->import_file(filename);
+		Map3 map;
+		state.ResumeTiming();
+		vi->create_map(map);
+	}
+	state.SetLabel(format_name(f) + (tetra ? " tetra" : " hexa"));
+}
+
+static void surface_args(benchmark::internal::Benchmark* b)
+{
+	for (uint32 i = 0u; i < surface_formats.size(); ++i)
+		b->Arg(int(i));
+}
+
+static void add_volume_args(benchmark::internal::Benchmark* b, bool exported_only)
+{
+	for (uint32 i = 0u; i < volume_formats.size(); ++i)
+	{
+		if (exported_only && !volume_formats[i].has_export)
+			continue;
+		b->ArgPair(int(i), 1);
+		if (!tetra_only(volume_formats[i]))
+			b->ArgPair(int(i), 0);
+	}
+}
+
+static void volume_args(benchmark::internal::Benchmark* b)
+{
+	add_volume_args(b, false);
+}
+
+// the formats without exporter are written by the writers of this benchmark: their export is not timed
+static void volume_export_args(benchmark::internal::Benchmark* b)
+{
+	add_volume_args(b, true);
+}
+
+BENCHMARK(BENCH_surface_export)->Apply(surface_args)->UseRealTime();
+BENCHMARK(BENCH_surface_import)->Apply(surface_args)->UseRealTime();
+BENCHMARK(BENCH_surface_create_map)->Apply(surface_args)->UseRealTime();
+BENCHMARK(BENCH_volume_export)->Apply(volume_export_args)->UseRealTime();
+BENCHMARK(BENCH_volume_import)->Apply(volume_args)->UseRealTime();
+BENCHMARK(BENCH_volume_create_map)->Apply(volume_args)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+	::benchmark::Initialize(&argc, argv);
+
+	if (argc < 2)
+		cgogn_log_info("bench_io") << "USAGE: " << argv[0] << " [surface_grid_size] [volume_grid_size]";
+	if (argc > 1)
+		surface_grid_size = uint32(std::stoul(argv[1]));
+	if (argc > 2)
+		volume_grid_size = uint32(std::stoul(argv[2]));
+	cgogn_log_info("bench_io") << "Surface grid " << surface_grid_size << "x" << surface_grid_size << ", volume grids " << volume_grid_size << "^3.";
+
+	auto position = surface_map.add_attribute<Vec3, Vertex2::ORBIT>("position");
+	auto normal = surface_map.add_attribute<Vec3, Face2::ORBIT>("normal");
+	cgogn::modeling::TriangularGrid<Map2> grid(surface_map, surface_grid_size, surface_grid_size);
+	grid.embed_into_grid(position, 1.0f, 1.0f, 0.0f);
+	surface_map.foreach_cell([&] (Face2 f) { normal[f] = cgogn::geometry::normal<Vec3>(surface_map, f, position); });
+
+	generate_volume(tetra_map, volume_grid_size, true);
+	generate_volume(hexa_map, volume_grid_size, false);
+
+	// the files read by the import benchmarks
+	for (const Format& f : surface_formats)
+		cgogn::io::export_surface(surface_map, surface_export_options(f));
+	for (const Format& f : volume_formats)
+	{
+		write_volume_file(f, true);
+		if (!tetra_only(f))
+			write_volume_file(f, false);
+	}
+
+	::benchmark::RunSpecifiedBenchmarks();
+
+	for (const Format& f : surface_formats)
+		std::remove(format_filename("surface", f).c_str());
+	for (const Format& f : volume_formats)
+	{
+		for (const std::string& prefix : {"tetra", "hexa"})
+		{
+			const std::string filename = format_filename(prefix, f);
+			std::remove(filename.c_str());
+			if (f.extension == "ele")
+				std::remove((cgogn::remove_extension(filename) + ".node").c_str());
+		}
+	}
+
+	return 0;
+}
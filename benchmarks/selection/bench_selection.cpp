@@ -0,0 +1,168 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <string>
+
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/io/map_import.h>
+#include <cgogn/geometry/algos/selection.h>
+#include <cgogn/geometry/algos/bounding_box.h>
+
+#include <benchmark/benchmark.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Map2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vec3 = Eigen::Vector3d;
+using Vertex = Map2::Vertex;
+template <typename T>
+using VertexAttribute = Map2::VertexAttribute<T>;
+
+using OneRing = cgogn::geometry::Collector_OneRing<Vec3, Map2>;
+using WithinSphere = cgogn::geometry::Collector_WithinSphere<Vec3, Map2>;
+
+Map2 bench_map;
+VertexAttribute<Vec3> bench_position;
+float64 bench_size = 1.0;
+
+// the radius of the sphere is the size of the bounding box divided by the argument of the benchmark
+inline float64 radius(const benchmark::State& state)
+{
+	return bench_size / float64(state.range_x());
+}
+
+// all the benchmarks report the number of collects per second (items per second)
+
+static void BENCH_one_ring_new_collector(benchmark::State& state)
+{
+	float64 sum = 0.0;
+	while (state.KeepRunning())
+	{
+		bench_map.foreach_cell([&] (Vertex v)
+		{
+			OneRing c(bench_map);
+			c.collect(v);
+			sum += float64(c.size<Vertex>());
+		});
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+static void BENCH_one_ring_pool(benchmark::State& state)
+{
+	cgogn::geometry::CollectorPool<OneRing> pool(bench_map);
+	VertexAttribute<uint32> nb = bench_map.get_attribute<uint32, Vertex::ORBIT>("nb");
+	while (state.KeepRunning())
+	{
+		pool.parallel_collect(bench_map, [&] (Vertex v, const OneRing& c)
+		{
+			nb[v] = uint32(c.size<Vertex>());
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+static void BENCH_within_sphere_new_collector(benchmark::State& state)
+{
+	const float64 r = radius(state);
+	VertexAttribute<float64> area = bench_map.get_attribute<float64, Vertex::ORBIT>("area");
+	while (state.KeepRunning())
+	{
+		bench_map.parallel_foreach_cell([&] (Vertex v, uint32)
+		{
+			WithinSphere c(bench_map, r, bench_position);
+			c.collect(v);
+			area[v] = c.area(bench_position);
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+static void BENCH_within_sphere_reused_collector(benchmark::State& state)
+{
+	const float64 r = radius(state);
+	VertexAttribute<float64> area = bench_map.get_attribute<float64, Vertex::ORBIT>("area");
+	WithinSphere c(bench_map, r, bench_position);
+	while (state.KeepRunning())
+	{
+		bench_map.foreach_cell([&] (Vertex v)
+		{
+			c.collect(v);
+			area[v] = c.area(bench_position);
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+static void BENCH_within_sphere_pool(benchmark::State& state)
+{
+	const float64 r = radius(state);
+	VertexAttribute<float64> area = bench_map.get_attribute<float64, Vertex::ORBIT>("area");
+	cgogn::geometry::CollectorPool<WithinSphere> pool(bench_map, r, bench_position);
+	while (state.KeepRunning())
+	{
+		pool.parallel_collect(bench_map, [&] (Vertex v, const WithinSphere& c)
+		{
+			area[v] = c.area(bench_position);
+		});
+	}
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+BENCHMARK(BENCH_one_ring_new_collector)->UseRealTime();
+BENCHMARK(BENCH_one_ring_pool)->UseRealTime();
+BENCHMARK(BENCH_within_sphere_new_collector)->Arg(100)->Arg(30)->UseRealTime();
+BENCHMARK(BENCH_within_sphere_reused_collector)->Arg(100)->Arg(30)->UseRealTime();
+BENCHMARK(BENCH_within_sphere_pool)->Arg(100)->Arg(30)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+	::benchmark::Initialize(&argc, argv);
+	std::string surface_mesh;
+
+	if (argc < 2)
+	{
+		cgogn_log_info("bench_selection") << "USAGE: " << argv[0] << " [filename]";
+		surface_mesh = std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off");
+		cgogn_log_info("bench_selection") << "Using default mesh : \"" << surface_mesh << "\".";
+	}
+	else
+		surface_mesh = std::string(argv[1]);
+
+	cgogn::io::import_surface<Vec3>(bench_map, surface_mesh);
+	bench_position = bench_map.get_attribute<Vec3, Vertex::ORBIT>("position");
+
+	cgogn::geometry::AABB<Vec3> bb;
+	cgogn::geometry::compute_AABB(bench_position, bb);
+	bench_size = bb.max_size();
+
+	bench_map.add_attribute<uint32, Vertex::ORBIT>("nb");
+	bench_map.add_attribute<float64, Vertex::ORBIT>("area");
+
+	::benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <string>
+#include <random>
+#include <memory>
+
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/utils/unique_ptr.h>
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/modeling/tiling/triangular_grid.h>
+#include <cgogn/topology/algos/distance_field.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace cgogn::numerics;
+
+using Map2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = Map2::Vertex;
+using Edge = Map2::Edge;
+template <typename T>
+using VertexAttribute = Map2::VertexAttribute<T>;
+template <typename T>
+using EdgeAttribute = Map2::EdgeAttribute<T>;
+
+using DistanceField = cgogn::topology::DistanceField<float64, Map2>;
+
+// the tiling is generated in main, its size can be given on the command line
+// (1000 for about 1M vertices, 3163 for about 10M vertices)
+uint32 grid_size = 1000u;
+
+Map2 bench_map;
+EdgeAttribute<float64> bench_weight;
+VertexAttribute<float64> bench_distance;
+std::unique_ptr<cgogn::topology::AdjacencyCache<Map2>> bench_cache;
+Vertex bench_source;
+
+// all the benchmarks report the number of vertices reached per second (items per second)
+
+static void run_dijkstra(benchmark::State& state, cgogn::topology::ShortestPathQueue queue)
+{
+	DistanceField distance_field(bench_map, *bench_cache, bench_weight);
+	distance_field.set_queue(queue);
+	while (state.KeepRunning())
+		distance_field.distance_to_features({bench_source}, bench_distance);
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+static void BENCH_dijkstra_binary_heap(benchmark::State& state)
+{
+	run_dijkstra(state, cgogn::topology::BINARY_HEAP);
+}
+
+static void BENCH_dijkstra_four_ary_heap(benchmark::State& state)
+{
+	run_dijkstra(state, cgogn::topology::FOUR_ARY_HEAP);
+}
+
+static void BENCH_dijkstra_radix_heap(benchmark::State& state)
+{
+	run_dijkstra(state, cgogn::topology::RADIX_HEAP);
+}
+
+// the width of the buckets is the argument of the benchmark divided by 10 (the mean edge weight is 1)
+static void BENCH_delta_stepping(benchmark::State& state)
+{
+	DistanceField distance_field(bench_map, *bench_cache, bench_weight);
+	const float64 delta = float64(state.range_x()) / 10.0;
+	while (state.KeepRunning())
+		distance_field.delta_stepping_compute_distances({bench_source}, bench_distance, delta);
+	state.SetItemsProcessed(state.iterations() * bench_map.nb_cells<Vertex::ORBIT>());
+}
+
+BENCHMARK(BENCH_dijkstra_binary_heap)->UseRealTime();
+BENCHMARK(BENCH_dijkstra_four_ary_heap)->UseRealTime();
+BENCHMARK(BENCH_dijkstra_radix_heap)->UseRealTime();
+BENCHMARK(BENCH_delta_stepping)->Arg(5)->Arg(10)->Arg(40)->UseRealTime();
+
+int main(int argc, char** argv)
+{
+	::benchmark::Initialize(&argc, argv);
+
+	if (argc < 2)
+		cgogn_log_info("bench_shortest_paths") << "USAGE: " << argv[0] << " [grid_size]";
+	else
+		grid_size = uint32(std::stoul(argv[1]));
+	cgogn_log_info("bench_shortest_paths") << "Triangular grid " << grid_size << "x" << grid_size << ".";
+
+	cgogn::modeling::TriangularGrid<Map2> grid(bench_map, grid_size, grid_size);
+
+	// random edge weights in [0.5, 1.5]
+	std::mt19937 generator(0u);
+	std::uniform_real_distribution<float64> distribution(0.5, 1.5);
+	bench_weight = bench_map.add_attribute<float64, Edge::ORBIT>("weight");
+	bench_map.foreach_cell([&] (Edge e) { bench_weight[e] = distribution(generator); });
+
+	bench_distance = bench_map.add_attribute<float64, Vertex::ORBIT>("distance");
+	bench_cache = cgogn::make_unique<cgogn::topology::AdjacencyCache<Map2>>(bench_map);
+	bench_cache->init();
+
+	// the source is the first vertex of the tiling (a corner)
+	bench_map.foreach_cell_until([&] (Vertex v) { bench_source = v; return false; });
+
+	::benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
@@ -57,6 +57,7 @@ using FaceAttribute = Map2::FaceAttribute<T>;
 
 using TMap2 = cgogn::CMap2Tri<cgogn::DefaultMapTraits>;
 TMap2 bench_tri_map;
+TMap2 bench_reordered_tri_map; // same mesh, darts and cells renumbered in the Morton order of the faces
 
 using TVertex = TMap2::Vertex;
 const cgogn::Orbit TVERTEX = TVertex::ORBIT;
@@ -152,6 +153,42 @@ static void BENCH_vertices_normals_tri(benchmark::State& state)
 	}
 }
 
+static void BENCH_faces_normals_tri_reordered(benchmark::State& state)
+{
+	while(state.KeepRunning())
+	{
+		state.PauseTiming();
+		TVertexAttribute<Vec3> vertex_position = bench_reordered_tri_map.get_attribute<Vec3, TVERTEX>("position");
+		cgogn_assert(vertex_position.is_valid());
+		TFaceAttribute<Vec3> face_normal = bench_reordered_tri_map.get_attribute<Vec3, TFACE>("normal");
+		cgogn_assert(face_normal.is_valid());
+		state.ResumeTiming();
+
+		bench_reordered_tri_map.foreach_cell<cgogn::TraversalStrategy::FORCE_DART_MARKING>([&] (TFace f)
+		{
+			face_normal[f] = cgogn::geometry::normal<Vec3>(bench_reordered_tri_map, f, vertex_position);
+		});
+	}
+}
+
+static void BENCH_vertices_normals_tri_reordered(benchmark::State& state)
+{
+	while(state.KeepRunning())
+	{
+		state.PauseTiming();
+		TVertexAttribute<Vec3> vertex_position = bench_reordered_tri_map.get_attribute<Vec3, TVERTEX>("position");
+		cgogn_assert(vertex_position.is_valid());
+		TVertexAttribute<Vec3> vertices_normal = bench_reordered_tri_map.get_attribute<Vec3, TVERTEX>("normal");
+		cgogn_assert(vertices_normal.is_valid());
+		state.ResumeTiming();
+
+		bench_reordered_tri_map.foreach_cell<cgogn::TraversalStrategy::FORCE_DART_MARKING>([&] (TVertex v)
+		{
+			vertices_normal[v] = cgogn::geometry::normal<Vec3>(bench_reordered_tri_map, v, vertex_position);
+		});
+	}
+}
+
 static void BENCH_vertices_filter_poly(benchmark::State& state)
 {
 	while(state.KeepRunning())
@@ -186,12 +223,32 @@ static void BENCH_vertices_filter_tri(benchmark::State& state)
 }
 
 
+static void BENCH_vertices_filter_tri_reordered(benchmark::State& state)
+{
+	while(state.KeepRunning())
+	{
+		state.PauseTiming();
+		TVertexAttribute<Vec3> vertex_position = bench_reordered_tri_map.get_attribute<Vec3, TVERTEX>("position");
+		cgogn_assert(vertex_position.is_valid());
+		TVertexAttribute<Vec3> vertex_position2 = bench_reordered_tri_map.get_attribute<Vec3, TVERTEX>("position2");
+		cgogn_assert(vertex_position2.is_valid());
+
+		state.ResumeTiming();
+
+		cgogn::geometry::filter_taubin<Vec3>(bench_reordered_tri_map, vertex_position, vertex_position2);
+	}
+}
+
+
 BENCHMARK(BENCH_faces_normals_poly);
 BENCHMARK(BENCH_faces_normals_tri);
+BENCHMARK(BENCH_faces_normals_tri_reordered);
 BENCHMARK(BENCH_vertices_normals_poly);
 BENCHMARK(BENCH_vertices_normals_tri);
+BENCHMARK(BENCH_vertices_normals_tri_reordered);
 BENCHMARK(BENCH_vertices_filter_poly)->UseRealTime();
 BENCHMARK(BENCH_vertices_filter_tri)->UseRealTime();
+BENCHMARK(BENCH_vertices_filter_tri_reordered)->UseRealTime();
 
 
 int main(int argc, char** argv)
@@ -218,6 +275,12 @@ int main(int argc, char** argv)
 	bench_tri_map.add_attribute<Vec3, VERTEX>("normal");
 	bench_tri_map.add_attribute<Vec3, VERTEX>("position2");
 
+	cgogn::io::import_surface<Vec3>(bench_reordered_tri_map, surfaceMesh);
+	bench_reordered_tri_map.reorder(bench_reordered_tri_map.get_attribute<Vec3, TVERTEX>("position"));
+	bench_reordered_tri_map.add_attribute<Vec3, FACE>("normal");
+	bench_reordered_tri_map.add_attribute<Vec3, VERTEX>("normal");
+	bench_reordered_tri_map.add_attribute<Vec3, VERTEX>("position2");
+
 
 	::benchmark::RunSpecifiedBenchmarks();
 	return 0;
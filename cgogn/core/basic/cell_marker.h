@@ -26,6 +26,7 @@
 
 #include <cgogn/core/container/chunk_array.h>
 #include <cgogn/core/cmap/map_base_data.h>
+#include <cgogn/core/utils/buffers.h>
 #include <type_traits>
 
 namespace cgogn
@@ -1910,7 +1910,7 @@ public:
 	inline void foreach_adjacent_vertex_through_face(Vertex v, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
-		DartMarker marker_vertex(*this);
+		DartMarkerStore marker_vertex(*this);
 		marker_vertex.mark_orbit(v);
 		foreach_incident_face(v, [&] (Face inc_face)
 		{
@@ -1929,7 +1929,7 @@ public:
 	inline void foreach_adjacent_vertex_through_volume(Vertex v, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
-		DartMarker marker_vertex(*this);
+		DartMarkerStore marker_vertex(*this);
 		marker_vertex.mark_orbit(v);
 		foreach_incident_volume(v, [&] (Volume inc_vol)
 		{
@@ -1962,7 +1962,7 @@ public:
 	inline void foreach_adjacent_edge_through_face(Edge e, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Edge>::value, "Wrong function cell parameter type");
-		DartMarker marker_edge(*this);
+		DartMarkerStore marker_edge(*this);
 		marker_edge.mark_orbit(e);
 		foreach_incident_face(e, [&] (Face inc_face)
 		{
@@ -1981,7 +1981,7 @@ public:
 	inline void foreach_adjacent_edge_through_volume(Edge e, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Edge>::value, "Wrong function cell parameter type");
-		DartMarker marker_edge(*this);
+		DartMarkerStore marker_edge(*this);
 		marker_edge.mark_orbit(e);
 		foreach_incident_volume(e, [&] (Volume inc_vol)
 		{
@@ -2000,7 +2000,7 @@ public:
 	inline void foreach_adjacent_face_through_vertex(Face f, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Face>::value, "Wrong function cell parameter type");
-		DartMarker marker_face(*this);
+		DartMarkerStore marker_face(*this);
 		marker_face.mark_orbit(f);
 		foreach_incident_vertex(f, [&] (Vertex v)
 		{
@@ -2033,7 +2033,7 @@ public:
 	inline void foreach_adjacent_face_through_volume(Face f, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Face>::value, "Wrong function cell parameter type");
-		DartMarker marker_face(*this);
+		DartMarkerStore marker_face(*this);
 		marker_face.mark_orbit(f);
 		if (!this->is_boundary(f.dart))
 		{
@@ -2064,7 +2064,7 @@ public:
 	inline void foreach_adjacent_volume_through_vertex(Volume v, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Volume>::value, "Wrong function cell parameter type");
-		DartMarker marker_volume(*this);
+		DartMarkerStore marker_volume(*this);
 		marker_volume.mark_orbit(v);
 		foreach_incident_vertex(v, [&] (Vertex inc_vert)
 		{
@@ -2083,7 +2083,7 @@ public:
 	inline void foreach_adjacent_volume_through_edge(Volume v, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Volume>::value, "Wrong function cell parameter type");
-		DartMarker marker_volume(*this);
+		DartMarkerStore marker_volume(*this);
 		marker_volume.mark_orbit(v);
 		foreach_incident_edge(v, [&] (Edge inc_edge)
 		{
@@ -2102,9 +2102,9 @@ public:
 	inline void foreach_adjacent_volume_through_face(Volume v, const FUNC& func) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Volume>::value, "Wrong function cell parameter type");
-		DartMarker marker_volume(*this);
+		DartMarkerStore marker_volume(*this);
 		marker_volume.mark_orbit(v);
-		foreach_incident_face(v, [&] (Edge inc_face)
+		foreach_incident_face(v, [&] (Face inc_face)
 		{
 			foreach_incident_volume(inc_face, [&] (Volume inc_vol)
 			{
@@ -25,12 +25,16 @@
 #define CGOGN_CORE_CMAP_MAP_BASE_H_
 
 #include <vector>
+#include <array>
 #include <memory>
+#include <atomic>
 
 #include <cgogn/core/utils/masks.h>
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/utils/unique_ptr.h>
 #include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/union_find.h>
+#include <cgogn/core/utils/morton_code.h>
 
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/basic/dart_marker.h>
@@ -50,6 +54,25 @@ enum TraversalStrategy
 	FORCE_CELL_MARKING
 };
 
+enum ComponentConnectivity
+{
+	PHI_CONNECTIVITY = 0,	// darts connected by the phi relations (the ConnectedComponent orbits)
+	VERTEX_CONNECTIVITY		// vertices connected by the edges, the vertices of a same embedding being merged
+};
+
+// the size of a connected component: its number of darts and its number of cells of each dimension (boundary excluded)
+struct ConnectedComponentStats
+{
+	uint32 nb_darts_;
+	std::array<uint32, 4> nb_cells_;
+};
+
+enum ReorderStrategy
+{
+	BREADTH_FIRST_ORDER = 0,		// breadth first traversal of the faces (PHI1 orbits)
+	REVERSE_CUTHILL_MCKEE_ORDER		// reverse Cuthill-McKee ordering of the adjacency graph of the faces
+};
+
 template <typename MAP_TRAITS, typename MAP_TYPE>
 class MapBase : public MapBaseData<MAP_TRAITS>
 {
@@ -685,6 +708,188 @@ public:
 		return nb_cells<ConcreteMap::ConnectedComponent::ORBIT>();
 	}
 
+	/**
+	 * \brief label the cells of an orbit with the index of their connected component (boundary cells excluded)
+	 * The components are computed with a concurrent union-find, the unions being done in parallel:
+	 * - PHI_CONNECTIVITY: on the darts, each dart being united with its images by phi1, phi2 (and phi3)
+	 * - VERTEX_CONNECTIVITY: on the vertex embeddings, the two vertices of each edge being united
+	 *   (one union per dart instead of one per dart and relation; the vertices that share an embedding
+	 *   belong to the same component). The vertices must be embedded.
+	 * The components are numbered in the order of their smallest dart (or vertex embedding).
+	 * @param label the attribute that receives the index of the component of each cell
+	 * @param connectivity
+	 * @return the sizes of the components (indexed by the labels)
+	 */
+	template <Orbit ORBIT>
+	std::vector<ConnectedComponentStats> label_connected_components(
+			Attribute<uint32, ORBIT>& label,
+			ComponentConnectivity connectivity = PHI_CONNECTIVITY) const
+	{
+		using Vertex = typename ConcreteMap::Vertex;
+		static_assert(ConcreteMap::DIMENSION == 2u || ConcreteMap::DIMENSION == 3u,
+					  "label_connected_components is only defined for surfaces and volumes");
+
+		if (connectivity == VERTEX_CONNECTIVITY && !this->template is_embedded<Vertex>())
+		{
+			cgogn_log_warning("label_connected_components") << "The vertices are not embedded: the darts are used.";
+			connectivity = PHI_CONNECTIVITY;
+		}
+
+		const ConcreteMap* cmap = to_concrete();
+		const bool vertices = connectivity == VERTEX_CONNECTIVITY;
+		const auto& vertex_container = this->attributes_[Vertex::ORBIT];
+		const uint32 nb_elements = vertices ? vertex_container.end() : this->topology_.end();
+		auto is_used = [&] (uint32 i) -> bool
+		{
+			return vertices ? vertex_container.used(i) : this->topology_.used(i);
+		};
+		const uint32 nb_darts = this->topology_.end();
+
+		ConcurrentUnionFind uf(nb_elements);
+		parallel_foreach_range(nb_darts, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (!this->topology_.used(i))
+					continue;
+				const Dart d(i);
+				if (vertices)
+					uf.unite(this->embedding(Vertex(d)), this->embedding(Vertex(cmap->phi1(d))));
+				else
+					foreach_phi_image(d, [&] (Dart e) { uf.unite(d.index, e.index); });
+			}
+		});
+
+		// the components are numbered in the order of their roots (i.e. of their smallest element),
+		// the numbers of the roots are read from their own array while the elements are labeled in parallel
+		std::vector<uint32> root_component(nb_elements, INVALID_INDEX);
+		uint32 nb_components = 0u;
+		for (uint32 i = 0u; i < nb_elements; ++i)
+		{
+			if (is_used(i) && uf.find(i) == i)
+				root_component[i] = nb_components++;
+		}
+		std::vector<uint32> component(nb_elements, INVALID_INDEX);
+		parallel_foreach_range(nb_elements, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (is_used(i))
+					component[i] = root_component[uf.find(i)];
+			}
+		});
+		std::vector<uint32>().swap(root_component);
+
+		auto component_of = [&] (Dart d) -> uint32
+		{
+			return component[vertices ? this->embedding(Vertex(d)) : d.index];
+		};
+
+		this->parallel_foreach_cell([&] (Cell<ORBIT> c, uint32)
+		{
+			label[c] = component_of(c.dart);
+		});
+
+		// sizes of the components, accumulated in one atomic counter per component
+		// (consecutive darts mostly belong to the same component: the counts are added by runs)
+		std::vector<ConnectedComponentStats> stats(nb_components, ConnectedComponentStats{0u, {{0u, 0u, 0u, 0u}}});
+		std::vector<std::atomic<uint32>> count(nb_components);
+		reset_component_counts(count);
+		parallel_foreach_range(nb_darts, [&] (uint32, uint32 begin, uint32 end)
+		{
+			ComponentRun run;
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (this->topology_.used(i) && !this->is_boundary(Dart(i)))
+					run.add(component_of(Dart(i)), count);
+			}
+			run.flush(count);
+		});
+		for (uint32 k = 0u; k < nb_components; ++k)
+			stats[k].nb_darts_ = count[k].load(std::memory_order_relaxed);
+
+		count_cells_per_component<Vertex>(component_of, count, stats, 0u);
+		count_cells_per_component<typename ConcreteMap::Edge>(component_of, count, stats, 1u);
+		count_cells_per_component<typename ConcreteMap::Face>(component_of, count, stats, 2u);
+		if (ConcreteMap::DIMENSION == 3u)
+			count_cells_per_component<typename ConcreteMap::Volume>(component_of, count, stats, 3u);
+
+		return stats;
+	}
+
+protected:
+
+	template <typename FUNC, typename CMAP = ConcreteMap, typename std::enable_if<CMAP::DIMENSION == 2u>::type* = nullptr>
+	inline void foreach_phi_image(Dart d, const FUNC& f) const
+	{
+		f(to_concrete()->phi1(d));
+		f(to_concrete()->phi2(d));
+	}
+
+	template <typename FUNC, typename CMAP = ConcreteMap, typename std::enable_if<CMAP::DIMENSION == 3u>::type* = nullptr>
+	inline void foreach_phi_image(Dart d, const FUNC& f) const
+	{
+		f(to_concrete()->phi1(d));
+		f(to_concrete()->phi2(d));
+		f(to_concrete()->phi3(d));
+	}
+
+	/**
+	 * \brief a run of consecutive elements of the same component, added at once to the counter of the component
+	 */
+	struct ComponentRun
+	{
+		uint32 component_ = INVALID_INDEX;
+		uint32 size_ = 0u;
+
+		inline void add(uint32 component, std::vector<std::atomic<uint32>>& count)
+		{
+			if (component != component_)
+			{
+				flush(count);
+				component_ = component;
+			}
+			++size_;
+		}
+
+		inline void flush(std::vector<std::atomic<uint32>>& count)
+		{
+			if (size_ > 0u)
+				count[component_].fetch_add(size_, std::memory_order_relaxed);
+			size_ = 0u;
+		}
+	};
+
+	static void reset_component_counts(std::vector<std::atomic<uint32>>& count)
+	{
+		parallel_foreach_range(uint32(count.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 k = begin; k < end; ++k)
+				count[k].store(0u, std::memory_order_relaxed);
+		});
+	}
+
+	template <typename CellType, typename COMPONENT>
+	void count_cells_per_component(
+			const COMPONENT& component_of,
+			std::vector<std::atomic<uint32>>& count,
+			std::vector<ConnectedComponentStats>& stats,
+			uint32 dim) const
+	{
+		reset_component_counts(count);
+		std::vector<ComponentRun> runs(thread_pool()->nb_concurrent_tasks());
+		this->parallel_foreach_cell([&] (CellType c, uint32 thread_index)
+		{
+			runs[thread_index].add(component_of(c.dart), count);
+		});
+		for (ComponentRun& run : runs)
+			run.flush(count);
+		for (uint32 k = 0u; k < uint32(stats.size()); ++k)
+			stats[k].nb_cells_[dim] = count[k].load(std::memory_order_relaxed);
+	}
+
+public:
+
 	/**
 	 * \brief return the number of darts in the given cell
 	 */
@@ -782,7 +987,7 @@ public:
 		using VecDarts = std::vector<Dart>;
 
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		const std::size_t nb_threads_pool = thread_pool->nb_threads();
+		const std::size_t nb_threads_pool = thread_pool->nb_concurrent_tasks();
 
 		std::array<std::vector<VecDarts*>, 2> dart_buffers;
 		std::array<std::vector<Future>, 2> futures;
@@ -1076,7 +1281,7 @@ public:
 		using Future = std::future<typename std::result_of<FUNC(CellType, uint32)>::type>;
 
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		const std::size_t nb_threads_pool = thread_pool->nb_threads();
+		const std::size_t nb_threads_pool = thread_pool->nb_concurrent_tasks();
 
 		std::array<std::vector<VecCell*>, 2> cells_buffers;
 		std::array<std::vector<Future>, 2> futures;
@@ -1176,7 +1381,7 @@ protected:
 		using Future = std::future<typename std::result_of<FUNC(CellType, uint32)>::type>;
 
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		const std::size_t nb_threads_pool = thread_pool->nb_threads();
+		const std::size_t nb_threads_pool = thread_pool->nb_concurrent_tasks();
 
 		std::array<std::vector<VecCell*>, 2> cells_buffers;
 		std::array<std::vector<Future>, 2> futures;
@@ -1275,7 +1480,7 @@ protected:
 		using Future = std::future<typename std::result_of<FUNC(CellType, uint32)>::type>;
 
 		ThreadPool* thread_pool = cgogn::thread_pool();
-		const std::size_t nb_threads_pool = thread_pool->nb_threads();
+		const std::size_t nb_threads_pool = thread_pool->nb_concurrent_tasks();
 
 		std::array<std::vector<VecCell*>, 2> cells_buffers;
 		std::array<std::vector<Future>, 2> futures;
@@ -1449,6 +1654,282 @@ public:
 			compact_embedding(orbit); // checking if embedding used done inside
 	}
 
+	/*******************************************************************************
+	 * reordering
+	 *******************************************************************************/
+
+	/**
+	 * @brief renumber the darts and the cells of the map to improve the locality of the traversals
+	 * The faces (PHI1 orbits, or primitives for the maps with PRIM_SIZE > 1) are ordered with the given
+	 * strategy, their darts are renumbered consecutively in this order and the cells of each embedded orbit
+	 * are renumbered in the order of their first dart. The topology and attribute containers are permuted
+	 * (in parallel, see ChunkArrayContainer::permute), without holes, and the embeddings are remapped.
+	 * The darts, cells and caches (adjacency caches, cell caches...) obtained before are invalidated.
+	 */
+	void reorder(ReorderStrategy strategy)
+	{
+		static_assert(ConcreteMap::DIMENSION == 2u || ConcreteMap::DIMENSION == 3u,
+					  "reorder is only defined for surfaces and volumes");
+
+		std::vector<uint32> unit_offsets, unit_darts, dart_unit;
+		reorder_units(unit_offsets, unit_darts, dart_unit);
+		const uint32 nb_units = uint32(unit_offsets.size() - 1u);
+
+		// adjacency graph of the units (through the phi relations)
+		std::vector<uint32> offsets(nb_units + 1u, 0u);
+		std::vector<uint32> adjacency;
+		auto foreach_adjacent_unit = [&] (uint32 u, std::vector<uint32>& neighbors)
+		{
+			neighbors.clear();
+			for (uint32 k = unit_offsets[u]; k < unit_offsets[u + 1u]; ++k)
+			{
+				foreach_phi_image(Dart(unit_darts[k]), [&] (Dart e)
+				{
+					const uint32 v = dart_unit[e.index];
+					if (v != u)
+						neighbors.push_back(v);
+				});
+			}
+			std::sort(neighbors.begin(), neighbors.end());
+			neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		};
+		parallel_foreach_range(nb_units, [&] (uint32, uint32 begin, uint32 end)
+		{
+			std::vector<uint32> neighbors;
+			for (uint32 u = begin; u < end; ++u)
+			{
+				foreach_adjacent_unit(u, neighbors);
+				offsets[u + 1u] = uint32(neighbors.size());
+			}
+		});
+		for (uint32 u = 0u; u < nb_units; ++u)
+			offsets[u + 1u] += offsets[u];
+		adjacency.resize(offsets[nb_units]);
+		parallel_foreach_range(nb_units, [&] (uint32, uint32 begin, uint32 end)
+		{
+			std::vector<uint32> neighbors;
+			for (uint32 u = begin; u < end; ++u)
+			{
+				foreach_adjacent_unit(u, neighbors);
+				std::copy(neighbors.begin(), neighbors.end(), adjacency.begin() + offsets[u]);
+			}
+		});
+
+		auto degree = [&] (uint32 u) -> uint32 { return offsets[u + 1u] - offsets[u]; };
+
+		std::vector<uint32> order;
+		order.reserve(nb_units);
+		std::vector<uint8> visited(nb_units, 0u);
+		std::vector<uint32> neighbors;
+
+		// breadth first traversal from u (in the order of the adjacency or by increasing degree)
+		auto breadth_first = [&] (uint32 u, bool sort_by_degree)
+		{
+			std::size_t head = order.size();
+			visited[u] = 1u;
+			order.push_back(u);
+			while (head < order.size())
+			{
+				const uint32 v = order[head++];
+				neighbors.clear();
+				for (uint32 k = offsets[v]; k < offsets[v + 1u]; ++k)
+				{
+					const uint32 w = adjacency[k];
+					if (!visited[w])
+					{
+						visited[w] = 1u;
+						neighbors.push_back(w);
+					}
+				}
+				if (sort_by_degree)
+					std::stable_sort(neighbors.begin(), neighbors.end(), [&] (uint32 a, uint32 b) { return degree(a) < degree(b); });
+				order.insert(order.end(), neighbors.begin(), neighbors.end());
+			}
+		};
+
+		for (uint32 u = 0u; u < nb_units; ++u)
+		{
+			if (visited[u])
+				continue;
+			if (strategy == BREADTH_FIRST_ORDER)
+				breadth_first(u, false);
+			else
+			{
+				// the traversal starts from the last reached unit of a first traversal (pseudo-peripheral unit)
+				const std::size_t first = order.size();
+				breadth_first(u, false);
+				const uint32 start = order.back();
+				for (std::size_t i = first; i < order.size(); ++i)
+					visited[order[i]] = 0u;
+				order.resize(first);
+				breadth_first(start, true);
+			}
+		}
+		if (strategy == REVERSE_CUTHILL_MCKEE_ORDER)
+			std::reverse(order.begin(), order.end());
+
+		reorder_darts(order, unit_offsets, unit_darts);
+	}
+
+	/**
+	 * @brief renumber the darts and the cells of the map in the Morton order (Z-order) of the centroids
+	 * of the faces (PHI1 orbits, or primitives for the maps with PRIM_SIZE > 1), see reorder(strategy)
+	 * @param position the position of the cells of ORBIT (e.g. the vertices)
+	 */
+	template <typename VEC3, Orbit ORBIT>
+	void reorder(const Attribute<VEC3, ORBIT>& position)
+	{
+		static_assert(ConcreteMap::DIMENSION == 2u || ConcreteMap::DIMENSION == 3u,
+					  "reorder is only defined for surfaces and volumes");
+		cgogn_message_assert(position.is_valid(), "reorder: invalid position attribute");
+
+		std::vector<uint32> unit_offsets, unit_darts, dart_unit;
+		reorder_units(unit_offsets, unit_darts, dart_unit);
+		const uint32 nb_units = uint32(unit_offsets.size() - 1u);
+
+		std::vector<std::array<float64, 3>> centroids(nb_units);
+		parallel_foreach_range(nb_units, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 u = begin; u < end; ++u)
+			{
+				std::array<float64, 3>& c = centroids[u];
+				c.fill(0.0);
+				for (uint32 k = unit_offsets[u]; k < unit_offsets[u + 1u]; ++k)
+				{
+					const VEC3& p = position[this->embedding(Dart(unit_darts[k]), ORBIT)];
+					for (uint32 j = 0u; j < 3u; ++j)
+						c[j] += float64(p[j]);
+				}
+				for (uint32 j = 0u; j < 3u; ++j)
+					c[j] /= float64(unit_offsets[u + 1u] - unit_offsets[u]);
+			}
+		});
+
+		const std::vector<uint64> codes = morton_codes(centroids);
+		std::vector<uint32> order(nb_units);
+		for (uint32 u = 0u; u < nb_units; ++u)
+			order[u] = u;
+		parallel_sort(order, [&] (uint32 a, uint32 b)
+		{
+			return codes[a] < codes[b] || (codes[a] == codes[b] && a < b);
+		});
+
+		reorder_darts(order, unit_offsets, unit_darts);
+	}
+
+protected:
+
+	/**
+	 * @brief the units of the reordering: the PHI1 orbits, or the primitives for the maps with PRIM_SIZE > 1
+	 * (the darts of the unit u are unit_darts[unit_offsets[u]] ... unit_darts[unit_offsets[u + 1] - 1])
+	 */
+	void reorder_units(std::vector<uint32>& unit_offsets, std::vector<uint32>& unit_darts, std::vector<uint32>& dart_unit) const
+	{
+		const ConcreteMap* cmap = to_concrete();
+		const uint32 end = this->topology_.end();
+		dart_unit.assign(end, INVALID_INDEX);
+		unit_darts.clear();
+		unit_darts.reserve(this->topology_.size());
+		unit_offsets.assign(1u, 0u);
+
+		for (uint32 i = this->topology_.begin(); i != end; this->topology_.next(i))
+		{
+			if (dart_unit[i] != INVALID_INDEX)
+				continue;
+			const uint32 u = uint32(unit_offsets.size() - 1u);
+			if (ConcreteMap::PRIM_SIZE > 1u)
+			{
+				const uint32 first = i - i % ConcreteMap::PRIM_SIZE;
+				for (uint32 j = first; j < first + ConcreteMap::PRIM_SIZE; ++j)
+				{
+					dart_unit[j] = u;
+					unit_darts.push_back(j);
+				}
+			}
+			else
+			{
+				Dart d(i);
+				do
+				{
+					dart_unit[d.index] = u;
+					unit_darts.push_back(d.index);
+					d = cmap->phi1(d);
+				} while (d.index != i);
+			}
+			unit_offsets.push_back(uint32(unit_darts.size()));
+		}
+	}
+
+	/**
+	 * @brief renumber the darts unit by unit in the given order of the units, then the cells
+	 * of each embedded orbit in the order of their first dart
+	 */
+	void reorder_darts(const std::vector<uint32>& order, const std::vector<uint32>& unit_offsets, const std::vector<uint32>& unit_darts)
+	{
+		std::vector<uint32> old_new(this->topology_.end(), INVALID_INDEX);
+		uint32 nb_darts = 0u;
+		for (uint32 u : order)
+		{
+			for (uint32 k = unit_offsets[u]; k < unit_offsets[u + 1u]; ++k)
+				old_new[unit_darts[k]] = nb_darts++;
+		}
+		cgogn_message_assert(nb_darts == this->topology_.size(), "reorder: some darts have not been ordered");
+
+		this->topology_.permute(old_new, nb_darts);
+		for (ChunkArrayGen* ptr : this->topology_.chunk_arrays())
+		{
+			ChunkArray<Dart>* ca = dynamic_cast<ChunkArray<Dart>*>(ptr);
+			if (ca)
+			{
+				parallel_foreach_range(nb_darts, [&] (uint32, uint32 begin, uint32 end)
+				{
+					for (uint32 i = begin; i < end; ++i)
+					{
+						Dart& d = (*ca)[i];
+						if (!d.is_nil())
+							d = Dart(old_new[d.index]);
+					}
+				});
+			}
+		}
+
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		{
+			ChunkArray<uint32>* embedding = this->embeddings_[orbit];
+			if (embedding == nullptr)
+				continue;
+
+			ChunkArrayContainer<uint32>& container = this->attributes_[orbit];
+			std::vector<uint32> emb_old_new(container.end(), INVALID_INDEX);
+			uint32 nb_cells = 0u;
+			for (uint32 i = 0u; i < nb_darts; ++i)
+			{
+				const uint32 emb = (*embedding)[i];
+				if (emb != INVALID_INDEX && emb_old_new[emb] == INVALID_INDEX)
+					emb_old_new[emb] = nb_cells++;
+			}
+			// the cells that are not referenced by any dart are kept after the others
+			for (uint32 emb = container.begin(); emb != container.end(); container.next(emb))
+			{
+				if (emb_old_new[emb] == INVALID_INDEX)
+					emb_old_new[emb] = nb_cells++;
+			}
+
+			container.permute(emb_old_new, nb_cells);
+			parallel_foreach_range(nb_darts, [&] (uint32, uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					uint32& emb = (*embedding)[i];
+					if (emb != INVALID_INDEX)
+						emb = emb_old_new[emb];
+				}
+			});
+		}
+	}
+
+public:
+
 	/**
 	 * @brief merge map in this map
 	 * @param map must be of same type than map
@@ -38,6 +38,7 @@
 #include <cgogn/core/utils/assert.h>
 #include <cgogn/core/utils/name_types.h>
 #include <cgogn/core/utils/unique_ptr.h>
+#include <cgogn/core/utils/thread_pool.h>
 #include <cgogn/core/container/chunk_array.h>
 #include <cgogn/core/container/chunk_stack.h>
 #include <cgogn/core/container/chunk_array_factory.h>
@@ -642,6 +643,59 @@ public:
 		return map_old_new;
 	}
 
+	/**
+	 * @brief container renumbering: the line i goes to line old_new[i]
+	 * @param old_new the new index of each used line (distinct indices in [0, new_end))
+	 * @param new_end the end of the renumbered container, the lines of [0, new_end) that are not reached
+	 * are unused (and not stored as holes)
+	 * The arrays are renumbered in parallel, except the marker arrays (bit arrays).
+	 * The permutation is not done in place: each array is copied in a permuted clone that replaces it,
+	 * one array at a time, so that the renumbering needs the memory of the largest array in addition.
+	 */
+	void permute(const std::vector<uint32>& old_new, uint32 new_end)
+	{
+		const uint32 old_end = nb_max_lines_;
+		const uint32 new_nb_blocks = new_end / CHUNK_SIZE + 1u;
+
+		auto permute_array = [&] (ChunkArrayGen* arr, bool parallel)
+		{
+			std::unique_ptr<ChunkArrayGen> permuted = arr->clone(arr->name() + "_permuted");
+			permuted->set_nb_chunks(new_nb_blocks);
+			auto permute_range = [&] (uint32, uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					if (used(i))
+						permuted->copy_external_element(old_new[i], arr, i);
+				}
+			};
+			if (parallel)
+				parallel_foreach_range(old_end, permute_range);
+			else
+				permute_range(0u, 0u, old_end);
+			arr->swap(permuted.get());
+		};
+
+		for (auto arr : table_arrays_)
+			permute_array(arr, true);
+		for (auto arr : table_marker_arrays_)
+			permute_array(arr, false);
+
+		ChunkArray<T_REF> refs;
+		refs.set_nb_chunks(new_nb_blocks);
+		for (uint32 i = 0u; i < new_nb_blocks * CHUNK_SIZE; ++i)
+			refs.set_value(i, T_REF(0));
+		for (uint32 i = 0u; i < old_end; ++i)
+		{
+			if (used(i))
+				refs.set_value(old_new[i], refs_[i]);
+		}
+		refs_.swap(&refs);
+
+		holes_stack_.clear();
+		nb_max_lines_ = new_end;
+	}
+
 	bool check_before_merge(const Self& cac)
 	{
 		for (uint32 i=0; i<cac.names_.size(); ++i)
@@ -416,6 +416,133 @@ TEST_F(CMap2Test, merge_map)
 	EXPECT_EQ(map1.nb_cells<Volume::ORBIT>(),10);
 }
 
+/**
+ * \brief The labels of the connected components are the indices of the Volume orbits
+ * and the sizes of the components sum to the sizes of the map.
+ */
+TEST_F(CMap2Test, label_connected_components)
+{
+	add_closed_surfaces();
+	add_faces(NB_MAX);
+
+	testCMap2::VertexAttribute<uint32> vertex_label = cmap_.add_attribute<uint32, Vertex::ORBIT>("vertex_label");
+	testCMap2::VolumeAttribute<uint32> volume_label = cmap_.add_attribute<uint32, Volume::ORBIT>("volume_label");
+
+	std::vector<ConnectedComponentStats> stats = cmap_.label_connected_components(volume_label);
+	EXPECT_EQ(uint32(stats.size()), cmap_.nb_connected_components());
+
+	std::vector<uint32> labels;
+	cmap_.foreach_cell([&] (Volume w) { labels.push_back(volume_label[w]); });
+	std::sort(labels.begin(), labels.end());
+	for (uint32 i = 0u; i < uint32(labels.size()); ++i)
+		EXPECT_EQ(labels[i], i);
+
+	uint32 nb_darts = 0u;
+	std::array<uint32, 4> nb_cells = {{0u, 0u, 0u, 0u}};
+	for (const ConnectedComponentStats& s : stats)
+	{
+		nb_darts += s.nb_darts_;
+		for (uint32 i = 0u; i < 4u; ++i)
+			nb_cells[i] += s.nb_cells_[i];
+		EXPECT_EQ(s.nb_cells_[3], 0u);
+	}
+	uint32 nb_inner_darts = 0u;
+	cmap_.foreach_dart([&] (Dart d) { if (!cmap_.is_boundary(d)) ++nb_inner_darts; });
+	EXPECT_EQ(nb_darts, nb_inner_darts);
+	EXPECT_EQ(nb_cells[0], cmap_.nb_cells<Vertex::ORBIT>());
+	EXPECT_EQ(nb_cells[1], cmap_.nb_cells<Edge::ORBIT>());
+	EXPECT_EQ(nb_cells[2], cmap_.nb_cells<Face::ORBIT>());
+
+	// the embeddings of the vertices are unique: the vertex connectivity gives the same components
+	std::vector<ConnectedComponentStats> vertex_stats = cmap_.label_connected_components(vertex_label, VERTEX_CONNECTIVITY);
+	EXPECT_EQ(vertex_stats.size(), stats.size());
+	cmap_.foreach_cell([&] (Vertex v)
+	{
+		cmap_.foreach_incident_vertex(Volume(v.dart), [&] (Vertex u)
+		{
+			EXPECT_EQ(vertex_label[u], vertex_label[v]);
+		});
+	});
+	std::vector<uint32> sizes, vertex_sizes;
+	for (uint32 i = 0u; i < uint32(stats.size()); ++i)
+	{
+		sizes.push_back(stats[i].nb_cells_[0]);
+		vertex_sizes.push_back(vertex_stats[i].nb_cells_[0]);
+	}
+	std::sort(sizes.begin(), sizes.end());
+	std::sort(vertex_sizes.begin(), vertex_sizes.end());
+	EXPECT_TRUE(sizes == vertex_sizes);
+}
+
+TEST_F(CMap2Test, reorder)
+{
+	add_closed_surfaces();
+	add_faces(NB_MAX);
+
+	testCMap2::VertexAttribute<int32> att_v = cmap_.get_attribute<int32, Vertex::ORBIT>("vertices");
+	testCMap2::EdgeAttribute<int32> att_e = cmap_.get_attribute<int32, Edge::ORBIT>("edges");
+	testCMap2::FaceAttribute<int32> att_f = cmap_.get_attribute<int32, Face::ORBIT>("faces");
+	testCMap2::VertexAttribute<std::array<float64, 3>> position = cmap_.add_attribute<std::array<float64, 3>, Vertex::ORBIT>("position");
+
+	int32 count = 0;
+	cmap_.foreach_cell([&] (Vertex v) { att_v[v] = count++; position[v] = {{ float64(std::rand() % 100), float64(std::rand() % 100), float64(std::rand() % 100) }}; });
+	cmap_.foreach_cell([&] (Edge e) { att_e[e] = count++; });
+	cmap_.foreach_cell([&] (Face f) { att_f[f] = count++; });
+
+	// remove some faces to make holes in the containers
+	for (uint32 i = 0u; i < NB_MAX; i += 5u)
+	{
+		if (cmap_.codegree(Face(darts_[i])) > 2u)
+			cmap_.collapse_edge(Edge(darts_[i]));
+	}
+	EXPECT_TRUE(cmap_.check_map_integrity());
+
+	// the attributes of the cells around each face do not depend on the numbering
+	auto signature = [&] () -> std::vector<std::vector<int32>>
+	{
+		std::vector<std::vector<int32>> result;
+		cmap_.foreach_cell([&] (Face f)
+		{
+			std::vector<int32> s;
+			cmap_.foreach_incident_vertex(f, [&] (Vertex v) { s.push_back(att_v[v]); });
+			cmap_.foreach_incident_edge(f, [&] (Edge e) { s.push_back(att_e[e]); });
+			std::sort(s.begin(), s.end());
+			s.push_back(att_f[f]);
+			s.push_back(int32(cmap_.is_boundary(f.dart)));
+			result.push_back(s);
+		});
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+	const std::vector<std::vector<int32>> initial = signature();
+	const uint32 nb_darts = cmap_.nb_darts();
+	const uint32 nb_vertices = cmap_.nb_cells<Vertex::ORBIT>();
+
+	auto check = [&] ()
+	{
+		EXPECT_TRUE(cmap_.check_map_integrity());
+		EXPECT_EQ(cmap_.nb_darts(), nb_darts);
+		EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), nb_vertices);
+		EXPECT_EQ(cmap_.topology_container().size(), cmap_.topology_container().end());
+		EXPECT_EQ(cmap_.const_attribute_container<Vertex::ORBIT>().size(), cmap_.const_attribute_container<Vertex::ORBIT>().end());
+		EXPECT_EQ(cmap_.const_attribute_container<Edge::ORBIT>().size(), cmap_.const_attribute_container<Edge::ORBIT>().end());
+		EXPECT_TRUE(signature() == initial);
+	};
+
+	cmap_.reorder(BREADTH_FIRST_ORDER);
+	check();
+	// the darts of a face are consecutive
+	cmap_.foreach_dart([&] (Dart d)
+	{
+		const Dart e = cmap_.phi1(d);
+		EXPECT_TRUE(e.index == d.index + 1u || e.index <= d.index);
+	});
+	cmap_.reorder(REVERSE_CUTHILL_MCKEE_ORDER);
+	check();
+	cmap_.reorder(position);
+	check();
+}
+
 #undef NB_MAX
 
 } // namespace cgogn
@@ -0,0 +1,101 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/utils/thread_pool.h>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <functional>
+
+using namespace cgogn::numerics;
+
+TEST(ThreadPoolTest, ParallelForeachRange)
+{
+	const uint32 nb = 100000u;
+	std::vector<uint32> count(nb, 0u);
+	cgogn::parallel_foreach_range(nb, 7u, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+			++count[i];
+	});
+	EXPECT_EQ(std::count(count.begin(), count.end(), 1u), int32(nb));
+}
+
+// every worker runs an outer range that waits for inner ranges
+TEST(ThreadPoolTest, NestedParallelForeachRange)
+{
+	const uint32 nb_outer = 4u * uint32(cgogn::thread_pool()->nb_threads() + 1u);
+	const uint32 nb = 10000u;
+	std::vector<std::vector<uint32>> count(nb_outer, std::vector<uint32>(nb, 0u));
+	std::vector<std::vector<uint32>> sorted(nb_outer);
+	cgogn::parallel_foreach_range(nb_outer, nb_outer, [&] (uint32 r, uint32, uint32)
+	{
+		cgogn::parallel_foreach_range(nb, 7u, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				++count[r][i];
+		});
+		std::vector<uint32>& v = sorted[r];
+		for (uint32 i = 0u; i < 3u * 1024u * 8u; ++i)
+			v.push_back((i * 7919u + r) % 1000u);
+		cgogn::parallel_sort(v, std::less<uint32>());
+	});
+	for (uint32 r = 0u; r < nb_outer; ++r)
+	{
+		EXPECT_EQ(std::count(count[r].begin(), count[r].end(), 1u), int32(nb));
+		EXPECT_TRUE(std::is_sorted(sorted[r].begin(), sorted[r].end()));
+	}
+}
+
+TEST(ThreadPoolTest, ParallelComputeOffsets)
+{
+	for (uint32 nb : {0u, 1u, 100003u})
+	{
+		std::vector<uint32> offsets;
+		cgogn::parallel_compute_offsets(nb, [] (uint32 i) { return i % 5u; }, offsets);
+		ASSERT_EQ(offsets.size(), nb + 1u);
+		uint32 first = 0u;
+		for (uint32 i = 0u; i < nb; ++i)
+		{
+			EXPECT_EQ(offsets[i], first);
+			first += i % 5u;
+		}
+		EXPECT_EQ(offsets[nb], first);
+	}
+}
+
+TEST(ThreadPoolTest, ParallelSort)
+{
+	std::mt19937 gen(12345u);
+	std::uniform_int_distribution<uint32> dist(0u, 1000u);
+	for (uint32 nb : {0u, 1u, 1000u, 5000u, 100003u})
+	{
+		std::vector<uint32> v(nb);
+		for (uint32& x : v)
+			x = dist(gen);
+		std::vector<uint32> expected = v;
+		std::sort(expected.begin(), expected.end(), std::greater<uint32>());
+		cgogn::parallel_sort(v, std::greater<uint32>());
+		EXPECT_TRUE(v == expected);
+	}
+}
@@ -0,0 +1,93 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/utils/union_find.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace cgogn::numerics;
+
+TEST(UnionFindTest, Singletons)
+{
+	cgogn::ConcurrentUnionFind uf(10u);
+	EXPECT_EQ(uf.size(), 10u);
+	for (uint32 i = 0u; i < 10u; ++i)
+		EXPECT_EQ(uf.find(i), i);
+	EXPECT_FALSE(uf.same_set(2u, 3u));
+}
+
+TEST(UnionFindTest, RootIsSmallestElement)
+{
+	const uint32 nb = 10000u;
+	cgogn::ConcurrentUnionFind uf(nb);
+
+	// the elements are united with the other elements of the same residue modulo 7, in parallel
+	cgogn::parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (i >= 7u)
+				uf.unite(i, i - 7u);
+		}
+	});
+
+	for (uint32 i = 0u; i < nb; ++i)
+		EXPECT_EQ(uf.find(i), i % 7u);
+	EXPECT_TRUE(uf.same_set(3u, 9999u));
+	EXPECT_FALSE(uf.same_set(3u, 9998u));
+
+	uf.reset(nb);
+	EXPECT_EQ(uf.find(9999u), 9999u);
+}
+
+TEST(UnionFindTest, SameSetsAsSerialLabels)
+{
+	const uint32 nb = 2000u;
+	std::mt19937 gen(42u);
+	std::uniform_int_distribution<uint32> dist(0u, nb - 1u);
+
+	cgogn::ConcurrentUnionFind uf(nb);
+	std::vector<uint32> label(nb);
+	for (uint32 i = 0u; i < nb; ++i)
+		label[i] = i;
+
+	for (uint32 k = 0u; k < 1500u; ++k)
+	{
+		const uint32 a = dist(gen);
+		const uint32 b = dist(gen);
+		uf.unite(a, b);
+		const uint32 la = label[a];
+		const uint32 lb = label[b];
+		for (uint32& l : label)
+			if (l == lb)
+				l = la;
+	}
+
+	for (uint32 k = 0u; k < 1000u; ++k)
+	{
+		const uint32 a = dist(gen);
+		const uint32 b = dist(gen);
+		EXPECT_EQ(uf.same_set(a, b), label[a] == label[b]);
+	}
+}
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_MORTON_CODE_H_
+#define CGOGN_CORE_UTILS_MORTON_CODE_H_
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief Morton code (Z-order) of a point of the grid [0, 2^21)^3: interleaving of the bits of its coordinates
+ */
+inline uint64 morton_code(uint32 x, uint32 y, uint32 z)
+{
+	auto spread = [] (uint64 v) -> uint64
+	{
+		v &= 0x1fffff;
+		v = (v | v << 32) & 0x1f00000000ffff;
+		v = (v | v << 16) & 0x1f0000ff0000ff;
+		v = (v | v << 8) & 0x100f00f00f00f00f;
+		v = (v | v << 4) & 0x10c30c30c30c30c3;
+		v = (v | v << 2) & 0x1249249249249249;
+		return v;
+	};
+	return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+}
+
+/**
+ * @brief Morton codes of 3D points, quantized in a grid of 2^21 cells per side fitted on their bounding box
+ * (the codes are computed in parallel)
+ */
+template <typename VEC3>
+std::vector<uint64> morton_codes(const std::vector<VEC3>& points)
+{
+	using Scalar = typename std::decay<decltype(points[0][0])>::type;
+	const uint32 nb = uint32(points.size());
+	std::vector<uint64> codes(nb);
+	if (nb == 0u)
+		return codes;
+
+	Scalar min[3] = { points[0][0], points[0][1], points[0][2] };
+	Scalar max[3] = { points[0][0], points[0][1], points[0][2] };
+	for (const VEC3& p : points)
+	{
+		for (uint32 j = 0u; j < 3u; ++j)
+		{
+			min[j] = std::min(min[j], Scalar(p[j]));
+			max[j] = std::max(max[j], Scalar(p[j]));
+		}
+	}
+	Scalar extent(0);
+	for (uint32 j = 0u; j < 3u; ++j)
+		extent = std::max(extent, max[j] - min[j]);
+	const Scalar scale = extent > Scalar(0) ? Scalar((1u << 21u) - 1u) / extent : Scalar(0);
+
+	parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			const VEC3& p = points[i];
+			codes[i] = morton_code(uint32((p[0] - min[0]) * scale), uint32((p[1] - min[1]) * scale), uint32((p[2] - min[2]) * scale));
+		}
+	});
+	return codes;
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_MORTON_CODE_H_
@@ -63,7 +63,9 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <atomic>
 #include <functional>
+#include <algorithm>
 
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/utils/assert.h>
@@ -91,6 +93,15 @@ public:
 		return workers_.size();
 	}
 
+	/**
+	 * number of tasks that may run at the same time. Without worker (single core),
+	 * enqueue executes the tasks in the calling thread, one at a time.
+	 */
+	inline std::size_t nb_concurrent_tasks() const
+	{
+		return std::max(workers_.size(), std::size_t(1u));
+	}
+
 private:
 
 	// need to keep track of threads so we can join them
@@ -117,6 +128,14 @@ auto ThreadPool::enqueue(const F& f, Args&&... args)
 	});
 
 	std::future<return_type> res = task->get_future();
+
+	// no worker (see nb_concurrent_tasks)
+	if (workers_.empty())
+	{
+		(*task)(0u);
+		return res;
+	}
+
 	{
 		std::unique_lock<std::mutex> lock(queue_mutex_);
 			// don't allow enqueueing after stopping the pool
@@ -133,6 +152,133 @@ auto ThreadPool::enqueue(const F& f, Args&&... args)
 	return res;
 }
 
+/**
+ * \brief number of ranges used to process nb elements with parallel_foreach_range
+ * (a few ranges per thread to balance the load, ranges of at least 1024 elements)
+ */
+inline uint32 nb_parallel_ranges(uint32 nb)
+{
+	const uint32 nb_threads_pool = uint32(thread_pool()->nb_threads());
+	return std::max(1u, std::min(4u * (nb_threads_pool + 1u), nb / 1024u));
+}
+
+/**
+ * \brief apply f(range, begin, end) on nb_ranges consecutive ranges of [0, nb) with the thread pool
+ * and wait for the end of all the ranges.
+ * The ranges are picked in order by the calling thread and the workers of the pool. The calling thread
+ * never waits for a range that has not started: if all the workers are busy (e.g. when called from a task
+ * of the pool) it processes all the ranges itself, so that the calls can be nested.
+ */
+template <typename FUNC>
+void parallel_foreach_range(uint32 nb, uint32 nb_ranges, const FUNC& f)
+{
+	if (nb_ranges == 0u)
+		return;
+	if (nb_ranges == 1u)
+	{
+		f(0u, 0u, nb);
+		return;
+	}
+
+	// the state is shared with the enqueued jobs since they may start after the return of this function
+	// (they find no range left and do nothing)
+	struct State
+	{
+		State(uint32 n) : nb_ranges(n), next_range(0u), nb_done(0u) {}
+		const uint32 nb_ranges;
+		std::atomic<uint32> next_range;
+		std::atomic<uint32> nb_done;
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+
+	auto state = std::make_shared<State>(nb_ranges);
+	auto work = [nb, &f] (State& st)
+	{
+		for (uint32 r = st.next_range++; r < st.nb_ranges; r = st.next_range++)
+		{
+			f(r, uint32(uint64(nb) * r / st.nb_ranges), uint32(uint64(nb) * (r + 1u) / st.nb_ranges));
+			if (++st.nb_done == st.nb_ranges)
+			{
+				std::lock_guard<std::mutex> lock(st.mutex);
+				st.done.notify_all();
+			}
+		}
+	};
+
+	ThreadPool* pool = thread_pool();
+	const std::size_t nb_jobs = std::min(std::size_t(nb_ranges - 1u), pool->nb_threads());
+	for (std::size_t j = 0u; j < nb_jobs; ++j)
+		pool->enqueue([state, work] (uint32) { work(*state); });
+	work(*state);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->done.wait(lock, [&state] () { return state->nb_done == state->nb_ranges; });
+}
+
+template <typename FUNC>
+inline void parallel_foreach_range(uint32 nb, const FUNC& f)
+{
+	parallel_foreach_range(nb, nb_parallel_ranges(nb), f);
+}
+
+/**
+ * \brief offsets of compressed sparse row (CSR) arrays of nb rows: the sizes degree(i) of the rows
+ * are computed with parallel_foreach_range, then accumulated in the order of the rows.
+ * The slots of row i are [offsets[i], offsets[i + 1]) and offsets[nb] is the number of slots.
+ */
+template <typename FUNC>
+void parallel_compute_offsets(uint32 nb, const FUNC& degree, std::vector<uint32>& offsets)
+{
+	offsets.assign(nb + 1u, 0u);
+	parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+			offsets[i + 1u] = degree(i);
+	});
+	for (uint32 i = 0u; i < nb; ++i)
+		offsets[i + 1u] += offsets[i];
+}
+
+/**
+ * \brief sort the elements of v with the thread pool: the ranges of parallel_foreach_range are sorted
+ * with std::sort, then merged pairwise (the merges of a same level are done in parallel).
+ * Like parallel_foreach_range, it can be called from a task of the thread pool.
+ */
+template <typename T, typename COMPARE>
+void parallel_sort(std::vector<T>& v, const COMPARE& compare)
+{
+	const uint32 nb = uint32(v.size());
+	const uint32 nb_ranges = nb_parallel_ranges(nb);
+
+	std::vector<uint32> bounds(nb_ranges + 1u);
+	for (uint32 r = 0u; r <= nb_ranges; ++r)
+		bounds[r] = uint32(uint64(nb) * r / nb_ranges);
+
+	parallel_foreach_range(nb, nb_ranges, [&] (uint32, uint32 begin, uint32 end)
+	{
+		std::sort(v.begin() + begin, v.begin() + end, compare);
+	});
+
+	if (nb_ranges == 1u)
+		return;
+
+	std::vector<T> buffer(nb);
+	for (uint32 width = 1u; width < nb_ranges; width *= 2u)
+	{
+		const uint32 nb_merges = (nb_ranges + 2u * width - 1u) / (2u * width);
+		parallel_foreach_range(nb_merges, nb_merges, [&] (uint32 m, uint32, uint32)
+		{
+			const uint32 first = bounds[2u * m * width];
+			const uint32 middle = bounds[std::min(2u * m * width + width, nb_ranges)];
+			const uint32 last = bounds[std::min(2u * m * width + 2u * width, nb_ranges)];
+			std::merge(v.begin() + first, v.begin() + middle, v.begin() + middle, v.begin() + last,
+					   buffer.begin() + first, compare);
+		});
+		v.swap(buffer);
+	}
+}
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_UTILS_THREADPOOL_H_
@@ -0,0 +1,132 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_UNION_FIND_H_
+#define CGOGN_CORE_UTILS_UNION_FIND_H_
+
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+namespace cgogn
+{
+
+/**
+ * Union-find on the indices [0, n) whose unions and finds can be called concurrently (lock-free):
+ * - the roots are linked with compare-and-swap operations, the root of larger index below
+ *   the root of smaller index, so that the root of a set is always its smallest element
+ *   (the result does not depend on the order of the unions),
+ * - find compresses the paths by halving.
+ */
+class ConcurrentUnionFind
+{
+public:
+
+	inline ConcurrentUnionFind(uint32 n = 0u) :
+		size_(0u)
+	{
+		reset(n);
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ConcurrentUnionFind);
+
+	/**
+	 * @brief make n singletons (in parallel)
+	 */
+	void reset(uint32 n)
+	{
+		if (n != size_)
+		{
+			parent_.reset(n > 0u ? new std::atomic<uint32>[n] : nullptr);
+			size_ = n;
+		}
+		parallel_foreach_range(n, [this] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				parent_[i].store(i, std::memory_order_relaxed);
+		});
+	}
+
+	inline uint32 size() const
+	{
+		return size_;
+	}
+
+	inline uint32 find(uint32 x)
+	{
+		for (;;)
+		{
+			uint32 p = parent_[x].load();
+			if (p == x)
+				return x;
+			const uint32 gp = parent_[p].load();
+			if (p != gp)
+				parent_[x].compare_exchange_weak(p, gp);
+			x = gp;
+		}
+	}
+
+	inline void unite(uint32 a, uint32 b)
+	{
+		for (;;)
+		{
+			a = find(a);
+			b = find(b);
+			if (a == b)
+				return;
+			if (a < b)
+				std::swap(a, b);
+			// a is still a root if the exchange succeeds
+			uint32 expected = a;
+			if (parent_[a].compare_exchange_strong(expected, b))
+				return;
+		}
+	}
+
+	inline bool same_set(uint32 a, uint32 b)
+	{
+		for (;;)
+		{
+			a = find(a);
+			b = find(b);
+			if (a == b)
+				return true;
+			// a may have been linked since it was found
+			if (parent_[a].load() == a)
+				return false;
+		}
+	}
+
+private:
+
+	std::unique_ptr<std::atomic<uint32>[]> parent_;
+	uint32 size_;
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_UNION_FIND_H_
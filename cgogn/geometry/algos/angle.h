@@ -39,6 +39,37 @@ namespace cgogn
 namespace geometry
 {
 
+/**
+ * compute and return the angle formed by the normals n1 and n2 of two faces sharing an edge
+ * (signed w.r.t. the normalized edge vector)
+ */
+template <typename VEC3>
+inline typename vector_traits<VEC3>::Scalar angle_between_normals(
+	const VEC3& n1,
+	const VEC3& n2,
+	const VEC3& edge
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	Scalar s = edge.dot(n1.cross(n2));
+	Scalar c = n1.dot(n2);
+	Scalar a(0);
+
+	// the following trick is useful to avoid NaNs (due to floating point errors)
+	if (c > 0.5) a = std::asin(s);
+	else
+	{
+		if(c < -1) c = -1;
+		if (s >= 0) a = std::acos(c);
+		else a = -std::acos(c);
+	}
+	if(a != a)
+		cgogn_log_warning("angle_between_normals") << "NaN computed";
+
+	return a;
+}
+
 /**
  * compute and return the angle formed by the normals of the two faces incident to the given edge
  */
@@ -64,22 +95,7 @@ inline typename vector_traits<VEC3>::Scalar angle_between_face_normals(
 
 	VEC3 edge = position[Vertex2(d2)] - position[Vertex2(d)];
 	edge.normalize();
-	Scalar s = edge.dot(n1.cross(n2));
-	Scalar c = n1.dot(n2);
-	Scalar a(0);
-
-	// the following trick is useful to avoid NaNs (due to floating point errors)
-	if (c > 0.5) a = std::asin(s);
-	else
-	{
-		if(c < -1) c = -1;
-		if (s >= 0) a = std::acos(c);
-		else a = -std::acos(c);
-	}
-	if(a != a)
-		cgogn_log_warning("angle_between_face_normals") << "NaN computed";
-
-	return a;
+	return angle_between_normals<VEC3>(n1, n2, edge);
 }
 
 template <typename VEC3, typename MAP, typename MASK>
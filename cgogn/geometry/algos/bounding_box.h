@@ -24,9 +24,17 @@
 #ifndef CGOGN_GEOMETRY_ALGO_BOUNDING_BOX_H_
 #define CGOGN_GEOMETRY_ALGO_BOUNDING_BOX_H_
 
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/core/cmap/cmap3.h>
+
 #include <cgogn/geometry/types/aabb.h>
 #include <cgogn/geometry/types/obb.h>
-#include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/geometry/functions/symmetric_eigen.h>
 
 namespace cgogn
 {
@@ -104,6 +112,7 @@ void compute_OBB(const ATTR& attr, OBB<array_data_type<ATTR>>& bb)
 
 	// Compute the size of the obb
 	Vec ex;
+	ex.setZero();
 	Vec t;
 	for (const auto& p : attr)
 	{
@@ -126,6 +135,290 @@ void compute_OBB(const ATTR& attr, OBB<array_data_type<ATTR>>& bb)
 	bb.extension(ex);
 }
 
+/**
+ * @brief compute the axis-aligned bounding box of the vertices of the map
+ * The lines of the container of the vertices are split in ranges that are reduced in parallel.
+ */
+template <typename VEC3, typename MAP>
+void parallel_compute_AABB(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	AABB<VEC3>& bb
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename MAP::Vertex;
+
+	const auto& container = map.template const_attribute_container<Vertex::ORBIT>();
+	const uint32 nb = container.end();
+	const uint32 nb_ranges = nb_parallel_ranges(nb);
+
+	std::vector<VEC3> range_min(nb_ranges);
+	std::vector<VEC3> range_max(nb_ranges);
+	parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
+	{
+		VEC3 p_min;
+		VEC3 p_max;
+		for (uint32 k = 0u; k < 3u; ++k)
+		{
+			p_min[k] = std::numeric_limits<Scalar>::max();
+			p_max[k] = std::numeric_limits<Scalar>::lowest();
+		}
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (!container.used(i))
+				continue;
+			const VEC3& p = position[i];
+			for (uint32 k = 0u; k < 3u; ++k)
+			{
+				p_min[k] = std::min(p_min[k], p[k]);
+				p_max[k] = std::max(p_max[k], p[k]);
+			}
+		}
+		range_min[r] = p_min;
+		range_max[r] = p_max;
+	});
+
+	bb.reset();
+	for (uint32 r = 0u; r < nb_ranges; ++r)
+	{
+		// empty ranges keep an inverted box
+		if (range_min[r][0] > range_max[r][0])
+			continue;
+		bb.add_point(range_min[r]);
+		bb.add_point(range_max[r]);
+	}
+}
+
+namespace internal
+{
+
+/**
+ * number of points, mean and sum of the outer products of the centered points of a set of points
+ */
+template <typename VEC3>
+struct PointStatistics
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
+
+	uint32 nb_;
+	VEC3 mean_;
+	Mat3 m2_;
+
+	PointStatistics() :
+		nb_(0u)
+	{
+		mean_.setZero();
+		m2_.setZero();
+	}
+
+	// statistics of the union of the two sets (pairwise update of Chan et al.)
+	void merge(const PointStatistics& s)
+	{
+		if (s.nb_ == 0u)
+			return;
+		if (nb_ == 0u)
+		{
+			*this = s;
+			return;
+		}
+		const Scalar n = Scalar(nb_ + s.nb_);
+		const VEC3 delta = s.mean_ - mean_;
+		mean_ += delta * (Scalar(s.nb_) / n);
+		m2_ += s.m2_ + (delta * delta.transpose()) * (Scalar(nb_) * Scalar(s.nb_) / n);
+		nb_ += s.nb_;
+	}
+};
+
+} // namespace internal
+
+/**
+ * @brief compute the object bounding box of the vertices of the map
+ * The axes are the principal directions of the points (eigenvectors of the covariance matrix).
+ * The covariance is reduced in parallel over ranges of the container of the vertices
+ * (per range mean and centered second moments, merged in the order of the ranges),
+ * then the extents along the axes are reduced in a second parallel pass.
+ * Contrary to compute_OBB, the box is centered on the extents and not on the mean of the points.
+ */
+template <typename VEC3, typename MAP>
+void parallel_compute_OBB(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	OBB<VEC3>& bb
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
+	using Vertex = typename MAP::Vertex;
+	using Statistics = internal::PointStatistics<VEC3>;
+
+	bb.reset();
+
+	const auto& container = map.template const_attribute_container<Vertex::ORBIT>();
+	const uint32 nb = container.end();
+	const uint32 nb_ranges = nb_parallel_ranges(nb);
+
+	std::vector<Statistics> range_statistics(nb_ranges);
+	parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
+	{
+		Statistics& s = range_statistics[r];
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (container.used(i))
+			{
+				s.mean_ += position[i];
+				++s.nb_;
+			}
+		}
+		if (s.nb_ == 0u)
+			return;
+		s.mean_ /= Scalar(s.nb_);
+
+		Scalar xx(0), xy(0), xz(0), yy(0), yz(0), zz(0);
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (!container.used(i))
+				continue;
+			const VEC3 q = position[i] - s.mean_;
+			xx += q[0] * q[0]; xy += q[0] * q[1]; xz += q[0] * q[2];
+			yy += q[1] * q[1]; yz += q[1] * q[2];
+			zz += q[2] * q[2];
+		}
+		s.m2_ << xx, xy, xz,
+				 xy, yy, yz,
+				 xz, yz, zz;
+	});
+
+	Statistics all;
+	for (const Statistics& s : range_statistics)
+		all.merge(s);
+	if (all.nb_ == 0u)
+		return;
+
+	const VEC3 mean = all.mean_;
+	const Mat3 covariance = all.m2_ / Scalar(all.nb_);
+	Eigen::Matrix<Scalar, 3, 1> eigenvalues;
+	Mat3 axes;
+	symmetric_eigen_3x3(covariance, eigenvalues, axes);
+
+	std::vector<VEC3> range_min(nb_ranges);
+	std::vector<VEC3> range_max(nb_ranges);
+	parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
+	{
+		VEC3 t_min;
+		VEC3 t_max;
+		t_min.setConstant(std::numeric_limits<Scalar>::max());
+		t_max.setConstant(std::numeric_limits<Scalar>::lowest());
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (!container.used(i))
+				continue;
+			const VEC3 t = axes.transpose() * (position[i] - mean);
+			t_min = t_min.cwiseMin(t);
+			t_max = t_max.cwiseMax(t);
+		}
+		range_min[r] = t_min;
+		range_max[r] = t_max;
+	});
+
+	VEC3 t_min = range_min[0];
+	VEC3 t_max = range_max[0];
+	for (uint32 r = 1u; r < nb_ranges; ++r)
+	{
+		t_min = t_min.cwiseMin(range_min[r]);
+		t_max = t_max.cwiseMax(range_max[r]);
+	}
+
+	bb.axis(axes);
+	bb.center(mean + axes * ((t_min + t_max) * Scalar(0.5)));
+	bb.extension((t_max - t_min) * Scalar(0.5));
+}
+
+/**
+ * @brief compute the axis-aligned bounding box of each cell of the map (e.g. per volume)
+ * The vertices of a cell are reached through its darts (the min/max are insensitive to repetitions),
+ * so no marker is needed. The cells are processed in parallel.
+ */
+template <typename VEC3, typename CellType, typename MAP, typename MASK>
+void parallel_compute_cell_AABB(
+	const MAP& map,
+	const MASK& mask,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	typename MAP::template Attribute<VEC3, CellType::ORBIT>& bb_min,
+	typename MAP::template Attribute<VEC3, CellType::ORBIT>& bb_max
+)
+{
+	using Vertex = typename MAP::Vertex;
+
+	map.parallel_foreach_cell([&] (CellType c, uint32)
+	{
+		VEC3 p_min = position[Vertex(c.dart)];
+		VEC3 p_max = p_min;
+		map.foreach_dart_of_orbit(c, [&] (Dart d)
+		{
+			const VEC3& p = position[Vertex(d)];
+			for (uint32 k = 0u; k < 3u; ++k)
+			{
+				p_min[k] = std::min(p_min[k], p[k]);
+				p_max[k] = std::max(p_max[k], p[k]);
+			}
+		});
+		bb_min[c] = p_min;
+		bb_max[c] = p_max;
+	},
+	mask);
+}
+
+template <typename VEC3, typename CellType, typename MAP>
+void parallel_compute_cell_AABB(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	typename MAP::template Attribute<VEC3, CellType::ORBIT>& bb_min,
+	typename MAP::template Attribute<VEC3, CellType::ORBIT>& bb_max
+)
+{
+	parallel_compute_cell_AABB<VEC3, CellType>(map, CellFilters(), position, bb_min, bb_max);
+}
+
+/**
+ * @brief compute the axis-aligned bounding box of each connected component of the map
+ * The connected components are not embedded: they are gathered in components
+ * and their boxes are stored in boxes (in the same order).
+ * The components are distributed over the threads of the pool, each component being processed by one task.
+ */
+template <typename VEC3, typename MAP>
+void parallel_compute_component_AABB(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	std::vector<typename MAP::ConnectedComponent>& components,
+	std::vector<AABB<VEC3>>& boxes
+)
+{
+	using Vertex = typename MAP::Vertex;
+	using ConnectedComponent = typename MAP::ConnectedComponent;
+
+	components.clear();
+	map.foreach_cell([&] (ConnectedComponent cc) { components.push_back(cc); });
+
+	const uint32 nb = uint32(components.size());
+	boxes.clear();
+	boxes.resize(nb);
+	// the ranges are sized on the number of darts traversed, not on the number of components
+	const uint32 nb_ranges = std::min(nb, nb_parallel_ranges(map.nb_darts()));
+	parallel_foreach_range(nb, nb_ranges, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			AABB<VEC3>& bb = boxes[i];
+			map.foreach_dart_of_orbit(components[i], [&] (Dart d)
+			{
+				bb.add_point(position[Vertex(d)]);
+			});
+		}
+	});
+}
+
 } // namespace geometry
 
 } // namespace cgogn
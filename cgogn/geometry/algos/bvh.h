@@ -0,0 +1,663 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_BVH_H_
+#define CGOGN_GEOMETRY_ALGOS_BVH_H_
+
+#include <vector>
+#include <array>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/geometry/functions/intersection.h>
+#include <cgogn/geometry/functions/distance.h>
+#include <cgogn/geometry/algos/ear_triangulation.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * Bounding Volume Hierarchy over the faces of a map.
+ * Faces are triangulated once (ear triangulation for non triangular faces) and the tree
+ * is built over the triangles with a binned SAH. The top of the tree is split sequentially,
+ * then the subtrees are built in parallel by the thread pool. Under MAX_DEPTH the nodes are split
+ * at the median of their centroids, which bounds the depth of the tree (and the traversal stacks).
+ * The topology of the map must not change while the BVH is used, but the positions can:
+ * refit() updates the boxes of the tree without rebuilding it.
+ */
+template <typename VEC3, typename MAP>
+class BVH
+{
+public:
+
+	using Self = BVH<VEC3, MAP>;
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+	using VertexAttribute = typename MAP::template VertexAttribute<VEC3>;
+
+	static const uint32 MAX_LEAF_SIZE = 4u;
+	static const uint32 NB_BINS = 16u;
+	static const uint32 MAX_DEPTH = 32u; // from this depth on, the nodes are split at the median
+	static const uint32 STACK_SIZE = 64u; // MAX_DEPTH + log2 of the max number of triangles
+
+private:
+
+	struct Triangle
+	{
+		Face face_;
+		std::array<uint32, 3> vertices_; // embeddings of the vertices
+	};
+
+	struct Box
+	{
+		VEC3 min_;
+		VEC3 max_;
+
+		inline void reset()
+		{
+			for (uint32 i = 0u; i < 3u; ++i)
+			{
+				min_[i] = std::numeric_limits<Scalar>::max();
+				max_[i] = std::numeric_limits<Scalar>::lowest();
+			}
+		}
+
+		inline void add_point(const VEC3& p)
+		{
+			for (uint32 i = 0u; i < 3u; ++i)
+			{
+				min_[i] = std::min(min_[i], p[i]);
+				max_[i] = std::max(max_[i], p[i]);
+			}
+		}
+
+		inline void fusion(const Box& b)
+		{
+			for (uint32 i = 0u; i < 3u; ++i)
+			{
+				min_[i] = std::min(min_[i], b.min_[i]);
+				max_[i] = std::max(max_[i], b.max_[i]);
+			}
+		}
+
+		inline Scalar half_area() const
+		{
+			if (min_[0] > max_[0])
+				return Scalar(0);
+			const Scalar dx = max_[0] - min_[0];
+			const Scalar dy = max_[1] - min_[1];
+			const Scalar dz = max_[2] - min_[2];
+			return dx * dy + dy * dz + dz * dx;
+		}
+
+		// entry distance of the ray (P, inv_dir) in the box if lower than t_max, infinity otherwise
+		inline Scalar ray_entry(const VEC3& P, const VEC3& inv_dir, Scalar t_max) const
+		{
+			Scalar t_min = Scalar(0);
+			for (uint32 i = 0u; i < 3u; ++i)
+			{
+				Scalar t0 = (min_[i] - P[i]) * inv_dir[i];
+				Scalar t1 = (max_[i] - P[i]) * inv_dir[i];
+				if (t0 > t1)
+					std::swap(t0, t1);
+				// NaN (0 * infinity) are ignored by these comparisons
+				if (t0 > t_min)
+					t_min = t0;
+				if (t1 < t_max)
+					t_max = t1;
+			}
+			return t_min <= t_max ? t_min : std::numeric_limits<Scalar>::infinity();
+		}
+
+		inline Scalar squared_distance(const VEC3& P) const
+		{
+			Scalar d2 = Scalar(0);
+			for (uint32 i = 0u; i < 3u; ++i)
+			{
+				const Scalar d = std::max(std::max(min_[i] - P[i], P[i] - max_[i]), Scalar(0));
+				d2 += d * d;
+			}
+			return d2;
+		}
+	};
+
+	// internal nodes have nb_ = 0 and their children at first_ and first_ + 1
+	// leaves contain the triangles [first_, first_ + nb_)
+	struct Node
+	{
+		Box box_;
+		uint32 first_;
+		uint32 nb_;
+	};
+
+	const MAP& map_;
+	VertexAttribute position_;
+
+	std::vector<Triangle> triangles_;
+	std::vector<Node> nodes_;
+
+public:
+
+	BVH(const MAP& map, const VertexAttribute& position) :
+		map_(map),
+		position_(position)
+	{
+		build();
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(BVH);
+
+	inline const MAP& map() const { return map_; }
+	inline const VertexAttribute& position() const { return position_; }
+	inline uint32 nb_nodes() const { return uint32(nodes_.size()); }
+	inline uint32 nb_triangles() const { return uint32(triangles_.size()); }
+
+	/**
+	 * @brief (re)build the tree from the current faces of the map
+	 */
+	void build()
+	{
+		triangles_.clear();
+		nodes_.clear();
+
+		std::vector<Face> faces;
+		faces.reserve(map_.template nb_cells<Face::ORBIT>());
+		map_.foreach_cell([&] (Face f) { faces.push_back(f); });
+
+		// triangulation of the faces
+		const uint32 nb_faces = uint32(faces.size());
+		const uint32 nb_face_ranges = nb_parallel_ranges(nb_faces);
+		std::vector<std::vector<Triangle>> range_triangles(nb_face_ranges);
+		parallel_foreach_range(nb_faces, nb_face_ranges, [&] (uint32 c, uint32 begin, uint32 end)
+		{
+			std::vector<Triangle>& triangles = range_triangles[c];
+			triangles.reserve(end - begin);
+			std::vector<uint32> ear_indices;
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const Face f = faces[i];
+				if (map_.codegree(f) == 3u)
+				{
+					const Dart d = f.dart;
+					triangles.push_back({f, {{
+						map_.embedding(Vertex(d)),
+						map_.embedding(Vertex(map_.phi1(d))),
+						map_.embedding(Vertex(map_.phi1(map_.phi1(d))))
+					}}});
+				}
+				else
+				{
+					ear_indices.clear();
+					append_ear_triangulation<VEC3>(map_, f, position_, ear_indices);
+					for (std::size_t j = 0u; j + 2u < ear_indices.size(); j += 3u)
+						triangles.push_back({f, {{ear_indices[j], ear_indices[j+1u], ear_indices[j+2u]}}});
+				}
+			}
+		});
+
+		std::vector<Triangle> triangles;
+		std::size_t nb_triangles = 0u;
+		for (const auto& t : range_triangles)
+			nb_triangles += t.size();
+		triangles.reserve(nb_triangles);
+		for (const auto& t : range_triangles)
+			triangles.insert(triangles.end(), t.begin(), t.end());
+
+		const uint32 nb = uint32(triangles.size());
+		if (nb == 0u)
+			return;
+
+		// boxes and centroids of the triangles
+		BuildData data;
+		data.boxes_.resize(nb);
+		data.centroids_.resize(nb);
+		data.indices_.resize(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				data.boxes_[i] = triangle_box(triangles[i]);
+				data.centroids_[i] = (data.boxes_[i].min_ + data.boxes_[i].max_) * Scalar(0.5);
+				data.indices_[i] = i;
+			}
+		});
+
+		Node root;
+		root.box_.reset();
+		for (const Box& b : data.boxes_)
+			root.box_.fusion(b);
+		root.first_ = 0u;
+		root.nb_ = nb;
+
+		nodes_.reserve(2u * (nb / MAX_LEAF_SIZE) + 1u);
+		nodes_.push_back(root);
+
+		// the top of the tree is split sequentially, the nodes under the threshold are deferred
+		const std::size_t nb_workers = thread_pool()->nb_threads();
+		const uint32 threshold = nb_workers == 0u ? 0u : std::max(nb / uint32(4u * (nb_workers + 1u)), 4096u);
+		std::vector<std::pair<uint32, uint32>> subtrees; // (node, depth)
+		subdivide(nodes_, 0u, 0u, data, threshold, subtrees);
+
+		if (!subtrees.empty())
+		{
+			// each subtree is built in its own array of nodes (with its root at index 0) ..
+			std::vector<std::vector<Node>> subtree_nodes(subtrees.size());
+			parallel_foreach_range(uint32(subtrees.size()), uint32(subtrees.size()), [&] (uint32 c, uint32, uint32)
+			{
+				std::vector<Node>& nodes = subtree_nodes[c];
+				nodes.push_back(nodes_[subtrees[c].first]);
+				std::vector<std::pair<uint32, uint32>> none;
+				subdivide(nodes, 0u, subtrees[c].second, data, 0u, none);
+			});
+
+			// .. then appended to the tree
+			for (uint32 s = 0u; s < uint32(subtrees.size()); ++s)
+			{
+				const std::vector<Node>& nodes = subtree_nodes[s];
+				const uint32 offset = uint32(nodes_.size()) - 1u; // local index k > 0 is stored at offset + k
+				Node root_node = nodes[0u];
+				if (root_node.nb_ == 0u)
+					root_node.first_ += offset;
+				nodes_[subtrees[s].first] = root_node;
+				for (uint32 k = 1u; k < uint32(nodes.size()); ++k)
+				{
+					Node n = nodes[k];
+					if (n.nb_ == 0u)
+						n.first_ += offset;
+					nodes_.push_back(n);
+				}
+			}
+		}
+
+		triangles_.resize(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			triangles_[i] = triangles[data.indices_[i]];
+	}
+
+	/**
+	 * @brief update the boxes of the tree after a modification of the positions
+	 */
+	void refit()
+	{
+		const uint32 nb = uint32(nodes_.size());
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				Node& n = nodes_[i];
+				if (n.nb_ > 0u)
+				{
+					n.box_.reset();
+					for (uint32 t = n.first_; t < n.first_ + n.nb_; ++t)
+						n.box_.fusion(triangle_box(triangles_[t]));
+				}
+			}
+		});
+
+		// children are always stored after their parent
+		for (uint32 i = nb; i-- > 0u; )
+		{
+			Node& n = nodes_[i];
+			if (n.nb_ == 0u)
+			{
+				n.box_ = nodes_[n.first_].box_;
+				n.box_.fusion(nodes_[n.first_ + 1u].box_);
+			}
+		}
+	}
+
+	/**
+	 * @brief find the first face hit by a ray
+	 * @param A origin of the ray
+	 * @param dir direction of the ray
+	 * @param f the face hit
+	 * @param inter the intersection point
+	 * @return true if the ray hits a face
+	 */
+	bool intersect(const VEC3& A, const VEC3& dir, Face& f, VEC3& inter) const
+	{
+		Scalar best = std::numeric_limits<Scalar>::infinity();
+		traverse_ray(A, dir, [&] (const Triangle& t, const VEC3& I, Scalar dist) -> Scalar
+		{
+			if (dist < best)
+			{
+				best = dist;
+				f = t.face_;
+				inter = I;
+			}
+			return best;
+		});
+		return best < std::numeric_limits<Scalar>::infinity();
+	}
+
+	/**
+	 * @brief find all the faces hit by a ray
+	 * @param A origin of the ray
+	 * @param dir direction of the ray
+	 * @param selected (face, intersection point, squared distance to A) sorted by distance to A
+	 */
+	void intersect_all(const VEC3& A, const VEC3& dir, std::vector<std::tuple<Face, VEC3, Scalar>>& selected) const
+	{
+		selected.clear();
+		traverse_ray(A, dir, [&] (const Triangle& t, const VEC3& I, Scalar) -> Scalar
+		{
+			selected.push_back(std::make_tuple(t.face_, I, (I - A).squaredNorm()));
+			return std::numeric_limits<Scalar>::infinity();
+		});
+
+		// the triangles of a same face may all be hit: only the closest hit is kept
+		std::sort(selected.begin(), selected.end(), [] (const std::tuple<Face, VEC3, Scalar>& a, const std::tuple<Face, VEC3, Scalar>& b)
+		{
+			return std::get<0>(a).dart.index < std::get<0>(b).dart.index ||
+				(std::get<0>(a).dart.index == std::get<0>(b).dart.index && std::get<2>(a) < std::get<2>(b));
+		});
+		selected.erase(std::unique(selected.begin(), selected.end(), [] (const std::tuple<Face, VEC3, Scalar>& a, const std::tuple<Face, VEC3, Scalar>& b)
+		{
+			return std::get<0>(a).dart == std::get<0>(b).dart;
+		}), selected.end());
+		std::sort(selected.begin(), selected.end(), [] (const std::tuple<Face, VEC3, Scalar>& a, const std::tuple<Face, VEC3, Scalar>& b)
+		{
+			return std::get<2>(a) < std::get<2>(b);
+		});
+	}
+
+	/**
+	 * @brief find the point of the surface that is the closest to a given point
+	 * @param P the point
+	 * @param f the face that contains the closest point
+	 * @param closest the closest point
+	 * @return the squared distance between P and closest (infinity if the map has no face)
+	 */
+	Scalar closest_point(const VEC3& P, Face& f, VEC3& closest) const
+	{
+		Scalar best = std::numeric_limits<Scalar>::infinity();
+		if (nodes_.empty())
+			return best;
+
+		std::array<uint32, STACK_SIZE> stack;
+		uint32 stack_size = 0u;
+		stack[stack_size++] = 0u;
+		while (stack_size > 0u)
+		{
+			const Node& n = nodes_[stack[--stack_size]];
+			if (n.box_.squared_distance(P) >= best)
+				continue;
+
+			if (n.nb_ > 0u)
+			{
+				for (uint32 i = n.first_; i < n.first_ + n.nb_; ++i)
+				{
+					const Triangle& t = triangles_[i];
+					const VEC3 Q = closest_point_in_triangle(P, position_[t.vertices_[0]], position_[t.vertices_[1]], position_[t.vertices_[2]]);
+					const Scalar d2 = (Q - P).squaredNorm();
+					if (d2 < best)
+					{
+						best = d2;
+						f = t.face_;
+						closest = Q;
+					}
+				}
+			}
+			else
+			{
+				// the closest child is visited first
+				uint32 near = n.first_;
+				uint32 far = n.first_ + 1u;
+				if (nodes_[far].box_.squared_distance(P) < nodes_[near].box_.squared_distance(P))
+					std::swap(near, far);
+				cgogn_message_assert(stack_size + 2u <= STACK_SIZE, "BVH::closest_point: traversal stack overflow");
+				stack[stack_size++] = far;
+				stack[stack_size++] = near;
+			}
+		}
+
+		return best;
+	}
+
+private:
+
+	struct BuildData
+	{
+		std::vector<Box> boxes_;
+		std::vector<VEC3> centroids_;
+		std::vector<uint32> indices_;
+	};
+
+	inline Box triangle_box(const Triangle& t) const
+	{
+		Box b;
+		b.min_ = position_[t.vertices_[0]];
+		b.max_ = b.min_;
+		b.add_point(position_[t.vertices_[1]]);
+		b.add_point(position_[t.vertices_[2]]);
+		return b;
+	}
+
+	/**
+	 * @brief split recursively nodes[node_id] (at depth node_depth) with a binned SAH
+	 * the nodes whose number of triangles is under threshold are not split but pushed in deferred with their depth
+	 */
+	static void subdivide(std::vector<Node>& nodes, uint32 node_id, uint32 node_depth, BuildData& data, uint32 threshold, std::vector<std::pair<uint32, uint32>>& deferred)
+	{
+		std::vector<std::pair<uint32, uint32>> stack;
+		stack.push_back(std::make_pair(node_id, node_depth));
+
+		while (!stack.empty())
+		{
+			const uint32 current = stack.back().first;
+			const uint32 depth = stack.back().second;
+			stack.pop_back();
+			const Node n = nodes[current];
+
+			if (n.nb_ <= MAX_LEAF_SIZE)
+				continue;
+			if (n.nb_ < threshold)
+			{
+				deferred.push_back(std::make_pair(current, depth));
+				continue;
+			}
+
+			const uint32 begin = n.first_;
+			const uint32 end = n.first_ + n.nb_;
+
+			Box centroid_box;
+			centroid_box.reset();
+			for (uint32 i = begin; i < end; ++i)
+				centroid_box.add_point(data.centroids_[data.indices_[i]]);
+
+			// best split among the bins of the 3 axis
+			Scalar best_cost = std::numeric_limits<Scalar>::max();
+			uint32 best_axis = 0u;
+			uint32 best_split = 0u;
+			Box best_left, best_right;
+			for (uint32 axis = 0u; axis < 3u && depth < MAX_DEPTH; ++axis)
+			{
+				const Scalar extent = centroid_box.max_[axis] - centroid_box.min_[axis];
+				if (!(extent > Scalar(0)))
+					continue;
+				const Scalar scale = Scalar(NB_BINS) / extent;
+
+				std::array<Box, NB_BINS> bin_boxes;
+				std::array<uint32, NB_BINS> bin_counts;
+				for (uint32 b = 0u; b < NB_BINS; ++b)
+				{
+					bin_boxes[b].reset();
+					bin_counts[b] = 0u;
+				}
+				for (uint32 i = begin; i < end; ++i)
+				{
+					const uint32 t = data.indices_[i];
+					const uint32 b = bin_index(data.centroids_[t][axis], centroid_box.min_[axis], scale);
+					bin_boxes[b].fusion(data.boxes_[t]);
+					++bin_counts[b];
+				}
+
+				// right to left sweep then left to right sweep
+				std::array<Box, NB_BINS> right_boxes;
+				std::array<uint32, NB_BINS> right_counts;
+				Box acc;
+				acc.reset();
+				uint32 count = 0u;
+				for (uint32 b = NB_BINS - 1u; b > 0u; --b)
+				{
+					acc.fusion(bin_boxes[b]);
+					count += bin_counts[b];
+					right_boxes[b] = acc;
+					right_counts[b] = count;
+				}
+				acc.reset();
+				count = 0u;
+				for (uint32 b = 1u; b < NB_BINS; ++b)
+				{
+					acc.fusion(bin_boxes[b - 1u]);
+					count += bin_counts[b - 1u];
+					if (count == 0u || right_counts[b] == 0u)
+						continue;
+					const Scalar cost = acc.half_area() * count + right_boxes[b].half_area() * right_counts[b];
+					if (cost < best_cost)
+					{
+						best_cost = cost;
+						best_axis = axis;
+						best_split = b;
+						best_left = acc;
+						best_right = right_boxes[b];
+					}
+				}
+			}
+
+			uint32 middle;
+			if (best_split > 0u)
+			{
+				const Scalar extent = centroid_box.max_[best_axis] - centroid_box.min_[best_axis];
+				const Scalar scale = Scalar(NB_BINS) / extent;
+				const Scalar cmin = centroid_box.min_[best_axis];
+				middle = uint32(std::partition(data.indices_.begin() + begin, data.indices_.begin() + end, [&] (uint32 t)
+				{
+					return bin_index(data.centroids_[t][best_axis], cmin, scale) < best_split;
+				}) - data.indices_.begin());
+			}
+			else
+			{
+				// too deep or all the centroids at the same place: median split along the largest extent
+				middle = begin + n.nb_ / 2u;
+				uint32 axis = 0u;
+				for (uint32 i = 1u; i < 3u; ++i)
+					if (centroid_box.max_[i] - centroid_box.min_[i] > centroid_box.max_[axis] - centroid_box.min_[axis])
+						axis = i;
+				std::nth_element(data.indices_.begin() + begin, data.indices_.begin() + middle, data.indices_.begin() + end, [&] (uint32 a, uint32 b)
+				{
+					return data.centroids_[a][axis] < data.centroids_[b][axis];
+				});
+				best_left.reset();
+				for (uint32 i = begin; i < middle; ++i)
+					best_left.fusion(data.boxes_[data.indices_[i]]);
+				best_right.reset();
+				for (uint32 i = middle; i < end; ++i)
+					best_right.fusion(data.boxes_[data.indices_[i]]);
+			}
+
+			const uint32 left = uint32(nodes.size());
+			nodes[current].first_ = left;
+			nodes[current].nb_ = 0u;
+			nodes.push_back({best_left, begin, middle - begin});
+			nodes.push_back({best_right, middle, end - middle});
+			stack.push_back(std::make_pair(left + 1u, depth + 1u));
+			stack.push_back(std::make_pair(left, depth + 1u));
+		}
+	}
+
+	static inline uint32 bin_index(Scalar c, Scalar cmin, Scalar scale)
+	{
+		return std::min(uint32((c - cmin) * scale), NB_BINS - 1u);
+	}
+
+	template <typename FUNC>
+	void traverse_ray(const VEC3& A, const VEC3& dir, const FUNC& hit) const
+	{
+		if (nodes_.empty())
+			return;
+
+		VEC3 inv_dir;
+		for (uint32 i = 0u; i < 3u; ++i)
+			inv_dir[i] = Scalar(1) / dir[i];
+		// the boxes are pruned with the ray parameter t (I = A + t.dir), not with the distance to A
+		const Scalar inv_sq_norm = Scalar(1) / dir.squaredNorm();
+
+		Scalar best = std::numeric_limits<Scalar>::infinity();
+		std::array<uint32, STACK_SIZE> stack;
+		uint32 stack_size = 0u;
+		stack[stack_size++] = 0u;
+		while (stack_size > 0u)
+		{
+			const Node& n = nodes_[stack[--stack_size]];
+			if (n.box_.ray_entry(A, inv_dir, best) == std::numeric_limits<Scalar>::infinity())
+				continue;
+
+			if (n.nb_ > 0u)
+			{
+				VEC3 I;
+				for (uint32 i = n.first_; i < n.first_ + n.nb_; ++i)
+				{
+					const Triangle& t = triangles_[i];
+					if (intersection_ray_triangle<VEC3>(A, dir, position_[t.vertices_[0]], position_[t.vertices_[1]], position_[t.vertices_[2]], &I))
+						best = hit(t, I, (I - A).dot(dir) * inv_sq_norm);
+				}
+			}
+			else
+			{
+				// the closest child is visited first
+				uint32 near = n.first_;
+				uint32 far = n.first_ + 1u;
+				if (nodes_[far].box_.ray_entry(A, inv_dir, best) < nodes_[near].box_.ray_entry(A, inv_dir, best))
+					std::swap(near, far);
+				cgogn_message_assert(stack_size + 2u <= STACK_SIZE, "BVH::traverse_ray: traversal stack overflow");
+				stack[stack_size++] = far;
+				stack[stack_size++] = near;
+			}
+		}
+	}
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_BVH_CPP_))
+extern template CGOGN_GEOMETRY_API class BVH<Eigen::Vector3f, CMap2<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class BVH<Eigen::Vector3d, CMap2<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class BVH<Eigen::Vector3f, CMap3<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class BVH<Eigen::Vector3d, CMap3<DefaultMapTraits>>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_BVH_CPP_))
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_BVH_H_
@@ -28,6 +28,7 @@
 #include <cgogn/geometry/algos/selection.h>
 #include <cgogn/geometry/algos/length.h>
 #include <cgogn/geometry/functions/intersection.h>
+#include <cgogn/geometry/functions/symmetric_eigen.h>
 #include <cgogn/core/utils/masks.h>
 
 namespace cgogn
@@ -36,15 +37,17 @@ namespace cgogn
 namespace geometry
 {
 
+namespace internal
+{
+
+/**
+ * @brief set the curvature attributes of v from its normal cycle tensor
+ */
 template <typename VEC3, typename MAP>
-void curvature(
-	const MAP& map,
+void curvature_from_tensor(
 	const Cell<Orbit::PHI21> v,
-	typename vector_traits<VEC3>::Scalar radius,
-	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+	Eigen::Matrix3d tensor,
 	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
-	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
-	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_area,
 	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
 	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
 	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
@@ -53,38 +56,6 @@ void curvature(
 )
 {
 	using Scalar = typename vector_traits<VEC3>::Scalar;
-	using Vertex2 = Cell<Orbit::PHI21>;
-	using Edge2 = Cell<Orbit::PHI2>;
-	using Face = typename MAP::Face;
-
-	// collect the normal cycle tensor
-	geometry::Collector_WithinSphere<VEC3, MAP> neighborhood(map, radius, position);
-	neighborhood.collect(v);
-
-	Eigen::Matrix3d tensor;
-	tensor.setZero();
-
-	neighborhood.foreach_cell([&] (Edge2 e)
-	{
-		std::pair<Vertex2, Vertex2> vv = map.vertices(e);
-		const VEC3& p1 = position[vv.first];
-		const VEC3& p2 = position[vv.second];
-		Eigen::Vector3d ev = Eigen::Vector3d(p2[0], p2[1], p2[2]) - Eigen::Vector3d(p1[0], p1[1], p1[2]);
-		tensor += (ev * ev.transpose()) * edge_angle[e] * (Scalar(1) / ev.norm());
-	});
-
-	neighborhood.foreach_border([&] (Dart d)
-	{
-		std::pair<Vertex2, Vertex2> vv = map.vertices(Edge2(d));
-		const VEC3& p1 = position[vv.first];
-		const VEC3& p2 = position[vv.second];
-		Eigen::Vector3d ev = Eigen::Vector3d(p2[0], p2[1], p2[2]) - Eigen::Vector3d(p1[0], p1[1], p1[2]);
-		Scalar alpha;
-		geometry::intersection_sphere_segment<VEC3>(position[v], radius, position[Vertex2(d)], position[Vertex2(map.phi1(d))], alpha);
-		tensor += (ev * ev.transpose()) * edge_angle[Edge2(d)] * (Scalar(1) / ev.norm()) * alpha;
-	});
-
-	tensor /= neighborhood.area(position);
 
 	const VEC3& normal_v = normal[v];
 	Eigen::Vector3d e_normal_v(normal_v[0], normal_v[1], normal_v[2]);
@@ -96,9 +67,9 @@ void curvature(
 	tensor = proj * tensor * proj;
 
 	// solve eigen problem
-	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(tensor);
-	const Eigen::Vector3d& ev = solver.eigenvalues();
-	const Eigen::Matrix3d& evec = solver.eigenvectors();
+	Eigen::Vector3d ev;
+	Eigen::Matrix3d evec;
+	symmetric_eigen_3x3(tensor, ev, evec);
 
 	// sort eigen components : ev[inormal] has minimal absolute value ; kmin = ev[imin] <= ev[imax] = kmax
 	uint32 inormal = 0, imin, imax;
@@ -134,6 +105,227 @@ void curvature(
 	Kmax_v[2] = evec(2, imin);
 }
 
+/**
+ * @brief reusable computation of the normal cycle tensor in a sphere around vertices
+ * The vertices within the sphere are marked by embedding in a SparseIndexSet and the
+ * collected cells are not stored : the tensor and the area are accumulated during the traversal.
+ * One instance per thread.
+ */
+template <typename VEC3, typename MAP>
+class CurvatureNeighborhood
+{
+public:
+
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex2 = Cell<Orbit::PHI21>;
+	using Edge2 = Cell<Orbit::PHI2>;
+	using Face = typename MAP::Face;
+
+	CurvatureNeighborhood(
+		const MAP& map,
+		Scalar radius,
+		const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+		const typename MAP::template Attribute<Scalar, Orbit::PHI2>& edge_angle
+	) :
+		map_(map),
+		radius_(radius),
+		position_(position),
+		edge_angle_(edge_angle)
+	{
+		queue_.reserve(64u);
+	}
+
+	/**
+	 * @brief normal cycle tensor of the edges within the sphere centered on v, divided by the area within the sphere
+	 * (same neighborhood and weights as Collector_WithinSphere in curvature())
+	 */
+	Eigen::Matrix3d tensor(Vertex2 v)
+	{
+		const VEC3& center = position_[v];
+
+		Eigen::Matrix3d tensor;
+		tensor.setZero();
+		Scalar area = 0;
+
+		visited_.clear();
+		queue_.clear();
+		visited_.insert(map_.embedding(v));
+		queue_.push_back(v.dart);
+
+		for (uint32 i = 0u; i < queue_.size(); ++i)
+		{
+			const Vertex2 u(queue_[i]);
+			const uint32 emb_u = map_.embedding(u);
+			map_.foreach_dart_of_orbit(u, [&] (Dart d)
+			{
+				const Dart d2 = map_.phi2(d);
+				const Vertex2 w(d2);
+				if (in_sphere(position_[w], center, radius_))
+				{
+					const uint32 emb_w = map_.embedding(w);
+					if (visited_.insert(emb_w))
+						queue_.push_back(d2);
+					// each inner edge is counted from its endpoint of smallest embedding
+					if (emb_u < emb_w)
+						add_edge(tensor, d, Scalar(1));
+				}
+				else
+				{
+					const Dart f = map_.phi1(d);
+					const Dart g = map_.phi1(f);
+					Scalar alpha, beta;
+					intersection_sphere_segment<VEC3>(center, radius_, position_[u], position_[Vertex2(f)], alpha);
+					add_edge(tensor, d, alpha);
+					// TODO: the following works only for triangle meshes
+					// (the boundary faces have no area)
+					if (!map_.is_boundary(d))
+					{
+						if (in_sphere(position_[Vertex2(g)], center, radius_))
+						{
+							intersection_sphere_segment<VEC3>(center, radius_, position_[Vertex2(g)], position_[Vertex2(f)], beta);
+							area += (alpha + beta - alpha * beta) * geometry::area<VEC3>(map_, Face(d), position_);
+						}
+						else
+						{
+							intersection_sphere_segment<VEC3>(center, radius_, position_[u], position_[Vertex2(g)], beta);
+							area += alpha * beta * geometry::area<VEC3>(map_, Face(d), position_);
+						}
+					}
+				}
+
+				// each face whose vertices are all in the sphere is counted from its smallest dart
+				bool inner_face = !map_.is_boundary(d);
+				for (Dart fd = map_.phi1(d); fd != d && inner_face; fd = map_.phi1(fd))
+					inner_face = fd.index > d.index && in_sphere(position_[Vertex2(fd)], center, radius_);
+				if (inner_face)
+					area += geometry::area<VEC3>(map_, Face(d), position_);
+			});
+		}
+
+		tensor /= area;
+		return tensor;
+	}
+
+private:
+
+	inline void add_edge(Eigen::Matrix3d& tensor, Dart d, Scalar weight) const
+	{
+		const VEC3& p1 = position_[Vertex2(d)];
+		const VEC3& p2 = position_[Vertex2(map_.phi1(d))];
+		Eigen::Vector3d ev = Eigen::Vector3d(p2[0], p2[1], p2[2]) - Eigen::Vector3d(p1[0], p1[1], p1[2]);
+		tensor += (ev * ev.transpose()) * (edge_angle_[Edge2(d)] * weight / ev.norm());
+	}
+
+	const MAP& map_;
+	Scalar radius_;
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position_;
+	const typename MAP::template Attribute<Scalar, Orbit::PHI2>& edge_angle_;
+
+	SparseIndexSet visited_;
+	std::vector<Dart> queue_;
+};
+
+} // namespace internal
+
+/**
+ * @brief curvature of v, computed from its neighborhood already collected in the given collector
+ */
+template <typename VEC3, typename MAP>
+void curvature_from_neighborhood(
+	const MAP& map,
+	const Cell<Orbit::PHI21> v,
+	const Collector_WithinSphere<VEC3, MAP>& neighborhood,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
+	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex2 = Cell<Orbit::PHI21>;
+	using Edge2 = Cell<Orbit::PHI2>;
+
+	const Scalar radius = neighborhood.radius();
+
+	// collect the normal cycle tensor
+	Eigen::Matrix3d tensor;
+	tensor.setZero();
+
+	neighborhood.foreach_cell([&] (Edge2 e)
+	{
+		std::pair<Vertex2, Vertex2> vv = map.vertices(e);
+		const VEC3& p1 = position[vv.first];
+		const VEC3& p2 = position[vv.second];
+		Eigen::Vector3d ev = Eigen::Vector3d(p2[0], p2[1], p2[2]) - Eigen::Vector3d(p1[0], p1[1], p1[2]);
+		tensor += (ev * ev.transpose()) * edge_angle[e] * (Scalar(1) / ev.norm());
+	});
+
+	neighborhood.foreach_border([&] (Dart d)
+	{
+		std::pair<Vertex2, Vertex2> vv = map.vertices(Edge2(d));
+		const VEC3& p1 = position[vv.first];
+		const VEC3& p2 = position[vv.second];
+		Eigen::Vector3d ev = Eigen::Vector3d(p2[0], p2[1], p2[2]) - Eigen::Vector3d(p1[0], p1[1], p1[2]);
+		Scalar alpha;
+		geometry::intersection_sphere_segment<VEC3>(position[v], radius, position[Vertex2(d)], position[Vertex2(map.phi1(d))], alpha);
+		tensor += (ev * ev.transpose()) * edge_angle[Edge2(d)] * (Scalar(1) / ev.norm()) * alpha;
+	});
+
+	tensor /= neighborhood.area(position);
+
+	internal::curvature_from_tensor<VEC3, MAP>(v, tensor, normal, kmax, kmin, Kmax, Kmin, Knormal);
+}
+
+/**
+ * @brief curvature of v, computed with the given collector (which can be reused from one vertex to the next)
+ */
+template <typename VEC3, typename MAP>
+void curvature(
+	const MAP& map,
+	const Cell<Orbit::PHI21> v,
+	Collector_WithinSphere<VEC3, MAP>& neighborhood,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
+	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
+)
+{
+	neighborhood.collect(v);
+	curvature_from_neighborhood<VEC3>(map, v, neighborhood, position, normal, edge_angle, kmax, kmin, Kmax, Kmin, Knormal);
+}
+
+/**
+ * @brief curvature of the single vertex v (the cost is proportional to the size of its neighborhood)
+ */
+template <typename VEC3, typename MAP>
+void curvature(
+	const MAP& map,
+	const Cell<Orbit::PHI21> v,
+	typename vector_traits<VEC3>::Scalar radius,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
+	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
+	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& /*edge_area*/,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
+)
+{
+	Collector_WithinSphere<VEC3, MAP> neighborhood(map, radius, position);
+	neighborhood.collect_once(v);
+	curvature_from_neighborhood<VEC3>(map, v, neighborhood, position, normal, edge_angle, kmax, kmin, Kmax, Kmin, Knormal);
+}
+
 template <typename VEC3, typename MAP, typename MASK>
 void compute_curvature(
 	const MAP& map,
@@ -142,7 +334,6 @@ void compute_curvature(
 	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
 	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
 	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
-	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_area,
 	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
 	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
 	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
@@ -150,9 +341,10 @@ void compute_curvature(
 	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
 )
 {
-	map.parallel_foreach_cell([&] (Cell<Orbit::PHI21> v, uint32)
+	CollectorPool<Collector_WithinSphere<VEC3, MAP>> collectors(map, radius, position);
+	map.parallel_foreach_cell([&] (Cell<Orbit::PHI21> v, uint32 th)
 	{
-		curvature<VEC3>(map, v, radius, position, normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
+		curvature<VEC3>(map, v, collectors.collector(th), position, normal, edge_angle, kmax, kmin, Kmax, Kmin, Knormal);
 	},
 	mask);
 }
@@ -164,7 +356,6 @@ void compute_curvature(
 	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
 	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
 	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
-	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_area,
 	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
 	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
 	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
@@ -172,7 +363,56 @@ void compute_curvature(
 	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
 )
 {
-	compute_curvature<VEC3>(map, CellFilters(), radius, position, normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
+	compute_curvature<VEC3>(map, CellFilters(), radius, position, normal, edge_angle, kmax, kmin, Kmax, Kmin, Knormal);
+}
+
+/**
+ * @brief same result as compute_curvature, with one reusable neighborhood traversal per thread
+ * (no map-wide marker nor cell lists allocated per vertex)
+ */
+template <typename VEC3, typename MAP, typename MASK>
+void parallel_compute_curvature(
+	const MAP& map,
+	const MASK& mask,
+	typename vector_traits<VEC3>::Scalar radius,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
+	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
+)
+{
+	std::vector<internal::CurvatureNeighborhood<VEC3, MAP>> neighborhoods;
+	neighborhoods.reserve(cgogn::nb_threads());
+	for (uint32 i = 0u; i < cgogn::nb_threads(); ++i)
+		neighborhoods.emplace_back(map, radius, position, edge_angle);
+
+	map.parallel_foreach_cell([&] (Cell<Orbit::PHI21> v, uint32 th)
+	{
+		const Eigen::Matrix3d tensor = neighborhoods[th].tensor(v);
+		internal::curvature_from_tensor<VEC3, MAP>(v, tensor, normal, kmax, kmin, Kmax, Kmin, Knormal);
+	},
+	mask);
+}
+
+template <typename VEC3, typename MAP>
+void parallel_compute_curvature(
+	const MAP& map,
+	typename vector_traits<VEC3>::Scalar radius,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& position,
+	const typename MAP::template Attribute<VEC3, Orbit::PHI21>& normal,
+	const typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmax,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI21>& kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmax,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Kmin,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& Knormal
+)
+{
+	parallel_compute_curvature<VEC3>(map, CellFilters(), radius, position, normal, edge_angle, kmax, kmin, Kmax, Kmin, Knormal);
 }
 
 } // namespace geometry
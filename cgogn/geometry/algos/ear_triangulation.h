@@ -25,17 +25,115 @@
 #define CGOGN_GEOMETRY_ALGOS_EAR_TRIANGULATION_H_
 
 #include <set>
+#include <memory>
+#include <vector>
+#include <unordered_map>
 
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/geometry/algos/normal.h>
 #include <cgogn/geometry/functions/inclusion.h>
 
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/masks.h>
+
 namespace cgogn
 {
 
 namespace geometry
 {
 
+namespace internal
+{
+
+/**
+ * @brief free list of nodes of a fixed size, allocated by blocks and never given back to the system
+ * (used to reuse the nodes of node based containers)
+ */
+class NodePool
+{
+public:
+
+	inline NodePool() : node_size_(0u), free_(nullptr) {}
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(NodePool);
+
+	inline void* allocate(std::size_t size)
+	{
+		if (node_size_ == 0u)
+			node_size_ = std::max(size, sizeof(void*));
+		cgogn_message_assert(size <= node_size_, "NodePool: nodes of different sizes");
+		if (free_ == nullptr)
+		{
+			const std::size_t nb_nodes = 64u;
+			blocks_.emplace_back(new char[nb_nodes * node_size_]);
+			char* block = blocks_.back().get();
+			for (std::size_t i = 0u; i < nb_nodes; ++i)
+				deallocate(block + i * node_size_);
+		}
+		void* node = free_;
+		free_ = *static_cast<void**>(free_);
+		return node;
+	}
+
+	inline void deallocate(void* node)
+	{
+		*static_cast<void**>(node) = free_;
+		free_ = node;
+	}
+
+private:
+
+	std::vector<std::unique_ptr<char[]>> blocks_;
+	std::size_t node_size_;
+	void* free_;
+};
+
+/**
+ * @brief allocator of single objects in a NodePool (other requests are forwarded to std::allocator)
+ */
+template <typename T>
+class NodePoolAllocator
+{
+public:
+
+	using value_type = T;
+
+	template <typename U>
+	struct rebind { using other = NodePoolAllocator<U>; };
+
+	inline NodePoolAllocator(NodePool* pool) : pool_(pool) {}
+
+	template <typename U>
+	inline NodePoolAllocator(const NodePoolAllocator<U>& a) : pool_(a.pool()) {}
+
+	inline T* allocate(std::size_t n)
+	{
+		if (n == 1u)
+			return static_cast<T*>(pool_->allocate(sizeof(T)));
+		return std::allocator<T>().allocate(n);
+	}
+
+	inline void deallocate(T* p, std::size_t n)
+	{
+		if (n == 1u)
+			pool_->deallocate(p);
+		else
+			std::allocator<T>().deallocate(p, n);
+	}
+
+	inline NodePool* pool() const { return pool_; }
+
+	template <typename U>
+	inline bool operator==(const NodePoolAllocator<U>& a) const { return pool_ == a.pool(); }
+	template <typename U>
+	inline bool operator!=(const NodePoolAllocator<U>& a) const { return pool_ != a.pool(); }
+
+private:
+
+	NodePool* pool_;
+};
+
+} // namespace internal
+
 template <typename VEC3, typename MAP>
 class EarTriangulation
 {
@@ -47,7 +145,7 @@ class EarTriangulation
 	{
 	public:
 
-		using VPMS = std::multiset<VertexPoly*, bool(*)(VertexPoly*,VertexPoly*)>;
+		using VPMS = std::multiset<VertexPoly*, bool(*)(VertexPoly*,VertexPoly*), internal::NodePoolAllocator<VertexPoly*>>;
 
 		int32 id;
 		Vertex vert_;
@@ -74,13 +172,31 @@ class EarTriangulation
 			VertexPoly* tmp = vp->prev_;
 			tmp->next_ = vp->next_;
 			vp->next_->prev_ = tmp;
-			delete vp;
 			return tmp;
 		}
 	};
 
 	using VPMS = typename VertexPoly::VPMS;
 
+public:
+
+	/**
+	 * @brief memory reused by the successive triangulations of a thread
+	 * (the polygon and the nodes of the ear set are not allocated for each face)
+	 */
+	class Scratch
+	{
+		friend class EarTriangulation<VEC3, MAP>;
+		std::vector<VertexPoly> polygon_;
+		internal::NodePool ear_nodes_;
+	};
+
+private:
+
+	// memory of the polygon and of the ears
+	std::unique_ptr<Scratch> own_scratch_;
+	Scratch* scratch_;
+
 	// normal to polygon (for orientation of angles)
 	VEC3 normalPoly_;
 
@@ -217,9 +333,34 @@ public:
 	 * @param position attribute of position to use
 	 */
 	EarTriangulation(MAP& map, const typename MAP::Face f, const typename MAP::template VertexAttribute<VEC3>& position) :
+		own_scratch_(new Scratch()),
+		scratch_(own_scratch_.get()),
 		map_(map),
 		positions_(position),
-		ears_(cmp_VP)
+		ears_(cmp_VP, internal::NodePoolAllocator<VertexPoly*>(&scratch_->ear_nodes_))
+	{
+		init(f);
+	}
+
+	/**
+	 * @brief EarTriangulation constructor using the memory of a Scratch
+	 * @param map ref on map
+	 * @param f the face to tringulate
+	 * @param position attribute of position to use
+	 * @param scratch memory to use (must not be used by another EarTriangulation at the same time)
+	 */
+	EarTriangulation(MAP& map, const typename MAP::Face f, const typename MAP::template VertexAttribute<VEC3>& position, Scratch& scratch) :
+		scratch_(&scratch),
+		map_(map),
+		positions_(position),
+		ears_(cmp_VP, internal::NodePoolAllocator<VertexPoly*>(&scratch_->ear_nodes_))
+	{
+		init(f);
+	}
+
+private:
+
+	void init(const typename MAP::Face f)
 	{
 		if (map_.codegree(f) == 3)
 		{
@@ -229,9 +370,13 @@ public:
 		}
 
 		// compute normals for orientation
-		normalPoly_ = normal<VEC3>(map_, Cell<Orbit::PHI1>(f.dart), position);
+		normalPoly_ = normal<VEC3>(map_, Cell<Orbit::PHI1>(f.dart), positions_);
 
 		// first pass create polygon in chained list with angle computation
+		// (the polygon vector is not reallocated during the pass, so that the links remain valid)
+		std::vector<VertexPoly>& polygon = scratch_->polygon_;
+		polygon.clear();
+		polygon.reserve(map_.codegree(f));
 		VertexPoly* vpp = nullptr;
 		VertexPoly* prem = nullptr;
 		nb_verts_ = 0;
@@ -242,12 +387,13 @@ public:
 		Dart c = map_.phi1(b);
 		do
 		{
-			const VEC3& P1 = position[Vertex(a)];
-			const VEC3& P2 = position[Vertex(b)];
-			const VEC3& P3 = position[Vertex(c)];
+			const VEC3& P1 = positions_[Vertex(a)];
+			const VEC3& P2 = positions_[Vertex(b)];
+			const VEC3& P3 = positions_[Vertex(c)];
 
 			Scalar val = ear_angle(P1, P2, P3);
-			VertexPoly* vp = new VertexPoly(Vertex(b), val, Scalar((P3-P1).squaredNorm()), vpp);
+			polygon.emplace_back(Vertex(b), val, Scalar((P3-P1).squaredNorm()), vpp);
+			VertexPoly* vp = &polygon.back();
 
 			if (vp->value_ > 5.0f)  // concav angle
 				convex_ = false;
@@ -287,6 +433,8 @@ public:
 		}
 	}
 
+public:
+
 	/**
 	 * @brief compute table of vertices indices (embeddings) of triangulation
 	 * @param table_indices
@@ -332,10 +480,6 @@ public:
 				table_indices.push_back(map_.embedding(be->vert_));
 				table_indices.push_back(map_.embedding(be->next_->vert_));
 				table_indices.push_back(map_.embedding(be->prev_->vert_));
-				// release memory of last triangle in polygon
-				delete be->next_;
-				delete be->prev_;
-				delete be;
 			}
 		}
 	}
@@ -365,13 +509,6 @@ public:
 				be = VertexPoly::erase(be); 	// and remove ear vertex from polygon
 				recompute_2_ears(be);
 			}
-			else // finish (no need to update ears)
-			{
-				// release memory of last triangle in polygon
-				delete be->next_;
-				delete be->prev_;
-				delete be;
-			}
 		}
 	}
 };
@@ -434,6 +571,245 @@ static void apply_ear_triangulation(
 	});
 }
 
+/**
+ * @brief ear triangulation of the faces of a map reusing its memory from one face to another.
+ * The triangulation of all the faces is computed in parallel and kept in a cache,
+ * in which only the faces whose vertices moved can be recomputed (see invalidate and update).
+ */
+template <typename VEC3, typename MAP>
+class Triangulator
+{
+public:
+
+	using Self = Triangulator<VEC3, MAP>;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+	using EarTri = EarTriangulation<VEC3, const MAP>;
+
+	/**
+	 * @brief Triangulator constructor
+	 * @param map the map (its topology must not change while the cache is used)
+	 * @param position attribute of position to use
+	 */
+	Triangulator(const MAP& map, const typename MAP::template VertexAttribute<VEC3>& position) :
+		map_(map),
+		position_(position)
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(Triangulator);
+
+	/**
+	 * @brief append the triangulation of the face f to table_indices (not thread safe)
+	 */
+	void triangulate(Face f, std::vector<uint32>& table_indices)
+	{
+		if (scratches_.empty())
+			scratches_.emplace_back(new RangeScratch());
+		triangulate(f, *scratches_[0], table_indices);
+	}
+
+	/**
+	 * @brief append the triangulation of the faces of the map to table_indices (and store it in the cache)
+	 * The triangles are in the order of the traversal of the faces, whatever the number of threads.
+	 */
+	template <typename MASK>
+	void parallel_triangulate(const MASK& mask, std::vector<uint32>& table_indices)
+	{
+		faces_.clear();
+		offsets_.clear();
+		face_index_.clear();
+		dirty_faces_.clear();
+
+		uint32 nb_indices = 0u;
+		map_.foreach_cell([&] (Face f)
+		{
+			faces_.push_back(f);
+			offsets_.push_back(nb_indices);
+			nb_indices += nb_triangle_indices(f);
+		},
+		mask);
+		offsets_.push_back(nb_indices);
+
+		indices_.resize(nb_indices);
+		parallel_foreach_faces(uint32(faces_.size()), [&] (uint32 i) { return i; });
+		valid_ = true;
+
+		table_indices.insert(table_indices.end(), indices_.begin(), indices_.end());
+	}
+
+	void parallel_triangulate(std::vector<uint32>& table_indices)
+	{
+		parallel_triangulate(CellFilters(), table_indices);
+	}
+
+	/**
+	 * @brief the cached triangulation (valid after parallel_triangulate)
+	 */
+	inline const std::vector<uint32>& indices() const
+	{
+		return indices_;
+	}
+
+	/**
+	 * @brief the faces of the cached triangulation, in traversal order
+	 * (the triangles of faces()[i] are in indices() from offsets()[i] to offsets()[i+1])
+	 */
+	inline const std::vector<Face>& faces() const
+	{
+		return faces_;
+	}
+
+	inline const std::vector<uint32>& offsets() const
+	{
+		return offsets_;
+	}
+
+	inline bool is_valid() const
+	{
+		return valid_;
+	}
+
+	/**
+	 * @brief invalidate the whole cache (e.g. after a topological change)
+	 */
+	inline void invalidate()
+	{
+		valid_ = false;
+	}
+
+	/**
+	 * @brief mark the face f as to be triangulated again by the next update (e.g. after the move of one of its vertices)
+	 */
+	void invalidate(Face f)
+	{
+		if (!valid_)
+			return;
+		if (face_index_.empty())
+		{
+			face_index_.reserve(faces_.size());
+			for (uint32 i = 0u, end = uint32(faces_.size()); i < end; ++i)
+				face_index_[face_key(faces_[i])] = i;
+		}
+		auto it = face_index_.find(face_key(f));
+		if (it != face_index_.end())
+			dirty_faces_.push_back(it->second);
+	}
+
+	/**
+	 * @brief triangulate again the invalidated faces in the cache and append the whole triangulation to table_indices
+	 */
+	void update(std::vector<uint32>& table_indices)
+	{
+		cgogn_message_assert(valid_, "Triangulator::update: no valid triangulation in cache");
+
+		std::sort(dirty_faces_.begin(), dirty_faces_.end());
+		dirty_faces_.erase(std::unique(dirty_faces_.begin(), dirty_faces_.end()), dirty_faces_.end());
+		parallel_foreach_faces(uint32(dirty_faces_.size()), [&] (uint32 i) { return dirty_faces_[i]; });
+		dirty_faces_.clear();
+
+		table_indices.insert(table_indices.end(), indices_.begin(), indices_.end());
+	}
+
+private:
+
+	struct RangeScratch
+	{
+		typename EarTri::Scratch ear_scratch_;
+		std::vector<uint32> indices_;
+	};
+
+	inline uint32 nb_triangle_indices(Face f) const
+	{
+		const uint32 nb_vertices = map_.codegree(f);
+		return nb_vertices < 3u ? 0u : 3u * (nb_vertices - 2u);
+	}
+
+	// the smallest dart of the face identifies it in the cache
+	inline uint32 face_key(Face f) const
+	{
+		uint32 key = f.dart.index;
+		map_.foreach_dart_of_orbit(f, [&] (Dart d) { key = std::min(key, d.index); });
+		return key;
+	}
+
+	void triangulate(Face f, RangeScratch& scratch, std::vector<uint32>& table_indices)
+	{
+		if (map_.codegree(f) == 3u)
+		{
+			table_indices.push_back(map_.embedding(Vertex(f.dart)));
+			table_indices.push_back(map_.embedding(Vertex(map_.phi1(f.dart))));
+			table_indices.push_back(map_.embedding(Vertex(map_.phi1(map_.phi1(f.dart)))));
+		}
+		else if (nb_triangle_indices(f) > 0u)
+		{
+			EarTri tri(map_, f, position_, scratch.ear_scratch_);
+			tri.append_indices(table_indices);
+		}
+	}
+
+	// triangulate the faces face_number(0..nb-1) into the cache, each range of faces with its own scratch
+	template <typename FUNC>
+	void parallel_foreach_faces(uint32 nb, const FUNC& face_number)
+	{
+		const uint32 nb_ranges = nb_parallel_ranges(nb);
+		while (scratches_.size() < nb_ranges)
+			scratches_.emplace_back(new RangeScratch());
+
+		parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
+		{
+			RangeScratch& scratch = *scratches_[r];
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const uint32 fi = face_number(i);
+				scratch.indices_.clear();
+				triangulate(faces_[fi], scratch, scratch.indices_);
+				std::copy(scratch.indices_.begin(), scratch.indices_.end(), indices_.begin() + offsets_[fi]);
+			}
+		});
+	}
+
+	const MAP& map_;
+	const typename MAP::template VertexAttribute<VEC3>& position_;
+
+	std::vector<std::unique_ptr<RangeScratch>> scratches_;
+
+	// cache : faces in traversal order, offset of their triangles in indices_
+	std::vector<Face> faces_;
+	std::vector<uint32> offsets_;
+	std::vector<uint32> indices_;
+	bool valid_ = false;
+
+	// faces to triangulate again by update, number of the faces from their key
+	std::vector<uint32> dirty_faces_;
+	std::unordered_map<uint32, uint32> face_index_;
+};
+
+/**
+ * @brief append the ear triangulation of the faces of the map to table_indices, computed in parallel
+ * (same result as append_ear_triangulation on the faces in the order of their traversal)
+ */
+template <typename VEC3, typename MAP, typename MASK>
+void parallel_triangulate(
+	const MAP& map,
+	const MASK& mask,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	std::vector<uint32>& table_indices
+)
+{
+	Triangulator<VEC3, MAP> triangulator(map, position);
+	triangulator.parallel_triangulate(mask, table_indices);
+}
+
+template <typename VEC3, typename MAP>
+void parallel_triangulate(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	std::vector<uint32>& table_indices
+)
+{
+	parallel_triangulate<VEC3>(map, CellFilters(), position, table_indices);
+}
+
 } // namespace geometry
 
 } // namespace cgogn
@@ -24,8 +24,14 @@
 #ifndef CGOGN_GEOMETRY_ALGOS_FILTERING_H_
 #define CGOGN_GEOMETRY_ALGOS_FILTERING_H_
 
+#include <vector>
+#include <array>
+#include <algorithm>
+
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/basic/dart.h>
 
 namespace cgogn
 {
@@ -187,6 +193,251 @@ void filter_taubin(
 	filter_taubin<VEC3>(map, CellFilters(), position, position_tmp);
 }
 
+enum LaplacianWeights
+{
+	UNIFORM_WEIGHTS = 0,
+	COTANGENT_WEIGHTS
+};
+
+/**
+ * Iterative Laplacian smoothing over a compressed sparse row (CSR) adjacency of the vertices.
+ * The adjacency and the weights of the edges (normalized per vertex) are built once from the map,
+ * then the iterations only read and write dense arrays of positions, alternating between two buffers,
+ * in parallel over ranges of vertices. The positions are gathered from the attribute at the beginning
+ * of smooth() / taubin() and written back at the end.
+ * The smoothed vertices are the vertices of the mask; their neighbors that are not in the mask
+ * are read but never moved.
+ * Cotangent weights are only defined on the triangles of a surface map; they can be negative (obtuse triangles)
+ * and uniform weights are used for a vertex whose sum of cotangent weights is not positive.
+ * The topology of the map must not change while the smoother is used.
+ */
+template <typename VEC3, typename MAP>
+class LaplacianSmoothing
+{
+public:
+
+	using Self = LaplacianSmoothing<VEC3, MAP>;
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename MAP::Vertex;
+	using VertexAttribute = typename MAP::template VertexAttribute<VEC3>;
+
+	template <typename MASK>
+	LaplacianSmoothing(const MAP& map, const MASK& mask, const VertexAttribute& position, LaplacianWeights weights = UNIFORM_WEIGHTS) :
+		map_(map),
+		weights_type_(weights),
+		nb_smoothed_(0u)
+	{
+		build(mask);
+		update_weights(position);
+	}
+
+	LaplacianSmoothing(const MAP& map, const VertexAttribute& position, LaplacianWeights weights = UNIFORM_WEIGHTS) :
+		LaplacianSmoothing(map, CellFilters(), position, weights)
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(LaplacianSmoothing);
+
+	inline uint32 nb_smoothed_vertices() const { return nb_smoothed_; }
+	inline uint32 nb_vertices() const { return uint32(vertices_.size()); }
+
+	/**
+	 * @brief recompute the (cotangent) weights from the given positions
+	 */
+	void update_weights(const VertexAttribute& position)
+	{
+		if (weights_type_ == COTANGENT_WEIGHTS && MAP::DIMENSION != 2u)
+		{
+			cgogn_log_warning("LaplacianSmoothing") << "Cotangent weights are only defined on surfaces, uniform weights are used.";
+			weights_type_ = UNIFORM_WEIGHTS;
+		}
+
+		parallel_foreach_range(nb_smoothed_, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const uint32 first = offsets_[i];
+				const uint32 last = offsets_[i + 1u];
+				if (first == last)
+					continue;
+
+				Scalar sum(0);
+				if (weights_type_ == COTANGENT_WEIGHTS)
+				{
+					// same order as in build()
+					uint32 k = first;
+					map_.foreach_adjacent_vertex_through_edge(cells_[i], [&] (Vertex av)
+					{
+						const Scalar w = cotangent_weight(av.dart, position);
+						weights_[k++] = w;
+						sum += w;
+					});
+				}
+				if (!(sum > Scalar(0)))
+				{
+					std::fill(weights_.begin() + first, weights_.begin() + last, Scalar(1));
+					sum = Scalar(last - first);
+				}
+				for (uint32 k = first; k < last; ++k)
+					weights_[k] /= sum;
+			}
+		});
+	}
+
+	/**
+	 * @brief apply nb_iterations steps p <- p + lambda * (weighted average of the neighbors - p)
+	 */
+	void smooth(VertexAttribute& position, uint32 nb_iterations, Scalar lambda = Scalar(1))
+	{
+		run(position, nb_iterations, [lambda] (uint32) { return lambda; });
+	}
+
+	/**
+	 * @brief apply nb_iterations Taubin iterations (a step of factor lambda followed by a step of factor mu)
+	 * mu < -lambda < 0 gives the non-shrinking lambda|mu filter
+	 */
+	void taubin(VertexAttribute& position, uint32 nb_iterations, Scalar lambda = Scalar(0.6307), Scalar mu = Scalar(-0.6732))
+	{
+		run(position, 2u * nb_iterations, [lambda, mu] (uint32 step) { return (step & 1u) == 0u ? lambda : mu; });
+	}
+
+private:
+
+	template <typename MASK>
+	void build(const MASK& mask)
+	{
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		std::vector<uint32> dense_index(container.end(), INVALID_INDEX);
+
+		map_.foreach_cell([&] (Vertex v)
+		{
+			const uint32 emb = map_.embedding(v);
+			dense_index[emb] = uint32(vertices_.size());
+			vertices_.push_back(emb);
+			cells_.push_back(v);
+		},
+		mask);
+		nb_smoothed_ = uint32(vertices_.size());
+
+		parallel_compute_offsets(nb_smoothed_, [&] (uint32 i)
+		{
+			uint32 degree = 0u;
+			map_.foreach_adjacent_vertex_through_edge(cells_[i], [&] (Vertex) { ++degree; });
+			return degree;
+		},
+		offsets_);
+
+		neighbors_.resize(offsets_[nb_smoothed_]);
+		weights_.resize(offsets_[nb_smoothed_]);
+		parallel_foreach_range(nb_smoothed_, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				uint32 k = offsets_[i];
+				map_.foreach_adjacent_vertex_through_edge(cells_[i], [&] (Vertex av)
+				{
+					neighbors_[k++] = map_.embedding(av);
+				});
+			}
+		});
+
+		// the neighbors that are not smoothed are appended after the smoothed vertices
+		for (uint32& n : neighbors_)
+		{
+			uint32& index = dense_index[n];
+			if (index == INVALID_INDEX)
+			{
+				index = uint32(vertices_.size());
+				vertices_.push_back(n);
+			}
+			n = index;
+		}
+
+		for (auto& b : buffers_)
+			b.resize(vertices_.size());
+	}
+
+	// (cot(alpha) + cot(beta)) / 2, alpha and beta being the angles opposite to the edge of d in its triangles
+	Scalar cotangent_weight(Dart d, const VertexAttribute& position) const
+	{
+		Scalar w(0);
+		const std::array<Dart, 2> darts = {{ d, map_.phi2(d) }};
+		for (Dart e : darts)
+		{
+			if (map_.is_boundary(e))
+				continue;
+			const VEC3& o = position[Vertex(map_.phi_1(e))];
+			const VEC3 a = position[Vertex(e)] - o;
+			const VEC3 b = position[Vertex(map_.phi1(e))] - o;
+			const Scalar sin = a.cross(b).norm();
+			if (sin > Scalar(0))
+				w += a.dot(b) / sin;
+		}
+		return w * Scalar(0.5);
+	}
+
+	template <typename FACTOR>
+	void run(VertexAttribute& position, uint32 nb_steps, const FACTOR& factor)
+	{
+		const uint32 nb = nb_vertices();
+
+		// gather (the fixed neighbors are copied in both buffers)
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				buffers_[0u][i] = position[vertices_[i]];
+				if (i >= nb_smoothed_)
+					buffers_[1u][i] = buffers_[0u][i];
+			}
+		});
+
+		uint32 src = 0u;
+		for (uint32 step = 0u; step < nb_steps; ++step)
+		{
+			const Scalar f = factor(step);
+			const VEC3* in = buffers_[src].data();
+			VEC3* out = buffers_[1u - src].data();
+			parallel_foreach_range(nb_smoothed_, [&] (uint32, uint32 begin, uint32 end)
+			{
+				for (uint32 i = begin; i < end; ++i)
+				{
+					const uint32 first = offsets_[i];
+					const uint32 last = offsets_[i + 1u];
+					const VEC3& p = in[i];
+					if (first == last)
+					{
+						out[i] = p;
+						continue;
+					}
+					VEC3 avg = in[neighbors_[first]] * weights_[first];
+					for (uint32 k = first + 1u; k < last; ++k)
+						avg += in[neighbors_[k]] * weights_[k];
+					out[i] = p + (avg - p) * f;
+				}
+			});
+			src = 1u - src;
+		}
+
+		// scatter
+		parallel_foreach_range(nb_smoothed_, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				position[vertices_[i]] = buffers_[src][i];
+		});
+	}
+
+	const MAP& map_;
+	LaplacianWeights weights_type_;
+
+	uint32 nb_smoothed_;
+	std::vector<Vertex> cells_;       // smoothed vertices
+	std::vector<uint32> vertices_;    // embeddings of the smoothed vertices, then of their fixed neighbors
+	std::vector<uint32> offsets_;     // CSR offsets (size nb_smoothed_ + 1)
+	std::vector<uint32> neighbors_;   // dense indices of the neighbors
+	std::vector<Scalar> weights_;     // normalized weights of the neighbors
+	std::array<std::vector<VEC3>, 2> buffers_;
+};
+
 } // namespace geometry
 
 } // namespace cgogn
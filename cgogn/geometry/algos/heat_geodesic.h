@@ -0,0 +1,348 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_HEAT_GEODESIC_H_
+#define CGOGN_GEOMETRY_ALGOS_HEAT_GEODESIC_H_
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/basic/dart.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * Geodesic distances on a surface with the heat method (Crane, Weischedel and Wardetzky 2013):
+ * 1. integrate the heat flow u' = Lap(u) from the sources for a short time t: (M + t L) u = delta
+ * 2. normalize the opposite of the gradient of u in each triangle: X = -grad(u) / |grad(u)|
+ * 3. solve the Poisson equation Lap(phi) = div(X) and shift phi so that its minimum is zero
+ * where L is the cotangent Laplacian (positive semi-definite) and M the lumped mass matrix.
+ * Both matrices are factorized (sparse Cholesky LDLT) when the geometry is set, so that
+ * any number of source sets can then be processed with back-substitutions only:
+ * the source sets given to a same call are solved together, as the columns of a dense right-hand side,
+ * the blocks of columns being distributed over the thread pool.
+ * The faces are triangulated as fans (exact for triangle meshes) and the boundaries get Neumann conditions.
+ * The time step is t = time_factor * h^2, h being the mean length of the edges.
+ * The vertices that are not connected to any source get meaningless distances.
+ * The topology of the map must not change while the object is used.
+ */
+template <typename VEC3, typename MAP>
+class HeatGeodesic
+{
+public:
+
+	using Self = HeatGeodesic<VEC3, MAP>;
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+	template <typename T>
+	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+
+	using SparseMatrix = Eigen::SparseMatrix<Scalar>;
+	using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+	static_assert(MAP::DIMENSION == 2u, "HeatGeodesic is only defined on surfaces");
+
+	HeatGeodesic(const MAP& map, const VertexAttribute<VEC3>& position, Scalar time_factor = Scalar(1)) :
+		map_(map),
+		time_factor_(time_factor),
+		valid_(false)
+	{
+		build();
+		update_geometry(position);
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(HeatGeodesic);
+
+	inline uint32 nb_vertices() const { return uint32(vertices_.size()); }
+	inline uint32 nb_triangles() const { return uint32(corners_.size() / 3u); }
+
+	// the time step of the heat flow
+	inline Scalar time() const { return time_; }
+
+	// false if one of the factorizations failed
+	inline bool is_valid() const { return valid_; }
+
+	/**
+	 * @brief recompute the matrices and their factorizations from the given positions
+	 * (the sparsity pattern does not change: only the numerical factorizations are done again)
+	 */
+	void update_geometry(const VertexAttribute<VEC3>& position)
+	{
+		const uint32 nb = nb_vertices();
+		const uint32 nb_tri = nb_triangles();
+
+		std::vector<VEC3> p(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				p[i] = position[vertices_[i]];
+		});
+
+		// per triangle: the gradients of the hat functions of the corners and the cotangents of the corners
+		gradients_.resize(3u * nb_tri);
+		cotangents_.resize(3u * nb_tri);
+		edges_.resize(3u * nb_tri);
+		areas_.resize(nb_tri);
+		parallel_foreach_range(nb_tri, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 t = begin; t < end; ++t)
+			{
+				const uint32* c = &corners_[3u * t];
+				VEC3 n = (p[c[1]] - p[c[0]]).cross(p[c[2]] - p[c[0]]);
+				const Scalar double_area = n.norm();
+				areas_[t] = double_area / Scalar(2);
+				for (uint32 k = 0u; k < 3u; ++k)
+				{
+					// the edge opposite to corner k (counterclockwise) and the edge from corner k to the next one
+					const VEC3 opposite = p[c[(k + 2u) % 3u]] - p[c[(k + 1u) % 3u]];
+					const VEC3 a = p[c[(k + 1u) % 3u]] - p[c[k]];
+					const VEC3 b = p[c[(k + 2u) % 3u]] - p[c[k]];
+					edges_[3u * t + k] = a;
+					if (double_area > Scalar(0))
+					{
+						gradients_[3u * t + k] = n.cross(opposite) / (double_area * double_area);
+						cotangents_[3u * t + k] = a.dot(b) / a.cross(b).norm();
+					}
+					else
+					{
+						gradients_[3u * t + k] = VEC3(Scalar(0), Scalar(0), Scalar(0));
+						cotangents_[3u * t + k] = Scalar(0);
+					}
+				}
+			}
+		});
+
+		// cotangent Laplacian and lumped mass matrix
+		std::vector<Eigen::Triplet<Scalar>> laplacian_triplets;
+		laplacian_triplets.reserve(12u * nb_tri);
+		std::vector<Scalar> mass(nb, Scalar(0));
+		for (uint32 t = 0u; t < nb_tri; ++t)
+		{
+			const uint32* c = &corners_[3u * t];
+			for (uint32 k = 0u; k < 3u; ++k)
+			{
+				const uint32 i = c[(k + 1u) % 3u];
+				const uint32 j = c[(k + 2u) % 3u];
+				const Scalar w = cotangents_[3u * t + k] / Scalar(2);
+				laplacian_triplets.push_back(Eigen::Triplet<Scalar>(i, j, -w));
+				laplacian_triplets.push_back(Eigen::Triplet<Scalar>(j, i, -w));
+				laplacian_triplets.push_back(Eigen::Triplet<Scalar>(i, i, w));
+				laplacian_triplets.push_back(Eigen::Triplet<Scalar>(j, j, w));
+				mass[c[k]] += areas_[t] / Scalar(3);
+			}
+		}
+		SparseMatrix laplacian(nb, nb);
+		laplacian.setFromTriplets(laplacian_triplets.begin(), laplacian_triplets.end());
+		SparseMatrix mass_matrix(nb, nb);
+		mass_matrix.reserve(Eigen::VectorXi::Constant(nb, 1));
+		for (uint32 i = 0u; i < nb; ++i)
+			mass_matrix.insert(i, i) = mass[i];
+
+		Scalar h(0);
+		uint32 nb_edges = 0u;
+		for (uint32 t = 0u; t < nb_tri; ++t)
+		{
+			for (uint32 k = 0u; k < 3u; ++k)
+				h += edges_[3u * t + k].norm();
+			nb_edges += 3u;
+		}
+		h = nb_edges > 0u ? h / Scalar(nb_edges) : Scalar(1);
+		time_ = time_factor_ * h * h;
+
+		// the Laplacian is singular (constant functions): a small multiple of the mass is added
+		const SparseMatrix heat = mass_matrix + laplacian * time_;
+		const SparseMatrix poisson = laplacian + mass_matrix * (Scalar(1e-8) / (h * h));
+
+		if (!pattern_analyzed_)
+		{
+			heat_solver_.analyzePattern(heat);
+			poisson_solver_.analyzePattern(poisson);
+			pattern_analyzed_ = true;
+		}
+		heat_solver_.factorize(heat);
+		poisson_solver_.factorize(poisson);
+
+		valid_ = heat_solver_.info() == Eigen::Success && poisson_solver_.info() == Eigen::Success;
+		if (!valid_)
+			cgogn_log_warning("HeatGeodesic") << "The factorization of the matrices failed.";
+	}
+
+	/**
+	 * @brief compute the geodesic distances to a set of sources
+	 */
+	void compute(const std::vector<Vertex>& sources, VertexAttribute<Scalar>& distance) const
+	{
+		const std::vector<std::vector<Vertex>> source_sets = { sources };
+		std::vector<VertexAttribute<Scalar>> distances = { distance };
+		compute(source_sets, distances);
+	}
+
+	/**
+	 * @brief compute the geodesic distances to several sets of sources
+	 * @param source_sets the sets of sources
+	 * @param distances for each set of sources, the attribute that receives the distances
+	 */
+	void compute(const std::vector<std::vector<Vertex>>& source_sets, std::vector<VertexAttribute<Scalar>>& distances) const
+	{
+		cgogn_message_assert(source_sets.size() == distances.size(), "HeatGeodesic::compute: one attribute per set of sources is needed");
+		if (!valid_)
+		{
+			cgogn_log_warning("HeatGeodesic::compute") << "The factorization of the matrices failed.";
+			return;
+		}
+
+		const uint32 nb = nb_vertices();
+		const uint32 nb_sets = uint32(source_sets.size());
+		if (nb == 0u || nb_sets == 0u)
+			return;
+
+		Matrix delta = Matrix::Zero(nb, nb_sets);
+		for (uint32 s = 0u; s < nb_sets; ++s)
+		{
+			for (Vertex v : source_sets[s])
+			{
+				const uint32 i = dense_index_[map_.embedding(v)];
+				if (i != INVALID_INDEX)
+					delta(i, s) = Scalar(1);
+			}
+		}
+
+		// blocks of columns solved together
+		const uint32 nb_blocks = std::max(1u, std::min(nb_sets, uint32(thread_pool()->nb_threads())));
+		parallel_foreach_range(nb_sets, nb_blocks, [&] (uint32, uint32 begin, uint32 end)
+		{
+			const uint32 nb_columns = end - begin;
+			const Matrix u = heat_solver_.solve(delta.middleCols(begin, nb_columns));
+
+			Matrix divergence = Matrix::Zero(nb, nb_columns);
+			for (uint32 col = 0u; col < nb_columns; ++col)
+				integrated_divergence(u.col(col), divergence.col(col));
+
+			const Matrix phi = poisson_solver_.solve(divergence);
+
+			for (uint32 col = 0u; col < nb_columns; ++col)
+			{
+				const Scalar min = phi.col(col).minCoeff();
+				VertexAttribute<Scalar>& distance = distances[begin + col];
+				for (uint32 i = 0u; i < nb; ++i)
+					distance[vertices_[i]] = phi(i, col) - min;
+			}
+		});
+	}
+
+private:
+
+	void build()
+	{
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		dense_index_.assign(container.end(), INVALID_INDEX);
+
+		map_.foreach_cell([&] (Vertex v)
+		{
+			const uint32 emb = map_.embedding(v);
+			dense_index_[emb] = uint32(vertices_.size());
+			vertices_.push_back(emb);
+		});
+
+		// fan triangulation of the faces
+		map_.foreach_cell([&] (Face f)
+		{
+			const uint32 c0 = dense_index_[map_.embedding(Vertex(f.dart))];
+			Dart d = map_.phi1(f.dart);
+			for (Dart e = map_.phi1(d); e != f.dart; d = e, e = map_.phi1(e))
+			{
+				corners_.push_back(c0);
+				corners_.push_back(dense_index_[map_.embedding(Vertex(d))]);
+				corners_.push_back(dense_index_[map_.embedding(Vertex(e))]);
+			}
+		});
+
+		pattern_analyzed_ = false;
+	}
+
+	/**
+	 * the opposite of the divergence of the normalized (opposite) gradient of u, integrated around each vertex:
+	 * -div(X)_i = -1/2 sum_t (cot(theta_1) (e_1 . X_t) + cot(theta_2) (e_2 . X_t))
+	 * e_1, e_2 being the edges of t from i and theta_1, theta_2 the angles opposite to them
+	 * (the sign matches the positive semi-definite Laplacian)
+	 */
+	template <typename COLUMN, typename RESULT>
+	void integrated_divergence(const COLUMN& u, RESULT&& divergence) const
+	{
+		const uint32 nb_tri = nb_triangles();
+		for (uint32 t = 0u; t < nb_tri; ++t)
+		{
+			const uint32* c = &corners_[3u * t];
+			VEC3 x = gradients_[3u * t] * u(c[0]) + gradients_[3u * t + 1u] * u(c[1]) + gradients_[3u * t + 2u] * u(c[2]);
+			const Scalar norm = x.norm();
+			if (!(norm > Scalar(0)))
+				continue;
+			x = x * (Scalar(-1) / norm);
+			for (uint32 k = 0u; k < 3u; ++k)
+			{
+				const uint32 next = (k + 1u) % 3u;
+				const uint32 previous = (k + 2u) % 3u;
+				// edge k -> next is opposite to the corner previous, edge k -> previous is opposite to the corner next
+				const Scalar e1 = edges_[3u * t + k].dot(x);
+				const Scalar e2 = -edges_[3u * t + previous].dot(x);
+				divergence(c[k]) -= (cotangents_[3u * t + previous] * e1 + cotangents_[3u * t + next] * e2) / Scalar(2);
+			}
+		}
+	}
+
+	const MAP& map_;
+	Scalar time_factor_;
+	Scalar time_;
+	bool valid_;
+	bool pattern_analyzed_;
+
+	std::vector<uint32> vertices_;      // embeddings of the vertices
+	std::vector<uint32> dense_index_;   // dense index of the vertices (indexed by embedding)
+	std::vector<uint32> corners_;       // dense indices of the corners of the triangles (3 per triangle)
+	std::vector<VEC3> gradients_;       // gradients of the hat functions of the corners
+	std::vector<VEC3> edges_;           // edges from each corner to the next one
+	std::vector<Scalar> cotangents_;    // cotangents of the angles of the corners
+	std::vector<Scalar> areas_;
+
+	Eigen::SimplicialLDLT<SparseMatrix> heat_solver_;
+	Eigen::SimplicialLDLT<SparseMatrix> poisson_solver_;
+};
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_HEAT_GEODESIC_H_
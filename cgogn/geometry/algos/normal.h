@@ -24,9 +24,14 @@
 #ifndef CGOGN_GEOMETRY_ALGOS_NORMAL_H_
 #define CGOGN_GEOMETRY_ALGOS_NORMAL_H_
 
+#include <vector>
+#include <algorithm>
+
 #include <cgogn/core/utils/numerics.h>
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/basic/cell_marker.h>
 
 #include <cgogn/geometry/algos/area.h>
 #include <cgogn/geometry/functions/basics.h>
@@ -205,6 +210,93 @@ inline void compute_normal(
 	compute_normal<VEC3>(map, CellFilters(), position, face_normal, vertex_normal);
 }
 
+/**
+ * @brief update the face and vertex normals after the displacement of some vertices
+ * Only the faces incident to the dirty vertices and the vertices of these faces are recomputed (in parallel).
+ * @param dirty_vertices the vertices whose position changed
+ * @param updated_vertices filled with the (sorted) embeddings of the vertices whose normal was recomputed
+ */
+template <typename VEC3, typename MAP>
+void update_normal(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	const std::vector<Cell<Orbit::PHI21>>& dirty_vertices,
+	typename MAP::template Attribute<VEC3, Orbit::PHI1>& face_normal,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& vertex_normal,
+	std::vector<uint32>& updated_vertices
+)
+{
+	using Vertex2 = Cell<Orbit::PHI21>;
+	using Face2 = Cell<Orbit::PHI1>;
+
+	// collect the faces and vertices to update without duplicates
+	std::vector<Face2> faces;
+	std::vector<Vertex2> vertices;
+	CellMarkerStore<MAP, Orbit::PHI1> face_marker(map);
+	CellMarkerStore<MAP, Orbit::PHI21> vertex_marker(map);
+	for (Vertex2 v : dirty_vertices)
+	{
+		if (!vertex_marker.is_marked(v))
+		{
+			vertex_marker.mark(v);
+			vertices.push_back(v);
+		}
+		map.foreach_incident_face(v, [&] (Face2 f)
+		{
+			if (face_marker.is_marked(f))
+				return;
+			face_marker.mark(f);
+			faces.push_back(f);
+			map.foreach_incident_vertex(f, [&] (Vertex2 w)
+			{
+				if (!vertex_marker.is_marked(w))
+				{
+					vertex_marker.mark(w);
+					vertices.push_back(w);
+				}
+			});
+		});
+	}
+
+	parallel_foreach_range(uint32(faces.size()), [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+			face_normal[faces[i]] = normal<VEC3>(map, faces[i], position);
+	});
+
+	parallel_foreach_range(uint32(vertices.size()), [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+			vertex_normal[vertices[i]] = normal<VEC3>(map, vertices[i], position, face_normal);
+	});
+
+	updated_vertices = vertex_marker.marked_cells();
+	std::sort(updated_vertices.begin(), updated_vertices.end());
+}
+
+/**
+ * @brief update the face and vertex normals after the displacement of the marked vertices
+ * (the marked vertices are gathered by a traversal of the vertices of the map)
+ */
+template <typename VEC3, typename MAP>
+void update_normal(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	const CellMarker<MAP, Orbit::PHI21>& dirty_vertices,
+	typename MAP::template Attribute<VEC3, Orbit::PHI1>& face_normal,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& vertex_normal,
+	std::vector<uint32>& updated_vertices
+)
+{
+	std::vector<Cell<Orbit::PHI21>> dirty;
+	map.foreach_cell([&] (Cell<Orbit::PHI21> v)
+	{
+		if (dirty_vertices.is_marked(v))
+			dirty.push_back(v);
+	});
+	update_normal<VEC3>(map, position, dirty, face_normal, vertex_normal, updated_vertices);
+}
+
 } // namespace geometry
 
 } // namespace cgogn
@@ -34,6 +34,7 @@
 #include <cgogn/geometry/functions/intersection.h>
 #include <cgogn/geometry/functions/distance.h>
 #include <cgogn/geometry/algos/ear_triangulation.h>
+#include <cgogn/geometry/algos/bvh.h>
 
 #include <tuple>
 
@@ -113,20 +114,13 @@ inline void picking_internal_face(
 }
 
 template <typename VEC3, typename MAP>
-bool picking(
+bool picking_selection(
 	const MAP& m,
-	const typename MAP::template VertexAttribute<VEC3>& position,
-	const VEC3& A,
-	const VEC3& B,
+	const typename MAP::template VertexAttribute<VEC3>&,
+	const typename std::vector<std::tuple<typename MAP::Face, VEC3, typename vector_traits<VEC3>::Scalar>>& sel,
 	typename std::vector<typename MAP::Face>& selected
 )
 {
-	using Scalar = typename vector_traits<VEC3>::Scalar;
-
-	typename std::vector<std::tuple<typename MAP::Face, VEC3, Scalar>> sel;
-	picking_internal_face<VEC3>(m, position, A, B, sel);
-
-	DartMarkerStore<MAP> dm(m);
 	selected.clear();
 	for (const auto& fs : sel)
 		selected.push_back(std::get<0>(fs));
@@ -135,11 +129,10 @@ bool picking(
 }
 
 template <typename VEC3, typename MAP>
-bool picking(
+bool picking_selection(
 	const MAP& m,
 	const typename MAP::template VertexAttribute<VEC3>& position,
-	const VEC3& A,
-	const VEC3& B,
+	const typename std::vector<std::tuple<typename MAP::Face, VEC3, typename vector_traits<VEC3>::Scalar>>& sel,
 	typename std::vector<typename MAP::Vertex>& selected
 )
 {
@@ -147,9 +140,6 @@ bool picking(
 	using Vertex = typename MAP::Vertex;
 	using Face = typename MAP::Face;
 
-	typename std::vector<std::tuple<Face, VEC3, Scalar>> sel;
-	picking_internal_face<VEC3>(m, position, A, B, sel);
-
 	DartMarkerStore<MAP> dm(m);
 	selected.clear();
 	for (const auto& fs : sel)
@@ -181,11 +171,10 @@ bool picking(
 }
 
 template <typename VEC3, typename MAP>
-bool picking(
+bool picking_selection(
 	const MAP& m,
 	const typename MAP::template VertexAttribute<VEC3>& position,
-	const VEC3& A,
-	const VEC3& B,
+	const typename std::vector<std::tuple<typename MAP::Face, VEC3, typename vector_traits<VEC3>::Scalar>>& sel,
 	typename std::vector<typename MAP::Edge>& selected
 )
 {
@@ -194,9 +183,6 @@ bool picking(
 	using Edge = typename MAP::Edge;
 	using Face = typename MAP::Face;
 
-	typename std::vector<std::tuple<Face, VEC3, Scalar>> sel;
-	picking_internal_face<VEC3>(m, position, A, B, sel);
-
 	DartMarkerStore<MAP> dm(m);
 	selected.clear();
 	for (const auto& fs : sel)
@@ -229,23 +215,18 @@ bool picking(
 }
 
 template <typename VEC3, typename MAP>
-bool picking(
+bool picking_selection(
 	const MAP& m,
-	const typename MAP::template VertexAttribute<VEC3>& position,
-	const VEC3& A,
-	const VEC3& B,
+	const typename MAP::template VertexAttribute<VEC3>&,
+	const typename std::vector<std::tuple<typename MAP::Face, VEC3, typename vector_traits<VEC3>::Scalar>>& sel,
 	typename std::vector<typename MAP::Volume>& selected
 )
 {
 	// here used Face2 for selecting the 2 volumes incident to selected faces
 
-	using Scalar = typename vector_traits<VEC3>::Scalar;
 	using Face = typename MAP::Face;
 	using Volume = typename MAP::Volume;
 
-	typename std::vector<std::tuple<Face, VEC3, Scalar>> sel;
-	picking_internal_face<VEC3>(m, position, A, B, sel);
-
 	selected.clear();
 	DartMarker<MAP> dm(m);
 	for (const auto& fs : sel)
@@ -264,6 +245,73 @@ bool picking(
 	return !selected.empty();
 }
 
+/**
+ * @brief select the cells (vertices, edges, faces or volumes) of the faces intersected by the ray [A,B)
+ * sorted by distance to A
+ */
+template <typename VEC3, typename MAP, typename CellType>
+bool picking(
+	const MAP& m,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	const VEC3& A,
+	const VEC3& B,
+	typename std::vector<CellType>& selected
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	typename std::vector<std::tuple<typename MAP::Face, VEC3, Scalar>> sel;
+	picking_internal_face<VEC3>(m, position, A, B, sel);
+
+	return picking_selection<VEC3>(m, position, sel, selected);
+}
+
+/**
+ * @brief same as above, the intersected faces are found with a BVH built on the map
+ */
+template <typename VEC3, typename MAP, typename CellType>
+bool picking(
+	const MAP& m,
+	const BVH<VEC3, MAP>& bvh,
+	const VEC3& A,
+	const VEC3& B,
+	typename std::vector<CellType>& selected
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	cgogn_message_assert(&bvh.map() == &m, "the BVH must be built on the given map");
+
+	VEC3 AB = B - A;
+	cgogn_message_assert(AB.squaredNorm() > 0.0, "line must be defined by 2 different points");
+	AB.normalize();
+
+	typename std::vector<std::tuple<typename MAP::Face, VEC3, Scalar>> sel;
+	bvh.intersect_all(A, AB, sel);
+
+	return picking_selection<VEC3>(m, bvh.position(), sel, selected);
+}
+
+/**
+ * @brief find the point of the surface of a map that is the closest to P
+ * @param bvh a BVH built on the map
+ * @param P the point
+ * @param f the face containing the closest point
+ * @param closest the closest point
+ * @return false if the map has no face
+ */
+template <typename VEC3, typename MAP>
+bool closest_point(
+	const BVH<VEC3, MAP>& bvh,
+	const VEC3& P,
+	typename MAP::Face& f,
+	VEC3& closest
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	return bvh.closest_point(P, f, closest) < std::numeric_limits<Scalar>::infinity();
+}
+
 } // namespace geometry
 
 } // namespace cgogn
@@ -0,0 +1,583 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_POINT_INDEX_H_
+#define CGOGN_GEOMETRY_ALGOS_POINT_INDEX_H_
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+enum PointIndexType
+{
+	HASH_GRID = 0,
+	KD_TREE
+};
+
+/**
+ * Spatial index over the positions of the vertices of a map.
+ * Two backends are available:
+ * - HASH_GRID : uniform grid whose cells are stored in a hash table,
+ * - KD_TREE : balanced k-d tree (median splits on the largest extent).
+ * The positions are copied in the index: build() must be called again after a modification of the positions.
+ * The queries are const and can be called concurrently.
+ */
+template <typename VEC3, typename MAP>
+class PointIndex
+{
+public:
+
+	using Self = PointIndex<VEC3, MAP>;
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename MAP::Vertex;
+	using VertexAttribute = typename MAP::template VertexAttribute<VEC3>;
+	using Neighbor = std::pair<Vertex, Scalar>;
+
+	static const uint32 KD_LEAF_SIZE = 8u;
+
+private:
+
+	using Candidate = std::pair<Scalar, uint32>; // squared distance, point index
+
+	const MAP& map_;
+	VertexAttribute position_;
+	PointIndexType type_;
+
+	// points sorted by grid bucket or by k-d tree leaf
+	std::vector<Vertex> vertices_;
+	std::vector<VEC3> points_;
+
+	// bounding box of the points
+	VEC3 min_;
+	VEC3 max_;
+
+	// hash grid
+	Scalar cell_size_;
+	std::array<int32, 3> grid_size_;
+	uint32 hash_mask_;
+	std::vector<uint32> bucket_begin_; // points of bucket b : [bucket_begin_[b], bucket_begin_[b+1])
+
+	// k-d tree (node n has children 2n+1 and 2n+2)
+	std::vector<Scalar> split_value_;
+	std::vector<uint8> split_axis_;
+
+public:
+
+	/**
+	 * @param map the map
+	 * @param position the position of the vertices
+	 * @param type the backend
+	 * @param cell_size the size of the cells of the hash grid (0 : automatic)
+	 */
+	PointIndex(const MAP& map, const VertexAttribute& position, PointIndexType type = KD_TREE, Scalar cell_size = Scalar(0)) :
+		map_(map),
+		position_(position),
+		type_(type),
+		cell_size_(cell_size),
+		hash_mask_(0u)
+	{
+		build();
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(PointIndex);
+
+	inline PointIndexType type() const { return type_; }
+	inline uint32 nb_points() const { return uint32(points_.size()); }
+	inline Scalar cell_size() const { return cell_size_; }
+
+	/**
+	 * @brief (re)build the index from the current vertices and positions of the map
+	 */
+	void build()
+	{
+		vertices_.clear();
+		points_.clear();
+		bucket_begin_.clear();
+		split_value_.clear();
+		split_axis_.clear();
+
+		vertices_.reserve(map_.template nb_cells<Vertex::ORBIT>());
+		map_.foreach_cell([&] (Vertex v) { vertices_.push_back(v); });
+
+		const uint32 nb = uint32(vertices_.size());
+		points_.resize(nb);
+		if (nb == 0u)
+			return;
+
+		// positions and bounding box
+		const uint32 nb_ranges = nb_parallel_ranges(nb);
+		std::vector<std::pair<VEC3, VEC3>> range_boxes(nb_ranges);
+		parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
+		{
+			VEC3 bmin = position_[vertices_[begin]];
+			VEC3 bmax = bmin;
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const VEC3& p = position_[vertices_[i]];
+				points_[i] = p;
+				for (uint32 j = 0u; j < 3u; ++j)
+				{
+					bmin[j] = std::min(bmin[j], p[j]);
+					bmax[j] = std::max(bmax[j], p[j]);
+				}
+			}
+			range_boxes[r] = std::make_pair(bmin, bmax);
+		});
+		min_ = range_boxes[0].first;
+		max_ = range_boxes[0].second;
+		for (const auto& b : range_boxes)
+		{
+			for (uint32 j = 0u; j < 3u; ++j)
+			{
+				min_[j] = std::min(min_[j], b.first[j]);
+				max_[j] = std::max(max_[j], b.second[j]);
+			}
+		}
+
+		if (type_ == HASH_GRID)
+			build_hash_grid();
+		else
+			build_kd_tree();
+	}
+
+	/**
+	 * @brief find the k points closest to P
+	 * @param neighbors the k (or less if the map has less vertices) closest vertices
+	 * with their squared distance to P, sorted by increasing distance
+	 */
+	void k_nearest(const VEC3& P, uint32 k, std::vector<Neighbor>& neighbors) const
+	{
+		std::vector<Candidate> heap;
+		k_nearest(P, k, heap, neighbors);
+	}
+
+	/**
+	 * @brief find the point closest to P
+	 * @return false if the index is empty
+	 */
+	bool nearest(const VEC3& P, Vertex& v, Scalar& squared_distance) const
+	{
+		std::vector<Neighbor> neighbors;
+		k_nearest(P, 1u, neighbors);
+		if (neighbors.empty())
+			return false;
+		v = neighbors[0].first;
+		squared_distance = neighbors[0].second;
+		return true;
+	}
+
+	/**
+	 * @brief find the points inside the ball (P, radius)
+	 * @param neighbors the vertices whose distance to P is lower or equal to radius (in no particular order)
+	 */
+	void within_radius(const VEC3& P, Scalar radius, std::vector<Vertex>& neighbors) const
+	{
+		neighbors.clear();
+		if (points_.empty())
+			return;
+		if (type_ == HASH_GRID)
+			grid_within_radius(P, radius, neighbors);
+		else
+			kd_within_radius(0u, 0u, nb_points(), P, radius * radius, neighbors);
+	}
+
+	/**
+	 * @brief batched version of k_nearest, the queries are processed in parallel
+	 */
+	void k_nearest(const std::vector<VEC3>& points, uint32 k, std::vector<std::vector<Neighbor>>& neighbors) const
+	{
+		neighbors.resize(points.size());
+		parallel_foreach_range(uint32(points.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			std::vector<Candidate> heap;
+			for (uint32 i = begin; i < end; ++i)
+				k_nearest(points[i], k, heap, neighbors[i]);
+		});
+	}
+
+	/**
+	 * @brief batched version of within_radius, the queries are processed in parallel
+	 */
+	void within_radius(const std::vector<VEC3>& points, Scalar radius, std::vector<std::vector<Vertex>>& neighbors) const
+	{
+		neighbors.resize(points.size());
+		parallel_foreach_range(uint32(points.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				within_radius(points[i], radius, neighbors[i]);
+		});
+	}
+
+private:
+
+	void k_nearest(const VEC3& P, uint32 k, std::vector<Candidate>& heap, std::vector<Neighbor>& neighbors) const
+	{
+		neighbors.clear();
+		heap.clear();
+		if (points_.empty() || k == 0u)
+			return;
+
+		if (type_ == HASH_GRID)
+			grid_k_nearest(P, k, heap);
+		else
+			kd_k_nearest(0u, 0u, nb_points(), P, k, heap);
+
+		std::sort_heap(heap.begin(), heap.end());
+		neighbors.reserve(heap.size());
+		for (const Candidate& c : heap)
+			neighbors.push_back(std::make_pair(vertices_[c.second], c.first));
+	}
+
+	// insert point i in the max-heap of the k closest points
+	inline void push_candidate(const VEC3& P, uint32 i, uint32 k, std::vector<Candidate>& heap) const
+	{
+		const Scalar d2 = (points_[i] - P).squaredNorm();
+		if (heap.size() < k)
+		{
+			heap.push_back(std::make_pair(d2, i));
+			std::push_heap(heap.begin(), heap.end());
+		}
+		else if (d2 < heap.front().first)
+		{
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = std::make_pair(d2, i);
+			std::push_heap(heap.begin(), heap.end());
+		}
+	}
+
+	/**********************************************/
+	/*                 HASH GRID                  */
+	/**********************************************/
+
+	inline int32 cell_coord(Scalar x, uint32 axis) const
+	{
+		const Scalar c = std::floor((x - min_[axis]) / cell_size_);
+		// far away points are clamped to avoid overflows
+		return int32(std::max(std::min(c, Scalar(1 << 30)), -Scalar(1 << 30)));
+	}
+
+	inline uint32 bucket(int32 i, int32 j, int32 k) const
+	{
+		return ((uint32(i) * 73856093u) ^ (uint32(j) * 19349663u) ^ (uint32(k) * 83492791u)) & hash_mask_;
+	}
+
+	inline bool in_cell(uint32 p, int32 i, int32 j, int32 k) const
+	{
+		const VEC3& q = points_[p];
+		return cell_coord(q[0], 0u) == i && cell_coord(q[1], 1u) == j && cell_coord(q[2], 2u) == k;
+	}
+
+	void build_hash_grid()
+	{
+		const uint32 nb = nb_points();
+
+		if (!(cell_size_ > Scalar(0)))
+		{
+			// a few points per cell for points sampled on a surface
+			Scalar max_size = Scalar(0);
+			for (uint32 j = 0u; j < 3u; ++j)
+				max_size = std::max(max_size, max_[j] - min_[j]);
+			cell_size_ = Scalar(2) * max_size / std::sqrt(Scalar(nb));
+			if (!(cell_size_ > Scalar(0)))
+				cell_size_ = Scalar(1);
+		}
+		for (uint32 j = 0u; j < 3u; ++j)
+			grid_size_[j] = cell_coord(max_[j], j) + 1;
+
+		uint32 nb_buckets = 1u;
+		while (nb_buckets < nb)
+			nb_buckets <<= 1u;
+		hash_mask_ = nb_buckets - 1u;
+
+		std::vector<uint32> buckets(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const VEC3& p = points_[i];
+				buckets[i] = bucket(cell_coord(p[0], 0u), cell_coord(p[1], 1u), cell_coord(p[2], 2u));
+			}
+		});
+
+		// counting sort of the points by bucket
+		bucket_begin_.assign(nb_buckets + 1u, 0u);
+		for (uint32 b : buckets)
+			++bucket_begin_[b + 1u];
+		for (uint32 b = 0u; b < nb_buckets; ++b)
+			bucket_begin_[b + 1u] += bucket_begin_[b];
+
+		std::vector<uint32> fill(bucket_begin_.begin(), bucket_begin_.end() - 1);
+		std::vector<uint32> order(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			order[fill[buckets[i]]++] = i;
+
+		reorder(order);
+	}
+
+	template <typename FUNC>
+	inline void foreach_point_in_cell(int32 i, int32 j, int32 k, const FUNC& f) const
+	{
+		const uint32 b = bucket(i, j, k);
+		for (uint32 p = bucket_begin_[b]; p < bucket_begin_[b + 1u]; ++p)
+			if (in_cell(p, i, j, k))
+				f(p);
+	}
+
+	void grid_within_radius(const VEC3& P, Scalar radius, std::vector<Vertex>& neighbors) const
+	{
+		const Scalar r2 = radius * radius;
+		std::array<int32, 3> lo, hi;
+		for (uint32 a = 0u; a < 3u; ++a)
+		{
+			lo[a] = std::max(cell_coord(P[a] - radius, a), 0);
+			hi[a] = std::min(cell_coord(P[a] + radius, a), grid_size_[a] - 1);
+			if (lo[a] > hi[a])
+				return;
+		}
+		for (int32 i = lo[0]; i <= hi[0]; ++i)
+			for (int32 j = lo[1]; j <= hi[1]; ++j)
+				for (int32 k = lo[2]; k <= hi[2]; ++k)
+					foreach_point_in_cell(i, j, k, [&] (uint32 p)
+					{
+						if ((points_[p] - P).squaredNorm() <= r2)
+							neighbors.push_back(vertices_[p]);
+					});
+	}
+
+	void grid_k_nearest(const VEC3& P, uint32 k, std::vector<Candidate>& heap) const
+	{
+		std::array<int32, 3> c;
+		for (uint32 a = 0u; a < 3u; ++a)
+			c[a] = cell_coord(P[a], a);
+
+		// the shells of cells at distance r (infinity norm) of the cell of P are visited until
+		// the k-th candidate is closer than the outside of the visited block
+		// (starting from the first shell that reaches the grid)
+		int32 r0 = 0;
+		for (uint32 a = 0u; a < 3u; ++a)
+			r0 = std::max(r0, std::max(-c[a], c[a] - (grid_size_[a] - 1)));
+		for (int32 r = r0; ; ++r)
+		{
+			bool outside_grid = true;
+			for (uint32 a = 0u; a < 3u; ++a)
+				outside_grid = outside_grid && c[a] - r <= 0 && c[a] + r >= grid_size_[a] - 1;
+
+			for (int32 i = std::max(c[0] - r, 0); i <= std::min(c[0] + r, grid_size_[0] - 1); ++i)
+				for (int32 j = std::max(c[1] - r, 0); j <= std::min(c[1] + r, grid_size_[1] - 1); ++j)
+				{
+					const bool on_shell = std::abs(i - c[0]) == r || std::abs(j - c[1]) == r;
+					for (int32 l = std::max(c[2] - r, 0); l <= std::min(c[2] + r, grid_size_[2] - 1); ++l)
+					{
+						if (on_shell || std::abs(l - c[2]) == r)
+							foreach_point_in_cell(i, j, l, [&] (uint32 p) { push_candidate(P, p, k, heap); });
+					}
+				}
+
+			if (outside_grid)
+				return;
+
+			if (heap.size() == k)
+			{
+				Scalar d = std::numeric_limits<Scalar>::max();
+				for (uint32 a = 0u; a < 3u; ++a)
+				{
+					d = std::min(d, P[a] - (min_[a] + Scalar(c[a] - r) * cell_size_));
+					d = std::min(d, (min_[a] + Scalar(c[a] + r + 1) * cell_size_) - P[a]);
+				}
+				if (d > Scalar(0) && heap.front().first <= d * d)
+					return;
+			}
+		}
+	}
+
+	/**********************************************/
+	/*                  K-D TREE                  */
+	/**********************************************/
+
+	void build_kd_tree()
+	{
+		const uint32 nb = nb_points();
+
+		uint32 depth = 0u;
+		for (uint32 size = nb; size > KD_LEAF_SIZE; size = (size + 1u) / 2u)
+			++depth;
+		split_value_.resize((1u << depth) - 1u);
+		split_axis_.resize((1u << depth) - 1u);
+
+		std::vector<uint32> order(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			order[i] = i;
+
+		// the first levels are built sequentially, then the subtrees in parallel
+		struct Subtree { uint32 node, begin, end; };
+		std::vector<Subtree> subtrees;
+		const uint32 nb_subtrees = nb_parallel_ranges(nb);
+		std::vector<Subtree> level = {{0u, 0u, nb}};
+		while (level.size() < nb_subtrees && !level.empty())
+		{
+			std::vector<Subtree> next;
+			for (const Subtree& s : level)
+			{
+				if (s.end - s.begin <= KD_LEAF_SIZE)
+					continue;
+				const uint32 middle = kd_split(s.node, s.begin, s.end, order);
+				next.push_back({2u * s.node + 1u, s.begin, middle});
+				next.push_back({2u * s.node + 2u, middle, s.end});
+			}
+			level.swap(next);
+		}
+
+		parallel_foreach_range(uint32(level.size()), uint32(level.size()), [&] (uint32 r, uint32, uint32)
+		{
+			kd_build(level[r].node, level[r].begin, level[r].end, order);
+		});
+
+		reorder(order);
+	}
+
+	// split the points [begin, end) of node at the median of the largest extent of their bounding box
+	uint32 kd_split(uint32 node, uint32 begin, uint32 end, std::vector<uint32>& order)
+	{
+		VEC3 bmin = points_[order[begin]];
+		VEC3 bmax = bmin;
+		for (uint32 i = begin + 1u; i < end; ++i)
+		{
+			const VEC3& p = points_[order[i]];
+			for (uint32 j = 0u; j < 3u; ++j)
+			{
+				bmin[j] = std::min(bmin[j], p[j]);
+				bmax[j] = std::max(bmax[j], p[j]);
+			}
+		}
+		uint8 axis = 0u;
+		for (uint8 j = 1u; j < 3u; ++j)
+			if (bmax[j] - bmin[j] > bmax[axis] - bmin[axis])
+				axis = j;
+
+		const uint32 middle = (begin + end) / 2u;
+		std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&] (uint32 a, uint32 b)
+		{
+			return points_[a][axis] < points_[b][axis];
+		});
+		split_axis_[node] = axis;
+		split_value_[node] = points_[order[middle]][axis];
+		return middle;
+	}
+
+	void kd_build(uint32 node, uint32 begin, uint32 end, std::vector<uint32>& order)
+	{
+		if (end - begin <= KD_LEAF_SIZE)
+			return;
+		const uint32 middle = kd_split(node, begin, end, order);
+		kd_build(2u * node + 1u, begin, middle, order);
+		kd_build(2u * node + 2u, middle, end, order);
+	}
+
+	void kd_k_nearest(uint32 node, uint32 begin, uint32 end, const VEC3& P, uint32 k, std::vector<Candidate>& heap) const
+	{
+		if (end - begin <= KD_LEAF_SIZE)
+		{
+			for (uint32 p = begin; p < end; ++p)
+				push_candidate(P, p, k, heap);
+			return;
+		}
+
+		const uint32 middle = (begin + end) / 2u;
+		const Scalar diff = P[split_axis_[node]] - split_value_[node];
+		if (diff < Scalar(0))
+		{
+			kd_k_nearest(2u * node + 1u, begin, middle, P, k, heap);
+			if (heap.size() < k || diff * diff < heap.front().first)
+				kd_k_nearest(2u * node + 2u, middle, end, P, k, heap);
+		}
+		else
+		{
+			kd_k_nearest(2u * node + 2u, middle, end, P, k, heap);
+			if (heap.size() < k || diff * diff < heap.front().first)
+				kd_k_nearest(2u * node + 1u, begin, middle, P, k, heap);
+		}
+	}
+
+	void kd_within_radius(uint32 node, uint32 begin, uint32 end, const VEC3& P, Scalar r2, std::vector<Vertex>& neighbors) const
+	{
+		if (end - begin <= KD_LEAF_SIZE)
+		{
+			for (uint32 p = begin; p < end; ++p)
+				if ((points_[p] - P).squaredNorm() <= r2)
+					neighbors.push_back(vertices_[p]);
+			return;
+		}
+
+		const uint32 middle = (begin + end) / 2u;
+		const Scalar diff = P[split_axis_[node]] - split_value_[node];
+		if (diff <= Scalar(0) || diff * diff <= r2)
+			kd_within_radius(2u * node + 1u, begin, middle, P, r2, neighbors);
+		if (diff >= Scalar(0) || diff * diff <= r2)
+			kd_within_radius(2u * node + 2u, middle, end, P, r2, neighbors);
+	}
+
+	// sort the points and vertices in the given order
+	void reorder(const std::vector<uint32>& order)
+	{
+		const uint32 nb = nb_points();
+		std::vector<Vertex> vertices(nb);
+		std::vector<VEC3> points(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				vertices[i] = vertices_[order[i]];
+				points[i] = points_[order[i]];
+			}
+		});
+		vertices_.swap(vertices);
+		points_.swap(points);
+	}
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_POINT_INDEX_CPP_))
+extern template CGOGN_GEOMETRY_API class PointIndex<Eigen::Vector3f, CMap2<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class PointIndex<Eigen::Vector3d, CMap2<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class PointIndex<Eigen::Vector3f, CMap3<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class PointIndex<Eigen::Vector3d, CMap3<DefaultMapTraits>>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_POINT_INDEX_CPP_))
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_POINT_INDEX_H_
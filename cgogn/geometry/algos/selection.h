@@ -24,6 +24,13 @@
 #ifndef CGOGN_GEOMETRY_ALGOS_SELECTION_H_
 #define CGOGN_GEOMETRY_ALGOS_SELECTION_H_
 
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/unique_ptr.h>
+#include <cgogn/core/utils/masks.h>
 #include <cgogn/core/cmap/cmap3.h>
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/geometry/algos/area.h>
@@ -36,6 +43,121 @@ namespace cgogn
 namespace geometry
 {
 
+namespace internal
+{
+
+/**
+ * @brief set of uint32 indices with a cost proportional to its size
+ * (open addressing hash table, only the used slots are reset by clear)
+ */
+class SparseIndexSet
+{
+public:
+
+	inline SparseIndexSet() : mask_(0u)
+	{
+		resize(64u);
+	}
+
+	/**
+	 * @brief insert an index
+	 * @return true if the index was not already in the set
+	 */
+	inline bool insert(uint32 index)
+	{
+		if (2u * (used_.size() + 1u) > slots_.size())
+			resize(2u * uint32(slots_.size()));
+		uint32 s = hash(index) & mask_;
+		while (slots_[s] != EMPTY)
+		{
+			if (slots_[s] == index)
+				return false;
+			s = (s + 1u) & mask_;
+		}
+		slots_[s] = index;
+		used_.push_back(s);
+		return true;
+	}
+
+	inline bool contains(uint32 index) const
+	{
+		uint32 s = hash(index) & mask_;
+		while (slots_[s] != EMPTY)
+		{
+			if (slots_[s] == index)
+				return true;
+			s = (s + 1u) & mask_;
+		}
+		return false;
+	}
+
+	inline void clear()
+	{
+		for (uint32 s : used_)
+			slots_[s] = EMPTY;
+		used_.clear();
+	}
+
+	inline std::size_t size() const
+	{
+		return used_.size();
+	}
+
+private:
+
+	static const uint32 EMPTY = 0xffffffffu;
+
+	static inline uint32 hash(uint32 index)
+	{
+		return index * 2654435761u;
+	}
+
+	inline void resize(uint32 nb_slots)
+	{
+		std::vector<uint32> old_used;
+		old_used.swap(used_);
+		std::vector<uint32> old_slots(nb_slots, uint32(EMPTY));
+		old_slots.swap(slots_);
+		mask_ = nb_slots - 1u;
+		used_.reserve(nb_slots / 2u);
+		for (uint32 s : old_used)
+			insert(old_slots[s]);
+	}
+
+	std::vector<uint32> slots_;
+	std::vector<uint32> used_;
+	uint32 mask_;
+};
+
+/**
+ * Dart marker owned by a single user (e.g. one collector per thread) whose memory and clearing cost
+ * are proportional to the number of marked darts, not to the size of the map.
+ */
+class SparseDartMarker
+{
+public:
+
+	inline void mark(Dart d)
+	{
+		marked_.insert(d.index);
+	}
+
+	inline bool is_marked(Dart d) const
+	{
+		return marked_.contains(d.index);
+	}
+
+	inline void unmark_all()
+	{
+		marked_.clear();
+	}
+
+private:
+
+	SparseIndexSet marked_;
+};
+
+} // namespace internal
 
 template <typename VEC3>
 class CollectorGen
@@ -77,15 +199,12 @@ public:
 	}
 	virtual ~CollectorGen() {}
 
+	// the capacity of the vectors is kept from one collect to the next
 	void clear()
 	{
 		for (auto& cells_vector : this->cells_)
-		{
 			cells_vector.clear();
-			cells_vector.reserve(256u);
-		}
 		this->border_.clear();
-		this->border_.reserve(256u);
 	}
 
 	virtual Scalar area(const MapBaseData<DefaultMapTraits>::Attribute_T<VEC3>& position) const = 0;
@@ -199,15 +318,73 @@ public:
 		position_(position)
 	{}
 
+	inline Scalar radius() const
+	{
+		return radius_;
+	}
+
 	void collect(const Vertex center) override
+	{
+		marker_.unmark_all();
+		collect(center, marker_);
+	}
+
+	/**
+	 * @brief collect with a DartMarkerStore of the map instead of the sparse marker of the collector
+	 * (same result, the marker of the collector keeps no memory)
+	 */
+	void collect_once(const Vertex center)
+	{
+		typename MAP::DartMarkerStore dm(this->map_);
+		collect(center, dm);
+	}
+
+	Scalar area(const typename MAP::template VertexAttribute<VEC3>& position) const override
+	{
+		Scalar result = 0;
+		const VEC3& center_position = position[this->center_];
+		for (Dart d : this->cells_[Face::ORBIT])
+		{
+			if (!this->map_.is_boundary(d))
+				result += geometry::area<VEC3>(this->map_, Face(d), position);
+		}
+		// TODO: the following works only for triangle meshes
+		for (Dart d : this->border_)
+		{
+			// the boundary faces have no area
+			if (this->map_.is_boundary(d))
+				continue;
+			// Vertex(d) is inside
+			const Dart f = this->map_.phi1(d); // Vertex(f) is outside
+			const Dart g = this->map_.phi1(f);
+			if (geometry::in_sphere(position[Vertex(g)], center_position, radius_)) // Vertex(g) is inside
+			{
+				Scalar alpha, beta;
+				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(d)], position[Vertex(f)], alpha);
+				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(g)], position[Vertex(f)], beta);
+				result += (alpha+beta - alpha*beta) * geometry::area<VEC3>(this->map_, Face(d), position);
+			}
+			else // Vertex(g) is outside
+			{
+				Scalar alpha, beta;
+				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(d)], position[Vertex(f)], alpha);
+				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(d)], position[Vertex(g)], beta);
+				result += alpha * beta * geometry::area<VEC3>(this->map_, Face(d), position);
+			}
+		}
+		return result;
+	}
+
+protected:
+
+	template <typename MARKER>
+	void collect(const Vertex center, MARKER& dm)
 	{
 		this->clear();
 		this->center_ = center.dart;
 
 		const VEC3& center_position = position_[center];
 
-		typename MAP::DartMarkerStore dm(this->map_);
-
 		auto mark_vertex = [&] (Vertex v)
 		{
 			this->map_.foreach_dart_of_orbit(v, [&] (Dart d)
@@ -278,42 +455,68 @@ public:
 		}
 	}
 
-	Scalar area(const typename MAP::template VertexAttribute<VEC3>& position) const override
+	Scalar radius_;
+	const typename MAP::template VertexAttribute<VEC3>& position_;
+	internal::SparseDartMarker marker_;
+};
+
+/**
+ * Pool of collectors, one per thread, that keep their buffers and markers from one collect to the next.
+ * collector(th) is the collector of the thread of index th given by parallel_foreach_cell,
+ * parallel_collect collects the neighborhood of each vertex of the map in parallel.
+ */
+template <typename COLLECTOR>
+class CollectorPool
+{
+public:
+
+	using Self = CollectorPool<COLLECTOR>;
+
+	/**
+	 * @param args the parameters of the constructor of the collectors
+	 */
+	template <typename... Args>
+	explicit CollectorPool(const Args&... args)
 	{
-		Scalar result = 0;
-		const VEC3& center_position = position[this->center_];
-		for (Dart d : this->cells_[Face::ORBIT])
-		{
-			result += geometry::area<VEC3>(this->map_, Face(d), position);
-		}
-		// TODO: the following works only for triangle meshes
-		for (Dart d : this->border_)
+		const uint32 nb = cgogn::nb_threads();
+		collectors_.reserve(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			collectors_.push_back(cgogn::make_unique<COLLECTOR>(args...));
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(CollectorPool);
+
+	inline COLLECTOR& collector(uint32 thread_index)
+	{
+		cgogn_assert(thread_index < collectors_.size());
+		return *collectors_[thread_index];
+	}
+
+	/**
+	 * @brief call f(v, collector) for each vertex v of the map (filtered by mask) after the collect around v
+	 */
+	template <typename MAP, typename MASK, typename FUNC>
+	void parallel_collect(const MAP& map, const MASK& mask, const FUNC& f)
+	{
+		using Vertex = typename MAP::Vertex;
+		map.parallel_foreach_cell([&] (Vertex v, uint32 th)
 		{
-			// Vertex(d) is inside
-			const Dart f = this->map_.phi1(d); // Vertex(f) is outside
-			const Dart g = this->map_.phi1(f);
-			if (geometry::in_sphere(position[Vertex(g)], center_position, radius_)) // Vertex(g) is inside
-			{
-				Scalar alpha, beta;
-				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(d)], position[Vertex(f)], alpha);
-				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(g)], position[Vertex(f)], beta);
-				result += (alpha+beta - alpha*beta) * geometry::area<VEC3>(this->map_, Face(d), position);
-			}
-			else // Vertex(g) is outside
-			{
-				Scalar alpha, beta;
-				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(d)], position[Vertex(f)], alpha);
-				geometry::intersection_sphere_segment<VEC3>(center_position, radius_, position[Vertex(d)], position[Vertex(g)], beta);
-				result += alpha * beta * geometry::area<VEC3>(this->map_, Face(d), position);
-			}
-		}
-		return result;
+			COLLECTOR& c = *collectors_[th];
+			c.collect(v);
+			f(v, static_cast<const COLLECTOR&>(c));
+		},
+		mask);
 	}
 
-protected:
+	template <typename MAP, typename FUNC>
+	inline void parallel_collect(const MAP& map, const FUNC& f)
+	{
+		parallel_collect(map, CellFilters(), f);
+	}
 
-	Scalar radius_;
-	const typename MAP::template VertexAttribute<VEC3>& position_;
+private:
+
+	std::vector<std::unique_ptr<COLLECTOR>> collectors_;
 };
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_SELECTION_CPP_))
@@ -0,0 +1,242 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_SURFACE_GEOMETRY_H_
+#define CGOGN_GEOMETRY_ALGOS_SURFACE_GEOMETRY_H_
+
+#include <vector>
+#include <cmath>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/basic/cell.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/geometry/functions/basics.h>
+#include <cgogn/geometry/algos/area.h>
+#include <cgogn/geometry/algos/normal.h>
+#include <cgogn/geometry/algos/angle.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+namespace internal
+{
+
+/**
+ * @brief batch of triangles stored as structure of arrays,
+ * the normals and areas of the batch are computed by a branchless loop the compiler can vectorize
+ */
+template <typename VEC3>
+class TriangleBatch
+{
+public:
+
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Face2 = Cell<Orbit::PHI1>;
+
+	static const uint32 SIZE = 32u;
+
+	TriangleBatch() : size_(0u)
+	{
+		for (uint32 k = 0u; k < 9u; ++k)
+			for (uint32 i = 0u; i < SIZE; ++i)
+				coords_[k][i] = Scalar(0);
+	}
+
+	inline bool full() const { return size_ == SIZE; }
+
+	inline void push(Face2 f, const VEC3& a, const VEC3& b, const VEC3& c)
+	{
+		for (uint32 k = 0u; k < 3u; ++k)
+		{
+			coords_[k][size_] = a[k];
+			coords_[3u + k][size_] = b[k];
+			coords_[6u + k][size_] = c[k];
+		}
+		faces_[size_++] = f;
+	}
+
+	/**
+	 * @brief compute the normals and areas of the triangles of the batch, store them and empty the batch
+	 */
+	template <typename FN_ATTR, typename FA_ATTR>
+	void flush(FN_ATTR& face_normal, FA_ATTR& face_area)
+	{
+		const Scalar* ax = coords_[0]; const Scalar* ay = coords_[1]; const Scalar* az = coords_[2];
+		const Scalar* bx = coords_[3]; const Scalar* by = coords_[4]; const Scalar* bz = coords_[5];
+		const Scalar* cx = coords_[6]; const Scalar* cy = coords_[7]; const Scalar* cz = coords_[8];
+
+		// the whole batch is processed (unused slots hold degenerate triangles) to keep a fixed trip count
+		for (uint32 i = 0u; i < SIZE; ++i)
+		{
+			const Scalar ux = bx[i] - ax[i], uy = by[i] - ay[i], uz = bz[i] - az[i];
+			const Scalar vx = cx[i] - ax[i], vy = cy[i] - ay[i], vz = cz[i] - az[i];
+			const Scalar nx = uy * vz - uz * vy;
+			const Scalar ny = uz * vx - ux * vz;
+			const Scalar nz = ux * vy - uy * vx;
+			const Scalar l = std::sqrt(nx * nx + ny * ny + nz * nz);
+			const Scalar inv = l > Scalar(0) ? l : Scalar(1);
+			nx_[i] = nx / inv;
+			ny_[i] = ny / inv;
+			nz_[i] = nz / inv;
+			area_[i] = Scalar(0.5) * l;
+		}
+
+		for (uint32 i = 0u; i < size_; ++i)
+		{
+			VEC3& n = face_normal[faces_[i]];
+			n[0] = nx_[i];
+			n[1] = ny_[i];
+			n[2] = nz_[i];
+			face_area[faces_[i]] = area_[i];
+		}
+		size_ = 0u;
+	}
+
+private:
+
+	Scalar coords_[9][SIZE];
+	Scalar nx_[SIZE], ny_[SIZE], nz_[SIZE], area_[SIZE];
+	Face2 faces_[SIZE];
+	uint32 size_;
+};
+
+} // namespace internal
+
+/**
+ * @brief compute in two parallel sweeps the normals and areas of the faces,
+ * and the lengths and dihedral angles of the edges and the normals of the vertices.
+ * The results are the ones of compute_normal, compute_area, compute_length and compute_angle_between_face_normals.
+ * The face normals and areas of triangles are computed by batches (see internal::TriangleBatch).
+ * The edge and vertex attributes are optional : an invalid attribute is not computed.
+ */
+template <typename VEC3, typename MAP>
+void compute_surface_geometry(
+	const MAP& map,
+	const typename MAP::template VertexAttribute<VEC3>& position,
+	typename MAP::template Attribute<VEC3, Orbit::PHI1>& face_normal,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI1>& face_area,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_length,
+	typename MAP::template Attribute<typename vector_traits<VEC3>::Scalar, Orbit::PHI2>& edge_angle,
+	typename MAP::template Attribute<VEC3, Orbit::PHI21>& vertex_normal
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex2 = Cell<Orbit::PHI21>;
+	using Edge2 = Cell<Orbit::PHI2>;
+	using Face2 = Cell<Orbit::PHI1>;
+	using Vertex = typename MAP::Vertex;
+
+	cgogn_message_assert(face_normal.is_valid() && face_area.is_valid(), "compute_surface_geometry: invalid face attribute");
+
+	// faces : triangles are batched per thread, other faces are computed directly
+	std::vector<internal::TriangleBatch<VEC3>> batches(cgogn::nb_threads());
+
+	map.parallel_foreach_cell([&] (Face2 f, uint32 th)
+	{
+		if (map.codegree(f) == 3)
+		{
+			internal::TriangleBatch<VEC3>& batch = batches[th];
+			batch.push(f,
+				position[Vertex(f.dart)],
+				position[Vertex(map.phi1(f.dart))],
+				position[Vertex(map.phi_1(f.dart))]
+			);
+			if (batch.full())
+				batch.flush(face_normal, face_area);
+		}
+		else
+		{
+			face_normal[f] = normal<VEC3>(map, f, position);
+			face_area[f] = convex_area<VEC3>(map, f, position);
+		}
+	});
+
+	for (internal::TriangleBatch<VEC3>& batch : batches)
+		batch.flush(face_normal, face_area);
+
+	const bool compute_edge_length = edge_length.is_valid();
+	const bool compute_edge_angle = edge_angle.is_valid();
+	const bool compute_vertex_normal = vertex_normal.is_valid();
+	if (!compute_edge_length && !compute_edge_angle && !compute_vertex_normal)
+		return;
+
+	// vertices : each edge is computed from its dart of smallest index
+	map.parallel_foreach_cell([&] (Vertex2 v, uint32)
+	{
+		const VEC3& p = position[v];
+		VEC3 n;
+		n.setZero();
+
+		map.foreach_dart_of_orbit(v, [&] (Dart d)
+		{
+			const bool boundary = map.is_boundary(d);
+
+			if (compute_vertex_normal && !boundary)
+			{
+				VEC3 facen = face_normal[Face2(d)];
+				const VEC3& p1 = position[Vertex(map.phi1(d))];
+				const VEC3& p2 = position[Vertex(map.phi_1(d))];
+				const Scalar l = (p1-p).squaredNorm() * (p2-p).squaredNorm();
+				if (l != Scalar(0))
+					facen *= face_area[Face2(d)] / l;
+				n += facen;
+			}
+
+			const Dart d2 = map.phi2(d);
+			if (d.index < d2.index)
+			{
+				VEC3 edge = position[Vertex(d2)] - p;
+				const Scalar length = edge.norm();
+				if (compute_edge_length)
+					edge_length[Edge2(d)] = length;
+				if (compute_edge_angle)
+				{
+					if (boundary || map.is_boundary(d2))
+						edge_angle[Edge2(d)] = Scalar(0);
+					else
+					{
+						if (length > Scalar(0))
+							edge /= length;
+						edge_angle[Edge2(d)] = angle_between_normals<VEC3>(face_normal[Face2(d)], face_normal[Face2(d2)], edge);
+					}
+				}
+			}
+		});
+
+		if (compute_vertex_normal)
+		{
+			normalize_safe(n);
+			vertex_normal[v] = n;
+		}
+	});
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_SURFACE_GEOMETRY_H_
@@ -0,0 +1,260 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_TRIANGLE_SOUP_H_
+#define CGOGN_GEOMETRY_ALGOS_TRIANGLE_SOUP_H_
+
+#include <vector>
+#include <array>
+#include <limits>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/geometry_traits.h>
+#include <cgogn/geometry/functions/intersection_packet.h>
+#include <cgogn/geometry/algos/ear_triangulation.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * Snapshot of the faces of a map as a soup of triangles stored in packets (structure of arrays of float32)
+ * for the packet ray / triangle kernels of intersection_packet.h.
+ * Faces are triangulated once (ear triangulation for non triangular faces).
+ * The topology of the map must not change while the soup is used, but the positions can:
+ * update() copies the current positions in the packets.
+ * The queries test all the triangles (use a BVH for large meshes and few rays).
+ */
+template <typename VEC3, typename MAP>
+class TriangleSoup
+{
+public:
+
+	using Self = TriangleSoup<VEC3, MAP>;
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+	using VertexAttribute = typename MAP::template VertexAttribute<VEC3>;
+
+	static const uint32 PACKET_SIZE = 8u;
+	static const uint32 RAY_PACKET_SIZE = 8u;
+	using Packet = TrianglePacket<PACKET_SIZE>;
+	using Rays = RayPacket<RAY_PACKET_SIZE>;
+
+private:
+
+	const MAP& map_;
+	VertexAttribute position_;
+
+	std::vector<Face> faces_; // face of each triangle
+	std::vector<std::array<uint32, 3>> triangles_; // embeddings of the vertices of each triangle
+	std::vector<Packet> packets_;
+
+public:
+
+	TriangleSoup(const MAP& map, const VertexAttribute& position) :
+		map_(map),
+		position_(position)
+	{
+		build();
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(TriangleSoup);
+
+	inline uint32 nb_triangles() const { return uint32(triangles_.size()); }
+	inline const std::vector<Packet>& packets() const { return packets_; }
+	inline Face face(uint32 triangle) const { return faces_[triangle]; }
+
+	/**
+	 * @brief (re)build the soup from the current faces of the map
+	 */
+	void build()
+	{
+		Triangulator<VEC3, MAP> triangulator(map_, position_);
+		std::vector<uint32> indices;
+		triangulator.parallel_triangulate(indices);
+
+		const uint32 nb = uint32(indices.size() / 3u);
+		triangles_.resize(nb);
+		faces_.resize(nb);
+
+		const std::vector<Face>& faces = triangulator.faces();
+		const std::vector<uint32>& offsets = triangulator.offsets();
+		parallel_foreach_range(uint32(faces.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				for (uint32 j = offsets[i]; j < offsets[i + 1u]; j += 3u)
+				{
+					faces_[j / 3u] = faces[i];
+					triangles_[j / 3u] = {{indices[j], indices[j + 1u], indices[j + 2u]}};
+				}
+			}
+		});
+
+		packets_.resize((nb + PACKET_SIZE - 1u) / PACKET_SIZE);
+		update();
+	}
+
+	/**
+	 * @brief copy the current positions of the vertices in the packets
+	 */
+	void update()
+	{
+		const uint32 nb = nb_triangles();
+		parallel_foreach_range(uint32(packets_.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 p = begin; p < end; ++p)
+			{
+				Packet& packet = packets_[p];
+				packet.clear();
+				for (uint32 i = 0u, t = p * PACKET_SIZE; i < PACKET_SIZE && t < nb; ++i, ++t)
+				{
+					const std::array<uint32, 3>& tri = triangles_[t];
+					packet.set(i, position_[tri[0]], position_[tri[1]], position_[tri[2]]);
+				}
+			}
+		});
+	}
+
+	/**
+	 * @brief closest intersection of the ray (A, dir) with the faces
+	 * @param f the intersected face
+	 * @param t distance of the intersection (in units of |dir|) : the intersection point is A + t * dir
+	 * @return true if the ray intersects a face
+	 */
+	bool intersect(const VEC3& A, const VEC3& dir, Face& f, Scalar& t) const
+	{
+		float32 best = std::numeric_limits<float32>::infinity();
+		uint32 best_triangle = std::numeric_limits<uint32>::max();
+		float32 pt[PACKET_SIZE], pu[PACKET_SIZE], pv[PACKET_SIZE];
+		for (uint32 p = 0u, end = uint32(packets_.size()); p < end; ++p)
+		{
+			uint32 mask = intersection_ray_triangles(A, dir, packets_[p], best, pt, pu, pv);
+			for (uint32 i = 0u; mask != 0u; ++i, mask >>= 1u)
+			{
+				if ((mask & 1u) && pt[i] < best)
+				{
+					best = pt[i];
+					best_triangle = p * PACKET_SIZE + i;
+				}
+			}
+		}
+		if (best_triangle == std::numeric_limits<uint32>::max())
+			return false;
+		f = faces_[best_triangle];
+		t = Scalar(best);
+		return true;
+	}
+
+	/**
+	 * @brief test if a face is intersected by the ray (A, dir) at a distance lower than t_max (in units of |dir|)
+	 * (e.g. visibility or ambient occlusion rays)
+	 */
+	bool occluded(const VEC3& A, const VEC3& dir, Scalar t_max = std::numeric_limits<Scalar>::max()) const
+	{
+		const float32 tm = float32(std::min(t_max, Scalar(std::numeric_limits<float32>::max())));
+		float32 pt[PACKET_SIZE], pu[PACKET_SIZE], pv[PACKET_SIZE];
+		for (const Packet& packet : packets_)
+			if (intersection_ray_triangles(A, dir, packet, tm, pt, pu, pv) != 0u)
+				return true;
+		return false;
+	}
+
+	/**
+	 * @brief closest intersections of a set of rays with the faces, computed in parallel by packets of rays
+	 * @param origins origins of the rays
+	 * @param dirs directions of the rays
+	 * @param faces the intersected faces (a face with a nil dart if the ray does not intersect any face)
+	 * @param t distances of the intersections (infinity if the ray does not intersect any face)
+	 */
+	void intersect(const std::vector<VEC3>& origins, const std::vector<VEC3>& dirs, std::vector<Face>& faces, std::vector<Scalar>& t) const
+	{
+		cgogn_message_assert(origins.size() == dirs.size(), "TriangleSoup::intersect: different numbers of origins and directions");
+
+		const uint32 nb_rays = uint32(origins.size());
+		faces.assign(nb_rays, Face());
+		t.assign(nb_rays, std::numeric_limits<Scalar>::infinity());
+
+		const uint32 nb_packets = (nb_rays + RAY_PACKET_SIZE - 1u) / RAY_PACKET_SIZE;
+		parallel_foreach_range(nb_packets, [&] (uint32, uint32 begin, uint32 end)
+		{
+			Rays rays;
+			float32 best[RAY_PACKET_SIZE], pt[RAY_PACKET_SIZE], pu[RAY_PACKET_SIZE], pv[RAY_PACKET_SIZE];
+			uint32 best_triangle[RAY_PACKET_SIZE];
+			for (uint32 p = begin; p < end; ++p)
+			{
+				const uint32 first = p * RAY_PACKET_SIZE;
+				const uint32 nb = std::min(uint32(RAY_PACKET_SIZE), nb_rays - first);
+				for (uint32 i = 0u; i < RAY_PACKET_SIZE; ++i)
+				{
+					// unused lanes duplicate the first ray
+					const uint32 r = first + (i < nb ? i : 0u);
+					rays.set(i, origins[r], dirs[r]);
+					best[i] = std::numeric_limits<float32>::infinity();
+					best_triangle[i] = std::numeric_limits<uint32>::max();
+				}
+
+				for (uint32 tr = 0u, nb_tri = nb_triangles(); tr < nb_tri; ++tr)
+				{
+					uint32 mask = intersection_rays_triangle(rays, packets_[tr / PACKET_SIZE], tr % PACKET_SIZE, best, pt, pu, pv);
+					for (uint32 i = 0u; mask != 0u; ++i, mask >>= 1u)
+					{
+						if (mask & 1u)
+						{
+							best[i] = pt[i];
+							best_triangle[i] = tr;
+						}
+					}
+				}
+
+				for (uint32 i = 0u; i < nb; ++i)
+				{
+					if (best_triangle[i] != std::numeric_limits<uint32>::max())
+					{
+						faces[first + i] = faces_[best_triangle[i]];
+						t[first + i] = Scalar(best[i]);
+					}
+				}
+			}
+		});
+	}
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_TRIANGLE_SOUP_CPP_))
+extern template CGOGN_GEOMETRY_API class TriangleSoup<Eigen::Vector3f, CMap2<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class TriangleSoup<Eigen::Vector3d, CMap2<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class TriangleSoup<Eigen::Vector3f, CMap3<DefaultMapTraits>>;
+extern template CGOGN_GEOMETRY_API class TriangleSoup<Eigen::Vector3d, CMap3<DefaultMapTraits>>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_ALGOS_TRIANGLE_SOUP_CPP_))
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_TRIANGLE_SOUP_H_
@@ -131,6 +131,58 @@ typename vector_traits<VEC3>::Scalar squared_distance_line_seg(const VEC3& A, co
 	return squared_distance_line_seg(A,AB, AB.dot(AB),P,Q);
 }
 
+/**
+* compute the point of a triangle that is the closest to a given point
+* (classification of P in the Voronoi regions of the vertices, edges and face of the triangle)
+* @param P the point
+* @param A first point of triangle
+* @param B second point of triangle
+* @param C third point of triangle
+* @return the closest point
+*/
+template <typename VEC3>
+VEC3 closest_point_in_triangle(const VEC3& P, const VEC3& A, const VEC3& B, const VEC3& C)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	const VEC3 AB = B - A;
+	const VEC3 AC = C - A;
+
+	const VEC3 AP = P - A;
+	const Scalar d1 = AB.dot(AP);
+	const Scalar d2 = AC.dot(AP);
+	if (d1 <= Scalar(0) && d2 <= Scalar(0))
+		return A;
+
+	const VEC3 BP = P - B;
+	const Scalar d3 = AB.dot(BP);
+	const Scalar d4 = AC.dot(BP);
+	if (d3 >= Scalar(0) && d4 <= d3)
+		return B;
+
+	const Scalar vc = d1 * d4 - d3 * d2;
+	if (vc <= Scalar(0) && d1 >= Scalar(0) && d3 <= Scalar(0))
+		return A + AB * (d1 / (d1 - d3));
+
+	const VEC3 CP = P - C;
+	const Scalar d5 = AB.dot(CP);
+	const Scalar d6 = AC.dot(CP);
+	if (d6 >= Scalar(0) && d5 <= d6)
+		return C;
+
+	const Scalar vb = d5 * d2 - d1 * d6;
+	if (vb <= Scalar(0) && d2 >= Scalar(0) && d6 <= Scalar(0))
+		return A + AC * (d2 / (d2 - d6));
+
+	const Scalar va = d3 * d6 - d5 * d4;
+	if (va <= Scalar(0) && (d4 - d3) >= Scalar(0) && (d5 - d6) >= Scalar(0))
+		return B + (C - B) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	// P projects inside the triangle
+	const Scalar denom = Scalar(1) / (va + vb + vc);
+	return A + AB * (vb * denom) + AC * (vc * denom);
+}
+
 
 
 } // namespace geometry
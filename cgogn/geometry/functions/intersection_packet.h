@@ -0,0 +1,346 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_FUNCTIONS_INTERSECTION_PACKET_H_
+#define CGOGN_GEOMETRY_FUNCTIONS_INTERSECTION_PACKET_H_
+
+#include <limits>
+
+#include <cgogn/core/utils/numerics.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CGOGN_SIMD_AVX
+#endif
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CGOGN_SIMD_SSE
+#endif
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+namespace internal
+{
+
+/**
+ * @brief W lanes of float32 with the operations of the ray triangle kernels
+ * (W = 8 with AVX, W = 4 with SSE, W = 1 is the scalar fallback)
+ */
+template <uint32 W>
+struct FloatLanes;
+
+template <>
+struct FloatLanes<1u>
+{
+	float32 v;
+
+	static inline FloatLanes load(const float32* p) { return {*p}; }
+	static inline FloatLanes set(float32 x) { return {x}; }
+	inline void store(float32* p) const { *p = v; }
+
+	friend inline FloatLanes operator+(FloatLanes a, FloatLanes b) { return {a.v + b.v}; }
+	friend inline FloatLanes operator-(FloatLanes a, FloatLanes b) { return {a.v - b.v}; }
+	friend inline FloatLanes operator*(FloatLanes a, FloatLanes b) { return {a.v * b.v}; }
+	friend inline FloatLanes operator/(FloatLanes a, FloatLanes b) { return {a.v / b.v}; }
+
+	// comparisons return lane masks (bit i set if true in lane i)
+	friend inline uint32 operator>=(FloatLanes a, FloatLanes b) { return a.v >= b.v ? 1u : 0u; }
+	friend inline uint32 operator<(FloatLanes a, FloatLanes b) { return a.v < b.v ? 1u : 0u; }
+	friend inline uint32 operator!=(FloatLanes a, FloatLanes b) { return a.v != b.v ? 1u : 0u; }
+};
+
+#if defined(CGOGN_SIMD_SSE)
+template <>
+struct FloatLanes<4u>
+{
+	__m128 v;
+
+	static inline FloatLanes load(const float32* p) { return {_mm_loadu_ps(p)}; }
+	static inline FloatLanes set(float32 x) { return {_mm_set1_ps(x)}; }
+	inline void store(float32* p) const { _mm_storeu_ps(p, v); }
+
+	friend inline FloatLanes operator+(FloatLanes a, FloatLanes b) { return {_mm_add_ps(a.v, b.v)}; }
+	friend inline FloatLanes operator-(FloatLanes a, FloatLanes b) { return {_mm_sub_ps(a.v, b.v)}; }
+	friend inline FloatLanes operator*(FloatLanes a, FloatLanes b) { return {_mm_mul_ps(a.v, b.v)}; }
+	friend inline FloatLanes operator/(FloatLanes a, FloatLanes b) { return {_mm_div_ps(a.v, b.v)}; }
+
+	friend inline uint32 operator>=(FloatLanes a, FloatLanes b) { return uint32(_mm_movemask_ps(_mm_cmpge_ps(a.v, b.v))); }
+	friend inline uint32 operator<(FloatLanes a, FloatLanes b) { return uint32(_mm_movemask_ps(_mm_cmplt_ps(a.v, b.v))); }
+	friend inline uint32 operator!=(FloatLanes a, FloatLanes b) { return uint32(_mm_movemask_ps(_mm_cmpneq_ps(a.v, b.v))); }
+};
+#endif // CGOGN_SIMD_SSE
+
+#if defined(CGOGN_SIMD_AVX)
+template <>
+struct FloatLanes<8u>
+{
+	__m256 v;
+
+	static inline FloatLanes load(const float32* p) { return {_mm256_loadu_ps(p)}; }
+	static inline FloatLanes set(float32 x) { return {_mm256_set1_ps(x)}; }
+	inline void store(float32* p) const { _mm256_storeu_ps(p, v); }
+
+	friend inline FloatLanes operator+(FloatLanes a, FloatLanes b) { return {_mm256_add_ps(a.v, b.v)}; }
+	friend inline FloatLanes operator-(FloatLanes a, FloatLanes b) { return {_mm256_sub_ps(a.v, b.v)}; }
+	friend inline FloatLanes operator*(FloatLanes a, FloatLanes b) { return {_mm256_mul_ps(a.v, b.v)}; }
+	friend inline FloatLanes operator/(FloatLanes a, FloatLanes b) { return {_mm256_div_ps(a.v, b.v)}; }
+
+	friend inline uint32 operator>=(FloatLanes a, FloatLanes b) { return uint32(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ))); }
+	friend inline uint32 operator<(FloatLanes a, FloatLanes b) { return uint32(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ))); }
+	friend inline uint32 operator!=(FloatLanes a, FloatLanes b) { return uint32(_mm256_movemask_ps(_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ))); }
+};
+#endif // CGOGN_SIMD_AVX
+
+/**
+ * @brief widest available number of lanes for packets of N elements
+ */
+template <uint32 N>
+struct NativeLanes
+{
+#if defined(CGOGN_SIMD_AVX)
+	static const uint32 value = N % 8u == 0u ? 8u : (N % 4u == 0u ? 4u : 1u);
+#elif defined(CGOGN_SIMD_SSE)
+	static const uint32 value = N % 4u == 0u ? 4u : 1u;
+#else
+	static const uint32 value = 1u;
+#endif
+};
+
+/**
+ * @brief Moller-Trumbore test of W ray/triangle pairs (no backface culling)
+ * @return mask of the lanes where the ray hits the triangle at a distance in [0, t_max)
+ */
+template <uint32 W>
+inline uint32 intersect_lanes(
+	FloatLanes<W> ox, FloatLanes<W> oy, FloatLanes<W> oz,
+	FloatLanes<W> dx, FloatLanes<W> dy, FloatLanes<W> dz,
+	FloatLanes<W> ax, FloatLanes<W> ay, FloatLanes<W> az,
+	FloatLanes<W> e1x, FloatLanes<W> e1y, FloatLanes<W> e1z,
+	FloatLanes<W> e2x, FloatLanes<W> e2y, FloatLanes<W> e2z,
+	FloatLanes<W> t_max,
+	FloatLanes<W>& t, FloatLanes<W>& u, FloatLanes<W>& v
+)
+{
+	using F = FloatLanes<W>;
+
+	const F px = dy * e2z - dz * e2y;
+	const F py = dz * e2x - dx * e2z;
+	const F pz = dx * e2y - dy * e2x;
+	const F det = e1x * px + e1y * py + e1z * pz;
+	const F inv_det = F::set(1.0f) / det;
+
+	const F sx = ox - ax;
+	const F sy = oy - ay;
+	const F sz = oz - az;
+	u = (sx * px + sy * py + sz * pz) * inv_det;
+
+	const F qx = sy * e1z - sz * e1y;
+	const F qy = sz * e1x - sx * e1z;
+	const F qz = sx * e1y - sy * e1x;
+	v = (dx * qx + dy * qy + dz * qz) * inv_det;
+	t = (e2x * qx + e2y * qy + e2z * qz) * inv_det;
+
+	// NaN lanes (det = 0) fail the ordered comparisons
+	const F zero = F::set(0.0f);
+	return (det != zero) & (u >= zero) & (v >= zero) & (F::set(1.0f) >= u + v) & (t >= zero) & (t < t_max);
+}
+
+} // namespace internal
+
+/**
+ * @brief N triangles stored as structure of arrays : first vertex A and edges E1 = B - A, E2 = C - A
+ * (unused slots must be degenerate, e.g. null edges, so that they are never hit)
+ */
+template <uint32 N>
+struct TrianglePacket
+{
+	static_assert(N > 0u && N <= 32u, "TrianglePacket: N must be in [1, 32]");
+	static const uint32 SIZE = N;
+
+	float32 ax[N], ay[N], az[N];
+	float32 e1x[N], e1y[N], e1z[N];
+	float32 e2x[N], e2y[N], e2z[N];
+
+	inline void clear()
+	{
+		for (uint32 i = 0u; i < N; ++i)
+			ax[i] = ay[i] = az[i] = e1x[i] = e1y[i] = e1z[i] = e2x[i] = e2y[i] = e2z[i] = 0.0f;
+	}
+
+	template <typename VEC3>
+	inline void set(uint32 i, const VEC3& A, const VEC3& B, const VEC3& C)
+	{
+		ax[i] = float32(A[0]); ay[i] = float32(A[1]); az[i] = float32(A[2]);
+		e1x[i] = float32(B[0] - A[0]); e1y[i] = float32(B[1] - A[1]); e1z[i] = float32(B[2] - A[2]);
+		e2x[i] = float32(C[0] - A[0]); e2y[i] = float32(C[1] - A[1]); e2z[i] = float32(C[2] - A[2]);
+	}
+};
+
+/**
+ * @brief N rays stored as structure of arrays : origins O and directions D
+ */
+template <uint32 N>
+struct RayPacket
+{
+	static_assert(N > 0u && N <= 32u, "RayPacket: N must be in [1, 32]");
+	static const uint32 SIZE = N;
+
+	float32 ox[N], oy[N], oz[N];
+	float32 dx[N], dy[N], dz[N];
+
+	template <typename VEC3>
+	inline void set(uint32 i, const VEC3& O, const VEC3& D)
+	{
+		ox[i] = float32(O[0]); oy[i] = float32(O[1]); oz[i] = float32(O[2]);
+		dx[i] = float32(D[0]); dy[i] = float32(D[1]); dz[i] = float32(D[2]);
+	}
+};
+
+/**
+ * @brief intersection of one ray with the N triangles of a packet
+ * @param O origin of the ray
+ * @param D direction of the ray (the distances are in units of |D|)
+ * @param t_max only the hits at a distance t in [0, t_max) are reported
+ * @param t distance of the hits (for the lanes of the returned mask)
+ * @param u barycentric coordinate of B of the hits
+ * @param v barycentric coordinate of C of the hits
+ * @return mask of the hit triangles (bit i for triangle i)
+ */
+template <uint32 N, uint32 W = internal::NativeLanes<N>::value, typename VEC3>
+uint32 intersection_ray_triangles(
+	const VEC3& O, const VEC3& D,
+	const TrianglePacket<N>& tris,
+	float32 t_max,
+	float32* t, float32* u, float32* v
+)
+{
+	static_assert(N % W == 0u, "intersection_ray_triangles: N must be a multiple of W");
+	using F = internal::FloatLanes<W>;
+
+	const F ox = F::set(float32(O[0])), oy = F::set(float32(O[1])), oz = F::set(float32(O[2]));
+	const F dx = F::set(float32(D[0])), dy = F::set(float32(D[1])), dz = F::set(float32(D[2]));
+	const F tm = F::set(t_max);
+
+	uint32 mask = 0u;
+	for (uint32 i = 0u; i < N; i += W)
+	{
+		F ft, fu, fv;
+		const uint32 m = internal::intersect_lanes<W>(ox, oy, oz, dx, dy, dz,
+			F::load(tris.ax + i), F::load(tris.ay + i), F::load(tris.az + i),
+			F::load(tris.e1x + i), F::load(tris.e1y + i), F::load(tris.e1z + i),
+			F::load(tris.e2x + i), F::load(tris.e2y + i), F::load(tris.e2z + i),
+			tm, ft, fu, fv);
+		ft.store(t + i);
+		fu.store(u + i);
+		fv.store(v + i);
+		mask |= m << i;
+	}
+	return mask;
+}
+
+namespace internal
+{
+
+template <uint32 N, uint32 W>
+uint32 intersection_rays_triangle(
+	const RayPacket<N>& rays,
+	float32 a_x, float32 a_y, float32 a_z,
+	float32 e1_x, float32 e1_y, float32 e1_z,
+	float32 e2_x, float32 e2_y, float32 e2_z,
+	const float32* t_max,
+	float32* t, float32* u, float32* v
+)
+{
+	static_assert(N % W == 0u, "intersection_rays_triangle: N must be a multiple of W");
+	using F = FloatLanes<W>;
+
+	const F ax = F::set(a_x), ay = F::set(a_y), az = F::set(a_z);
+	const F e1x = F::set(e1_x), e1y = F::set(e1_y), e1z = F::set(e1_z);
+	const F e2x = F::set(e2_x), e2y = F::set(e2_y), e2z = F::set(e2_z);
+
+	uint32 mask = 0u;
+	for (uint32 i = 0u; i < N; i += W)
+	{
+		F ft, fu, fv;
+		const uint32 m = intersect_lanes<W>(
+			F::load(rays.ox + i), F::load(rays.oy + i), F::load(rays.oz + i),
+			F::load(rays.dx + i), F::load(rays.dy + i), F::load(rays.dz + i),
+			ax, ay, az, e1x, e1y, e1z, e2x, e2y, e2z,
+			F::load(t_max + i), ft, fu, fv);
+		ft.store(t + i);
+		fu.store(u + i);
+		fv.store(v + i);
+		mask |= m << i;
+	}
+	return mask;
+}
+
+} // namespace internal
+
+/**
+ * @brief intersection of the N rays of a packet with one triangle ABC
+ * @param t_max only the hits at a distance t[i] in [0, t_max[i]) are reported
+ * @return mask of the rays that hit the triangle (bit i for ray i)
+ */
+template <uint32 N, uint32 W = internal::NativeLanes<N>::value, typename VEC3>
+uint32 intersection_rays_triangle(
+	const RayPacket<N>& rays,
+	const VEC3& A, const VEC3& B, const VEC3& C,
+	const float32* t_max,
+	float32* t, float32* u, float32* v
+)
+{
+	return internal::intersection_rays_triangle<N, W>(rays,
+		float32(A[0]), float32(A[1]), float32(A[2]),
+		float32(B[0] - A[0]), float32(B[1] - A[1]), float32(B[2] - A[2]),
+		float32(C[0] - A[0]), float32(C[1] - A[1]), float32(C[2] - A[2]),
+		t_max, t, u, v);
+}
+
+/**
+ * @brief intersection of the N rays of a packet with the triangle number i of a triangle packet
+ */
+template <uint32 N, uint32 W = internal::NativeLanes<N>::value, uint32 M>
+uint32 intersection_rays_triangle(
+	const RayPacket<N>& rays,
+	const TrianglePacket<M>& tris, uint32 i,
+	const float32* t_max,
+	float32* t, float32* u, float32* v
+)
+{
+	return internal::intersection_rays_triangle<N, W>(rays,
+		tris.ax[i], tris.ay[i], tris.az[i],
+		tris.e1x[i], tris.e1y[i], tris.e1z[i],
+		tris.e2x[i], tris.e2y[i], tris.e2z[i],
+		t_max, t, u, v);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_FUNCTIONS_INTERSECTION_PACKET_H_
@@ -0,0 +1,225 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_FUNCTIONS_SYMMETRIC_EIGEN_H_
+#define CGOGN_GEOMETRY_FUNCTIONS_SYMMETRIC_EIGEN_H_
+
+#include <cmath>
+#include <algorithm>
+#include <array>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/geometry/types/eigen.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+namespace internal
+{
+
+// unit vector orthogonal to the rows of A - eigenvalue * I (eigenvector of a simple eigenvalue)
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> eigenvector_simple(const Eigen::Matrix<Scalar, 3, 3>& A, Scalar eigenvalue)
+{
+	using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+
+	const Vec3 r0(A(0,0) - eigenvalue, A(0,1), A(0,2));
+	const Vec3 r1(A(0,1), A(1,1) - eigenvalue, A(1,2));
+	const Vec3 r2(A(0,2), A(1,2), A(2,2) - eigenvalue);
+	const Vec3 r0xr1 = r0.cross(r1);
+	const Vec3 r0xr2 = r0.cross(r2);
+	const Vec3 r1xr2 = r1.cross(r2);
+	const Scalar d0 = r0xr1.squaredNorm();
+	const Scalar d1 = r0xr2.squaredNorm();
+	const Scalar d2 = r1xr2.squaredNorm();
+
+	if (d0 >= d1 && d0 >= d2)
+		return r0xr1 / std::sqrt(d0);
+	if (d1 >= d2)
+		return r0xr2 / std::sqrt(d1);
+	return r1xr2 / std::sqrt(d2);
+}
+
+// unit eigenvector of A for the given eigenvalue, orthogonal to the unit eigenvector w
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> eigenvector_orthogonal(const Eigen::Matrix<Scalar, 3, 3>& A, const Eigen::Matrix<Scalar, 3, 1>& w, Scalar eigenvalue)
+{
+	using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+
+	// orthonormal basis (u,v) of the plane orthogonal to w
+	Vec3 u;
+	if (std::abs(w[0]) > std::abs(w[1]))
+		u = Vec3(-w[2], Scalar(0), w[0]) / std::sqrt(w[0] * w[0] + w[2] * w[2]);
+	else
+		u = Vec3(Scalar(0), w[2], -w[1]) / std::sqrt(w[1] * w[1] + w[2] * w[2]);
+	const Vec3 v = w.cross(u);
+
+	// restriction of A - eigenvalue * I to this plane
+	const Vec3 Au = A * u;
+	const Vec3 Av = A * v;
+	Scalar m00 = u.dot(Au) - eigenvalue;
+	Scalar m01 = u.dot(Av);
+	Scalar m11 = v.dot(Av) - eigenvalue;
+
+	const Scalar abs_m00 = std::abs(m00);
+	const Scalar abs_m01 = std::abs(m01);
+	const Scalar abs_m11 = std::abs(m11);
+	if (abs_m00 >= abs_m11)
+	{
+		if (std::max(abs_m00, abs_m01) > Scalar(0))
+		{
+			if (abs_m00 >= abs_m01)
+			{
+				m01 /= m00;
+				m00 = Scalar(1) / std::sqrt(Scalar(1) + m01 * m01);
+				m01 *= m00;
+			}
+			else
+			{
+				m00 /= m01;
+				m01 = Scalar(1) / std::sqrt(Scalar(1) + m00 * m00);
+				m00 *= m01;
+			}
+			return m01 * u - m00 * v;
+		}
+		return u;
+	}
+	else
+	{
+		if (std::max(abs_m11, abs_m01) > Scalar(0))
+		{
+			if (abs_m11 >= abs_m01)
+			{
+				m01 /= m11;
+				m11 = Scalar(1) / std::sqrt(Scalar(1) + m01 * m01);
+				m01 *= m11;
+			}
+			else
+			{
+				m11 /= m01;
+				m01 = Scalar(1) / std::sqrt(Scalar(1) + m11 * m11);
+				m11 *= m01;
+			}
+			return m11 * u - m01 * v;
+		}
+		return u;
+	}
+}
+
+} // namespace internal
+
+/**
+ * @brief closed form eigen decomposition of a 3x3 symmetric matrix
+ * (trigonometric solution of the characteristic polynomial, D. Eberly, "A Robust Eigensolver for 3x3 Symmetric Matrices")
+ * @param M the symmetric matrix (only the upper triangle is read)
+ * @param eigenvalues the eigenvalues in increasing order
+ * @param eigenvectors the unit eigenvectors (columns, in the order of the eigenvalues)
+ */
+template <typename Scalar>
+void symmetric_eigen_3x3(const Eigen::Matrix<Scalar, 3, 3>& M, Eigen::Matrix<Scalar, 3, 1>& eigenvalues, Eigen::Matrix<Scalar, 3, 3>& eigenvectors)
+{
+	using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+	using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
+
+	// scaling to avoid overflows
+	Scalar max_abs = std::max(std::max(std::abs(M(0,0)), std::abs(M(0,1))), std::max(std::abs(M(0,2)), std::abs(M(1,1))));
+	max_abs = std::max(max_abs, std::max(std::abs(M(1,2)), std::abs(M(2,2))));
+	if (!(max_abs > Scalar(0)))
+	{
+		eigenvalues.setZero();
+		eigenvectors.setIdentity();
+		return;
+	}
+
+	Mat3 A;
+	A(0,0) = M(0,0) / max_abs; A(0,1) = M(0,1) / max_abs; A(0,2) = M(0,2) / max_abs;
+	A(1,1) = M(1,1) / max_abs; A(1,2) = M(1,2) / max_abs;
+	A(2,2) = M(2,2) / max_abs;
+	A(1,0) = A(0,1); A(2,0) = A(0,2); A(2,1) = A(1,2);
+
+	const Scalar norm_offdiag = A(0,1) * A(0,1) + A(0,2) * A(0,2) + A(1,2) * A(1,2);
+	if (!(norm_offdiag > Scalar(0)))
+	{
+		// diagonal matrix
+		std::array<uint32, 3> order{{0u, 1u, 2u}};
+		std::sort(order.begin(), order.end(), [&] (uint32 a, uint32 b) { return A(a,a) < A(b,b); });
+		eigenvectors.setZero();
+		for (uint32 i = 0u; i < 3u; ++i)
+		{
+			eigenvalues[i] = A(order[i], order[i]) * max_abs;
+			eigenvectors(order[i], i) = Scalar(1);
+		}
+		return;
+	}
+
+	// A = q * I + p * B, with B of trace 0 and det(B) / 2 = cos(3 * angle)
+	const Scalar q = (A(0,0) + A(1,1) + A(2,2)) / Scalar(3);
+	const Scalar b00 = A(0,0) - q;
+	const Scalar b11 = A(1,1) - q;
+	const Scalar b22 = A(2,2) - q;
+	const Scalar p = std::sqrt((b00 * b00 + b11 * b11 + b22 * b22 + Scalar(2) * norm_offdiag) / Scalar(6));
+	const Scalar c00 = b11 * b22 - A(1,2) * A(1,2);
+	const Scalar c01 = A(0,1) * b22 - A(1,2) * A(0,2);
+	const Scalar c02 = A(0,1) * A(1,2) - b11 * A(0,2);
+	const Scalar det = (b00 * c00 - A(0,1) * c01 + A(0,2) * c02) / (p * p * p);
+	const Scalar half_det = std::min(std::max(det / Scalar(2), Scalar(-1)), Scalar(1));
+
+	const Scalar angle = std::acos(half_det) / Scalar(3);
+	const Scalar two_thirds_pi = Scalar(2.09439510239319549);
+	const Scalar beta2 = std::cos(angle) * Scalar(2);
+	const Scalar beta0 = std::cos(angle + two_thirds_pi) * Scalar(2);
+	const Scalar beta1 = -(beta0 + beta2);
+
+	eigenvalues[0] = q + p * beta0;
+	eigenvalues[1] = q + p * beta1;
+	eigenvalues[2] = q + p * beta2;
+
+	// the eigenvector of the most isolated eigenvalue is computed first
+	Vec3 ev0, ev1, ev2;
+	if (half_det >= Scalar(0))
+	{
+		ev2 = internal::eigenvector_simple(A, eigenvalues[2]);
+		ev1 = internal::eigenvector_orthogonal(A, ev2, eigenvalues[1]);
+		ev0 = ev1.cross(ev2);
+	}
+	else
+	{
+		ev0 = internal::eigenvector_simple(A, eigenvalues[0]);
+		ev1 = internal::eigenvector_orthogonal(A, ev0, eigenvalues[1]);
+		ev2 = ev0.cross(ev1);
+	}
+
+	eigenvalues *= max_abs;
+	eigenvectors.col(0) = ev0;
+	eigenvectors.col(1) = ev1;
+	eigenvectors.col(2) = ev2;
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_FUNCTIONS_SYMMETRIC_EIGEN_H_
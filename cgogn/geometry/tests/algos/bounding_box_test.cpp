@@ -0,0 +1,142 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/bounding_box.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using Mat3 = Eigen::Matrix3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using CMap3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+
+class BoundingBox_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	CMap2::VertexAttribute<Vec3> position_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		position_ = map2_.get_attribute<Vec3, CMap2::Vertex::ORBIT>("position");
+	}
+};
+
+TEST_F(BoundingBox_TEST, ParallelAABB)
+{
+	cgogn::geometry::AABB<Vec3> ref;
+	cgogn::geometry::compute_AABB(position_, ref);
+
+	cgogn::geometry::AABB<Vec3> bb;
+	cgogn::geometry::parallel_compute_AABB<Vec3>(map2_, position_, bb);
+
+	ASSERT_TRUE(bb.is_initialized());
+	EXPECT_EQ(bb.min(), ref.min());
+	EXPECT_EQ(bb.max(), ref.max());
+}
+
+TEST_F(BoundingBox_TEST, ParallelOBB)
+{
+	cgogn::geometry::OBB<Vec3> ref;
+	cgogn::geometry::compute_OBB(position_, ref);
+
+	cgogn::geometry::OBB<Vec3> bb;
+	cgogn::geometry::parallel_compute_OBB<Vec3>(map2_, position_, bb);
+
+	const Mat3& axes = bb.axis();
+	EXPECT_TRUE((axes.transpose() * axes).isApprox(Mat3::Identity(), 1e-9));
+
+	// same principal directions as the sequential computation, and a box at least as tight
+	for (uint32 k = 0u; k < 3u; ++k)
+	{
+		EXPECT_NEAR(std::abs(axes.col(k).dot(ref.axis().col(k))), 1.0, 1e-6);
+		EXPECT_LE(bb.extension()[k], ref.extension()[k] + 1e-9);
+	}
+
+	// all the points are in the box
+	const Vec3 tolerance = Vec3::Constant(1e-9 * (1.0 + bb.extension().maxCoeff()));
+	map2_.foreach_cell([&] (CMap2::Vertex v)
+	{
+		const Vec3 t = axes.transpose() * (position_[v] - bb.center());
+		EXPECT_TRUE((t.cwiseAbs().array() <= (bb.extension() + tolerance).array()).all());
+	});
+}
+
+TEST_F(BoundingBox_TEST, ComponentAABB)
+{
+	std::vector<CMap2::ConnectedComponent> components;
+	std::vector<cgogn::geometry::AABB<Vec3>> boxes;
+	cgogn::geometry::parallel_compute_component_AABB<Vec3>(map2_, position_, components, boxes);
+
+	ASSERT_EQ(components.size(), boxes.size());
+	ASSERT_GE(components.size(), 1u);
+
+	cgogn::geometry::AABB<Vec3> ref;
+	cgogn::geometry::compute_AABB(position_, ref);
+
+	cgogn::geometry::AABB<Vec3> all = boxes[0];
+	for (std::size_t i = 0u; i < components.size(); ++i)
+	{
+		cgogn::geometry::AABB<Vec3> bb;
+		map2_.foreach_incident_vertex(components[i], [&] (CMap2::Vertex v) { bb.add_point(position_[v]); });
+		EXPECT_EQ(boxes[i].min(), bb.min());
+		EXPECT_EQ(boxes[i].max(), bb.max());
+		all.fusion(boxes[i]);
+	}
+	EXPECT_EQ(all.min(), ref.min());
+	EXPECT_EQ(all.max(), ref.max());
+}
+
+TEST(BoundingBox3_TEST, VolumeAABB)
+{
+	CMap3 map3;
+	cgogn::io::import_volume<Vec3>(map3, std::string(DEFAULT_MESH_PATH) + std::string("tet/hand.tet"));
+	CMap3::VertexAttribute<Vec3> position = map3.get_attribute<Vec3, CMap3::Vertex::ORBIT>("position");
+
+	CMap3::VolumeAttribute<Vec3> bb_min = map3.add_attribute<Vec3, CMap3::Volume::ORBIT>("bb_min");
+	CMap3::VolumeAttribute<Vec3> bb_max = map3.add_attribute<Vec3, CMap3::Volume::ORBIT>("bb_max");
+	cgogn::geometry::parallel_compute_cell_AABB<Vec3, CMap3::Volume>(map3, position, bb_min, bb_max);
+
+	uint32 nb_volumes = 0u;
+	map3.foreach_cell([&] (CMap3::Volume w)
+	{
+		cgogn::geometry::AABB<Vec3> bb;
+		map3.foreach_incident_vertex(w, [&] (CMap3::Vertex v) { bb.add_point(position[v]); });
+		EXPECT_EQ(bb_min[w], bb.min());
+		EXPECT_EQ(bb_max[w], bb.max());
+		++nb_volumes;
+	});
+	EXPECT_EQ(nb_volumes, 8343u);
+}
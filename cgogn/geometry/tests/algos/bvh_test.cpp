@@ -0,0 +1,173 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/bvh.h>
+#include <cgogn/geometry/algos/picking.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using BVH = cgogn::geometry::BVH<Vec3, CMap2>;
+
+class BVH_TEST : public testing::TestWithParam<std::string>
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	std::mt19937 generator_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + GetParam());
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+	}
+
+	Vec3 random_point(double amplitude)
+	{
+		std::uniform_real_distribution<double> d(-amplitude, amplitude);
+		return Vec3(d(generator_), d(generator_), d(generator_));
+	}
+
+	Vec3 center()
+	{
+		Vec3 c(0, 0, 0);
+		uint32 nb = 0u;
+		map2_.foreach_cell([&] (Vertex v) { c += position_[v]; ++nb; });
+		return c / double(nb);
+	}
+
+	// closest point by testing all the faces
+	double brute_force_closest_point(const Vec3& P)
+	{
+		double best = std::numeric_limits<double>::max();
+		map2_.foreach_cell([&] (Face f)
+		{
+			std::vector<uint32> indices;
+			cgogn::geometry::append_ear_triangulation<Vec3>(map2_, f, position_, indices);
+			for (std::size_t i = 0u; i < indices.size(); i += 3u)
+			{
+				const Vec3 Q = cgogn::geometry::closest_point_in_triangle(P, position_[indices[i]], position_[indices[i+1]], position_[indices[i+2]]);
+				best = std::min(best, (Q - P).squaredNorm());
+			}
+		});
+		return best;
+	}
+
+	void check_picking(const BVH& bvh)
+	{
+		const Vec3 c = center();
+		for (uint32 i = 0u; i < 20u; ++i)
+		{
+			const Vec3 A = c + random_point(100.0);
+			const Vec3 B = c + random_point(1.0);
+
+			std::vector<Face> expected;
+			std::vector<Face> selected;
+			cgogn::geometry::picking<Vec3>(map2_, position_, A, B, expected);
+			cgogn::geometry::picking<Vec3>(map2_, bvh, A, B, selected);
+
+			EXPECT_EQ(expected.size(), selected.size());
+			if (!expected.empty() && !selected.empty())
+				EXPECT_EQ(expected.front().dart, selected.front().dart);
+		}
+	}
+
+	void check_closest_point(const BVH& bvh)
+	{
+		const Vec3 c = center();
+		for (uint32 i = 0u; i < 20u; ++i)
+		{
+			const Vec3 P = c + random_point(20.0);
+			Face f;
+			Vec3 Q;
+			EXPECT_TRUE(cgogn::geometry::closest_point(bvh, P, f, Q));
+			EXPECT_NEAR((Q - P).squaredNorm(), brute_force_closest_point(P), 1e-9);
+		}
+	}
+};
+
+TEST_P(BVH_TEST, Build)
+{
+	BVH bvh(map2_, position_);
+	EXPECT_GE(bvh.nb_triangles(), map2_.nb_cells<Face::ORBIT>());
+	EXPECT_GT(bvh.nb_nodes(), 1u);
+	check_picking(bvh);
+	check_closest_point(bvh);
+}
+
+TEST_P(BVH_TEST, Refit)
+{
+	BVH bvh(map2_, position_);
+	// the triangulation of the faces is kept by refit: a similarity does not change it
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		position_[v] = Vec3(-2.0 * position_[v][1], 2.0 * position_[v][0], 2.0 * position_[v][2] - 3.0);
+	});
+	bvh.refit();
+	check_picking(bvh);
+	check_closest_point(bvh);
+}
+
+TEST_P(BVH_TEST, NonUnitDirection)
+{
+	BVH bvh(map2_, position_);
+	const Vec3 c = center();
+	for (uint32 i = 0u; i < 200u; ++i)
+	{
+		const Vec3 A = c + random_point(100.0);
+		const Vec3 B = c + random_point(10.0);
+
+		std::vector<Face> expected;
+		cgogn::geometry::picking<Vec3>(map2_, position_, A, B, expected);
+
+		// the first hit must not depend on the norm of the direction
+		for (double scale : { 1e-6, 1.0, 1e6 })
+		{
+			Face f;
+			Vec3 I;
+			const bool hit = bvh.intersect(A, (B - A) * scale, f, I);
+			EXPECT_EQ(!expected.empty(), hit);
+			if (hit && !expected.empty())
+				EXPECT_EQ(expected.front().dart, f.dart);
+		}
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(BVH, BVH_TEST, testing::Values(std::string("off/aneurysm_3D.off"), std::string("off/aneurysm_quad.off")));
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/normal.h>
+#include <cgogn/geometry/algos/angle.h>
+#include <cgogn/geometry/algos/curvature.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+template <typename T>
+using EdgeAttribute = CMap2::EdgeAttribute<T>;
+
+class Curvature_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	VertexAttribute<Vec3> normal_;
+	EdgeAttribute<float64> edge_angle_;
+	EdgeAttribute<float64> edge_area_;
+
+	void SetUp() override
+	{
+		load("off/aneurysm_3D.off");
+	}
+
+	void load(const std::string& mesh)
+	{
+		map2_.clear_and_remove_attributes();
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + mesh);
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+		normal_ = map2_.add_attribute<Vec3, Vertex::ORBIT>("normal");
+		edge_angle_ = map2_.add_attribute<float64, Edge::ORBIT>("angle");
+		edge_area_ = map2_.add_attribute<float64, Edge::ORBIT>("area");
+		cgogn::geometry::compute_normal<Vec3>(map2_, position_, normal_);
+		cgogn::geometry::compute_angle_between_face_normals<Vec3>(map2_, position_, edge_angle_);
+	}
+
+	struct Curvatures
+	{
+		VertexAttribute<float64> kmax;
+		VertexAttribute<float64> kmin;
+		VertexAttribute<Vec3> Kmax;
+		VertexAttribute<Vec3> Kmin;
+		VertexAttribute<Vec3> Knormal;
+	};
+
+	Curvatures add_curvatures(const std::string& prefix)
+	{
+		return Curvatures{
+			map2_.add_attribute<float64, Vertex::ORBIT>(prefix + "kmax"),
+			map2_.add_attribute<float64, Vertex::ORBIT>(prefix + "kmin"),
+			map2_.add_attribute<Vec3, Vertex::ORBIT>(prefix + "Kmax"),
+			map2_.add_attribute<Vec3, Vertex::ORBIT>(prefix + "Kmin"),
+			map2_.add_attribute<Vec3, Vertex::ORBIT>(prefix + "Knormal")
+		};
+	}
+
+	void expect_same_curvatures(const Curvatures& c, const Curvatures& p)
+	{
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			const float64 scale = std::max(1.0, std::abs(c.kmax[v]) + std::abs(c.kmin[v]));
+			EXPECT_NEAR(p.kmax[v], c.kmax[v], 1e-9 * scale);
+			EXPECT_NEAR(p.kmin[v], c.kmin[v], 1e-9 * scale);
+			EXPECT_NEAR(p.Knormal[v].dot(c.Knormal[v]), 1.0, 1e-6);
+			// principal directions are defined up to orientation, and only for distinct curvatures
+			if (c.kmax[v] - c.kmin[v] > 1e-6 * scale)
+			{
+				EXPECT_NEAR(std::abs(p.Kmax[v].dot(c.Kmax[v])), 1.0, 1e-6);
+				EXPECT_NEAR(std::abs(p.Kmin[v].dot(c.Kmin[v])), 1.0, 1e-6);
+			}
+		});
+	}
+};
+
+TEST_F(Curvature_TEST, ParallelComputeCurvature)
+{
+	const float64 radius = 2.0 * cgogn::geometry::mean_edge_length<Vec3>(map2_, position_);
+
+	Curvatures c = add_curvatures("");
+	cgogn::geometry::compute_curvature<Vec3>(map2_, radius, position_, normal_, edge_angle_, c.kmax, c.kmin, c.Kmax, c.Kmin, c.Knormal);
+
+	Curvatures p = add_curvatures("p");
+	cgogn::geometry::parallel_compute_curvature<Vec3>(map2_, radius, position_, normal_, edge_angle_, p.kmax, p.kmin, p.Kmax, p.Kmin, p.Knormal);
+
+	expect_same_curvatures(c, p);
+}
+
+// on an open mesh, the boundary faces are ignored by both computations
+TEST_F(Curvature_TEST, ParallelComputeCurvatureOpenMesh)
+{
+	load("medit/tshirt_tri.mesh");
+	uint32 nb_boundary_darts = 0u;
+	map2_.foreach_dart([&] (cgogn::Dart d) { if (map2_.is_boundary(d)) ++nb_boundary_darts; });
+	ASSERT_GT(nb_boundary_darts, 0u);
+	const float64 radius = 2.0 * cgogn::geometry::mean_edge_length<Vec3>(map2_, position_);
+
+	Curvatures c = add_curvatures("");
+	cgogn::geometry::compute_curvature<Vec3>(map2_, radius, position_, normal_, edge_angle_, c.kmax, c.kmin, c.Kmax, c.Kmin, c.Knormal);
+
+	Curvatures p = add_curvatures("p");
+	cgogn::geometry::parallel_compute_curvature<Vec3>(map2_, radius, position_, normal_, edge_angle_, p.kmax, p.kmin, p.Kmax, p.Kmin, p.Knormal);
+
+	expect_same_curvatures(c, p);
+}
+
+// the pooled collectors of compute_curvature and the single vertex computation give the same result
+TEST_F(Curvature_TEST, SingleVertexCurvature)
+{
+	const float64 radius = 2.0 * cgogn::geometry::mean_edge_length<Vec3>(map2_, position_);
+
+	Curvatures c = add_curvatures("");
+	cgogn::geometry::compute_curvature<Vec3>(map2_, radius, position_, normal_, edge_angle_, c.kmax, c.kmin, c.Kmax, c.Kmin, c.Knormal);
+
+	Curvatures s = add_curvatures("s");
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		cgogn::geometry::curvature<Vec3>(map2_, v, radius, position_, normal_, edge_angle_, edge_area_, s.kmax, s.kmin, s.Kmax, s.Kmin, s.Knormal);
+	});
+
+	expect_same_curvatures(c, s);
+}
@@ -0,0 +1,121 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cmath>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/ear_triangulation.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Triangulator = cgogn::geometry::Triangulator<Vec3, CMap2>;
+
+class EarTriangulation_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_quad.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+
+		// add star shaped (non convex) polygons of various sizes
+		for (uint32 n = 4u; n < 64u; ++n)
+		{
+			Face f = map2_.add_face(2u * n);
+			cgogn::Dart d = f.dart;
+			for (uint32 i = 0u; i < 2u * n; ++i)
+			{
+				const double a = M_PI * double(i) / double(n);
+				const double r = (i % 2u == 0u) ? 10.0 : 4.0 + double(i % 5u);
+				position_[Vertex(d)] = Vec3(100.0 * n + r * std::cos(a), r * std::sin(a), 0.1 * double(i % 3u));
+				d = map2_.phi1(d);
+			}
+		}
+	}
+
+	// sequential triangulation of the faces in traversal order
+	std::vector<uint32> reference()
+	{
+		std::vector<uint32> indices;
+		map2_.foreach_cell([&] (Face f)
+		{
+			cgogn::geometry::append_ear_triangulation<Vec3>(map2_, f, position_, indices);
+		});
+		return indices;
+	}
+};
+
+TEST_F(EarTriangulation_TEST, ParallelTriangulate)
+{
+	std::vector<uint32> indices;
+	cgogn::geometry::parallel_triangulate<Vec3>(map2_, position_, indices);
+	EXPECT_EQ(indices, reference());
+
+	// a Triangulator reuses its memory from one face to another
+	Triangulator triangulator(map2_, position_);
+	std::vector<uint32> face_by_face;
+	map2_.foreach_cell([&] (Face f) { triangulator.triangulate(f, face_by_face); });
+	EXPECT_EQ(face_by_face, indices);
+}
+
+TEST_F(EarTriangulation_TEST, UpdateCache)
+{
+	Triangulator triangulator(map2_, position_);
+	std::vector<uint32> indices;
+	triangulator.parallel_triangulate(indices);
+	EXPECT_TRUE(triangulator.is_valid());
+	EXPECT_EQ(triangulator.indices(), indices);
+
+	// move one vertex of each star so that another ear is chosen
+	map2_.foreach_cell([&] (Face f)
+	{
+		if (map2_.codegree(f) > 4u)
+		{
+			Vertex v(map2_.phi1(f.dart));
+			position_[v] = Vec3(0.5, 0.5, 0.0) + 0.3 * position_[v] + 0.7 * position_[Vertex(map2_.phi_1(f.dart))];
+			triangulator.invalidate(Face(map2_.phi1(f.dart)));
+		}
+	});
+
+	std::vector<uint32> updated;
+	triangulator.update(updated);
+	EXPECT_EQ(updated, reference());
+}
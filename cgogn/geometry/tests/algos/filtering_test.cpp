@@ -0,0 +1,182 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/filtering.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using LaplacianSmoothing = cgogn::geometry::LaplacianSmoothing<Vec3, CMap2>;
+
+class Filtering_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	VertexAttribute<Vec3> position_ref_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+		position_ref_ = map2_.add_attribute<Vec3, Vertex::ORBIT>("position_ref");
+		map2_.copy_attribute(position_ref_, position_);
+	}
+
+	void expect_same_positions(float64 tolerance)
+	{
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			EXPECT_TRUE((position_[v] - position_ref_[v]).norm() <= tolerance);
+		});
+	}
+};
+
+TEST_F(Filtering_TEST, SmoothSameAsFilterAverage)
+{
+	VertexAttribute<Vec3> tmp = map2_.add_attribute<Vec3, Vertex::ORBIT>("tmp");
+	for (uint32 i = 0u; i < 3u; ++i)
+	{
+		cgogn::geometry::filter_average<Vec3>(map2_, position_ref_, tmp);
+		map2_.swap_attributes(position_ref_, tmp);
+	}
+
+	LaplacianSmoothing smoothing(map2_, position_);
+	EXPECT_EQ(smoothing.nb_smoothed_vertices(), map2_.nb_cells<Vertex::ORBIT>());
+	smoothing.smooth(position_, 3u);
+
+	expect_same_positions(1e-12);
+}
+
+TEST_F(Filtering_TEST, TaubinSameAsFilterTaubin)
+{
+	VertexAttribute<Vec3> tmp = map2_.add_attribute<Vec3, Vertex::ORBIT>("tmp");
+	cgogn::geometry::filter_taubin<Vec3>(map2_, position_ref_, tmp);
+	cgogn::geometry::filter_taubin<Vec3>(map2_, position_ref_, tmp);
+
+	// filter_taubin applies two shrinking steps (lambda = 0.6307, mu = 0.6732)
+	LaplacianSmoothing smoothing(map2_, position_);
+	smoothing.taubin(position_, 2u, 0.6307, 0.6732);
+
+	expect_same_positions(1e-12);
+}
+
+TEST_F(Filtering_TEST, MaskedVerticesOnly)
+{
+	cgogn::CellCache<CMap2> cache(map2_);
+	uint32 n = 0u;
+	cache.build<Vertex>([&] (Vertex) { return (n++ % 2u) == 0u; });
+
+	LaplacianSmoothing smoothing(map2_, cache, position_);
+	EXPECT_EQ(smoothing.nb_smoothed_vertices(), uint32(cache.size<Vertex>()));
+	EXPECT_GT(smoothing.nb_vertices(), smoothing.nb_smoothed_vertices());
+	smoothing.smooth(position_, 5u, 0.5);
+
+	CMap2::VertexAttribute<bool> smoothed = map2_.add_attribute<bool, Vertex::ORBIT>("smoothed");
+	smoothed.set_all_values(false);
+	map2_.foreach_cell([&] (Vertex v) { smoothed[v] = true; }, cache);
+
+	uint32 nb_moved = 0u;
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		if (!smoothed[v])
+			EXPECT_EQ(position_[v], position_ref_[v]);
+		else if (position_[v] != position_ref_[v])
+			++nb_moved;
+	});
+	EXPECT_GT(nb_moved, 0u);
+}
+
+// the cotangent Laplacian of a planar mesh is zero at its interior vertices
+TEST(FilteringCotangent_TEST, PlanarMeshIsInvariant)
+{
+	const uint32 n = 12u;
+	const std::string filename = std::string("filtering_test_planar.off");
+	{
+		std::mt19937 gen(5u);
+		std::uniform_real_distribution<float64> jitter(-0.2, 0.2);
+		std::ofstream out(filename);
+		out.precision(17);
+		out << "OFF\n" << (n + 1u) * (n + 1u) << " " << 2u * n * n << " 0\n";
+		for (uint32 j = 0u; j <= n; ++j)
+		{
+			for (uint32 i = 0u; i <= n; ++i)
+			{
+				const bool border = i == 0u || j == 0u || i == n || j == n;
+				out << (float64(i) + (border ? 0.0 : jitter(gen))) << " " << (float64(j) + (border ? 0.0 : jitter(gen))) << " 0\n";
+			}
+		}
+		for (uint32 j = 0u; j < n; ++j)
+		{
+			for (uint32 i = 0u; i < n; ++i)
+			{
+				const uint32 a = j * (n + 1u) + i;
+				out << "3 " << a << " " << a + 1u << " " << a + n + 2u << "\n";
+				out << "3 " << a << " " << a + n + 2u << " " << a + n + 1u << "\n";
+			}
+		}
+	}
+
+	CMap2 map;
+	cgogn::io::import_surface<Vec3>(map, filename);
+	std::remove(filename.c_str());
+	VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex::ORBIT>("position");
+	VertexAttribute<Vec3> position_ref = map.add_attribute<Vec3, Vertex::ORBIT>("position_ref");
+	map.copy_attribute(position_ref, position);
+
+	cgogn::CellCache<CMap2> interior(map);
+	interior.build<Vertex>([&] (Vertex v) { return !map.is_incident_to_boundary(v); });
+	ASSERT_EQ(interior.size<Vertex>(), std::size_t((n - 1u) * (n - 1u)));
+
+	LaplacianSmoothing cotangent(map, interior, position, cgogn::geometry::COTANGENT_WEIGHTS);
+	cotangent.smooth(position, 10u);
+	map.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_LT((position[v] - position_ref[v]).norm(), 1e-9);
+	});
+
+	LaplacianSmoothing uniform(map, interior, position);
+	uniform.smooth(position, 1u);
+	float64 max_move = 0.0;
+	map.foreach_cell([&] (Vertex v) { max_move = std::max(max_move, (position[v] - position_ref[v]).norm()); });
+	EXPECT_GT(max_move, 1e-3);
+}
@@ -0,0 +1,172 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <string>
+#include <queue>
+#include <limits>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/heat_geodesic.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using HeatGeodesic = cgogn::geometry::HeatGeodesic<Vec3, CMap2>;
+
+class HeatGeodesic_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+	}
+
+	// lengths of the shortest paths along the edges
+	void dijkstra(Vertex source, VertexAttribute<float64>& distance)
+	{
+		using Entry = std::pair<float64, uint32>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+		map2_.foreach_cell([&] (Vertex v) { distance[v] = std::numeric_limits<float64>::max(); });
+		distance[source] = 0.0;
+		queue.push(Entry(0.0, source.dart.index));
+		while (!queue.empty())
+		{
+			const Entry e = queue.top();
+			queue.pop();
+			const Vertex u(cgogn::Dart(e.second));
+			if (e.first > distance[u])
+				continue;
+			map2_.foreach_adjacent_vertex_through_edge(u, [&] (Vertex v)
+			{
+				const float64 d = e.first + (position_[v] - position_[u]).norm();
+				if (d < distance[v])
+				{
+					distance[v] = d;
+					queue.push(Entry(d, v.dart.index));
+				}
+			});
+		}
+	}
+
+	std::vector<Vertex> some_vertices(uint32 nb)
+	{
+		std::vector<Vertex> vertices;
+		uint32 i = 0u;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (i++ % 97u == 0u && vertices.size() < nb)
+				vertices.push_back(v);
+		});
+		return vertices;
+	}
+};
+
+TEST_F(HeatGeodesic_TEST, CloseToGraphDistances)
+{
+	HeatGeodesic heat(map2_, position_);
+	EXPECT_TRUE(heat.is_valid());
+
+	const Vertex source = some_vertices(1u)[0];
+	VertexAttribute<float64> geodesic = map2_.add_attribute<float64, Vertex::ORBIT>("geodesic");
+	VertexAttribute<float64> graph = map2_.add_attribute<float64, Vertex::ORBIT>("graph");
+	heat.compute({ source }, geodesic);
+	dijkstra(source, graph);
+
+	EXPECT_NEAR(geodesic[source], 0.0, 1e-9);
+
+	// the paths along the edges are longer than the geodesics (up to the error of the heat method)
+	float64 max_graph = 0.0;
+	float64 sum_ratio = 0.0;
+	uint32 nb = 0u;
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		max_graph = std::max(max_graph, graph[v]);
+		if (graph[v] > 0.0)
+		{
+			sum_ratio += geodesic[v] / graph[v];
+			++nb;
+		}
+	});
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_LE(geodesic[v], graph[v] * 1.05 + 0.02 * max_graph);
+	});
+	const float64 mean_ratio = sum_ratio / nb;
+	EXPECT_GT(mean_ratio, 0.8);
+	EXPECT_LT(mean_ratio, 1.0);
+}
+
+TEST_F(HeatGeodesic_TEST, SeveralSourceSets)
+{
+	HeatGeodesic heat(map2_, position_);
+	const std::vector<Vertex> vertices = some_vertices(5u);
+
+	std::vector<std::vector<Vertex>> source_sets;
+	std::vector<VertexAttribute<float64>> distances;
+	for (uint32 i = 0u; i < 4u; ++i)
+	{
+		source_sets.push_back({ vertices[i] });
+		distances.push_back(map2_.add_attribute<float64, Vertex::ORBIT>("distance_" + std::to_string(i)));
+	}
+	source_sets.back().push_back(vertices[4]);
+	heat.compute(source_sets, distances);
+
+	VertexAttribute<float64> single = map2_.add_attribute<float64, Vertex::ORBIT>("single");
+	for (uint32 i = 0u; i < 4u; ++i)
+	{
+		heat.compute(source_sets[i], single);
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			EXPECT_NEAR(distances[i][v], single[v], 1e-9);
+		});
+	}
+
+	// the distance to a set of sources is close to the minimum of the distances to each source
+	VertexAttribute<float64> first = map2_.add_attribute<float64, Vertex::ORBIT>("first");
+	VertexAttribute<float64> second = map2_.add_attribute<float64, Vertex::ORBIT>("second");
+	heat.compute({ vertices[3] }, first);
+	heat.compute({ vertices[4] }, second);
+	float64 max_distance = 0.0;
+	map2_.foreach_cell([&] (Vertex v) { max_distance = std::max(max_distance, first[v]); });
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_NEAR(distances[3][v], std::min(first[v], second[v]), 0.05 * max_distance);
+	});
+}
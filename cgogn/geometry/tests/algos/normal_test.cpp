@@ -0,0 +1,117 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/normal.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+template <typename T>
+using FaceAttribute = CMap2::FaceAttribute<T>;
+
+class UpdateNormal_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	FaceAttribute<Vec3> face_normal_;
+	VertexAttribute<Vec3> vertex_normal_;
+	std::vector<Vertex> dirty_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_quad.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+		face_normal_ = map2_.add_attribute<Vec3, Face::ORBIT>("face_normal");
+		vertex_normal_ = map2_.add_attribute<Vec3, Vertex::ORBIT>("vertex_normal");
+		cgogn::geometry::compute_normal<Vec3>(map2_, position_, face_normal_);
+		cgogn::geometry::compute_normal<Vec3>(map2_, position_, face_normal_, vertex_normal_);
+
+		// move some vertices (twice the first one to check duplicates)
+		uint32 i = 0u;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (i++ % 97u == 0u)
+			{
+				position_[v] += Vec3(0.1, -0.2, 0.3);
+				dirty_.push_back(v);
+			}
+		});
+		dirty_.push_back(dirty_.front());
+	}
+
+	// compare with a full computation and check that the updated vertices are the ones of the faces of dirty vertices
+	void check(const std::vector<uint32>& updated)
+	{
+		FaceAttribute<Vec3> ref_face_normal = map2_.add_attribute<Vec3, Face::ORBIT>("ref_face_normal");
+		VertexAttribute<Vec3> ref_vertex_normal = map2_.add_attribute<Vec3, Vertex::ORBIT>("ref_vertex_normal");
+		cgogn::geometry::compute_normal<Vec3>(map2_, position_, ref_face_normal);
+		cgogn::geometry::compute_normal<Vec3>(map2_, position_, ref_face_normal, ref_vertex_normal);
+
+		// the sums may start from another dart of the cell
+		map2_.foreach_cell([&] (Face f) { EXPECT_LT((face_normal_[f] - ref_face_normal[f]).norm(), 1e-12); });
+		map2_.foreach_cell([&] (Vertex v) { EXPECT_LT((vertex_normal_[v] - ref_vertex_normal[v]).norm(), 1e-12); });
+
+		std::vector<uint32> expected;
+		for (Vertex v : dirty_)
+			map2_.foreach_incident_face(v, [&] (Face f)
+			{
+				map2_.foreach_incident_vertex(f, [&] (Vertex w) { expected.push_back(map2_.embedding(w)); });
+			});
+		std::sort(expected.begin(), expected.end());
+		expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+		EXPECT_EQ(updated, expected);
+	}
+};
+
+TEST_F(UpdateNormal_TEST, UpdateNormalFromList)
+{
+	std::vector<uint32> updated;
+	cgogn::geometry::update_normal<Vec3>(map2_, position_, dirty_, face_normal_, vertex_normal_, updated);
+	check(updated);
+}
+
+TEST_F(UpdateNormal_TEST, UpdateNormalFromMarker)
+{
+	cgogn::CellMarker<CMap2, Vertex::ORBIT> marker(map2_);
+	for (Vertex v : dirty_)
+		marker.mark(v);
+	std::vector<uint32> updated;
+	cgogn::geometry::update_normal<Vec3>(map2_, position_, marker, face_normal_, vertex_normal_, updated);
+	check(updated);
+}
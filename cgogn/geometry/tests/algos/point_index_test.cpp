@@ -0,0 +1,141 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/point_index.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using PointIndex = cgogn::geometry::PointIndex<Vec3, CMap2>;
+
+class PointIndex_TEST : public testing::TestWithParam<cgogn::geometry::PointIndexType>
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	std::vector<Vec3> queries_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+
+		// query points around the vertices and far from the mesh
+		std::mt19937 generator;
+		std::uniform_real_distribution<double> d(-1.0, 1.0);
+		uint32 i = 0u;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (i++ % 200u == 0u)
+				queries_.push_back(position_[v] + Vec3(d(generator), d(generator), d(generator)));
+		});
+		queries_.push_back(queries_.front() + Vec3(1000.0, -500.0, 20.0));
+	}
+
+	// squared distances of all the vertices to P, sorted
+	std::vector<double> brute_force_distances(const Vec3& P)
+	{
+		std::vector<double> distances;
+		map2_.foreach_cell([&] (Vertex v) { distances.push_back((position_[v] - P).squaredNorm()); });
+		std::sort(distances.begin(), distances.end());
+		return distances;
+	}
+};
+
+TEST_P(PointIndex_TEST, KNearest)
+{
+	PointIndex index(map2_, position_, GetParam());
+	EXPECT_EQ(index.nb_points(), map2_.nb_cells<Vertex::ORBIT>());
+
+	std::vector<std::vector<PointIndex::Neighbor>> batch;
+	index.k_nearest(queries_, 10u, batch);
+	ASSERT_EQ(batch.size(), queries_.size());
+
+	for (std::size_t q = 0u; q < queries_.size(); ++q)
+	{
+		const std::vector<double> expected = brute_force_distances(queries_[q]);
+		std::vector<PointIndex::Neighbor> neighbors;
+		index.k_nearest(queries_[q], 10u, neighbors);
+		ASSERT_EQ(neighbors.size(), 10u);
+		ASSERT_EQ(batch[q].size(), 10u);
+		for (uint32 i = 0u; i < 10u; ++i)
+		{
+			EXPECT_DOUBLE_EQ(neighbors[i].second, expected[i]);
+			EXPECT_DOUBLE_EQ((position_[neighbors[i].first] - queries_[q]).squaredNorm(), expected[i]);
+			EXPECT_EQ(batch[q][i].first.dart, neighbors[i].first.dart);
+		}
+	}
+}
+
+TEST_P(PointIndex_TEST, WithinRadius)
+{
+	PointIndex index(map2_, position_, GetParam());
+
+	const double radius = 2.0;
+	std::vector<std::vector<Vertex>> batch;
+	index.within_radius(queries_, radius, batch);
+	ASSERT_EQ(batch.size(), queries_.size());
+
+	for (std::size_t q = 0u; q < queries_.size(); ++q)
+	{
+		const std::vector<double> distances = brute_force_distances(queries_[q]);
+		const std::size_t expected = std::upper_bound(distances.begin(), distances.end(), radius * radius) - distances.begin();
+
+		std::vector<Vertex> neighbors;
+		index.within_radius(queries_[q], radius, neighbors);
+		EXPECT_EQ(neighbors.size(), expected);
+		EXPECT_EQ(batch[q].size(), expected);
+		for (Vertex v : neighbors)
+			EXPECT_LE((position_[v] - queries_[q]).squaredNorm(), radius * radius);
+	}
+}
+
+TEST_P(PointIndex_TEST, Nearest)
+{
+	PointIndex index(map2_, position_, GetParam());
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		Vertex n;
+		double d2;
+		EXPECT_TRUE(index.nearest(position_[v], n, d2));
+		EXPECT_DOUBLE_EQ(d2, 0.0);
+	});
+}
+
+INSTANTIATE_TEST_CASE_P(PointIndex, PointIndex_TEST, testing::Values(cgogn::geometry::HASH_GRID, cgogn::geometry::KD_TREE));
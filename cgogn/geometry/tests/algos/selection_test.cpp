@@ -0,0 +1,158 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <vector>
+#include <algorithm>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/selection.h>
+#include <cgogn/geometry/algos/bounding_box.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+
+using OneRing = cgogn::geometry::Collector_OneRing<Vec3, CMap2>;
+using WithinSphere = cgogn::geometry::Collector_WithinSphere<Vec3, CMap2>;
+
+class Selection_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	float64 radius_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+		cgogn::geometry::AABB<Vec3> bb;
+		cgogn::geometry::compute_AABB(position_, bb);
+		radius_ = bb.max_size() / 30.0;
+	}
+
+	// sorted embeddings of the collected cells (the order depends on the darts of the traversal)
+	template <typename CellType, typename COLLECTOR>
+	std::vector<uint32> collected(const COLLECTOR& c)
+	{
+		std::vector<uint32> emb;
+		c.foreach_cell([&] (CellType ce) { emb.push_back(map2_.embedding(ce)); });
+		std::sort(emb.begin(), emb.end());
+		return emb;
+	}
+};
+
+TEST_F(Selection_TEST, ReusedCollectorSameAsFresh)
+{
+	map2_.add_attribute<uint32, Edge::ORBIT>("edge_emb");
+	map2_.add_attribute<uint32, Face::ORBIT>("face_emb");
+
+	// the same collector collects around every vertex, its sparse marker is cleared before each collect
+	// (a fresh collector used once marks the darts with a DartMarkerStore of the map)
+	WithinSphere reused(map2_, radius_, position_);
+	uint32 nb_large = 0u;
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		WithinSphere fresh(map2_, radius_, position_);
+		fresh.collect_once(v);
+		reused.collect(v);
+
+		EXPECT_EQ((collected<Vertex>(reused)), (collected<Vertex>(fresh)));
+		EXPECT_EQ((collected<Edge>(reused)), (collected<Edge>(fresh)));
+		EXPECT_EQ((collected<Face>(reused)), (collected<Face>(fresh)));
+		EXPECT_EQ(reused.area(position_), fresh.area(position_));
+		if (reused.size<Vertex>() > 1u)
+			++nb_large;
+	});
+	EXPECT_GT(nb_large, 0u);
+}
+
+TEST_F(Selection_TEST, PoolParallelCollect)
+{
+	VertexAttribute<float64> area = map2_.add_attribute<float64, Vertex::ORBIT>("area");
+	VertexAttribute<uint32> nb_vertices = map2_.add_attribute<uint32, Vertex::ORBIT>("nb_vertices");
+
+	cgogn::geometry::CollectorPool<WithinSphere> pool(map2_, radius_, position_);
+	pool.parallel_collect(map2_, [&] (Vertex v, const WithinSphere& c)
+	{
+		area[v] = c.area(position_);
+		nb_vertices[v] = uint32(c.size<Vertex>());
+	});
+
+	WithinSphere ref(map2_, radius_, position_);
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		ref.collect(v);
+		EXPECT_EQ(area[v], ref.area(position_));
+		EXPECT_EQ(nb_vertices[v], uint32(ref.size<Vertex>()));
+	});
+
+	cgogn::geometry::CollectorPool<OneRing> one_ring_pool(map2_);
+	one_ring_pool.parallel_collect(map2_, [&] (Vertex v, const OneRing& c)
+	{
+		nb_vertices[v] = uint32(c.size<Edge>());
+	});
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_EQ(nb_vertices[v], map2_.degree(v));
+	});
+}
+
+// on an open mesh, the boundary faces do not count in the area of the neighborhood
+TEST(Selection_OpenMesh_TEST, WithinSphereArea)
+{
+	CMap2 map;
+	VertexAttribute<Vec3> position = map.add_attribute<Vec3, Vertex::ORBIT>("position");
+	const Face f = map.add_face(3u);
+	const cgogn::Dart d = f.dart;
+	position[Vertex(d)] = Vec3(0.0, 0.0, 0.0);
+	position[Vertex(map.phi1(d))] = Vec3(1.0, 0.0, 0.0);
+	position[Vertex(map.phi_1(d))] = Vec3(0.0, 1.0, 0.0);
+
+	// the whole triangle is in the sphere
+	WithinSphere large(map, 2.0, position);
+	large.collect(Vertex(d));
+	EXPECT_EQ(large.size<Face>(), 2u);
+	EXPECT_NEAR(large.area(position), 0.5, 1e-12);
+
+	// the sphere cuts the two edges of the triangle at their middle
+	WithinSphere small(map, 0.5, position);
+	small.collect(Vertex(d));
+	EXPECT_EQ(small.size<Vertex>(), 1u);
+	EXPECT_NEAR(small.area(position), 0.125, 1e-12);
+}
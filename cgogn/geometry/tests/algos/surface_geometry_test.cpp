@@ -0,0 +1,117 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/surface_geometry.h>
+#include <cgogn/geometry/algos/length.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+template <typename T>
+using EdgeAttribute = CMap2::EdgeAttribute<T>;
+template <typename T>
+using FaceAttribute = CMap2::FaceAttribute<T>;
+
+class SurfaceGeometry_TEST : public testing::TestWithParam<std::string>
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + GetParam());
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+	}
+};
+
+TEST_P(SurfaceGeometry_TEST, SameAsSeparateComputations)
+{
+	FaceAttribute<Vec3> face_normal = map2_.add_attribute<Vec3, Face::ORBIT>("face_normal");
+	FaceAttribute<float64> face_area = map2_.add_attribute<float64, Face::ORBIT>("face_area");
+	EdgeAttribute<float64> edge_length = map2_.add_attribute<float64, Edge::ORBIT>("edge_length");
+	EdgeAttribute<float64> edge_angle = map2_.add_attribute<float64, Edge::ORBIT>("edge_angle");
+	VertexAttribute<Vec3> vertex_normal = map2_.add_attribute<Vec3, Vertex::ORBIT>("vertex_normal");
+	cgogn::geometry::compute_surface_geometry<Vec3>(map2_, position_, face_normal, face_area, edge_length, edge_angle, vertex_normal);
+
+	FaceAttribute<Vec3> ref_face_normal = map2_.add_attribute<Vec3, Face::ORBIT>("ref_face_normal");
+	FaceAttribute<float64> ref_face_area = map2_.add_attribute<float64, Face::ORBIT>("ref_face_area");
+	EdgeAttribute<float64> ref_edge_angle = map2_.add_attribute<float64, Edge::ORBIT>("ref_edge_angle");
+	VertexAttribute<Vec3> ref_vertex_normal = map2_.add_attribute<Vec3, Vertex::ORBIT>("ref_vertex_normal");
+	cgogn::geometry::compute_normal<Vec3>(map2_, position_, ref_face_normal);
+	cgogn::geometry::compute_area<Vec3, Face>(map2_, position_, ref_face_area);
+	cgogn::geometry::compute_angle_between_face_normals<Vec3>(map2_, position_, ref_edge_angle);
+	cgogn::geometry::compute_normal<Vec3>(map2_, position_, ref_vertex_normal);
+
+	map2_.foreach_cell([&] (Face f)
+	{
+		EXPECT_LT((face_normal[f] - ref_face_normal[f]).norm(), 1e-12);
+		EXPECT_NEAR(face_area[f], ref_face_area[f], 1e-12 * std::max(1.0, ref_face_area[f]));
+	});
+	map2_.foreach_cell([&] (Edge e)
+	{
+		EXPECT_NEAR(edge_length[e], cgogn::geometry::length<Vec3>(map2_, e, position_), 1e-12);
+		EXPECT_NEAR(edge_angle[e], ref_edge_angle[e], 1e-9);
+	});
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_LT((vertex_normal[v] - ref_vertex_normal[v]).norm(), 1e-9);
+	});
+}
+
+TEST_P(SurfaceGeometry_TEST, OptionalAttributes)
+{
+	FaceAttribute<Vec3> face_normal = map2_.add_attribute<Vec3, Face::ORBIT>("face_normal");
+	FaceAttribute<float64> face_area = map2_.add_attribute<float64, Face::ORBIT>("face_area");
+	EdgeAttribute<float64> edge_length;
+	EdgeAttribute<float64> edge_angle;
+	VertexAttribute<Vec3> vertex_normal = map2_.add_attribute<Vec3, Vertex::ORBIT>("vertex_normal");
+	cgogn::geometry::compute_surface_geometry<Vec3>(map2_, position_, face_normal, face_area, edge_length, edge_angle, vertex_normal);
+
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_LT((vertex_normal[v] - cgogn::geometry::normal<Vec3>(map2_, v, position_)).norm(), 1e-9);
+	});
+}
+
+INSTANTIATE_TEST_CASE_P(
+	Meshes,
+	SurfaceGeometry_TEST,
+	testing::Values(std::string("off/aneurysm_3D.off"), std::string("off/aneurysm_quad.off"))
+);
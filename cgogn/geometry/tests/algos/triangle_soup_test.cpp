@@ -0,0 +1,129 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/triangle_soup.h>
+#include <cgogn/geometry/algos/bvh.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using TriangleSoup = cgogn::geometry::TriangleSoup<Vec3, CMap2>;
+using BVH = cgogn::geometry::BVH<Vec3, CMap2>;
+
+class TriangleSoup_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	VertexAttribute<Vec3> position_;
+	std::vector<Vec3> origins_;
+	std::vector<Vec3> dirs_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_quad.off"));
+		position_ = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+
+		// rays from random points towards vertices of the mesh
+		std::mt19937 generator;
+		std::uniform_real_distribution<double> d(-20.0, 20.0);
+		uint32 i = 0u;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (i++ % 500u == 0u)
+			{
+				origins_.push_back(position_[v] + Vec3(d(generator), d(generator), d(generator)));
+				dirs_.push_back(position_[v] + Vec3(0.01, 0.02, 0.03) - origins_.back());
+			}
+		});
+		origins_.push_back(origins_.front());
+		dirs_.push_back(-dirs_.front()); // opposite direction
+	}
+
+	// closest hit of the rays with the BVH
+	void check(const TriangleSoup& soup, const std::vector<Face>& faces, const std::vector<double>& t)
+	{
+		BVH bvh(map2_, position_);
+		uint32 nb_hits = 0u;
+		for (std::size_t r = 0u; r < origins_.size(); ++r)
+		{
+			Face f;
+			Vec3 inter;
+			const bool hit = bvh.intersect(origins_[r], dirs_[r], f, inter);
+			EXPECT_EQ(hit, faces[r].is_valid());
+			if (hit && faces[r].is_valid())
+			{
+				++nb_hits;
+				const double t_ref = (inter - origins_[r]).norm() / dirs_[r].norm();
+				EXPECT_NEAR(t[r], t_ref, 1e-4 * std::max(1.0, t_ref));
+				EXPECT_TRUE(soup.occluded(origins_[r], dirs_[r], t_ref * 1.01));
+				EXPECT_FALSE(soup.occluded(origins_[r], dirs_[r], t_ref * 0.99));
+			}
+		}
+		EXPECT_GT(nb_hits, 0u);
+	}
+};
+
+TEST_F(TriangleSoup_TEST, Intersect)
+{
+	TriangleSoup soup(map2_, position_);
+	EXPECT_EQ(soup.nb_triangles(), 2u * map2_.nb_cells<Face::ORBIT>());
+
+	std::vector<Face> faces(origins_.size());
+	std::vector<double> t(origins_.size(), std::numeric_limits<double>::infinity());
+	for (std::size_t r = 0u; r < origins_.size(); ++r)
+		soup.intersect(origins_[r], dirs_[r], faces[r], t[r]);
+	check(soup, faces, t);
+}
+
+TEST_F(TriangleSoup_TEST, IntersectRayPackets)
+{
+	TriangleSoup soup(map2_, position_);
+	std::vector<Face> faces;
+	std::vector<double> t;
+	soup.intersect(origins_, dirs_, faces, t);
+	ASSERT_EQ(faces.size(), origins_.size());
+	check(soup, faces, t);
+
+	// after a move of the mesh
+	map2_.foreach_cell([&] (Vertex v) { position_[v] = 1.5 * position_[v] + Vec3(1.0, 2.0, 3.0); });
+	soup.update();
+	soup.intersect(origins_, dirs_, faces, t);
+	check(soup, faces, t);
+}
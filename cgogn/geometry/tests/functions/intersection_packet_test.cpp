@@ -0,0 +1,161 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+#include <array>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/functions/intersection_packet.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+
+namespace
+{
+
+// reference (double precision) Moller-Trumbore : returns the distance, or -1 if there is no hit
+// or if the hit is too close to the border of the triangle to be decided in single precision
+double reference_intersection(const Vec3& O, const Vec3& D, const Vec3& A, const Vec3& B, const Vec3& C, bool& ambiguous)
+{
+	const Vec3 e1 = B - A;
+	const Vec3 e2 = C - A;
+	const Vec3 p = D.cross(e2);
+	const double det = e1.dot(p);
+	ambiguous = std::abs(det) < 1e-6;
+	if (det == 0.0)
+		return -1.0;
+	const Vec3 s = O - A;
+	const double u = s.dot(p) / det;
+	const Vec3 q = s.cross(e1);
+	const double v = D.dot(q) / det;
+	const double t = e2.dot(q) / det;
+	const double eps = 1e-4;
+	ambiguous = ambiguous || std::abs(u) < eps || std::abs(v) < eps || std::abs(1.0 - u - v) < eps || std::abs(t) < eps;
+	if (u < 0.0 || v < 0.0 || u + v > 1.0 || t < 0.0)
+		return -1.0;
+	return t;
+}
+
+} // namespace
+
+class IntersectionPacket_TEST : public testing::Test
+{
+protected:
+
+	std::mt19937 generator_;
+	std::uniform_real_distribution<double> d_{-1.0, 1.0};
+
+	Vec3 random_point() { return Vec3(d_(generator_), d_(generator_), d_(generator_)); }
+};
+
+TEST_F(IntersectionPacket_TEST, RayTriangles)
+{
+	const uint32 N = 16u;
+	uint32 nb_hits = 0u;
+	for (uint32 k = 0u; k < 500u; ++k)
+	{
+		std::array<Vec3, N> A, B, C;
+		cgogn::geometry::TrianglePacket<N> tris;
+		for (uint32 i = 0u; i < N; ++i)
+		{
+			A[i] = random_point(); B[i] = random_point(); C[i] = random_point();
+			tris.set(i, A[i], B[i], C[i]);
+		}
+		const Vec3 O = 3.0 * random_point();
+		const Vec3 D = random_point() - O;
+
+		float32 t[N], u[N], v[N];
+		const uint32 mask = cgogn::geometry::intersection_ray_triangles(O, D, tris, 10.0f, t, u, v);
+		float32 t1[N], u1[N], v1[N];
+		const uint32 scalar_mask = cgogn::geometry::intersection_ray_triangles<N, 1u>(O, D, tris, 10.0f, t1, u1, v1);
+		EXPECT_EQ(mask, scalar_mask);
+
+		for (uint32 i = 0u; i < N; ++i)
+		{
+			bool ambiguous;
+			const double ref = reference_intersection(O, D, A[i], B[i], C[i], ambiguous);
+			if (ambiguous)
+				continue;
+			const bool hit = (mask >> i) & 1u;
+			EXPECT_EQ(hit, ref >= 0.0 && ref < 10.0);
+			if (hit)
+			{
+				++nb_hits;
+				EXPECT_NEAR(t[i], ref, 1e-3 * std::max(1.0, ref));
+			}
+		}
+	}
+	EXPECT_GT(nb_hits, 0u);
+}
+
+TEST_F(IntersectionPacket_TEST, RaysTriangle)
+{
+	const uint32 N = 8u;
+	uint32 nb_hits = 0u;
+	for (uint32 k = 0u; k < 500u; ++k)
+	{
+		const Vec3 A = random_point(), B = random_point(), C = random_point();
+		std::array<Vec3, N> O, D;
+		cgogn::geometry::RayPacket<N> rays;
+		float32 t_max[N];
+		for (uint32 i = 0u; i < N; ++i)
+		{
+			O[i] = 3.0 * random_point();
+			D[i] = random_point() - O[i];
+			rays.set(i, O[i], D[i]);
+			t_max[i] = i % 2u == 0u ? 10.0f : 1.0f;
+		}
+
+		float32 t[N], u[N], v[N];
+		const uint32 mask = cgogn::geometry::intersection_rays_triangle(rays, A, B, C, t_max, t, u, v);
+		float32 t1[N], u1[N], v1[N];
+		EXPECT_EQ(mask, (cgogn::geometry::intersection_rays_triangle<N, 1u>(rays, A, B, C, t_max, t1, u1, v1)));
+
+		for (uint32 i = 0u; i < N; ++i)
+		{
+			bool ambiguous;
+			const double ref = reference_intersection(O[i], D[i], A, B, C, ambiguous);
+			if (ambiguous || std::abs(ref - t_max[i]) < 1e-4)
+				continue;
+			const bool hit = (mask >> i) & 1u;
+			EXPECT_EQ(hit, ref >= 0.0 && ref < t_max[i]);
+			if (hit)
+			{
+				++nb_hits;
+				EXPECT_NEAR(t[i], ref, 1e-3 * std::max(1.0, ref));
+			}
+		}
+	}
+	EXPECT_GT(nb_hits, 0u);
+}
+
+TEST_F(IntersectionPacket_TEST, DegenerateTriangles)
+{
+	cgogn::geometry::TrianglePacket<4u> tris;
+	tris.clear();
+	float32 t[4], u[4], v[4];
+	EXPECT_EQ(cgogn::geometry::intersection_ray_triangles(Vec3(0, 0, -1), Vec3(0, 0, 1), tris, 10.0f, t, u, v), 0u);
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <random>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/functions/symmetric_eigen.h>
+
+#include <gtest/gtest.h>
+
+using Mat3 = Eigen::Matrix3d;
+using Vec3 = Eigen::Vector3d;
+
+namespace
+{
+
+// checks the decomposition against the eigen values of Eigen and the definition of eigen vectors
+void check_decomposition(const Mat3& M)
+{
+	Vec3 ev;
+	Mat3 evec;
+	cgogn::geometry::symmetric_eigen_3x3(M, ev, evec);
+
+	Eigen::SelfAdjointEigenSolver<Mat3> solver(M);
+	const double scale = std::max(1.0, M.cwiseAbs().maxCoeff());
+
+	for (int i = 0; i < 3; ++i)
+	{
+		EXPECT_NEAR(ev[i], solver.eigenvalues()[i], 1e-9 * scale);
+		EXPECT_NEAR(evec.col(i).norm(), 1.0, 1e-9);
+		EXPECT_LT((M * evec.col(i) - ev[i] * evec.col(i)).norm(), 1e-8 * scale);
+	}
+	EXPECT_LT((evec.transpose() * evec - Mat3::Identity()).norm(), 1e-8);
+}
+
+} // namespace
+
+TEST(SymmetricEigen_TEST, Random)
+{
+	std::mt19937 generator;
+	std::uniform_real_distribution<double> d(-10.0, 10.0);
+	for (int i = 0; i < 1000; ++i)
+	{
+		Mat3 A;
+		for (int r = 0; r < 3; ++r)
+			for (int c = 0; c < 3; ++c)
+				A(r, c) = d(generator);
+		check_decomposition(A + A.transpose());
+	}
+}
+
+TEST(SymmetricEigen_TEST, Degenerate)
+{
+	check_decomposition(Mat3::Zero());
+	check_decomposition(Mat3::Identity() * 3.0);
+	check_decomposition(Vec3(2.0, -1.0, 5.0).asDiagonal());
+
+	// rank 1 and rank 2 matrices (as projected curvature tensors)
+	const Vec3 u = Vec3(1.0, 2.0, -0.5).normalized();
+	const Vec3 v = u.cross(Vec3(0.0, 0.0, 1.0)).normalized();
+	check_decomposition(u * u.transpose());
+	check_decomposition(u * u.transpose() + v * v.transpose());
+	check_decomposition(2.0 * u * u.transpose() - 0.5 * v * v.transpose());
+
+	// double eigen value
+	check_decomposition(Mat3::Identity() + 1e-3 * u * u.transpose());
+	check_decomposition(1e-12 * (u * u.transpose() + v * v.transpose()));
+}
@@ -90,6 +90,15 @@ public:
 
 	virtual void to_chunk_array(ChunkArrayGen* ca_gen) const = 0;
 	virtual ChunkArrayGen* add_attribute(ChunkArrayContainer& cac, const std::string& att_name) const = 0;
+	/**
+	 * @brief add_attribute, same as above but the container is grown to hold nb_elements elements instead of size() ones.
+	 */
+	virtual ChunkArrayGen* add_attribute(ChunkArrayContainer& cac, const std::string& att_name, std::size_t nb_elements) const = 0;
+	/**
+	 * @brief binary_to_chunk_array, converts n binary elements of type BUFFER_T to T and stores them directly in the chunk array, from index first.
+	 * The buffer of the DataInput is not used, this allows to fill a chunk array by blocks without intermediate copy.
+	 */
+	virtual void binary_to_chunk_array(const char* data, std::size_t n, uint32 first, bool big_endian, ChunkArrayGen* ca_gen) const = 0;
 
 	virtual uint32 nb_components() const = 0;
 
@@ -162,17 +171,20 @@ public:
 			}
 			else
 			{ // 2nd case : BUFFER_T and T are different.
-				std::vector<BUFFER_T> buffer(old_size+n);
-				fp.read(reinterpret_cast<char*>(&buffer[old_size]), n * sizeof(BUFFER_T));
+				std::vector<BUFFER_T> buffer(n);
+				fp.read(reinterpret_cast<char*>(&buffer[0]), n * sizeof(BUFFER_T));
 				if ((big_endian && cgogn::internal::cgogn_is_little_endian) || (!big_endian && cgogn::internal::cgogn_is_big_endian))
 				{
-					for (auto it = buffer.begin() + old_size, end = buffer.end() ; it != end; ++it)
+					for (auto it = buffer.begin(), end = buffer.end() ; it != end; ++it)
 						*it = cgogn::swap_endianness(*it);
 				}
 				if (fp.eof() || fp.bad())
+				{
 					this->reset();
+					return;
+				}
 				// copy
-				auto dest_it = data_.begin();
+				auto dest_it = data_.begin() + old_size;
 				for (auto & x : buffer)
 					*dest_it++ = internal::convert<T>(x);
 			}
@@ -254,6 +266,28 @@ public:
 		return cac.template add_chunk_array<T>(att_name);
 	}
 
+	virtual ChunkArray* add_attribute(ChunkArrayContainer& cac, const std::string& att_name, std::size_t nb_elements) const override
+	{
+		for (std::size_t i = cac.capacity(); i < nb_elements; i += PRIM_SIZE)
+			cac.template insert_lines<PRIM_SIZE>();
+		return cac.template add_chunk_array<T>(att_name);
+	}
+
+	virtual void binary_to_chunk_array(const char* data, std::size_t n, uint32 first, bool big_endian, ChunkArrayGen* ca_gen) const override
+	{
+		ChunkArray* ca = dynamic_cast<ChunkArray*>(ca_gen);
+		cgogn_assert(ca != nullptr);
+		const bool swap = (big_endian && cgogn::internal::cgogn_is_little_endian) || (!big_endian && cgogn::internal::cgogn_is_big_endian);
+		BUFFER_T buff;
+		for (std::size_t i = 0ul; i < n; ++i, data += sizeof(BUFFER_T))
+		{
+			std::memcpy(&buff, data, sizeof(BUFFER_T));
+			if (swap)
+				buff = cgogn::swap_endianness(buff);
+			ca->operator[](first + uint32(i)) = internal::convert<T>(buff);
+		}
+	}
+
 	virtual void to_chunk_array(ChunkArrayGen* ca_gen) const override
 	{
 		ChunkArray* ca = dynamic_cast<ChunkArray *>(ca_gen);
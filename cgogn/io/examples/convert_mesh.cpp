@@ -37,10 +37,11 @@ int main(int argc, char** argv)
 	bool output_is_binary = false;
 	bool compress_output = false;
 	bool overwrite_output = false;
+	bool raw_appended_data = false;
 
 	if (argc < 4 || argc > 8)
 	{
-		cgogn_log_info("convert_mesh") << "USAGE: " << argv[0] << " [input_filename] [output_filename] [bool(is_surface)] [bool(binary_output)](optional, default 0) [bool(compress_output)](optional, default 0) [bool(overwrite_output)](optional, default 0)";
+		cgogn_log_info("convert_mesh") << "USAGE: " << argv[0] << " [input_filename] [output_filename] [bool(is_surface)] [bool(binary_output)](optional, default 0) [bool(compress_output)](optional, default 0) [bool(overwrite_output)](optional, default 0) [bool(raw_appended_data)](optional, default 0)";
 		return 0;
 	} else {
 		input_filename = std::string(argv[1]);
@@ -52,6 +53,8 @@ int main(int argc, char** argv)
 			compress_output = string_to_bool(argv[5]);
 		if (argc > 6)
 			overwrite_output = string_to_bool(argv[6]);
+		if (argc > 7)
+			raw_appended_data = string_to_bool(argv[7]);
 
 		cgogn_log_info("convert_mesh") << "input mesh : " << input_filename;
 		cgogn_log_info("convert_mesh") << "output mesh : " << output_filename;
@@ -63,11 +66,11 @@ int main(int argc, char** argv)
 	{
 		Map2 map;
 		cgogn::io::import_surface<Vec3>(map, input_filename);
-		cgogn::io::export_surface(map, cgogn::io::ExportOptions(output_filename, {vertex2, "position"}, {{vertex2, "normal"}, {face2, "normal"}}, output_is_binary, compress_output, overwrite_output));
+		cgogn::io::export_surface(map, cgogn::io::ExportOptions(output_filename, {vertex2, "position"}, {{vertex2, "normal"}, {face2, "normal"}}, output_is_binary, compress_output, overwrite_output, raw_appended_data));
 	} else {
 		Map3 map;
 		cgogn::io::import_volume<Vec3>(map, input_filename);
-		cgogn::io::export_volume(map, cgogn::io::ExportOptions(output_filename, {vertex3, "position"}, {}, output_is_binary, compress_output, overwrite_output));
+		cgogn::io::export_volume(map, cgogn::io::ExportOptions(output_filename, {vertex3, "position"}, {}, output_is_binary, compress_output, overwrite_output, raw_appended_data));
 	}
 
 	return 0;
@@ -25,11 +25,13 @@
 #include <istream>
 #include <iostream>
 #include <map>
+#include <fstream>
 
 #include <zlib.h>
 
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/utils/string.h>
+#include <cgogn/core/utils/thread_pool.h>
 #include <cgogn/io/io_utils.h>
 
 namespace cgogn
@@ -41,43 +43,55 @@ namespace io
 CGOGN_IO_API std::vector<std::vector<unsigned char>> zlib_compress(const unsigned char* input, std::size_t size, std::size_t chunk_size)
 {
 	chunk_size = std::min(size, chunk_size);
-	std::size_t buffer_size{0ul};
-	std::vector<std::vector<unsigned char>> res;
-	res.reserve(64);
+	const std::size_t nb_blocks = (chunk_size == 0ul) ? 1ul : (size + chunk_size - 1ul) / chunk_size;
+	std::vector<std::vector<unsigned char>> res(nb_blocks);
 
-	// zlib init
-	int32 ret;
-	z_stream zstream;
-	zstream.zalloc = Z_NULL;
-	zstream.zfree = Z_NULL;
-	zstream.opaque = Z_NULL;
-
-	do
+	auto compress_block = [&] (std::size_t block)
 	{
+		const std::size_t block_begin = block * chunk_size;
+		const std::size_t block_size = std::min(chunk_size, size - block_begin);
+
+		// zlib init
+		int32 ret;
+		z_stream zstream;
+		zstream.zalloc = Z_NULL;
+		zstream.zfree = Z_NULL;
+		zstream.opaque = Z_NULL;
 		ret = deflateInit(&zstream, Z_BEST_COMPRESSION);
 		cgogn_assert(ret == Z_OK);
 
-		buffer_size = deflateBound(&zstream, static_cast<uLong>(std::min(chunk_size, size)));
+		std::vector<unsigned char>& out = res[block];
+		const std::size_t buffer_size = deflateBound(&zstream, static_cast<uLong>(block_size));
+		out.resize(buffer_size);
 
-		zstream.avail_in = static_cast<uLong>(std::min(chunk_size, size));
-		size -= zstream.avail_in;
-		zstream.next_in = input;
-		input += zstream.avail_in;
-		res.emplace_back(buffer_size);
-		zstream.avail_out = static_cast<uLong>(res.back().size());
-		zstream.next_out = &(res.back()[0]);
-		cgogn_assert(zstream.next_out  != nullptr);
+		zstream.avail_in = static_cast<uInt>(block_size);
+		zstream.next_in = const_cast<unsigned char*>(input + block_begin);
+		zstream.avail_out = static_cast<uInt>(buffer_size);
+		zstream.next_out = &out[0];
 		ret = deflate(&zstream, Z_FINISH);
 		cgogn_assert(ret == Z_STREAM_END);
-		res.back().resize(buffer_size - zstream.avail_out);
-	} while (size > 0ul);
+		out.resize(buffer_size - zstream.avail_out);
+
+		/* clean up */
+		(void)deflateEnd(&zstream);
+	};
 
-	/* clean up and return */
-	(void)deflateEnd(&zstream);
+	std::vector<std::function<void()>> tasks;
+	tasks.reserve(nb_blocks);
+	for (std::size_t b = 0ul; b < nb_blocks; ++b)
+		tasks.push_back([&compress_block, b] () { compress_block(b); });
+	run_tasks(tasks);
 
 	return res;
 }
 
+CGOGN_IO_API void run_tasks(const std::vector<std::function<void()>>& tasks)
+{
+	// one range per task: the calling thread takes part in the work and never waits for a task that has not started
+	const uint32 nb_tasks = uint32(tasks.size());
+	parallel_foreach_range(nb_tasks, nb_tasks, [&tasks] (uint32 t, uint32, uint32) { tasks[t](); });
+}
+
 CGOGN_IO_API std::vector<unsigned char> zlib_decompress(const char* input, DataType header_type)
 {
 
@@ -196,6 +210,77 @@ CGOGN_IO_API std::vector<char> base64_encode(const char* input_buffer, std::size
 }
 
 
+Base64Encoder::Base64Encoder(std::ostream& output) :
+	output_(output),
+	nb_pending_(0u),
+	buffer_(4096ul),
+	buffer_pos_(0ul)
+{}
+
+Base64Encoder::~Base64Encoder()
+{
+	flush();
+}
+
+void Base64Encoder::encode(const char* input, std::size_t size)
+{
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(input);
+
+	// complete the quantum left by the previous call
+	while (nb_pending_ != 0u && size > 0ul)
+	{
+		pending_[nb_pending_++] = *in++;
+		--size;
+		if (nb_pending_ == 3u)
+		{
+			encode_quantum(&pending_[0]);
+			nb_pending_ = 0u;
+		}
+	}
+
+	for (; size >= 3ul; size -= 3ul, in += 3)
+		encode_quantum(in);
+
+	for (; size > 0ul; --size)
+		pending_[nb_pending_++] = *in++;
+}
+
+void Base64Encoder::flush()
+{
+	if (nb_pending_ != 0u)
+	{
+		for (uint32 i = nb_pending_; i < 3u; ++i)
+			pending_[i] = 0u;
+		encode_quantum(&pending_[0]);
+		for (uint32 i = nb_pending_ + 1u; i < 4u; ++i)
+			buffer_[buffer_pos_ - 4ul + i] = '=';
+		nb_pending_ = 0u;
+	}
+	write_buffer();
+}
+
+void Base64Encoder::encode_quantum(const unsigned char* in)
+{
+	const static char encode_lookup[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	if (buffer_pos_ + 4ul > buffer_.size())
+		write_buffer();
+
+	char* out = &buffer_[buffer_pos_];
+	out[0] = encode_lookup[in[0] >> 2];
+	out[1] = encode_lookup[((in[0] & 0x03) << 4) | (in[1] >> 4)];
+	out[2] = encode_lookup[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
+	out[3] = encode_lookup[in[2] & 0x3f];
+	buffer_pos_ += 4ul;
+}
+
+void Base64Encoder::write_buffer()
+{
+	if (buffer_pos_ > 0ul)
+		output_.write(&buffer_[0], std::streamsize(buffer_pos_));
+	buffer_pos_ = 0ul;
+}
+
 CGOGN_IO_API std::vector<unsigned char> base64_decode(const char* input, std::size_t begin, std::size_t length)
 {
 	const char padCharacter('=');
@@ -340,6 +425,25 @@ CGOGN_IO_API DataType data_type(const std::string& type_name)
 		return DataType::UNKNOWN;
 }
 
+CGOGN_IO_API uint32 data_type_size(DataType type)
+{
+	switch (type)
+	{
+		case DataType::CHAR:
+		case DataType::INT8:
+		case DataType::UINT8:	return 1u;
+		case DataType::INT16:
+		case DataType::UINT16:	return 2u;
+		case DataType::INT32:
+		case DataType::UINT32:
+		case DataType::FLOAT:	return 4u;
+		case DataType::INT64:
+		case DataType::UINT64:
+		case DataType::DOUBLE:	return 8u;
+		default:				return 0u;
+	}
+}
+
 CharArrayBuffer::~CharArrayBuffer() {}
 
 IMemoryStream::~IMemoryStream() {}
@@ -349,6 +453,37 @@ CGOGN_IO_API bool file_exists(const std::string& filename)
 	return std::ifstream(filename).good();
 }
 
+namespace
+{
+
+// output file stream writing through a large buffer, so that the data is written by big blocks
+class BufferedOFStream : public std::ofstream
+{
+public:
+
+	static const std::size_t BUFFER_SIZE = 1048576ul;
+
+	inline BufferedOFStream(const std::string& filename, std::ios_base::openmode mode) :
+		std::ofstream(),
+		buffer_(BUFFER_SIZE)
+	{
+		this->rdbuf()->pubsetbuf(&buffer_[0], std::streamsize(buffer_.size()));
+		this->open(filename, mode);
+	}
+
+	// the file is closed (and flushed) before the destruction of the buffer
+	inline ~BufferedOFStream() override
+	{
+		this->close();
+	}
+
+private:
+
+	std::vector<char> buffer_;
+};
+
+} // namespace
+
 CGOGN_IO_API std::unique_ptr<std::ofstream> create_file(const std::string& filename, bool binary, bool overwrite)
 {
 	std::unique_ptr<std::ofstream> output;
@@ -374,7 +509,7 @@ CGOGN_IO_API std::unique_ptr<std::ofstream> create_file(const std::string& filen
 			cgogn_log_warning("create_file")  << "The output filename has been changed to \"" << new_filename << "\"";
 		}
 	}
-	output = cgogn::make_unique<std::ofstream>(new_filename, open_mode);
+	output = cgogn::make_unique<BufferedOFStream>(new_filename, open_mode);
 	if (!output->good())
 		cgogn_log_warning("create_file")  << "Error while opening the file \"" << filename << "\"";
 	return output;
@@ -25,6 +25,8 @@
 #define CGOGN_IO_IO_UTILS_H_
 
 #include <type_traits>
+#include <array>
+#include <functional>
 #include <sstream>
 #include <streambuf>
 
@@ -69,13 +71,14 @@ namespace io
 
 struct ExportOptions
 {
-	inline ExportOptions(const std::string& filename,std::pair<Orbit, std::string> position_attribute, std::vector<std::pair<Orbit, std::string>> const& attributes = {}, bool binary = true, bool compress = false, bool overwrite = true) :
+	inline ExportOptions(const std::string& filename,std::pair<Orbit, std::string> position_attribute, std::vector<std::pair<Orbit, std::string>> const& attributes = {}, bool binary = true, bool compress = false, bool overwrite = true, bool raw_appended_data = false) :
 		filename_(filename),
 		position_attribute_(position_attribute),
 		attributes_to_export_(attributes),
 		binary_(binary),
 		compress_(compress),
-		overwrite_(overwrite)
+		overwrite_(overwrite),
+		raw_appended_data_(raw_appended_data)
 	{}
 
 	std::string filename_;
@@ -84,7 +87,8 @@ struct ExportOptions
 	bool binary_;
 	bool compress_;
 	bool overwrite_;
-
+	// binary VTK XML files only : store the data in a raw <AppendedData> section instead of base64 encoded DataArrays
+	bool raw_appended_data_;
 };
 
 enum FileType
@@ -133,13 +137,53 @@ CGOGN_IO_API bool							file_exists(const std::string& filename);
 CGOGN_IO_API std::unique_ptr<std::ofstream>	create_file(const std::string& filename, bool binary, bool overwrite);
 CGOGN_IO_API FileType						file_type(const std::string& filename);
 CGOGN_IO_API DataType						data_type(const std::string& type_name);
+CGOGN_IO_API uint32							data_type_size(DataType type);
 
 CGOGN_IO_API std::vector<char>				base64_encode(const char* input_buffer, std::size_t buffer_size);
 CGOGN_IO_API std::vector<unsigned char>		base64_decode(const char* input, std::size_t begin, std::size_t length = std::numeric_limits<std::size_t>::max());
 
 CGOGN_IO_API std::vector<unsigned char>					zlib_decompress(const char* input, DataType header_type);
+/**
+ * @brief zlib_compress, compress the input by blocks of chunk_size bytes
+ * The blocks are independent zlib streams, they are compressed in parallel using the thread pool.
+ * @return the compressed blocks, in the order of the input
+ */
 CGOGN_IO_API std::vector<std::vector<unsigned char>>	zlib_compress(const unsigned char* input, std::size_t size, std::size_t chunk_size = std::numeric_limits<std::size_t>::max());
 
+/**
+ * @brief run_tasks, runs the given independent tasks on the thread pool, the calling thread takes part in the work.
+ * Returns when all the tasks are done. It can be called from a task running on the thread pool.
+ */
+CGOGN_IO_API void run_tasks(const std::vector<std::function<void()>>& tasks);
+
+/**
+ * @brief The Base64Encoder class
+ * Encodes a byte stream in base64 and writes it to an ostream through a small fixed-size buffer, without building the whole encoded string.
+ * The data can be given in several calls to encode(). A call to flush() terminates the current base64 stream (remaining quantum and padding).
+ */
+class CGOGN_IO_API Base64Encoder
+{
+public:
+
+	explicit Base64Encoder(std::ostream& output);
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(Base64Encoder);
+	~Base64Encoder();
+
+	void encode(const char* input, std::size_t size);
+	void flush();
+
+private:
+
+	void encode_quantum(const unsigned char* in);
+	void write_buffer();
+
+	std::ostream& output_;
+	std::array<unsigned char, 3> pending_;
+	uint32 nb_pending_;
+	std::vector<char> buffer_;
+	std::size_t buffer_pos_;
+};
+
 namespace internal
 {
 
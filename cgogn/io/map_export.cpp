@@ -32,6 +32,8 @@ namespace io
 
 template CGOGN_IO_API void export_surface(CMap2<DefaultMapTraits>& , const ExportOptions&);
 template CGOGN_IO_API void export_volume(CMap3<DefaultMapTraits>& , const ExportOptions&);
+template CGOGN_IO_API void export_surfaces(CMap2<DefaultMapTraits>& , const std::vector<ExportOptions>&);
+template CGOGN_IO_API void export_volumes(CMap3<DefaultMapTraits>& , const std::vector<ExportOptions>&);
 
 } // namespace io
 } // namespace cgogn
@@ -63,6 +63,16 @@ inline void export_surface(MAP& map2, const ExportOptions& options);
 template <class MAP>
 inline void export_volume(MAP& map3, const ExportOptions& options);
 
+/**
+ * @brief export_surfaces, exports a map into several files (formats and/or attribute sets).
+ * The cells and the vertex numbering are computed once for all the files, which are then written in parallel.
+ */
+template <class MAP>
+inline void export_surfaces(MAP& map2, const std::vector<ExportOptions>& options);
+
+template <class MAP>
+inline void export_volumes(MAP& map3, const std::vector<ExportOptions>& options);
+
 template <class MAP>
 inline void export_surface(MAP& map2, const ExportOptions& options)
 {
@@ -81,6 +91,34 @@ inline void export_volume(MAP& map3, const ExportOptions& options)
 		ve->export_file(map3,options);
 }
 
+template <class MAP>
+inline void export_surfaces(MAP& map2, const std::vector<ExportOptions>& options)
+{
+	static_assert(MAP::DIMENSION == 2,"export_surfaces is designed for 2D maps.");
+	std::vector<std::unique_ptr<SurfaceExport<MAP>>> exporters;
+	std::vector<MeshExport<MAP>*> exporters_ptr;
+	for (const ExportOptions& opt : options)
+	{
+		exporters.push_back(new_surface_export<MAP>(opt.filename_));
+		exporters_ptr.push_back(exporters.back().get());
+	}
+	MeshExport<MAP>::export_files(map2, exporters_ptr, options);
+}
+
+template <class MAP>
+inline void export_volumes(MAP& map3, const std::vector<ExportOptions>& options)
+{
+	static_assert(MAP::DIMENSION == 3,"export_volumes is designed for 3D maps.");
+	std::vector<std::unique_ptr<VolumeExport<MAP>>> exporters;
+	std::vector<MeshExport<MAP>*> exporters_ptr;
+	for (const ExportOptions& opt : options)
+	{
+		exporters.push_back(new_volume_export<MAP>(opt.filename_));
+		exporters_ptr.push_back(exporters.back().get());
+	}
+	MeshExport<MAP>::export_files(map3, exporters_ptr, options);
+}
+
 template <typename MAP>
 inline std::unique_ptr<SurfaceExport<MAP> > new_surface_export(const std::string& filename)
 {
@@ -120,6 +158,8 @@ inline std::unique_ptr<VolumeExport<MAP> > new_volume_export(const std::string&
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_IO_MAP_EXPORT_CPP_))
 extern template CGOGN_IO_API void export_surface(CMap2<DefaultMapTraits>& , const ExportOptions&);
 extern template CGOGN_IO_API void export_volume(CMap3<DefaultMapTraits>& , const ExportOptions&);
+extern template CGOGN_IO_API void export_surfaces(CMap2<DefaultMapTraits>& , const std::vector<ExportOptions>&);
+extern template CGOGN_IO_API void export_volumes(CMap3<DefaultMapTraits>& , const std::vector<ExportOptions>&);
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_IO_MAP_EXPORT_CPP_))
 
 } // namespace io
@@ -50,14 +50,19 @@ namespace cgogn
 namespace io
 {
 
+/**
+ * @brief newSurfaceImport, creates the importer of a surface file from its extension
+ * @param welding_epsilon only used for STL files : the corners of the triangles that are closer than epsilon
+ * in each coordinate are welded into a vertex (0 welds the identical corners only)
+ */
 template <typename MAP_TRAITS, typename VEC3>
-inline std::unique_ptr<SurfaceFileImport<MAP_TRAITS, VEC3>> newSurfaceImport(const std::string& filename);
+inline std::unique_ptr<SurfaceFileImport<MAP_TRAITS, VEC3>> newSurfaceImport(const std::string& filename, float64 welding_epsilon = 0.0);
 
 template <typename MAP_TRAITS, typename VEC3>
 inline std::unique_ptr<VolumeFileImport<MAP_TRAITS, VEC3>> newVolumeImport(const std::string& filename);
 
 template <typename VEC3, typename MAP2>
-inline void import_surface(MAP2& cmap2, const std::string& filename);
+inline void import_surface(MAP2& cmap2, const std::string& filename, float64 welding_epsilon = 0.0);
 
 template <typename VEC3, typename MAP3>
 inline void import_volume(MAP3& cmap3, const std::string& filename);
@@ -66,9 +71,9 @@ inline void import_volume(MAP3& cmap3, const std::string& filename);
 
 
 template <typename VEC3, typename MAP2>
-inline void import_surface(MAP2& cmap2, const std::string& filename)
+inline void import_surface(MAP2& cmap2, const std::string& filename, float64 welding_epsilon)
 {
-	auto si = newSurfaceImport<typename MAP2::Traits, VEC3>(filename);
+	auto si = newSurfaceImport<typename MAP2::Traits, VEC3>(filename, welding_epsilon);
 	if (si)
 	{
 		if (si->import_file(filename))
@@ -88,7 +93,7 @@ inline void import_volume(MAP3& cmap3, const std::string& filename)
 }
 
 template <typename MAP_TRAITS, typename VEC3>
-inline std::unique_ptr<SurfaceFileImport<MAP_TRAITS, VEC3> > newSurfaceImport(const std::string& filename)
+inline std::unique_ptr<SurfaceFileImport<MAP_TRAITS, VEC3> > newSurfaceImport(const std::string& filename, float64 welding_epsilon)
 {
 	const FileType ft = file_type(filename);
 	switch (ft)
@@ -99,7 +104,7 @@ inline std::unique_ptr<SurfaceFileImport<MAP_TRAITS, VEC3> > newSurfaceImport(co
 		case FileType::FileType_VTP: return make_unique<VtkSurfaceImport<MAP_TRAITS, VEC3>>();
 		case FileType::FileType_OBJ: return make_unique<ObjSurfaceImport<MAP_TRAITS, VEC3>>();
 		case FileType::FileType_PLY: return make_unique<PlySurfaceImport<MAP_TRAITS, VEC3>>();
-		case FileType::FileType_STL: return make_unique<StlSurfaceImport<MAP_TRAITS, VEC3>>();
+		case FileType::FileType_STL: return make_unique<StlSurfaceImport<MAP_TRAITS, VEC3>>(typename geometry::vector_traits<VEC3>::Scalar(welding_epsilon));
 		case FileType::FileType_MSH: return make_unique<MshSurfaceImport<MAP_TRAITS, VEC3>>();
 		case FileType::FileType_MESHB: return make_unique<LM6SurfaceImport<MAP_TRAITS, VEC3>>();
 		default:
@@ -128,8 +133,8 @@ inline std::unique_ptr<VolumeFileImport<MAP_TRAITS, VEC3> > newVolumeImport(cons
 }
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_IO_MAP_IMPORT_CPP_))
-extern template CGOGN_IO_API void import_surface<Eigen::Vector3f>(CMap2<DefaultMapTraits>& , const std::string&);
-extern template CGOGN_IO_API void import_surface<Eigen::Vector3d>(CMap2<DefaultMapTraits>& , const std::string&);
+extern template CGOGN_IO_API void import_surface<Eigen::Vector3f>(CMap2<DefaultMapTraits>& , const std::string&, float64);
+extern template CGOGN_IO_API void import_surface<Eigen::Vector3d>(CMap2<DefaultMapTraits>& , const std::string&, float64);
 extern template CGOGN_IO_API void import_volume<Eigen::Vector3f>(CMap3<DefaultMapTraits>& , const std::string&);
 extern template CGOGN_IO_API void import_volume<Eigen::Vector3d>(CMap3<DefaultMapTraits>& , const std::string&);
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_IO_MAP_IMPORT_CPP_))
@@ -25,6 +25,8 @@
 #define CGOGN_IO_MESH_IO_GEN_H_
 
 #include <fstream>
+#include <functional>
+#include <memory>
 
 #include <cgogn/core/utils/numerics.h>
 #include <cgogn/core/utils/masks.h>
@@ -80,7 +82,7 @@ public:
 		Scoped_C_Locale loc;
 		this->reset();
 
-		this->cell_cache_ = cgogn::make_unique<CellCache>(map);
+		this->cell_cache_ = std::make_shared<CellCache>(map);
 		cgogn_assert(cell_cache_);
 
 		auto output = io::create_file(options.filename_, options.binary_, options.overwrite_);
@@ -98,10 +100,66 @@ public:
 			return;
 		}
 
+		this->prepare_cells(map);
 		this->export_file_impl(map,*output, options);
 		this->clean_added_attributes(map);
 	}
 
+	/**
+	 * @brief export_files, exports a map into several files, exporters[i] writing the file described by options[i].
+	 * The cell cache, the vertex numbering and the other cell data are built once by the first valid exporter and shared
+	 * with the other ones, then the files are written in parallel.
+	 * All the exporters must have the same dimension (i.e. all SurfaceExport or all VolumeExport).
+	 */
+	static void export_files(Map& map, const std::vector<Self*>& exporters, const std::vector<ExportOptions>& options)
+	{
+		cgogn_message_assert(exporters.size() == options.size(), "export_files: one ExportOptions is needed per exporter.");
+		Scoped_C_Locale loc;
+
+		Self* leader = nullptr;
+		std::vector<std::function<void()>> tasks;
+		std::vector<std::unique_ptr<std::ofstream>> outputs(exporters.size());
+
+		for (std::size_t i = 0ul, end = exporters.size(); i < end; ++i)
+		{
+			Self* e = exporters[i];
+			if (e == nullptr)
+				continue;
+
+			e->reset();
+			e->prepare_for_export(map, options[i]);
+			if (e->position_attribute_ == nullptr)
+			{
+				cgogn_log_warning("MeshExport::export_files") << "The position attribute is invalid, the file \"" << options[i].filename_ << "\" is not exported.";
+				continue;
+			}
+
+			outputs[i] = io::create_file(options[i].filename_, options[i].binary_, options[i].overwrite_);
+			if (!outputs[i] || !outputs[i]->good())
+				continue;
+
+			if (leader == nullptr)
+			{
+				leader = e;
+				leader->cell_cache_ = std::make_shared<CellCache>(map);
+				map.add_attribute(leader->indices_, "indices_vert_export");
+				leader->prepare_cells(map);
+			}
+			else
+				e->share_cells(*leader);
+
+			const Map& const_map = map;
+			std::ofstream& output = *outputs[i];
+			const ExportOptions& opt = options[i];
+			tasks.push_back([e, &const_map, &output, &opt] () { e->export_file_impl(const_map, output, opt); });
+		}
+
+		run_tasks(tasks);
+
+		if (leader)
+			leader->clean_added_attributes(map);
+	}
+
 	virtual ~MeshExport() {}
 
 protected:
@@ -121,7 +179,23 @@ protected:
 	}
 
 	virtual void export_file_impl(const Map& map, std::ofstream& output, const ExportOptions& options) = 0;
+	/**
+	 * @brief prepare_for_export, selects the attributes to export.
+	 */
 	virtual void prepare_for_export(Map& map, const ExportOptions& options) = 0;
+	/**
+	 * @brief prepare_cells, builds the cell cache, the vertex numbering (indices_) and the other data that depends only on the map.
+	 */
+	virtual void prepare_cells(Map& map) = 0;
+
+	/**
+	 * @brief share_cells, uses the cell data prepared by another exporter of the same map.
+	 */
+	virtual void share_cells(const Self& other)
+	{
+		cell_cache_ = other.cell_cache_;
+		indices_ = other.indices_;
+	}
 	virtual void reset()
 	{
 		position_attribute_ = nullptr;
@@ -132,7 +206,7 @@ protected:
 	VertexAttribute<uint32>				indices_;
 	std::vector<const ChunkArrayGen*>	vertex_attributes_;
 	const ChunkArrayGen*				position_attribute_;
-	std::unique_ptr<CellCache>			cell_cache_;
+	std::shared_ptr<CellCache>			cell_cache_;
 };
 
 
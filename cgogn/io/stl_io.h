@@ -24,6 +24,9 @@
 #ifndef CGOGN_IO_STL_IO_H_
 #define CGOGN_IO_STL_IO_H_
 
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/union_find.h>
+
 #include <cgogn/geometry/types/eigen.h>
 #include <cgogn/geometry/types/vec.h>
 #include <cgogn/geometry/types/geometry_traits.h>
@@ -32,8 +35,11 @@
 #include <cgogn/io/surface_export.h>
 
 #include <iomanip>
-#include <map>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
 
 namespace cgogn
 {
@@ -41,6 +47,13 @@ namespace cgogn
 namespace io
 {
 
+/**
+ * @brief The StlSurfaceImport class imports ascii and binary STL files.
+ * The corners of the triangles are welded into vertices by a parallel sort over their (quantized) coordinates.
+ * With a welding epsilon of 0 (default) only the corners with exactly the same coordinates are merged,
+ * otherwise the corners that are closer than epsilon in each coordinate are merged, transitively
+ * (the position of the merged vertex is the one of the first corner read).
+ */
 template <typename MAP_TRAITS, typename VEC3>
 class StlSurfaceImport : public SurfaceFileImport<MAP_TRAITS, VEC3>
 {
@@ -52,38 +65,51 @@ public:
 	template <typename T>
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
-	inline StlSurfaceImport() {}
+	inline StlSurfaceImport(Scalar welding_epsilon = Scalar(0)) :
+		welding_epsilon_(welding_epsilon)
+	{}
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(StlSurfaceImport);
 	virtual ~StlSurfaceImport() override
 	{}
 
+	inline void set_welding_epsilon(Scalar eps)
+	{
+		cgogn_message_assert(eps >= Scalar(0), "The welding epsilon must be positive.");
+		welding_epsilon_ = eps;
+	}
+
+	inline Scalar welding_epsilon() const
+	{
+		return welding_epsilon_;
+	}
+
 protected:
 
 	virtual bool import_file_impl(const std::string& filename) override
 	{
 		std::ifstream fp(filename, std::ios::in);
-		ChunkArray<VEC3>* position = this->add_position_attribute();
 		ChunkArray<VEC3>* normal = this->face_attributes_.template add_chunk_array<VEC3>("normal");
 		std::string word;
 		fp >> word;
 		fp.close();
+
+		std::vector<VEC3> corners;
+		bool res;
 		if (to_lower(word) == "solid")
-			return this->import_ascii(filename, position, normal);
+			res = this->import_ascii(filename, corners, normal);
 		else
-			return this->import_binary(filename, position, normal);
-	}
-private:
+			res = this->import_binary(filename, corners, normal);
 
-	// put compare function here because lambda version do not compile on VS2013
-	inline static bool comp_fct(const VEC3& v1, const VEC3& v2)
-	{
-		return std::lexicographical_compare(&v1[0], &v1[0] + 3, &v2[0], &v2[0] + 3);
+		if (res)
+			this->weld_corners(corners, this->add_position_attribute());
+		return res;
 	}
 
-	bool import_ascii(const std::string& filename, ChunkArray<VEC3>* position, ChunkArray<VEC3>* normal)
+private:
+
+	bool import_ascii(const std::string& filename, std::vector<VEC3>& corners, ChunkArray<VEC3>* normal)
 	{
 		std::ifstream fp(filename, std::ios::in);
-		std::map<VEC3, uint32, bool(*)(const VEC3&, const VEC3&)> vertices_set(comp_fct);
 
 		std::string line;
 		std::getline(fp, line); // 1st line : solid name
@@ -104,25 +130,13 @@ private:
 			(*normal)[face_id] = norm;
 			std::getline(fp, line); // outer loop
 
-			std::array<VEC3, 3> pos;
 			for (uint32 i = 0u; i < 3; ++i)
 			{
 				std::getline(fp, line);
 				std::stringstream stream_pos(line);
-				stream_pos >> line >> pos[i][0] >> pos[i][1] >> pos[i][2];
-				const auto it =  vertices_set.find(pos[i]);
-				uint32 vertex_id{UINT32_MAX};
-
-				if (it == vertices_set.end())
-				{
-					vertex_id = this->vertex_attributes_.template insert_lines<1>();
-					vertices_set.insert(std::make_pair(pos[i], vertex_id));
-//					indices_set.push_back(vertex_id);
-				} else
-					vertex_id = it->second;
-
-				(*position)[vertex_id] = pos[i];
-				this->faces_vertex_indices_.push_back(vertex_id);
+				VEC3 pos;
+				stream_pos >> line >> pos[0] >> pos[1] >> pos[2];
+				corners.push_back(pos);
 			}
 			this->faces_nb_edges_.push_back(3u);
 			std::getline(fp, line); // endloop
@@ -131,7 +145,8 @@ private:
 
 		return true;
 	}
-	bool import_binary(const std::string& filename, ChunkArray<VEC3>* position, ChunkArray<VEC3>* normal)
+
+	bool import_binary(const std::string& filename, std::vector<VEC3>& corners, ChunkArray<VEC3>* normal)
 	{
 		std::ifstream fp(filename, std::ios::in | std::ios::binary);
 
@@ -139,47 +154,202 @@ private:
 		fp.read(reinterpret_cast<char*>(&header[0]), 21u* sizeof(uint32));
 		const uint32 nb_faces = swap_endianness_native_little(*reinterpret_cast<uint32*>(&header[20]));
 		this->reserve(nb_faces);
+		corners.reserve(3ul * nb_faces);
 
-		std::array<float32, 3> normal_buffer;
-		std::array<float32, 9> position_buffer;
+		// a triangle is stored on 50 bytes : normal, 3 positions (float32) and the attribute byte count (uint16)
+		const std::size_t triangle_size = 12u * sizeof(float32) + sizeof(uint16);
+		const uint32 nb_faces_per_block = 65536u;
+		std::vector<char> buffer(triangle_size * nb_faces_per_block);
+		std::array<float32, 12> values;
 
-		std::map<VEC3, uint32, bool(*)(const VEC3&, const VEC3&)> vertices_set(comp_fct);
-
-		for(uint32 i = 0u; i < nb_faces; ++i)
+		for (uint32 first = 0u; first < nb_faces; first += nb_faces_per_block)
 		{
-			fp.read(reinterpret_cast<char*>(&normal_buffer[0]), 3u*sizeof(float32));
-			fp.read(reinterpret_cast<char*>(&position_buffer[0]), 3u*3u*sizeof(float32));
-			fp.ignore(sizeof(int16));
-			for (auto& x : normal_buffer)
-				x = swap_endianness_native_little(x);
+			const uint32 nb = std::min(nb_faces_per_block, nb_faces - first);
+			fp.read(&buffer[0], std::streamsize(nb * triangle_size));
+			if (std::size_t(fp.gcount()) != nb * triangle_size)
+			{
+				cgogn_log_warning("StlSurfaceImport::import_binary") << "Unexpected end of file \"" << filename << "\".";
+				return false;
+			}
 
-			for (auto& x : position_buffer)
-				x = swap_endianness_native_little(x);
+			for (uint32 i = 0u; i < nb; ++i)
+			{
+				std::memcpy(&values[0], &buffer[i * triangle_size], 12u * sizeof(float32));
+				for (auto& x : values)
+					x = swap_endianness_native_little(x);
+
+				const uint32 face_id = this->face_attributes_.template insert_lines<1>();
+				(*normal)[face_id] = VEC3{Scalar(values[0]), Scalar(values[1]), Scalar(values[2])};
+				for (uint32 vid = 1u; vid < 4u; ++vid)
+					corners.push_back(VEC3{Scalar(values[3u*vid]), Scalar(values[3u*vid + 1u]), Scalar(values[3u*vid + 2u])});
+				this->faces_nb_edges_.push_back(3u);
+			}
+		}
+		return true;
+	}
 
-			const uint32 face_id = this->face_attributes_.template insert_lines<1>();
-			const VEC3 norm{Scalar(normal_buffer[0]), Scalar(normal_buffer[1]), Scalar(normal_buffer[2])};
-			(*normal)[face_id] = norm;
+	/**
+	 * @brief weld_corners, creates the vertices from the corners of the triangles and fills faces_vertex_indices_
+	 * The integer coordinates of the welding cell of each corner are computed once, then the corners are sorted
+	 * on them in parallel: the corners of a same cell form a group.
+	 * Two corners closer than epsilon in each coordinate lie in the same cell or in adjacent cells : the groups
+	 * of adjacent cells that have such a pair of corners are united, so that the welding does not depend on
+	 * the position of the corners in the grid (the closeness is transitive, a chain of close corners is welded).
+	 * Without welding, the cell of a corner is given by the bits of its coordinates (exact comparison).
+	 * The vertices are created in the order of their first corner, as a sequential welding would do.
+	 */
+	void weld_corners(const std::vector<VEC3>& corners, ChunkArray<VEC3>* position)
+	{
+		using Cell = std::array<int64, 3>;
+		struct CornerKey
+		{
+			Cell cell;
+			uint32 corner;
+		};
+
+		const uint32 nb_corners = uint32(corners.size());
+		const bool welding = welding_epsilon_ > Scalar(0);
+		const Scalar inv_eps = welding ? Scalar(1) / welding_epsilon_ : Scalar(0);
+		// bound of the cell coordinates, so that the adjacent cells do not overflow
+		const Scalar max_cell = Scalar(int64(1) << 52);
 
-			for(uint32 vid = 0u; vid < 3u ; ++vid)
+		auto corner_cell = [&] (uint32 c) -> Cell
+		{
+			Cell res;
+			for (uint32 i = 0u; i < 3u; ++i)
 			{
-				const VEC3 pos{Scalar(position_buffer[3u*vid]), Scalar(position_buffer[3u*vid + 1u]), Scalar(position_buffer[3u*vid + 2u])};
-				const auto it =  vertices_set.find(pos);
-				uint32 vertex_id{UINT32_MAX};
+				if (welding)
+					res[i] = int64(std::max(-max_cell, std::min(max_cell, std::floor(corners[c][i] * inv_eps))));
+				else
+				{
+					// adding 0 identifies -0 and +0
+					const Scalar x = corners[c][i] + Scalar(0);
+					typename std::conditional<sizeof(Scalar) == 8u, int64, int32>::type bits;
+					std::memcpy(&bits, &x, sizeof(Scalar));
+					res[i] = int64(bits);
+				}
+			}
+			return res;
+		};
+
+		auto less = [] (const CornerKey& k1, const CornerKey& k2) -> bool
+		{
+			return k1.cell < k2.cell;
+		};
 
-				if (it == vertices_set.end())
+		std::vector<CornerKey> keys(nb_corners);
+		parallel_foreach_range(nb_corners, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 c = begin; c < end; ++c)
+				keys[c] = CornerKey{corner_cell(c), c};
+		});
+		parallel_sort(keys, less);
+
+		// the groups of corners of a same cell are contiguous in the keys
+		std::vector<uint32> group_begin;
+		for (uint32 i = 0u; i < nb_corners; ++i)
+		{
+			if (i == 0u || less(keys[i - 1u], keys[i]))
+				group_begin.push_back(i);
+		}
+		const uint32 nb_groups = uint32(group_begin.size());
+		group_begin.push_back(nb_corners);
+
+		// the root of a set of groups is its smallest group
+		ConcurrentUnionFind groups(nb_groups);
+
+		if (welding)
+		{
+			// the 13 adjacent cells that follow a cell in lexicographic order (each pair of cells is visited once)
+			std::vector<Cell> offsets;
+			for (int64 dx = -1; dx <= 1; ++dx)
+				for (int64 dy = -1; dy <= 1; ++dy)
+					for (int64 dz = -1; dz <= 1; ++dz)
+						if (dx > 0 || (dx == 0 && (dy > 0 || (dy == 0 && dz > 0))))
+							offsets.push_back(Cell{{dx, dy, dz}});
+
+			auto find_group = [&] (const Cell& cell) -> uint32
+			{
+				uint32 first = 0u, last = nb_groups;
+				while (first < last)
 				{
-					vertex_id = this->vertex_attributes_.template insert_lines<1>();
-					vertices_set.insert(std::make_pair(pos, vertex_id));
-				} else
-					vertex_id = it->second;
+					const uint32 mid = first + (last - first) / 2u;
+					if (keys[group_begin[mid]].cell < cell)
+						first = mid + 1u;
+					else
+						last = mid;
+				}
+				if (first < nb_groups && keys[group_begin[first]].cell == cell)
+					return first;
+				return INVALID_INDEX;
+			};
+
+			auto close = [&] (uint32 g1, uint32 g2) -> bool
+			{
+				for (uint32 i = group_begin[g1]; i < group_begin[g1 + 1u]; ++i)
+				{
+					for (uint32 j = group_begin[g2]; j < group_begin[g2 + 1u]; ++j)
+					{
+						const VEC3& p1 = corners[keys[i].corner];
+						const VEC3& p2 = corners[keys[j].corner];
+						if (std::abs(p1[0] - p2[0]) < welding_epsilon_ && std::abs(p1[1] - p2[1]) < welding_epsilon_ && std::abs(p1[2] - p2[2]) < welding_epsilon_)
+							return true;
+					}
+				}
+				return false;
+			};
+
+			// the pairs of close groups are searched and united in parallel
+			parallel_foreach_range(nb_groups, [&] (uint32, uint32 begin, uint32 end)
+			{
+				for (uint32 g = begin; g < end; ++g)
+				{
+					const Cell& cell = keys[group_begin[g]].cell;
+					for (const Cell& o : offsets)
+					{
+						const uint32 h = find_group(Cell{{cell[0] + o[0], cell[1] + o[1], cell[2] + o[2]}});
+						if (h != INVALID_INDEX && !groups.same_set(g, h) && close(g, h))
+							groups.unite(g, h);
+					}
+				}
+			});
+		}
+
+		// the first corner of each set of groups
+		std::vector<uint32> set_first_corner(nb_groups, INVALID_INDEX);
+		for (uint32 g = 0u; g < nb_groups; ++g)
+		{
+			uint32& first = set_first_corner[groups.find(g)];
+			for (uint32 i = group_begin[g]; i < group_begin[g + 1u]; ++i)
+				first = std::min(first, keys[i].corner);
+		}
+
+		// each corner points to the first corner of its set
+		std::vector<uint32>& first_corner = this->faces_vertex_indices_;
+		first_corner.resize(nb_corners);
+		for (uint32 g = 0u; g < nb_groups; ++g)
+		{
+			const uint32 first = set_first_corner[groups.find(g)];
+			for (uint32 i = group_begin[g]; i < group_begin[g + 1u]; ++i)
+				first_corner[keys[i].corner] = first;
+		}
+		std::vector<CornerKey>().swap(keys);
 
-				(*position)[vertex_id] = pos;
-				this->faces_vertex_indices_.push_back(vertex_id);
+		// create the vertices and replace the first corners by the vertex indices
+		for (uint32 c = 0u; c < nb_corners; ++c)
+		{
+			if (first_corner[c] == c)
+			{
+				const uint32 vertex_id = this->vertex_attributes_.template insert_lines<1>();
+				(*position)[vertex_id] = corners[c];
+				first_corner[c] = vertex_id;
 			}
-			this->faces_nb_edges_.push_back(3u);
+			else
+				first_corner[c] = first_corner[first_corner[c]];
 		}
-		return true;
 	}
+
+	Scalar welding_epsilon_;
 };
 
 template <typename MAP>
@@ -107,6 +107,10 @@ private:
 			}
 		}
 
+	}
+
+	virtual void prepare_cells(Map& map) override
+	{
 		this->cell_cache_->template build<Vertex>();
 		this->cell_cache_->template build<Face>();
 		uint32 count{0u};
@@ -211,6 +211,18 @@ public:
 			position_attribute_ = dynamic_cast<ChunkArray<VEC3>*>(att);
 	}
 
+	/**
+	 * @brief add_vertex_attribute, add an attribute of the type of in_data for nb_vertices vertices, without copying any data.
+	 * @return the (uninitialized) chunk array, to be filled by the caller
+	 */
+	inline ChunkArrayGen* add_vertex_attribute(const DataInputGen& in_data, const std::string& att_name, uint32 nb_vertices)
+	{
+		ChunkArrayGen* att = in_data.add_attribute(vertex_attributes_, att_name, nb_vertices);
+		if (att_name == "position")
+			position_attribute_ = dynamic_cast<ChunkArray<VEC3>*>(att);
+		return att;
+	}
+
 	template<typename T>
 	inline ChunkArray<T>* add_vertex_attribute(const std::string& att_name)
 	{
@@ -227,6 +239,11 @@ public:
 		in_data.to_chunk_array(in_data.add_attribute(face_attributes_, att_name));
 	}
 
+	inline ChunkArrayGen* add_face_attribute(const DataInputGen& in_data, const std::string& att_name, uint32 nb_faces)
+	{
+		return in_data.add_attribute(face_attributes_, att_name, nb_faces);
+	}
+
 	inline ChunkArray<VEC3>* position_attribute()
 	{
 		return position_attribute_;
@@ -0,0 +1,165 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+#include <cgogn/io/map_export.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+
+/**
+ * STL files of a n x n grid of unit squares (2 triangles per square), whose vertices have integer coordinates:
+ * each corner of a triangle is moved by a random jitter, so that the corners of a vertex lie on both sides
+ * of the boundaries of the welding cells (the cell size divides the grid spacing).
+ */
+class StlImport_TEST : public testing::Test
+{
+protected:
+
+	static const uint32 SIZE = 10u;
+	const std::string filename_ = "stl_io_test.stl";
+
+	void TearDown() override
+	{
+		std::remove(filename_.c_str());
+	}
+
+	void write_grid(bool binary, float64 jitter)
+	{
+		std::mt19937 generator(7u);
+		std::uniform_real_distribution<float64> random(-jitter, jitter);
+		std::vector<float32> triangles; // normal and 3 corners
+		auto add_corner = [&] (uint32 i, uint32 j)
+		{
+			triangles.push_back(float32(float64(i) + random(generator)));
+			triangles.push_back(float32(float64(j) + random(generator)));
+			triangles.push_back(float32(random(generator)));
+		};
+		for (uint32 j = 0u; j < SIZE; ++j)
+		{
+			for (uint32 i = 0u; i < SIZE; ++i)
+			{
+				triangles.insert(triangles.end(), { 0.0f, 0.0f, 1.0f });
+				add_corner(i, j); add_corner(i + 1u, j); add_corner(i + 1u, j + 1u);
+				triangles.insert(triangles.end(), { 0.0f, 0.0f, 1.0f });
+				add_corner(i, j); add_corner(i + 1u, j + 1u); add_corner(i, j + 1u);
+			}
+		}
+		const uint32 nb_triangles = uint32(triangles.size() / 12u);
+
+		if (binary)
+		{
+			std::ofstream out(filename_, std::ios::binary);
+			const std::string header(80u, ' ');
+			out.write(header.c_str(), 80);
+			out.write(reinterpret_cast<const char*>(&nb_triangles), sizeof(uint32));
+			const uint16 attribute = 0u;
+			for (uint32 t = 0u; t < nb_triangles; ++t)
+			{
+				out.write(reinterpret_cast<const char*>(&triangles[12u * t]), 12u * sizeof(float32));
+				out.write(reinterpret_cast<const char*>(&attribute), sizeof(uint16));
+			}
+		}
+		else
+		{
+			std::ofstream out(filename_);
+			out.precision(9);
+			out << "solid grid\n";
+			for (uint32 t = 0u; t < nb_triangles; ++t)
+			{
+				const float32* v = &triangles[12u * t];
+				out << "facet normal " << v[0] << " " << v[1] << " " << v[2] << "\n" << "outer loop\n";
+				for (uint32 k = 1u; k < 4u; ++k)
+					out << "vertex " << v[3u * k] << " " << v[3u * k + 1u] << " " << v[3u * k + 2u] << "\n";
+				out << "endloop\n" << "endfacet\n";
+			}
+			out << "endsolid grid\n";
+		}
+	}
+
+	uint32 nb_imported_vertices(float64 welding_epsilon)
+	{
+		CMap2 map;
+		cgogn::io::import_surface<Vec3>(map, filename_, welding_epsilon);
+		EXPECT_EQ(map.nb_cells<Face::ORBIT>(), 2u * SIZE * SIZE);
+		return map.nb_cells<Vertex::ORBIT>();
+	}
+};
+
+TEST_F(StlImport_TEST, ExactWelding)
+{
+	for (bool binary : { false, true })
+	{
+		write_grid(binary, 0.0);
+		EXPECT_EQ(nb_imported_vertices(0.0), (SIZE + 1u) * (SIZE + 1u));
+		EXPECT_EQ(nb_imported_vertices(1e-3), (SIZE + 1u) * (SIZE + 1u));
+	}
+}
+
+// the corners of a vertex that lie in adjacent welding cells are welded
+TEST_F(StlImport_TEST, WeldingAcrossCells)
+{
+	for (bool binary : { false, true })
+	{
+		write_grid(binary, 1e-4);
+		EXPECT_EQ(nb_imported_vertices(1e-3), (SIZE + 1u) * (SIZE + 1u));
+		EXPECT_EQ(nb_imported_vertices(0.25), (SIZE + 1u) * (SIZE + 1u));
+		// no welding: each corner is a vertex (the grid is then split in its triangles)
+		EXPECT_EQ(nb_imported_vertices(0.0), 6u * SIZE * SIZE);
+		EXPECT_EQ(nb_imported_vertices(1e-7), 6u * SIZE * SIZE);
+	}
+}
+
+TEST_F(StlImport_TEST, ExportImport)
+{
+	CMap2 map;
+	cgogn::io::import_surface<Vec3>(map, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+	CMap2::FaceAttribute<Vec3> normal = map.add_attribute<Vec3, Face::ORBIT>("normal");
+	normal.set_all_values(Vec3(0.0, 0.0, 1.0));
+
+	for (bool binary : { false, true })
+	{
+		cgogn::io::export_surface(map, cgogn::io::ExportOptions(filename_, { cgogn::Orbit(Vertex::ORBIT), "position" }, { { cgogn::Orbit(Face::ORBIT), "normal" } }, binary));
+		CMap2 imported;
+		cgogn::io::import_surface<Vec3>(imported, filename_);
+		EXPECT_EQ(imported.nb_cells<Vertex::ORBIT>(), map.nb_cells<Vertex::ORBIT>());
+		EXPECT_EQ(imported.nb_cells<Face::ORBIT>(), map.nb_cells<Face::ORBIT>());
+		EXPECT_TRUE((imported.get_attribute<Vec3, Face::ORBIT>("normal").is_valid()));
+	}
+}
@@ -0,0 +1,215 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+#include <cgogn/io/map_export.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using CMap3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+
+// the value stored in the vertex attribute, recomputed from the position after the import
+inline float64 vertex_value(const Vec3& p)
+{
+	return p[0] + 2.0 * p[1] + 3.0 * p[2];
+}
+
+// the value stored in the cell attribute, recomputed from the positions of the vertices after the import
+template <typename MAP, typename CellType>
+float64 cell_value(const MAP& map, const typename MAP::template VertexAttribute<Vec3>& position, CellType c)
+{
+	float64 res = 0.0;
+	map.foreach_incident_vertex(c, [&] (typename MAP::Vertex v) { res += vertex_value(position[v]); });
+	return res;
+}
+
+/**
+ * export a map with a vertex and a cell attribute in a VTK XML file, import it back
+ * and check the numbers of cells and the attributes
+ */
+template <typename MAP, typename CellType, typename IMPORT, typename EXPORT>
+void check_round_trip(MAP& map, const std::string& filename, bool binary, bool compress, bool raw_appended_data, const IMPORT& import, const EXPORT& export_map)
+{
+	using Vertex = typename MAP::Vertex;
+	const float64 precision = binary ? 1e-12 : 1e-4; // the ascii files have 6 significant digits
+
+	typename MAP::template VertexAttribute<Vec3> position = map.template get_attribute<Vec3, Vertex::ORBIT>("position");
+	typename MAP::template VertexAttribute<float64> scalar = map.template add_attribute<float64, Vertex::ORBIT>("scalar");
+	typename MAP::template Attribute<float64, CellType::ORBIT> value = map.template add_attribute<float64, CellType::ORBIT>("value");
+	map.foreach_cell([&] (Vertex v) { scalar[v] = vertex_value(position[v]); });
+	map.foreach_cell([&] (CellType c) { value[c] = cell_value(map, position, c); });
+
+	export_map(map, cgogn::io::ExportOptions(filename, { cgogn::Orbit(Vertex::ORBIT), "position" }, { { cgogn::Orbit(Vertex::ORBIT), "scalar" }, { cgogn::Orbit(CellType::ORBIT), "value" } }, binary, compress, true, raw_appended_data));
+	map.remove_attribute(scalar);
+	map.remove_attribute(value);
+
+	MAP imported;
+	import(imported, filename);
+	std::remove(filename.c_str());
+
+	EXPECT_EQ(imported.template nb_cells<Vertex::ORBIT>(), map.template nb_cells<Vertex::ORBIT>());
+	EXPECT_EQ(imported.template nb_cells<CellType::ORBIT>(), map.template nb_cells<CellType::ORBIT>());
+	position = imported.template get_attribute<Vec3, Vertex::ORBIT>("position");
+	scalar = imported.template get_attribute<float64, Vertex::ORBIT>("scalar");
+	value = imported.template get_attribute<float64, CellType::ORBIT>("value");
+	ASSERT_TRUE(position.is_valid());
+	ASSERT_TRUE(scalar.is_valid());
+	ASSERT_TRUE(value.is_valid());
+	imported.foreach_cell([&] (Vertex v) { EXPECT_NEAR(scalar[v], vertex_value(position[v]), precision * (1.0 + std::abs(scalar[v]))); });
+	imported.foreach_cell([&] (CellType c) { EXPECT_NEAR(value[c], cell_value(imported, position, c), 10.0 * precision * (1.0 + std::abs(value[c]))); });
+}
+
+// (binary, compress, raw appended data)
+using VtkFormat = std::tuple<bool, bool, bool>;
+
+class VtkRoundTrip_TEST : public testing::TestWithParam<VtkFormat>
+{};
+
+TEST_P(VtkRoundTrip_TEST, Surface)
+{
+	CMap2 map;
+	cgogn::io::import_surface<Vec3>(map, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+	check_round_trip<CMap2, CMap2::Face>(map, "vtk_io_test_round_trip.vtp", std::get<0>(GetParam()), std::get<1>(GetParam()), std::get<2>(GetParam()),
+		[] (CMap2& m, const std::string& f) { cgogn::io::import_surface<Vec3>(m, f); },
+		[] (CMap2& m, const cgogn::io::ExportOptions& o) { cgogn::io::export_surface(m, o); });
+}
+
+TEST_P(VtkRoundTrip_TEST, Volume)
+{
+	CMap3 map;
+	cgogn::io::import_volume<Vec3>(map, std::string(DEFAULT_MESH_PATH) + std::string("tet/hand.tet"));
+	check_round_trip<CMap3, CMap3::Volume>(map, "vtk_io_test_round_trip.vtu", std::get<0>(GetParam()), std::get<1>(GetParam()), std::get<2>(GetParam()),
+		[] (CMap3& m, const std::string& f) { cgogn::io::import_volume<Vec3>(m, f); },
+		[] (CMap3& m, const cgogn::io::ExportOptions& o) { cgogn::io::export_volume(m, o); });
+}
+
+INSTANTIATE_TEST_CASE_P(VtkFormats, VtkRoundTrip_TEST, testing::Values(
+	VtkFormat(false, false, false),	// ascii
+	VtkFormat(true, false, false),	// base64
+	VtkFormat(true, true, false),	// base64 + zlib
+	VtkFormat(true, false, true),	// raw appended data
+	VtkFormat(true, true, true)		// raw appended data + zlib
+));
+
+/**
+ * a corrupted file is rejected (the map stays empty) instead of giving uninitialized attributes
+ * or allocating from the corrupted sizes
+ */
+class VtkCorrupted_TEST : public testing::Test
+{
+protected:
+
+	std::string content_;
+	uint32 nb_vertices_;
+	const std::string filename_ = "vtk_io_test_corrupted.vtu";
+
+	void SetUp() override
+	{
+		CMap3 map;
+		cgogn::io::import_volume<Vec3>(map, std::string(DEFAULT_MESH_PATH) + std::string("tet/hand.tet"));
+		nb_vertices_ = map.nb_cells<CMap3::Vertex::ORBIT>();
+		cgogn::io::export_volume(map, cgogn::io::ExportOptions(filename_, { cgogn::Orbit(CMap3::Vertex::ORBIT), "position" }, {}, true, true, true, true));
+		std::ifstream in(filename_, std::ios::binary);
+		std::stringstream buffer;
+		buffer << in.rdbuf();
+		content_ = buffer.str();
+	}
+
+	void TearDown() override
+	{
+		std::remove(filename_.c_str());
+	}
+
+	uint32 import_corrupted(const std::string& content)
+	{
+		{
+			std::ofstream out(filename_, std::ios::binary);
+			out << content;
+		}
+		CMap3 map;
+		cgogn::io::import_volume<Vec3>(map, filename_);
+		return map.nb_cells<CMap3::Vertex::ORBIT>();
+	}
+};
+
+TEST_F(VtkCorrupted_TEST, NotCorrupted)
+{
+	EXPECT_EQ(import_corrupted(content_), nb_vertices_);
+}
+
+// more points announced than stored in the position array
+TEST_F(VtkCorrupted_TEST, MissingElements)
+{
+	std::string content = content_;
+	const std::string nb_points = "NumberOfPoints=\"" + std::to_string(nb_vertices_) + "\"";
+	const std::size_t pos = content.find(nb_points);
+	ASSERT_NE(pos, std::string::npos);
+	content.replace(pos, nb_points.size(), "NumberOfPoints=\"" + std::to_string(nb_vertices_ + 10u) + "\"");
+	EXPECT_EQ(import_corrupted(content), 0u);
+}
+
+// a huge number of blocks in the header of the first compressed array
+TEST_F(VtkCorrupted_TEST, NumberOfBlocks)
+{
+	std::string content = content_;
+	const std::size_t pos = content.find('_', content.find("<AppendedData"));
+	ASSERT_NE(pos, std::string::npos);
+	const uint32 nb_blocks = 0xfffffff0u;
+	content.replace(pos + 1u, sizeof(uint32), reinterpret_cast<const char*>(&nb_blocks), sizeof(uint32));
+	EXPECT_EQ(import_corrupted(content), 0u);
+}
+
+// a huge uncompressed block size in the header of the first compressed array
+TEST_F(VtkCorrupted_TEST, BlockSize)
+{
+	std::string content = content_;
+	const std::size_t pos = content.find('_', content.find("<AppendedData"));
+	ASSERT_NE(pos, std::string::npos);
+	const uint32 block_size = 0xfffffff0u;
+	content.replace(pos + 1u + sizeof(uint32), sizeof(uint32), reinterpret_cast<const char*>(&block_size), sizeof(uint32));
+	EXPECT_EQ(import_corrupted(content), 0u);
+}
+
+// the data of the last array is truncated
+TEST_F(VtkCorrupted_TEST, Truncated)
+{
+	const std::size_t end = content_.rfind("</AppendedData>");
+	ASSERT_NE(end, std::string::npos);
+	EXPECT_EQ(import_corrupted(content_.substr(0u, end - 100u)), 0u);
+}
@@ -94,8 +94,6 @@ public:
 		if (!this->position_attribute())
 			return;
 
-		map.add_attribute(vertices_of_volumes_, "vertices_of_volume_volume_export");
-
 		for (const auto& pair : options.attributes_to_export_)
 		{
 			if (pair.first == Vertex::ORBIT)
@@ -110,6 +108,12 @@ public:
 			}
 		}
 
+	}
+
+	virtual void prepare_cells(Map& map) override
+	{
+		map.add_attribute(vertices_of_volumes_, "vertices_of_volume_volume_export");
+
 		this->cell_cache_->template build<Vertex>(ConnectorCellFilter(map));
 		this->cell_cache_->template build<Volume>(ConnectorCellFilter(map));
 
@@ -206,13 +210,25 @@ public:
 							vertices.push_back(ids[Vertex(it)]);
 						}
 						else
-								cgogn_log_warning("VolumeExport::prepare_for_export") << "Unknown volume with " << nb_vert << " vertices. Ignoring.";
+								cgogn_log_warning("VolumeExport::prepare_cells") << "Unknown volume with " << nb_vert << " vertices. Ignoring.";
 					}
 				}
 			}
 		}, *(this->cell_cache_));
 	}
 
+	virtual void share_cells(const MeshExport<MAP>& other) override
+	{
+		Inherit::share_cells(other);
+		const Self* o = dynamic_cast<const Self*>(&other);
+		cgogn_assert(o != nullptr);
+		vertices_of_volumes_ = o->vertices_of_volumes_;
+		nb_tetras_ = o->nb_tetras_;
+		nb_pyramids_ = o->nb_pyramids_;
+		nb_triangular_prisms_ = o->nb_triangular_prisms_;
+		nb_hexas_ = o->nb_hexas_;
+	}
+
 	void clean_added_attributes(Map& map) override
 	{
 		Inherit::clean_added_attributes(map);
@@ -39,7 +39,6 @@
 #include <cgogn/io/io_utils.h>
 #include <cgogn/io/data_io.h>
 
-#include <tinyxml2.h>
 
 /*******************************************************************************
 * CGoGN convention for ordering the indices for volume cells in the VolumeImport class (prior to the map creation)
@@ -158,6 +157,18 @@ public:
 			position_attribute_ = dynamic_cast<ChunkArray<VEC3>*>(att);
 	}
 
+	/**
+	 * @brief add_vertex_attribute, add an attribute of the type of in_data for nb_vertices vertices, without copying any data.
+	 * @return the (uninitialized) chunk array, to be filled by the caller
+	 */
+	inline ChunkArrayGen* add_vertex_attribute(const DataInputGen& in_data, const std::string& att_name, uint32 nb_vertices)
+	{
+		ChunkArrayGen* att = in_data.add_attribute(vertex_attributes_, att_name, nb_vertices);
+		if (att_name == "position")
+			position_attribute_ = dynamic_cast<ChunkArray<VEC3>*>(att);
+		return att;
+	}
+
 	template<typename T>
 	inline ChunkArray<T>* add_vertex_attribute(const std::string& att_name)
 	{
@@ -174,6 +185,11 @@ public:
 		in_data.to_chunk_array(in_data.add_attribute(volume_attributes_, att_name));
 	}
 
+	inline ChunkArrayGen* add_volume_attribute(const DataInputGen& in_data, const std::string& att_name, uint32 nb_volumes)
+	{
+		return in_data.add_attribute(volume_attributes_, att_name, nb_volumes);
+	}
+
 	template<typename T>
 	inline ChunkArray<T>* add_volume_attribute(const std::string& att_name)
 	{
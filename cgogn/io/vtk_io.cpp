@@ -23,6 +23,9 @@
 
 #define CGOGN_IO_VTK_IO_CPP_
 
+#include <fstream>
+#include <zlib.h>
+
 #include <cgogn/io/vtk_io.h>
 
 namespace cgogn
@@ -121,6 +124,432 @@ CGOGN_IO_API std::string cgogn_name_of_type_to_vtk_legacy_data_type(const std::s
 	return std::string();
 }
 
+namespace
+{
+
+// parse the name and the attributes of an opening tag (without the enclosing '<' '>')
+void parse_xml_tag(const std::string& tag, std::string& name, std::map<std::string, std::string>& attributes)
+{
+	std::size_t i = 0ul;
+	const std::size_t size = tag.size();
+	while (i < size && !std::isspace(tag[i]))
+		++i;
+	name = tag.substr(0ul, i);
+	attributes.clear();
+	while (i < size)
+	{
+		while (i < size && (std::isspace(tag[i]) || tag[i] == '/'))
+			++i;
+		const std::size_t key_begin = i;
+		while (i < size && tag[i] != '=' && !std::isspace(tag[i]))
+			++i;
+		const std::string key = tag.substr(key_begin, i - key_begin);
+		while (i < size && tag[i] != '"' && tag[i] != '\'')
+			++i;
+		if (i == size)
+			break;
+		const char quote = tag[i++];
+		const std::size_t value_begin = i;
+		while (i < size && tag[i] != quote)
+			++i;
+		attributes[key] = tag.substr(value_begin, i - value_begin);
+		++i;
+	}
+}
+
+// source of decoded bytes for VtkXmlReader::read_binary
+class ByteSource
+{
+public:
+	virtual ~ByteSource() {}
+	// read n bytes (less if the end of the data is reached), return the number of bytes read
+	virtual std::size_t read(unsigned char* out, std::size_t n) = 0;
+};
+
+class RawByteSource : public ByteSource
+{
+public:
+
+	inline RawByteSource(std::istream& in) : in_(in) {}
+
+	std::size_t read(unsigned char* out, std::size_t n) override
+	{
+		in_.read(reinterpret_cast<char*>(out), std::streamsize(n));
+		return std::size_t(in_.gcount());
+	}
+
+private:
+
+	std::istream& in_;
+};
+
+// decodes base64 text on the fly. Several concatenated base64 streams (ended by a padding) are decoded as a single byte stream.
+class Base64ByteSource : public ByteSource
+{
+public:
+
+	inline Base64ByteSource(std::istream& in, std::streamoff nb_chars) :
+		in_(in),
+		nb_chars_left_(nb_chars),
+		buffer_(65536ul),
+		buffer_pos_(0ul),
+		buffer_size_(0ul),
+		nb_pending_(0u),
+		pending_pos_(0u)
+	{}
+
+	std::size_t read(unsigned char* out, std::size_t n) override
+	{
+		static const std::array<int8, 256> decode_lookup = build_lookup();
+
+		std::size_t res = 0ul;
+		while (res < n)
+		{
+			if (pending_pos_ < nb_pending_)
+			{
+				out[res++] = pending_[pending_pos_++];
+				continue;
+			}
+
+			std::array<int8, 4> quantum;
+			uint32 nb_chars = 0u;
+			uint32 nb_padding = 0u;
+			while (nb_chars < 4u)
+			{
+				if (buffer_pos_ == buffer_size_ && !fill_buffer())
+					return res;
+				const unsigned char c = static_cast<unsigned char>(buffer_[buffer_pos_++]);
+				if (c == '=')
+				{
+					quantum[nb_chars++] = 0;
+					++nb_padding;
+				}
+				else if (decode_lookup[c] >= 0)
+					quantum[nb_chars++] = decode_lookup[c];
+			}
+
+			const uint32 v = (uint32(quantum[0]) << 18) | (uint32(quantum[1]) << 12) | (uint32(quantum[2]) << 6) | uint32(quantum[3]);
+			pending_[0] = static_cast<unsigned char>((v >> 16) & 0xFF);
+			pending_[1] = static_cast<unsigned char>((v >> 8) & 0xFF);
+			pending_[2] = static_cast<unsigned char>(v & 0xFF);
+			nb_pending_ = 3u - std::min(nb_padding, 2u);
+			pending_pos_ = 0u;
+		}
+		return res;
+	}
+
+private:
+
+	static std::array<int8, 256> build_lookup()
+	{
+		std::array<int8, 256> lookup;
+		lookup.fill(-1);
+		const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		for (int8 i = 0; i < 64; ++i)
+			lookup[static_cast<unsigned char>(alphabet[i])] = i;
+		return lookup;
+	}
+
+	bool fill_buffer()
+	{
+		std::streamsize to_read = std::streamsize(buffer_.size());
+		if (nb_chars_left_ >= 0)
+			to_read = std::min(to_read, std::streamsize(nb_chars_left_));
+		if (to_read <= 0)
+			return false;
+		in_.read(&buffer_[0], to_read);
+		buffer_size_ = std::size_t(in_.gcount());
+		buffer_pos_ = 0ul;
+		if (nb_chars_left_ >= 0)
+			nb_chars_left_ -= std::streamoff(buffer_size_);
+		return buffer_size_ > 0ul;
+	}
+
+	std::istream& in_;
+	std::streamoff nb_chars_left_; // < 0 if unknown
+	std::vector<char> buffer_;
+	std::size_t buffer_pos_;
+	std::size_t buffer_size_;
+	std::array<unsigned char, 3> pending_;
+	uint32 nb_pending_;
+	uint32 pending_pos_;
+};
+
+// gives whole elements to the callable, keeping the bytes of an element split between two blocks
+class ElementSink
+{
+public:
+
+	inline ElementSink(uint32 element_size, const std::function<void(const char*, std::size_t)>& f) :
+		element_size_(element_size),
+		f_(f)
+	{
+		partial_.reserve(element_size);
+	}
+
+	void push(const unsigned char* data, std::size_t size)
+	{
+		const char* ptr = reinterpret_cast<const char*>(data);
+		if (!partial_.empty())
+		{
+			const std::size_t nb = std::min(size, std::size_t(element_size_) - partial_.size());
+			partial_.insert(partial_.end(), ptr, ptr + nb);
+			ptr += nb;
+			size -= nb;
+			if (partial_.size() < element_size_)
+				return;
+			f_(&partial_[0], 1ul);
+			partial_.clear();
+		}
+		const std::size_t nb_elements = size / element_size_;
+		if (nb_elements > 0ul)
+			f_(ptr, nb_elements);
+		ptr += nb_elements * element_size_;
+		partial_.insert(partial_.end(), ptr, ptr + (size - nb_elements * element_size_));
+	}
+
+private:
+
+	uint32 element_size_;
+	const std::function<void(const char*, std::size_t)>& f_;
+	std::vector<char> partial_;
+};
+
+inline bool read_header_word(ByteSource& source, uint32 word_size, bool swap, uint64& word)
+{
+	if (word_size == 8u)
+	{
+		if (source.read(reinterpret_cast<unsigned char*>(&word), 8ul) != 8ul)
+			return false;
+		if (swap)
+			word = swap_endianness(word);
+	}
+	else
+	{
+		uint32 w;
+		if (source.read(reinterpret_cast<unsigned char*>(&w), 4ul) != 4ul)
+			return false;
+		word = swap ? swap_endianness(w) : w;
+	}
+	return true;
+}
+
+} // namespace
+
+VtkXmlReader::VtkXmlReader() :
+	little_endian_(true),
+	compressed_(false),
+	header_word_size_(4u),
+	nb_points_(0u),
+	nb_cells_(0u),
+	appended_begin_(-1),
+	appended_raw_(true)
+{}
+
+VtkXmlReader::~VtkXmlReader()
+{}
+
+bool VtkXmlReader::open(const std::string& filename)
+{
+	filename_ = filename;
+	data_arrays_.clear();
+	appended_begin_ = -1;
+
+	std::ifstream fp(filename, std::ios::in | std::ios::binary);
+	if (!fp.good())
+		return false;
+
+	std::vector<std::string> elements; // stack of the open elements
+	std::string tag;
+	std::string name;
+	std::map<std::string, std::string> attributes;
+	bool vtk_file = false;
+	uint32 nb_pieces = 0u;
+	DataArray* open_data_array = nullptr;
+
+	while (fp.ignore(std::numeric_limits<std::streamsize>::max(), '<'))
+	{
+		const std::streamoff tag_begin = std::streamoff(fp.tellg()) - 1;
+		if (!std::getline(fp, tag, '>'))
+			break;
+		if (tag.empty() || tag[0] == '?' || tag[0] == '!')
+			continue;
+
+		if (tag[0] == '/')
+		{
+			if (open_data_array)
+			{
+				open_data_array->end = tag_begin;
+				open_data_array = nullptr;
+			}
+			if (!elements.empty())
+				elements.pop_back();
+			continue;
+		}
+
+		const bool self_closing = (tag.back() == '/');
+		parse_xml_tag(tag, name, attributes);
+
+		if (name == "VTKFile")
+		{
+			vtk_file = true;
+			little_endian_ = (attributes.count("byte_order") == 0ul) || (to_lower(attributes["byte_order"]) == "littleendian");
+			header_word_size_ = (attributes.count("header_type") && to_lower(attributes["header_type"]) == "uint64") ? 8u : 4u;
+			compressed_ = (attributes["compressor"] == "vtkZLibDataCompressor");
+		}
+		else if (name == "Piece")
+		{
+			if (nb_pieces++ == 0u)
+			{
+				nb_points_ = uint32(std::strtoul(attributes["NumberOfPoints"].c_str(), nullptr, 10));
+				nb_cells_ = uint32(std::strtoul(attributes["NumberOfCells"].c_str(), nullptr, 10));
+				if (nb_cells_ == 0u)
+					nb_cells_ = uint32(std::strtoul(attributes["NumberOfPolys"].c_str(), nullptr, 10));
+			}
+			else
+				cgogn_log_debug("VtkXmlReader::open") << "Ignoring the piece " << nb_pieces << " of the file \"" << filename << "\".";
+		}
+		else if (name == "DataArray" && nb_pieces == 1u)
+		{
+			DataArray array;
+			array.section = elements.empty() ? std::string() : elements.back();
+			array.name = attributes["Name"];
+			array.type = attributes["type"];
+			array.nb_components = attributes.count("NumberOfComponents") ? uint32(std::strtoul(attributes["NumberOfComponents"].c_str(), nullptr, 10)) : 1u;
+			const std::string& format = to_lower(attributes["format"]);
+			array.appended = (format == "appended");
+			array.binary = array.appended || (format == "binary");
+			array.begin = array.appended ? std::streamoff(std::strtoull(attributes["offset"].c_str(), nullptr, 10)) : std::streamoff(fp.tellg());
+			array.end = array.begin;
+			data_arrays_.push_back(array);
+			if (!self_closing && !array.appended)
+				open_data_array = &data_arrays_.back();
+		}
+		else if (name == "AppendedData")
+		{
+			appended_raw_ = (to_lower(attributes["encoding"]) == "raw");
+			// the data begins after the first '_'
+			fp.ignore(std::numeric_limits<std::streamsize>::max(), '_');
+			appended_begin_ = std::streamoff(fp.tellg());
+			break;
+		}
+
+		if (!self_closing)
+			elements.push_back(name);
+	}
+
+	return vtk_file;
+}
+
+uint32 VtkXmlReader::element_size(const DataArray& array)
+{
+	return data_type_size(data_type(vtk_data_type_to_cgogn_name_of_type(array.type))) * array.nb_components;
+}
+
+std::string VtkXmlReader::read_text(const DataArray& array) const
+{
+	std::string res;
+	if (array.appended || array.end <= array.begin)
+		return res;
+
+	std::ifstream fp(filename_, std::ios::in | std::ios::binary);
+	fp.seekg(array.begin);
+	res.resize(std::size_t(array.end - array.begin));
+	fp.read(&res[0], std::streamsize(res.size()));
+	res.resize(std::size_t(fp.gcount()));
+	return res;
+}
+
+bool VtkXmlReader::read_binary(const DataArray& array, const std::function<void(const char*, std::size_t)>& f) const
+{
+	const uint32 elem_size = element_size(array);
+	if (elem_size == 0u)
+		return false;
+
+	std::ifstream fp(filename_, std::ios::in | std::ios::binary);
+	std::unique_ptr<ByteSource> source;
+	if (array.appended)
+	{
+		if (appended_begin_ < 0)
+			return false;
+		fp.seekg(appended_begin_ + array.begin);
+		if (appended_raw_)
+			source = make_unique<RawByteSource>(fp);
+		else
+			source = make_unique<Base64ByteSource>(fp, -1);
+	}
+	else
+	{
+		fp.seekg(array.begin);
+		source = make_unique<Base64ByteSource>(fp, array.end - array.begin);
+	}
+
+	const bool swap = (little_endian_ != cgogn::internal::cgogn_is_little_endian);
+	ElementSink sink(elem_size, f);
+
+	if (!compressed_)
+	{
+		uint64 size;
+		if (!read_header_word(*source, header_word_size_, swap, size))
+			return false;
+		std::vector<unsigned char> buffer(std::max(std::size_t(elem_size), (std::size_t(1048576u) / elem_size) * elem_size));
+		while (size > 0ul)
+		{
+			const std::size_t nb = source->read(&buffer[0], std::min(std::size_t(size), buffer.size()));
+			if (nb == 0ul)
+				return false;
+			sink.push(&buffer[0], nb);
+			size -= nb;
+		}
+		return true;
+	}
+
+	// header : nb blocks, uncompressed block size, uncompressed size of the last block, compressed size of each block
+	// the header is not trusted: the sizes are read one by one (a corrupted nb_blocks fails at the end of the data
+	// instead of allocating) and the block sizes are checked against the maximal compression ratio of zlib (1032:1)
+	uint64 nb_blocks, block_size, last_block_size;
+	if (!read_header_word(*source, header_word_size_, swap, nb_blocks) ||
+		!read_header_word(*source, header_word_size_, swap, block_size) ||
+		!read_header_word(*source, header_word_size_, swap, last_block_size))
+		return false;
+	// an empty array (the writer gives a single empty block)
+	if (nb_blocks == 0ul || block_size == 0ul)
+		return true;
+	if (last_block_size > block_size)
+		return false;
+	if (last_block_size == 0ul) // the last block is full
+		last_block_size = block_size;
+
+	std::vector<uint64> compressed_sizes;
+	uint64 max_compressed_size = 0ul;
+	for (uint64 i = 0ul; i < nb_blocks; ++i)
+	{
+		uint64 s;
+		if (!read_header_word(*source, header_word_size_, swap, s) || s == 0ul)
+			return false;
+		compressed_sizes.push_back(s);
+		max_compressed_size = std::max(max_compressed_size, s);
+	}
+	if (block_size / 1032ul > max_compressed_size)
+		return false;
+
+	std::vector<unsigned char> compressed;
+	std::vector<unsigned char> uncompressed(static_cast<std::size_t>(block_size));
+	for (uint64 i = 0ul; i < nb_blocks; ++i)
+	{
+		compressed.resize(std::size_t(compressed_sizes[i]));
+		if (source->read(&compressed[0], compressed.size()) != compressed.size())
+			return false;
+
+		const uLongf expected_size = uLongf((i == nb_blocks - 1ul) ? last_block_size : block_size);
+		uLongf uncompressed_size = expected_size;
+		if (uncompress(&uncompressed[0], &uncompressed_size, &compressed[0], uLong(compressed.size())) != Z_OK || uncompressed_size != expected_size)
+			return false;
+		sink.push(&uncompressed[0], std::size_t(uncompressed_size));
+	}
+	return true;
+}
+
 CGOGN_IO_API std::vector<unsigned char> read_binary_xml_data(const char* data_str, bool is_compressed, DataType header_type)
 {
 	if (!is_compressed)
@@ -133,47 +562,101 @@ CGOGN_IO_API std::vector<unsigned char> read_binary_xml_data(const char* data_st
 		return zlib_decompress(data_str, header_type);
 }
 
-CGOGN_IO_API void write_binary_xml_data(std::ostream& output, const char* data_str, std::size_t size, bool compress)
+namespace
+{
+
+// header of a zlib compressed DataArray : nb blocks, uncompressed block size, size of the last uncompressed block, compressed size of each block
+std::vector<uint32> compressed_xml_data_header(const std::vector<std::vector<unsigned char>>& compressed_blocks, std::size_t size, std::size_t uncompressed_chunk_size)
 {
-	std::vector<char> data;
 	std::vector<uint32> header;
+	header.reserve(3ul + compressed_blocks.size());
+	header.push_back(static_cast<uint32>(compressed_blocks.size()));
+	header.push_back(static_cast<uint32>(uncompressed_chunk_size));
+	header.push_back(static_cast<uint32>(size - (compressed_blocks.size() - 1ul) * uncompressed_chunk_size));
+	for (const auto& block : compressed_blocks)
+		header.push_back(static_cast<uint32>(block.size()));
+	return header;
+}
+
+const std::size_t VTK_XML_COMPRESSION_CHUNK_SIZE = 1048576ul;
+
+} // namespace
+
+CGOGN_IO_API void write_binary_xml_data(std::ostream& output, const char* data_str, std::size_t size, bool compress)
+{
+	Base64Encoder encoder(output);
 	if (!compress)
 	{
-		header.push_back(static_cast<uint32>(size));
-		data.resize(sizeof(uint32) + size);
-
-		std::memcpy(&data[0], reinterpret_cast<const char*>(&header[0]), sizeof(uint32)* header.size());
-		std::memcpy(&data[sizeof(uint32)], data_str, size);
+		const uint32 header = static_cast<uint32>(size);
+		encoder.encode(reinterpret_cast<const char*>(&header), sizeof(uint32));
+		encoder.encode(data_str, size);
 	} else {
-		const std::size_t uncompressed_chunk_size = std::min(size, std::size_t(1048576));
+		const std::size_t uncompressed_chunk_size = std::min(size, VTK_XML_COMPRESSION_CHUNK_SIZE);
 		const std::vector<std::vector<unsigned char>>& compressed_blocks = zlib_compress(reinterpret_cast<const unsigned char*>(data_str), size, uncompressed_chunk_size);
-		std::size_t compressed_size{0ul};
-		const std::size_t last_block_size = (compressed_blocks.size() == 1ul) ? uncompressed_chunk_size : size % uncompressed_chunk_size;
+		const std::vector<uint32>& header = compressed_xml_data_header(compressed_blocks, size, uncompressed_chunk_size);
 
-		header.push_back(static_cast<uint32>(compressed_blocks.size()));
-		header.push_back(static_cast<uint32>(uncompressed_chunk_size));
-		header.push_back(static_cast<uint32>(last_block_size));
+		// the header and the data are encoded separately
+		encoder.encode(reinterpret_cast<const char*>(&header[0]), header.size() * sizeof(uint32));
+		encoder.flush();
 		for (const auto& block : compressed_blocks)
-		{
-			header.push_back(static_cast<uint32>(block.size()));
-			compressed_size += block.size();
-		}
+			encoder.encode(reinterpret_cast<const char*>(&block[0]), block.size());
+	}
+	encoder.flush();
+}
 
-		const auto& encoded_header = base64_encode(reinterpret_cast<char*>(&header[0]), header.size() * sizeof(uint32));
-		output.write(&encoded_header[0], encoded_header.size());
+CGOGN_IO_API void write_raw_binary_xml_data(std::ostream& output, const char* data_str, std::size_t size, bool compress)
+{
+	if (!compress)
+	{
+		const uint32 header = static_cast<uint32>(size);
+		output.write(reinterpret_cast<const char*>(&header), sizeof(uint32));
+		output.write(data_str, std::streamsize(size));
+	} else {
+		const std::size_t uncompressed_chunk_size = std::min(size, VTK_XML_COMPRESSION_CHUNK_SIZE);
+		const std::vector<std::vector<unsigned char>>& compressed_blocks = zlib_compress(reinterpret_cast<const unsigned char*>(data_str), size, uncompressed_chunk_size);
+		const std::vector<uint32>& header = compressed_xml_data_header(compressed_blocks, size, uncompressed_chunk_size);
 
-		data.resize(compressed_size);
-		char* data_ptr = &data[0];
+		output.write(reinterpret_cast<const char*>(&header[0]), std::streamsize(header.size() * sizeof(uint32)));
 		for (const auto& block : compressed_blocks)
-		{
-			const char* src = reinterpret_cast<const char*>(&block[0]);
-			std::memcpy(data_ptr, src, block.size());
-			data_ptr += block.size();
-		}
+			output.write(reinterpret_cast<const char*>(&block[0]), std::streamsize(block.size()));
 	}
+}
+
+VtkXmlDataWriter::VtkXmlDataWriter(const ExportOptions& option) :
+	binary_(option.binary_),
+	compress_(option.compress_),
+	appended_(option.binary_ && option.raw_appended_data_),
+	appended_data_(std::ios_base::in | std::ios_base::out | std::ios_base::binary)
+{}
+
+VtkXmlDataWriter::~VtkXmlDataWriter()
+{}
+
+std::string VtkXmlDataWriter::format_attributes()
+{
+	if (appended_)
+		return std::string("format=\"appended\" offset=\"") + std::to_string(static_cast<std::streamoff>(appended_data_.tellp())) + std::string("\"");
+	return binary_ ? std::string("format=\"binary\"") : std::string("format=\"ascii\"");
+}
+
+void VtkXmlDataWriter::write(std::ostream& output, const char* data_str, std::size_t size)
+{
+	if (appended_)
+		write_raw_binary_xml_data(appended_data_, data_str, size, compress_);
+	else
+		write_binary_xml_data(output, data_str, size, compress_);
+}
+
+void VtkXmlDataWriter::write_appended_data(std::ostream& output)
+{
+	if (!appended_)
+		return;
 
-	const auto& encoded_data = base64_encode(&data[0], data.size());
-	output.write(&encoded_data[0], encoded_data.size());
+	output << "  <AppendedData encoding=\"raw\">" << std::endl;
+	output << "   _";
+	if (appended_data_.tellp() > 0)
+		output << appended_data_.rdbuf();
+	output << std::endl << "  </AppendedData>" << std::endl;
 }
 
 } // namespace io
@@ -28,6 +28,7 @@
 #include <sstream>
 #include <ostream>
 #include <iomanip>
+#include <functional>
 
 #include <cgogn/core/utils/logger.h>
 
@@ -74,6 +75,105 @@ CGOGN_IO_API std::string cgogn_name_of_type_to_vtk_xml_data_type(const std::stri
 CGOGN_IO_API std::string cgogn_name_of_type_to_vtk_legacy_data_type(const std::string& cgogn_type);
 CGOGN_IO_API std::vector<unsigned char> read_binary_xml_data(const char*data_str, bool is_compressed, DataType header_type);
 CGOGN_IO_API void write_binary_xml_data(std::ostream& output, const char* data_str, std::size_t size, bool compress = false);
+CGOGN_IO_API void write_raw_binary_xml_data(std::ostream& output, const char* data_str, std::size_t size, bool compress = false);
+
+/**
+ * @brief The VtkXmlDataWriter class writes the content of the binary DataArrays of a VTK XML file.
+ * The data is either base64 encoded inside the DataArray elements or, if ExportOptions::raw_appended_data_ is set,
+ * stored without encoding in a <AppendedData encoding="raw"> section written at the end of the file.
+ */
+class CGOGN_IO_API VtkXmlDataWriter
+{
+public:
+
+	explicit VtkXmlDataWriter(const ExportOptions& option);
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(VtkXmlDataWriter);
+	~VtkXmlDataWriter();
+
+	/**
+	 * @brief format_attributes
+	 * @return the "format" (and "offset") attributes of the next DataArray element
+	 */
+	std::string format_attributes();
+	void write(std::ostream& output, const char* data_str, std::size_t size);
+	void write_appended_data(std::ostream& output);
+
+private:
+
+	bool binary_;
+	bool compress_;
+	bool appended_;
+	std::stringstream appended_data_;
+};
+
+/**
+ * @brief The VtkXmlReader class is a streaming reader for the VTK XML files (vtu, vtp).
+ * The file is scanned tag by tag without building a DOM tree : the content of the DataArray elements is skipped and only
+ * its location in the file is kept. The content of a DataArray is then decoded (base64, zlib) block by block, from the inline
+ * text or from the AppendedData section (raw or base64), and given to a callable, without loading the whole array in memory.
+ * Each read opens its own file stream, so that several DataArrays can be read concurrently.
+ * Only the first Piece of the file is read.
+ */
+class CGOGN_IO_API VtkXmlReader
+{
+public:
+
+	struct DataArray
+	{
+		std::string section;		// name of the parent element (Points, PointData, Cells, CellData, Polys...)
+		std::string name;
+		std::string type;			// VTK name of the scalar type
+		uint32 nb_components;
+		bool binary;
+		bool appended;
+		std::streamoff begin;		// beginning of the inline content in the file, or offset in the appended section
+		std::streamoff end;			// end of the inline content in the file
+	};
+
+	VtkXmlReader();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(VtkXmlReader);
+	~VtkXmlReader();
+
+	bool open(const std::string& filename);
+
+	inline bool little_endian() const { return little_endian_; }
+	inline bool compressed() const { return compressed_; }
+	inline uint32 nb_points() const { return nb_points_; }
+	inline uint32 nb_cells() const { return nb_cells_; }
+	inline const std::vector<DataArray>& data_arrays() const { return data_arrays_; }
+
+	/**
+	 * @brief element_size
+	 * @return the size in bytes of one element of the array (all components)
+	 */
+	static uint32 element_size(const DataArray& array);
+
+	/**
+	 * @brief read_text
+	 * @return the content of an ascii DataArray
+	 */
+	std::string read_text(const DataArray& array) const;
+
+	/**
+	 * @brief read_binary decodes a binary (inline or appended) DataArray
+	 * @param array
+	 * @param f a callable f(const char* data, std::size_t nb_elements), called successively on blocks of whole elements
+	 * @return false if the data could not be decoded
+	 */
+	bool read_binary(const DataArray& array, const std::function<void(const char*, std::size_t)>& f) const;
+
+private:
+
+	std::string filename_;
+	bool little_endian_;
+	bool compressed_;
+	uint32 header_word_size_;
+	uint32 nb_points_;
+	uint32 nb_cells_;
+	std::vector<DataArray> data_arrays_;
+	std::streamoff appended_begin_;
+	bool appended_raw_;
+};
 
 template <typename T>
 inline std::string vtk_name_of_type(const T& t)
@@ -274,7 +374,7 @@ private:
 	{
 		ChunkArrayGen const* pos = this->position_attribute();
 		const std::string endianness = cgogn::internal::cgogn_is_little_endian ? "LittleEndian" : "BigEndian";
-		const std::string format = (option.binary_?"binary" :"ascii");
+		VtkXmlDataWriter data_writer(option);
 		std::string scalar_type = cgogn_name_of_type_to_vtk_xml_data_type(pos->nested_type_name());
 		const uint32 nbv = map.template nb_cells<Vertex::ORBIT>();
 		const uint32 nbf = map.template nb_cells<Face::ORBIT>();
@@ -293,7 +393,7 @@ private:
 		// 1st step : vertices
 		output << "      <Points>" << std::endl;
 		// 1.a : positions
-		output << "        <DataArray type=\""<< scalar_type  << "\" Name=\"" << pos->name() << "\" NumberOfComponents=\"" << pos->nb_components() << "\" format=\"" << format << "\">" << std::endl;
+		output << "        <DataArray type=\""<< scalar_type  << "\" Name=\"" << pos->name() << "\" NumberOfComponents=\"" << pos->nb_components() << "\" " << data_writer.format_attributes() << ">" << std::endl;
 
 		std::vector<char> buffer_char;
 
@@ -310,7 +410,7 @@ private:
 					buffer_char.push_back(elem[i]);
 			}, *(this->cell_cache_));
 
-			write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+			data_writer.write(output, &buffer_char[0], buffer_char.size());
 			output << std::endl;
 		} else {
 			map.foreach_cell([&](Vertex v)
@@ -332,11 +432,11 @@ private:
 			for (const auto& att : this->vertex_attributes())
 			{
 				scalar_type = cgogn_name_of_type_to_vtk_xml_data_type(att->nested_type_name());
-				output << "        <DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" format=\"" << format << "\">" << std::endl;
+				output << "        <DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" " << data_writer.format_attributes() << ">" << std::endl;
 
 				if (bin)
 				{
-					const uint32 elem_size{pos->element_size()};
+					const uint32 elem_size{att->element_size()};
 					buffer_char.clear();
 					buffer_char.reserve(nbv * elem_size);
 
@@ -346,7 +446,7 @@ private:
 						for(uint32 i = 0u; i < elem_size; ++i)
 							buffer_char.push_back(elem[i]);
 					}, *(this->cell_cache_));
-					write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+					data_writer.write(output, &buffer_char[0], buffer_char.size());
 					output << std::endl;
 				} else {
 					map.foreach_cell([&](Vertex v)
@@ -370,7 +470,7 @@ private:
 			for (const auto& att : this->face_attributes())
 			{
 				scalar_type = cgogn_name_of_type_to_vtk_xml_data_type(att->nested_type_name());
-				output << "<DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" format=\"" << format << "\">" << std::endl;
+				output << "<DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" " << data_writer.format_attributes() << ">" << std::endl;
 
 				if (bin)
 				{
@@ -385,7 +485,7 @@ private:
 						std::memcpy(buffer_ptr, elem, elem_size);
 						buffer_ptr += elem_size;
 					}, *(this->cell_cache_));
-					write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+					data_writer.write(output, &buffer_char[0], buffer_char.size());
 					output << std::endl;
 				} else {
 					map.foreach_cell([&](Face f)
@@ -403,7 +503,7 @@ private:
 		output << "<Polys>" << std::endl;
 
 
-		output << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"" << format << "\">" << std::endl;
+		output << "<DataArray type=\"Int32\" Name=\"connectivity\" " << data_writer.format_attributes() << ">" << std::endl;
 
 		if (bin)
 		{
@@ -418,7 +518,7 @@ private:
 					it = map.phi1(it);
 				} while (it != f.dart);
 			}, *(this->cell_cache_));
-			write_binary_xml_data(output,reinterpret_cast<char*>(&buffer_vertices[0]), buffer_vertices.size() * sizeof(int32), compress);
+			data_writer.write(output, reinterpret_cast<char*>(&buffer_vertices[0]), buffer_vertices.size() * sizeof(int32));
 			output << std::endl;
 		} else {
 			map.foreach_cell([&](Face f)
@@ -435,7 +535,7 @@ private:
 
 		output << "</DataArray>" << std::endl;
 
-		output << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"" << format << "\">" << std::endl;
+		output << "<DataArray type=\"Int32\" Name=\"offsets\" " << data_writer.format_attributes() << ">" << std::endl;
 
 		int32 offset{0};
 		std::vector<int32> buffer_offset;
@@ -448,7 +548,7 @@ private:
 
 		if (bin)
 		{
-			write_binary_xml_data(output,reinterpret_cast<const char*>(&buffer_offset[0]),  buffer_offset.size() * sizeof(int32), compress);
+			data_writer.write(output, reinterpret_cast<const char*>(&buffer_offset[0]), buffer_offset.size() * sizeof(int32));
 		} else {
 			output << "         ";
 			for (auto o : buffer_offset)
@@ -459,6 +559,7 @@ private:
 		output << "</Polys>" << std::endl;
 		output << "</Piece>" << std::endl;
 		output << "</PolyData>" << std::endl;
+		data_writer.write_appended_data(output);
 		output << "</VTKFile>" << std::endl;
 	}
 };
@@ -632,7 +733,7 @@ private:
 	{
 		ChunkArrayGen const* pos = this->position_attribute();
 		const std::string endianness = cgogn::internal::cgogn_is_little_endian ? "LittleEndian" : "BigEndian";
-		const std::string format = (option.binary_?"binary" :"ascii");
+		VtkXmlDataWriter data_writer(option);
 		std::string scalar_type = cgogn_name_of_type_to_vtk_xml_data_type(pos->nested_type_name());
 		const uint32 nbv = this->nb_vertices();
 		const uint32 nbw = this->nb_volumes();
@@ -649,7 +750,7 @@ private:
 		// 1st step : vertices
 		output << "      <Points>" << std::endl;
 		// 1.a : positions
-		output << "        <DataArray type=\""<< scalar_type  << "\" Name=\"" << pos->name() << "\" NumberOfComponents=\"" << pos->nb_components() << "\" format=\"" << format << "\">" << std::endl;
+		output << "        <DataArray type=\""<< scalar_type  << "\" Name=\"" << pos->name() << "\" NumberOfComponents=\"" << pos->nb_components() << "\" " << data_writer.format_attributes() << ">" << std::endl;
 
 		std::vector<char> buffer_char;
 
@@ -666,7 +767,7 @@ private:
 					buffer_char.push_back(elem[i]);
 			}, *(this->cell_cache_));
 
-			write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+			data_writer.write(output, &buffer_char[0], buffer_char.size());
 			output << std::endl;
 		} else {
 			map.foreach_cell([&](Vertex v)
@@ -687,11 +788,11 @@ private:
 			for (const auto& att : this->vertex_attributes())
 			{
 				scalar_type = cgogn_name_of_type_to_vtk_xml_data_type(att->nested_type_name());
-				output << "        <DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" format=\"" << format << "\">" << std::endl;
+				output << "        <DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" " << data_writer.format_attributes() << ">" << std::endl;
 
 				if (bin)
 				{
-					const uint32 elem_size{pos->element_size()};
+					const uint32 elem_size{att->element_size()};
 					buffer_char.clear();
 					buffer_char.reserve(nbv * elem_size);
 
@@ -701,7 +802,7 @@ private:
 						for(uint32 i = 0u; i < elem_size; ++i)
 							buffer_char.push_back(elem[i]);
 					}, *(this->cell_cache_));
-					write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+					data_writer.write(output, &buffer_char[0], buffer_char.size());
 					output << std::endl;
 				} else {
 					map.foreach_cell([&](Vertex v)
@@ -720,7 +821,7 @@ private:
 		// begin volumes
 		output << "      <Cells>" << std::endl;
 		// 2.a. Connectivity
-		output << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"" << format << "\">" << std::endl;
+		output << "        <DataArray type=\"Int32\" Name=\"connectivity\" " << data_writer.format_attributes() << ">" << std::endl;
 
 		if (bin)
 		{
@@ -733,7 +834,7 @@ private:
 				for(uint32 i = 0u; i < vertices.size() * sizeof(int32) ; ++i)
 					buffer_char.push_back(data[i]);
 			}, *(this->cell_cache_));
-			write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+			data_writer.write(output, &buffer_char[0], buffer_char.size());
 			output << std::endl;
 		} else {
 			map.foreach_cell([&](Volume w)
@@ -748,7 +849,7 @@ private:
 
 		output << "        </DataArray>" << std::endl;
 		// 2.b. offsets
-		output << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"" << format << "\">" << std::endl;
+		output << "        <DataArray type=\"Int32\" Name=\"offsets\" " << data_writer.format_attributes() << ">" << std::endl;
 
 
 		int32 offset{0};
@@ -762,7 +863,7 @@ private:
 
 		if (bin)
 		{
-			write_binary_xml_data(output,reinterpret_cast<const char*>(&buffer_offset[0]),  buffer_offset.size() * sizeof(int32), option.compress_);
+			data_writer.write(output, reinterpret_cast<const char*>(&buffer_offset[0]), buffer_offset.size() * sizeof(int32));
 		} else {
 			output << "         ";
 			for (auto o : buffer_offset)
@@ -772,7 +873,7 @@ private:
 
 
 		// 2.c cell types
-		output << "        <DataArray type=\"UInt8\" Name=\"types\" format=\"" << format << "\">" << std::endl;
+		output << "        <DataArray type=\"UInt8\" Name=\"types\" " << data_writer.format_attributes() << ">" << std::endl;
 		std::vector<uint8> buffer_format;
 		buffer_format.reserve(this->nb_volumes());
 		map.foreach_cell([&](Volume w)
@@ -790,7 +891,7 @@ private:
 
 		if (bin)
 		{
-			write_binary_xml_data(output,reinterpret_cast<char*>(&buffer_format[0]),  buffer_format.size() * sizeof(uint8), option.compress_);
+			data_writer.write(output, reinterpret_cast<char*>(&buffer_format[0]), buffer_format.size() * sizeof(uint8));
 		} else {
 			output << "         ";
 			for (auto i : buffer_format)
@@ -806,7 +907,7 @@ private:
 			for (const auto& att : this->volume_attributes())
 			{
 				scalar_type = cgogn_name_of_type_to_vtk_xml_data_type(att->nested_type_name());
-				output << "        <DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" format=\"" << format << "\">" << std::endl;
+				output << "        <DataArray type=\""<< scalar_type  <<"\" Name=\"" << att->name() << "\" NumberOfComponents=\"" << att->nb_components() << "\" " << data_writer.format_attributes() << ">" << std::endl;
 
 				if (bin)
 				{
@@ -820,7 +921,7 @@ private:
 						for(uint32 i = 0u; i < elem_size; ++i)
 							buffer_char.push_back(elem[i]);
 					}, *(this->cell_cache_));
-					write_binary_xml_data(output,&buffer_char[0], buffer_char.size(), option.compress_);
+					data_writer.write(output, &buffer_char[0], buffer_char.size());
 					output << std::endl;
 				} else {
 					map.foreach_cell([&](Volume w)
@@ -837,6 +938,7 @@ private:
 		}
 		output << "    </Piece>" << std::endl;
 		output << "  </UnstructuredGrid>" << std::endl;
+		data_writer.write_appended_data(output);
 		output << "</VTKFile>" << std::endl;
 	}
 };
@@ -857,6 +959,7 @@ public:
 	using DataInputGen = cgogn::io::DataInputGen<CHUNK_SIZE>;
 	template <typename T>
 	using DataInput = cgogn::io::DataInput<CHUNK_SIZE, PRIM_SIZE, T>;
+	using ChunkArrayGen = cgogn::ChunkArrayGen<CHUNK_SIZE>;
 	using Scalar = typename VEC3::Scalar;
 
 	inline VtkIO() {}
@@ -874,6 +977,9 @@ protected:
 
 	virtual void add_vertex_attribute(const DataInputGen& attribute_data, const std::string& attribute_name) = 0;
 	virtual void add_cell_attribute(const DataInputGen& attribute_data, const std::string& attribute_name) = 0;
+	// same as above, but only allocate the attribute for nb elements, the returned chunk array is filled by the caller
+	virtual ChunkArrayGen* add_vertex_attribute(const DataInputGen& attribute_data, const std::string& attribute_name, uint32 nb) = 0;
+	virtual ChunkArrayGen* add_cell_attribute(const DataInputGen& attribute_data, const std::string& attribute_name, uint32 nb) = 0;
 
 	/**
 	 * @brief parse_vtk_legacy_file
@@ -1108,266 +1214,232 @@ protected:
 		return true;
 	}
 
+	/**
+	 * @brief parse_xml_vtu, reads a vtu or vtp file.
+	 * The binary DataArrays (inline or appended, compressed or not) are decoded block by block directly into the
+	 * attributes of the import, each array being decoded in a separate task of the thread pool.
+	 */
 	bool parse_xml_vtu(const std::string& filename)
 	{
-		using tinyxml2::XMLDocument;
-		using tinyxml2::XMLError;
-		using tinyxml2::XML_NO_ERROR;
-		using tinyxml2::XMLElement;
-
-		XMLDocument doc;
-		XMLError eResult = doc.LoadFile(filename.c_str());
-		if (eResult != XML_NO_ERROR)
+		using DataArray = VtkXmlReader::DataArray;
+
+		VtkXmlReader reader;
+		if (!reader.open(filename))
 		{
 			cgogn_log_warning("parse_xml_vtu")<< "Unable to load file \"" << filename << "\".";
 			return false;
 		}
 
-		XMLElement* root_node = doc.RootElement();
-		cgogn_assert(root_node != nullptr);
-		const bool little_endian = (!root_node->Attribute("byte_order")) || (to_lower(std::string(root_node->Attribute("byte_order"))) == "littleendian");
-
-		std::string header_type("uint32");
-		if (root_node->Attribute("header_type"))
-			header_type = vtk_data_type_to_cgogn_name_of_type(root_node->Attribute("header_type"));
-
-		const bool compressed = (root_node->Attribute("compressor") && (std::string(root_node->Attribute("compressor")) == "vtkZLibDataCompressor"));
-
-		XMLElement* grid_node = root_node->FirstChildElement("UnstructuredGrid");
-		if (grid_node == nullptr)
-			grid_node = root_node->FirstChildElement("PolyData");
-		cgogn_assert(grid_node != nullptr);
-		XMLElement* piece_node = grid_node->FirstChildElement("Piece");
-		cgogn_assert(piece_node != nullptr);
-
-		uint32 nb_vertices = 0u;
-		uint32 nb_cells = 0u;
-
-		piece_node->QueryUnsignedAttribute("NumberOfPoints", &nb_vertices);
-		piece_node->QueryUnsignedAttribute("NumberOfCells", &nb_cells);
-		if (nb_cells == 0u)
-			piece_node->QueryUnsignedAttribute("NumberOfPolys", &nb_cells);
+		const uint32 nb_vertices = reader.nb_points();
+		const uint32 nb_cells = reader.nb_cells();
 		if (nb_vertices == 0u || nb_cells == 0u)
 			return false;
+		const bool big_endian = !reader.little_endian();
 
-		XMLElement* points_node = piece_node->FirstChildElement("Points");
-		cgogn_assert(points_node != nullptr);
-		XMLElement* position_data_array_node = points_node->FirstChildElement("DataArray");
-		for (XMLElement* elem = position_data_array_node; elem != nullptr; elem = elem->NextSiblingElement("DataArray"))
+		const DataArray* position_array = nullptr;
+		bool has_cells = false;
+		for (const DataArray& array : reader.data_arrays())
 		{
-			if (elem->Attribute("Name") && to_lower(std::string(elem->Attribute("Name"))) == "points")
-				position_data_array_node = elem;
+			if (array.section == "Points" && (position_array == nullptr || to_lower(array.name) == "points"))
+				position_array = &array;
+			if (array.section == "Cells" || array.section == "Polys")
+				has_cells = true;
 		}
-		cgogn_assert(position_data_array_node != nullptr);
-		XMLElement* point_data_node = piece_node->FirstChildElement("PointData");
-		XMLElement* point_data_array_node = point_data_node ? point_data_node->FirstChildElement("DataArray") : nullptr;
-		std::vector<XMLElement*> vertices_nodes = {position_data_array_node};
-		while (point_data_array_node)
+		if (position_array == nullptr)
 		{
-			vertices_nodes.push_back(point_data_array_node);
-			point_data_array_node = point_data_array_node->NextSiblingElement("DataArray");
+			cgogn_log_warning("parse_xml_vtu")<< "No points in the file \"" << filename << "\".";
+			return false;
 		}
 
-		for (XMLElement* vertex_data : vertices_nodes)
-		{
-			std::string data_name("cgogn_unnamed_vertex_data");
-			if (vertex_data->Attribute("Name"))
-				data_name = std::string(vertex_data->Attribute("Name"));
-			if (to_lower(data_name) == "normal" || to_lower(data_name) == "normals")
-				data_name = "normal";
-			const bool binary =  vertex_data->Attribute("format", nullptr) && (to_lower(std::string(vertex_data->Attribute("format", nullptr))) == "binary");
-			uint32 nb_comp = 1u;
-			vertex_data->QueryUnsignedAttribute("NumberOfComponents", &nb_comp);
-			const std::string type = vtk_data_type_to_cgogn_name_of_type(std::string(vertex_data->Attribute("type", nullptr)));
+		std::vector<std::unique_ptr<DataInputGen>> data_inputs;
+		std::vector<std::function<void()>> tasks;
+		std::vector<uint8> tasks_success;
+		std::vector<const DataArray*> ascii_arrays;
+		std::unique_ptr<DataInputGen> cells, offsets, types;
 
-			if (data_name.empty())
-				cgogn_log_debug("parse_xml_vtu") << "Skipping a vertex DataArray without \"Name\" attribute.";
-			else
+		// binary attribute : the chunk array is allocated here, the decoding task fills it
+		auto add_attribute_task = [&] (const DataArray& array, const DataInputGen& data, ChunkArrayGen* ca, uint32 nb_elements)
+		{
+			const std::size_t task_index = tasks_success.size();
+			tasks_success.push_back(false);
+			tasks.push_back([&reader, &array, &data, ca, nb_elements, big_endian, task_index, &tasks_success] ()
 			{
-				const char*					ascii_data = vertex_data->GetText();
-				std::vector<unsigned char>	binary_data;
-				if (binary)
-					binary_data = read_binary_xml_data(ascii_data,compressed, data_type(header_type));
-
-				std::unique_ptr<IMemoryStream> mem_stream;
-				if (binary)
-					mem_stream = make_unique<IMemoryStream>(reinterpret_cast<char*>(&binary_data[0]), binary_data.size());
-				else
-					mem_stream = make_unique<IMemoryStream>(ascii_data);
-				if (vertex_data == position_data_array_node)
+				uint32 first = 0u;
+				tasks_success[task_index] = reader.read_binary(array, [&] (const char* buffer, std::size_t n)
 				{
-					cgogn_assert(nb_comp == 3);
-					auto pos = DataInputGen::template newDataIO<PRIM_SIZE, VEC3>(type, nb_comp);
-					pos->read_n(*mem_stream, nb_vertices,binary,!little_endian);
-					this->add_vertex_attribute(*pos,"position");
-					this->positions_ = *dynamic_cast_unique_ptr<DataInput<VEC3>>(pos->simplify());
-				}
-				else
+					n = std::min(n, std::size_t(nb_elements - first));
+					data.binary_to_chunk_array(buffer, n, first, big_endian, ca);
+					first += uint32(n);
+				});
+				// a truncated array would leave uninitialized elements
+				tasks_success[task_index] = tasks_success[task_index] && (first == nb_elements);
+			});
+		};
+
+		// binary cell description : the elements are appended to a DataInput
+		auto add_data_input_task = [&] (const DataArray& array, DataInputGen* data)
+		{
+			const std::size_t task_index = tasks_success.size();
+			tasks_success.push_back(false);
+			tasks.push_back([&reader, &array, data, big_endian, task_index, &tasks_success] ()
+			{
+				const uint32 elem_size = VtkXmlReader::element_size(array);
+				tasks_success[task_index] = reader.read_binary(array, [&] (const char* buffer, std::size_t n)
 				{
-					std::unique_ptr<DataInputGen> vertex_att = DataInputGen::template newDataIO<PRIM_SIZE>(type, nb_comp);
-					vertex_att->read_n(*mem_stream, nb_vertices,binary,!little_endian);
-					this->add_vertex_attribute(*vertex_att, data_name);
-				}
-			}
-		}
+					IMemoryStream mem_stream(buffer, n * elem_size);
+					data->read_n(mem_stream, n, true, big_endian);
+				});
+			});
+		};
 
-		XMLElement* const cell_node = piece_node->FirstChildElement("Cells");
-		if (cell_node != nullptr)
+		for (const DataArray& array : reader.data_arrays())
 		{
-			XMLElement* cells_array_node = cell_node->FirstChildElement("DataArray");
-			cgogn_assert(cells_array_node != nullptr);
-			std::vector<XMLElement*> cell_nodes;
-			while (cells_array_node)
+			const bool is_position = (&array == position_array);
+			const bool is_vertex_data = (array.section == "PointData");
+			const bool is_cell_data = (array.section == "CellData") && has_cells;
+			const bool is_cell_description = (array.section == "Cells" || array.section == "Polys");
+			if (!is_position && !is_vertex_data && !is_cell_data && !is_cell_description)
+				continue;
+
+			if (array.name.empty() && !is_position)
 			{
-				cell_nodes.push_back(cells_array_node);
-				cells_array_node = cells_array_node->NextSiblingElement("DataArray");
+				cgogn_log_debug("parse_xml_vtu") << "Skipping a DataArray without \"Name\" attribute.";
+				continue;
 			}
 
-			XMLElement* const cell_data_node = piece_node->FirstChildElement("CellData");
-			cells_array_node = cell_data_node ? cell_data_node->FirstChildElement("DataArray") : nullptr;
-			while (cells_array_node)
+			if (!array.binary)
 			{
-				cell_nodes.push_back(cells_array_node);
-				cells_array_node = cells_array_node->NextSiblingElement("DataArray");
+				ascii_arrays.push_back(&array);
+				continue;
 			}
 
-			for (XMLElement*& cell_data : cell_nodes)
+			const std::string type = vtk_data_type_to_cgogn_name_of_type(array.type);
+			std::string data_name = array.name;
+			if (to_lower(data_name) == "normal" || to_lower(data_name) == "normals")
+				data_name = "normal";
+
+			if (is_position)
 			{
-				if (to_lower(std::string(cell_data->Attribute("Name"))) == "connectivity" && (cell_data != cell_nodes.back()))
-				{
-					std::swap(cell_data, cell_nodes.back());
-					break;
-				}
+				cgogn_assert(array.nb_components == 3u);
+				data_inputs.push_back(DataInputGen::template newDataIO<PRIM_SIZE, VEC3>(type, 3u));
+				add_attribute_task(array, *data_inputs.back(), this->add_vertex_attribute(*data_inputs.back(), "position", nb_vertices), nb_vertices);
 			}
-
-			for (XMLElement* cell_data : cell_nodes)
+			else if (is_vertex_data)
 			{
-				std::string data_name;
-				if (cell_data->Attribute("Name"))
-					 data_name = std::string(cell_data->Attribute("Name"));
-				if (to_lower(data_name) == "normal" || to_lower(data_name) == "normals")
-					data_name = "normal";
-
-				const bool binary = cell_data->Attribute("format", nullptr) && (to_lower(std::string(cell_data->Attribute("format", nullptr))) == "binary");
-				uint32 nb_comp = 1u;
-				cell_data->QueryUnsignedAttribute("NumberOfComponents", &nb_comp);
-				std::string type = vtk_data_type_to_cgogn_name_of_type(std::string(cell_data->Attribute("type", nullptr)));
-
-				if (data_name.empty())
-					cgogn_log_debug("parse_xml_vtu") << "Skipping a cell DataArray without \"Name\" attribute.";
-				else
+				data_inputs.push_back(DataInputGen::template newDataIO<PRIM_SIZE>(type, array.nb_components));
+				add_attribute_task(array, *data_inputs.back(), this->add_vertex_attribute(*data_inputs.back(), data_name, nb_vertices), nb_vertices);
+			}
+			else if (is_cell_data)
+			{
+				cgogn_log_info("parse_xml_vtu") << "Reading cell attribute \"" <<  data_name << "\" of type " << type << ".";
+				data_inputs.push_back(DataInputGen::template newDataIO<PRIM_SIZE>(type, array.nb_components));
+				add_attribute_task(array, *data_inputs.back(), this->add_cell_attribute(*data_inputs.back(), data_name, nb_cells), nb_cells);
+			}
+			else
+			{
+				data_name = to_lower(data_name);
+				if (data_name == "connectivity")
 				{
-					const char*					ascii_data = cell_data->GetText();
-					std::vector<unsigned char>	binary_data;
-					if (binary)
-						binary_data = read_binary_xml_data(ascii_data,compressed, data_type(header_type));
-
-					std::unique_ptr<IMemoryStream> mem_stream;
-					if (binary)
-						mem_stream = make_unique<IMemoryStream>(reinterpret_cast<char*>(&binary_data[0]), binary_data.size());
-					else
-						mem_stream = make_unique<IMemoryStream>(ascii_data);
-					if (data_name == "connectivity")
-					{
-						const uint32 last_offset = this->offsets_.vec()->back();
-						auto cells = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
-						cells->read_n(*mem_stream, last_offset,binary,!little_endian);
-						this->cells_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(cells->simplify());
-					}
-					else
-					{
-						if (data_name == "offsets")
-						{
-							auto offsets = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
-							offsets->read_n(*mem_stream, nb_cells,binary,!little_endian);
-							this->offsets_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(offsets->simplify());
-						}
-						else
-						{
-							if (data_name == "types")
-							{
-								auto types = DataInputGen::template newDataIO<PRIM_SIZE, int>(type);
-								types->read_n(*mem_stream, nb_cells,binary,!little_endian);
-								this->cell_types_ = *dynamic_cast_unique_ptr<DataInput<int>>(types->simplify());
-							}
-							else
-							{
-								cgogn_log_info("parse_xml_vtu") << "Reading cell attribute \"" <<  data_name << "\" of type " << type << ".";
-								auto cell_att = DataInputGen::template newDataIO<PRIM_SIZE>(type, nb_comp);
-								cell_att->read_n(*mem_stream, nb_cells,binary,!little_endian);
-								this->add_cell_attribute(*cell_att, data_name);
-							}
-						}
-					}
+					cells = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
+					add_data_input_task(array, cells.get());
+				}
+				else if (data_name == "offsets")
+				{
+					offsets = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
+					add_data_input_task(array, offsets.get());
+				}
+				else if (data_name == "types" && array.section == "Cells")
+				{
+					types = DataInputGen::template newDataIO<PRIM_SIZE, int>(type);
+					add_data_input_task(array, types.get());
 				}
+				else
+					cgogn_log_debug("parse_xml_vtu") << "Ignoring cell attribute \"" <<  data_name << "\" of type " << type << ".";
 			}
 		}
 
-		XMLElement* const poly_node = piece_node->FirstChildElement("Polys");
-		if (poly_node)
+		run_tasks(tasks);
+
+		if (std::find(tasks_success.begin(), tasks_success.end(), uint8(false)) != tasks_success.end())
+		{
+			cgogn_log_warning("parse_xml_vtu")<< "Unable to decode the binary data of the file \"" << filename << "\".";
+			return false;
+		}
+
+		if (offsets)
+			this->offsets_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(offsets->simplify());
+		if (types)
+			this->cell_types_ = *dynamic_cast_unique_ptr<DataInput<int>>(types->simplify());
+		if (cells)
+			this->cells_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(cells->simplify());
+
+		// the ascii connectivity is read last since its size is given by the offsets
+		for (const DataArray*& array : ascii_arrays)
 		{
-			XMLElement* polys_array_node = poly_node->FirstChildElement("DataArray");
-			cgogn_assert(polys_array_node != nullptr);
-			std::vector<XMLElement*> poly_nodes;
-			while (polys_array_node)
+			if (to_lower(array->name) == "connectivity" && (array != ascii_arrays.back()))
 			{
-				poly_nodes.push_back(polys_array_node);
-				polys_array_node = polys_array_node->NextSiblingElement("DataArray");
+				std::swap(array, ascii_arrays.back());
+				break;
 			}
+		}
 
-			for (XMLElement*& poly_data_array : poly_nodes)
+		for (const DataArray* array : ascii_arrays)
+		{
+			const std::string type = vtk_data_type_to_cgogn_name_of_type(array->type);
+			std::string data_name = array->name;
+			if (to_lower(data_name) == "normal" || to_lower(data_name) == "normals")
+				data_name = "normal";
+
+			const std::string ascii_data = reader.read_text(*array);
+			IMemoryStream mem_stream(ascii_data.c_str());
+
+			if (array == position_array)
 			{
-				if (poly_data_array->Attribute("Name") && to_lower(std::string(poly_data_array->Attribute("Name"))) == "connectivity" && (poly_data_array != poly_nodes.back()))
-				{
-					std::swap(poly_data_array, poly_nodes.back());
-				}
+				cgogn_assert(array->nb_components == 3u);
+				auto pos = DataInputGen::template newDataIO<PRIM_SIZE, VEC3>(type, 3u);
+				pos->read_n(mem_stream, nb_vertices, false, big_endian);
+				this->add_vertex_attribute(*pos, "position");
 			}
-
-			for (XMLElement* poly_data_array : poly_nodes)
+			else if (array->section == "PointData")
 			{
-				const std::string& data_name = to_lower(std::string(poly_data_array->Attribute("Name")));
-				const bool binary = (poly_data_array->Attribute("format") && to_lower(std::string(poly_data_array->Attribute("format", nullptr))) == "binary");
-				uint32 nb_comp = 1;
-				poly_data_array->QueryUnsignedAttribute("NumberOfComponents", &nb_comp);
-				std::string type;
-				if (poly_data_array->Attribute("type", nullptr))
-					type = vtk_data_type_to_cgogn_name_of_type(std::string(poly_data_array->Attribute("type", nullptr)));
-
-				if (data_name.empty())
-					cgogn_log_debug("parse_xml_vtu")<< "Skipping a cell DataArray without \"Name\" attribute.";
-				else
+				auto vertex_att = DataInputGen::template newDataIO<PRIM_SIZE>(type, array->nb_components);
+				vertex_att->read_n(mem_stream, nb_vertices, false, big_endian);
+				this->add_vertex_attribute(*vertex_att, data_name);
+			}
+			else if (array->section == "CellData")
+			{
+				cgogn_log_info("parse_xml_vtu") << "Reading cell attribute \"" <<  data_name << "\" of type " << type << ".";
+				auto cell_att = DataInputGen::template newDataIO<PRIM_SIZE>(type, array->nb_components);
+				cell_att->read_n(mem_stream, nb_cells, false, big_endian);
+				this->add_cell_attribute(*cell_att, data_name);
+			}
+			else
+			{
+				data_name = to_lower(data_name);
+				if (data_name == "connectivity")
 				{
-					const char*					ascii_data = poly_data_array->GetText();
-					std::vector<unsigned char>	binary_data;
-					if (binary)
-						binary_data = read_binary_xml_data(ascii_data,compressed, data_type(header_type));
-
-					std::unique_ptr<IMemoryStream> mem_stream;
-					if (binary)
-						mem_stream = make_unique<IMemoryStream>(reinterpret_cast<char*>(&binary_data[0]), binary_data.size());
-					else
-						mem_stream = make_unique<IMemoryStream>(ascii_data);
-					if (data_name == "connectivity")
-					{
-						const uint32 last_offset = this->offsets_.vec()->back();
-						auto cells = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
-						cells->read_n(*mem_stream, last_offset,binary,!little_endian);
-						this->cells_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(cells->simplify());
-					}
-					else
-					{
-						if (data_name == "offsets")
-						{
-							auto offsets = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
-							offsets->read_n(*mem_stream, nb_cells,binary,!little_endian);
-							this->offsets_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(offsets->simplify());
-						}
-						else
-							cgogn_log_debug("parse_xml_vtu") << "Ignoring cell attribute \"" <<  data_name << "\" of type " << type << ".";
-					}
+					const uint32 last_offset = this->offsets_.vec()->empty() ? 0u : this->offsets_.vec()->back();
+					auto cells_data = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
+					cells_data->read_n(mem_stream, last_offset, false, big_endian);
+					this->cells_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(cells_data->simplify());
+				}
+				else if (data_name == "offsets")
+				{
+					auto offsets_data = DataInputGen::template newDataIO<PRIM_SIZE, uint32>(type);
+					offsets_data->read_n(mem_stream, nb_cells, false, big_endian);
+					this->offsets_ = *dynamic_cast_unique_ptr<DataInput<uint32>>(offsets_data->simplify());
 				}
+				else if (data_name == "types" && array->section == "Cells")
+				{
+					auto types_data = DataInputGen::template newDataIO<PRIM_SIZE, int>(type);
+					types_data->read_n(mem_stream, nb_cells, false, big_endian);
+					this->cell_types_ = *dynamic_cast_unique_ptr<DataInput<int>>(types_data->simplify());
+				}
+				else
+					cgogn_log_debug("parse_xml_vtu") << "Ignoring cell attribute \"" <<  data_name << "\" of type " << type << ".";
 			}
 		}
+
 		return true;
 	}
 };
@@ -1381,6 +1453,7 @@ public:
 	using Inherit_Vtk = VtkIO<MAP_TRAITS::CHUNK_SIZE, CMap2<MAP_TRAITS>::PRIM_SIZE, VEC3>;
 	using Inherit_Import = SurfaceFileImport<MAP_TRAITS, VEC3>;
 	using DataInputGen = typename Inherit_Vtk::DataInputGen;
+	using ChunkArrayGen = typename Inherit_Vtk::ChunkArrayGen;
 	template <typename T>
 	using DataInput = typename Inherit_Vtk::template DataInput<T>;
 
@@ -1438,6 +1511,18 @@ protected:
 		Inherit_Import::add_face_attribute(attribute_data, attribute_name);
 	}
 
+	virtual ChunkArrayGen* add_vertex_attribute(const DataInputGen& attribute_data, const std::string& attribute_name, uint32 nb) override
+	{
+		cgogn_log_info("VtkSurfaceImport::add_vertex_attribute") << "Adding a vertex attribute named \"" << attribute_name << "\".";
+		return Inherit_Import::add_vertex_attribute(attribute_data, attribute_name, nb);
+	}
+
+	virtual ChunkArrayGen* add_cell_attribute(const DataInputGen& attribute_data, const std::string& attribute_name, uint32 nb) override
+	{
+		cgogn_log_info("VtkSurfaceImport::add_cell_attribute") << "Adding a face attribute named \"" << attribute_name << "\".";
+		return Inherit_Import::add_face_attribute(attribute_data, attribute_name, nb);
+	}
+
 	virtual bool import_file_impl(const std::string& filename) override
 	{
 		const FileType ft = file_type(filename);
@@ -1513,6 +1598,7 @@ public:
 	using Inherit_Vtk = VtkIO<MAP_TRAITS::CHUNK_SIZE, CMap3<MAP_TRAITS>::PRIM_SIZE, VEC3>;
 	using Inherit_Import = VolumeFileImport<MAP_TRAITS, VEC3>;
 	using DataInputGen = typename Inherit_Vtk::DataInputGen;
+	using ChunkArrayGen = typename Inherit_Vtk::ChunkArrayGen;
 	template <typename T>
 	using DataInput = typename Inherit_Vtk::template DataInput<T>;
 	template <typename T>
@@ -1659,6 +1745,16 @@ protected:
 	{
 		Inherit_Import::add_volume_attribute(attribute_data, attribute_name);
 	}
+
+	virtual ChunkArrayGen* add_vertex_attribute(const DataInputGen& attribute_data, const std::string& attribute_name, uint32 nb) override
+	{
+		return Inherit_Import::add_vertex_attribute(attribute_data, attribute_name, nb);
+	}
+
+	virtual ChunkArrayGen* add_cell_attribute(const DataInputGen& attribute_data, const std::string& attribute_name, uint32 nb) override
+	{
+		return Inherit_Import::add_volume_attribute(attribute_data, attribute_name, nb);
+	}
 };
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_IO_VTK_IO_CPP_))
@@ -134,23 +134,7 @@ protected:
 		const typename MAP::template VertexAttribute<VEC3>* position
 	)
 	{
-		using Vertex = typename MAP::Vertex;
-		using Face = typename MAP::Face;
-
-		// reserve more ?
-//		table_indices.reserve(m.get_nb_darts() / 3);
-		m.foreach_cell([&] (Face f)
-		{
-			if (m.has_codegree(f, 3))
-			{
-				table_indices.push_back(m.embedding(Vertex(f.dart)));
-				table_indices.push_back(m.embedding(Vertex(m.phi1(f.dart))));
-				table_indices.push_back(m.embedding(Vertex(m.phi1(m.phi1(f.dart)))));
-			}
-			else
-				cgogn::geometry::append_ear_triangulation<VEC3>(m, f, *position, table_indices);
-		},
-		mask);
+		cgogn::geometry::parallel_triangulate<VEC3>(m, mask, *position, table_indices);
 	}
 
 	template <typename MAP, typename MASK>
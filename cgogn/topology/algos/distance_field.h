@@ -24,7 +24,16 @@
 #ifndef CGOGN_TOPOLOGY_DISTANCE_FIELD_H_
 #define CGOGN_TOPOLOGY_DISTANCE_FIELD_H_
 
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include <cgogn/core/utils/thread_pool.h>
+
 #include <cgogn/topology/types/adjacency_cache.h>
+#include <cgogn/topology/types/shortest_path_queue.h>
 
 #include <cgogn/geometry/algos/centroid.h>
 
@@ -60,7 +69,8 @@ public:
 		map_(map),
 		cache_(cache),
 		intern_edge_weight_(false),
-		edge_weight_(weight)
+		edge_weight_(weight),
+		queue_(RADIX_HEAP)
 	{
 	}
 
@@ -68,7 +78,8 @@ public:
 				  const AdjacencyCache<MAP>& cache) :
 		map_(map),
 		cache_(cache),
-		intern_edge_weight_(true)
+		intern_edge_weight_(true),
+		queue_(RADIX_HEAP)
 	{
 		map.add_attribute(edge_weight_, "__edge_weight__");
 
@@ -91,57 +102,142 @@ public:
 
 private:
 
+	// the queues of a shortest path computation (only the one selected by queue_ is used)
+	struct Queues
+	{
+		BinaryHeapQueue<Scalar> binary_heap_;
+		DAryHeapQueue<Scalar, 4u> four_ary_heap_;
+		RadixHeapQueue<Scalar> radix_heap_;
+	};
+
 	/**
-	 * Compute for each vertex of the map, the shortest path to the sources
-	 * A path is a sequence of adjacent edges whose weights are summed along the paths
-	 * The method returns the lengths of the shortest paths in a VertexAttribute.
-	 * @param[in] sources the vertices from which the shortest paths are computed
-	 * @param[out] distance_to_source : the sums of the edge weights in the shortest paths
+	 * Dijkstra flood on the arrays of the adjacency cache.
+	 * @param[in] sources the embeddings of the sources
+	 * @param[in] weight the edge weights gathered in the slots of the cache
+	 * @param[in,out] distance the distances to the sources, indexed by the embeddings of the vertices,
+	 * initialized with std::numeric_limits<Scalar>::max()
+	 * @param queue the queue, reused from one call to the next
+	 * @param on_relax called with (u, v) each time the distance of v is lowered through u
 	 */
-	void dijkstra_compute_distances(
-			const std::vector<Vertex>& sources,
-			VertexAttribute<Scalar>& distance_to_source)
+	template <typename QUEUE, typename FUNC>
+	void dijkstra(
+			const std::vector<uint32>& sources,
+			const std::vector<Scalar>& weight,
+			std::vector<Scalar>& distance,
+			QUEUE& queue,
+			const FUNC& on_relax) const
 	{
-		for (auto& d : distance_to_source)
-			d = std::numeric_limits<Scalar>::max();
+		queue.reset(uint32(distance.size()));
 
-		// A pair contains a scalar (the actual distance) and a vertex (the index of one of its darts)
-		using my_pair = std::pair<Scalar, uint32>;
-
-		// The queue is used to manage the front of the dijkstra flood that consider
-		// the vertices in the order of their estimated distance to a source
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>, std::greater<my_pair> >;
-		my_queue vertex_queue;
-
-		// Initialize the sources with a zero lenght path
-		for (auto& source : sources)
+		for (uint32 s : sources)
 		{
-			vertex_queue.push(std::make_pair(Scalar(0), source.dart.index));
-			distance_to_source[source] = Scalar(0);
+			distance[s] = Scalar(0);
+			queue.push(s, Scalar(0));
 		}
 
-		// The dijkstra flood
-		while (!vertex_queue.empty())
+		while (!queue.empty())
 		{
-			Scalar dist = vertex_queue.top().first;
-			Vertex u = Vertex(Dart(vertex_queue.top().second));
+			uint32 u;
+			Scalar dist;
+			queue.pop(u, dist);
 
-			vertex_queue.pop();
+			// outdated entry of a lazy queue: u has been reached through a shorter path
+			if (dist > distance[u])
+				continue;
 
-			cache_.foreach_adjacent_vertex_through_edge(u, [&](Vertex v)
+			cache_.foreach_adjacency(u, [&] (uint32 slot, uint32 v)
 			{
-				Scalar distance_through_u = dist + edge_weight_[Edge(v.dart)];
-				if (distance_through_u < distance_to_source[v])
+				const Scalar distance_through_u = dist + weight[slot];
+				if (distance_through_u < distance[v])
 				{
-					distance_to_source[v] = distance_through_u;
-					vertex_queue.push(std::make_pair(distance_through_u, v.dart.index));
+					distance[v] = distance_through_u;
+					on_relax(u, v);
+					queue.push(v, distance_through_u);
 				}
 			});
 		}
 	}
 
+	template <typename FUNC>
+	void dijkstra(
+			const std::vector<uint32>& sources,
+			const std::vector<Scalar>& weight,
+			std::vector<Scalar>& distance,
+			Queues& queues,
+			const FUNC& on_relax) const
+	{
+		switch (queue_)
+		{
+			case BINARY_HEAP: dijkstra(sources, weight, distance, queues.binary_heap_, on_relax); break;
+			case FOUR_ARY_HEAP: dijkstra(sources, weight, distance, queues.four_ary_heap_, on_relax); break;
+			case RADIX_HEAP: dijkstra(sources, weight, distance, queues.radix_heap_, on_relax); break;
+		}
+	}
+
+	std::vector<uint32> embeddings(const std::vector<Vertex>& vertices) const
+	{
+		std::vector<uint32> result;
+		result.reserve(vertices.size());
+		for (Vertex v : vertices)
+			result.push_back(map_.embedding(v));
+		return result;
+	}
+
+	/**
+	 * Copy the values of an array indexed by the embeddings of the vertices in a vertex attribute
+	 * (the lines that are not covered by the array are set to default_value)
+	 */
+	template <typename T, typename ATTRIBUTE>
+	void copy_to_attribute(const std::vector<T>& values, const T& default_value, ATTRIBUTE& attribute) const
+	{
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		const uint32 nb_values = uint32(values.size());
+		parallel_foreach_range(container.end(), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (container.used(i))
+					attribute[i] = i < nb_values ? values[i] : default_value;
+			}
+		});
+	}
+
+	/**
+	 * Compute for each vertex of the map, the shortest path to the sources
+	 * A path is a sequence of adjacent edges whose weights are summed along the paths
+	 * The method returns the lengths of the shortest paths in a VertexAttribute.
+	 * @param[in] sources the vertices from which the shortest paths are computed
+	 * @param[out] distance_to_source : the sums of the edge weights in the shortest paths
+	 */
+	void dijkstra_compute_distances(
+			const std::vector<Vertex>& sources,
+			VertexAttribute<Scalar>& distance_to_source)
+	{
+		std::vector<Scalar> weight;
+		cache_.gather_edge_values(edge_weight_, weight);
+
+		std::vector<Scalar> distance(cache_.nb_rows(), std::numeric_limits<Scalar>::max());
+		Queues queues;
+		dijkstra(embeddings(sources), weight, distance, queues, [] (uint32, uint32) {});
+
+		copy_to_attribute(distance, std::numeric_limits<Scalar>::max(), distance_to_source);
+	}
+
 public:
 
+	/**
+	 * @brief select the queue used by the dijkstra computations (RADIX_HEAP by default)
+	 */
+	void set_queue(ShortestPathQueue queue)
+	{
+		queue_ = queue;
+	}
+
+	ShortestPathQueue queue() const
+	{
+		return queue_;
+	}
+
 	/**
 	 * Compute for each vertex of the map, the shortest path to the sources
 	 * A path is a sequence of adjacent edges whose weights are summed along the paths
@@ -149,53 +245,253 @@ public:
 	 * @param[in] sources the vertices from which the shortest paths are computed
 	 * @param[out] distance_to_source : the sums of the edge weights in the shortest paths
 	 * @param[out] path_to_source : a reference to the previous vertex in the shortest path
+	 * (the sources reference themselves)
 	 */
 	void dijkstra_compute_paths(
 			const std::vector<Vertex>& sources,
 			VertexAttribute<Scalar>& distance_to_source,
 			VertexAttribute<Vertex>& path_to_source)
 	{
-		for (auto& d : distance_to_source)
-			d = std::numeric_limits<Scalar>::max();
+		std::vector<Scalar> weight;
+		cache_.gather_edge_values(edge_weight_, weight);
+
+		const uint32 nb_rows = cache_.nb_rows();
+		std::vector<Scalar> distance(nb_rows, std::numeric_limits<Scalar>::max());
+		std::vector<uint32> previous(nb_rows, INVALID_INDEX);
+		Queues queues;
+		dijkstra(embeddings(sources), weight, distance, queues, [&] (uint32 u, uint32 v) { previous[v] = u; });
 
-		for (auto& p : path_to_source)
-			p = Vertex();
+		copy_to_attribute(distance, std::numeric_limits<Scalar>::max(), distance_to_source);
 
-		// A pair contains a scalar (the actual distance) and a vertex (the index of one of its darts)
-		using my_pair = std::pair<Scalar, uint32>;
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		parallel_foreach_range(container.end(), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (container.used(i))
+					path_to_source[i] = i < nb_rows && previous[i] != INVALID_INDEX ? Vertex(cache_.vertex_dart(previous[i])) : Vertex();
+			}
+		});
+		for (Vertex s : sources)
+			path_to_source[s] = s;
+	}
 
-		// The queue is used to manage the front of the dijkstra flood that consider
-		// the vertices in the order of their estimated distance to a source
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>, std::greater<my_pair> >;
-		my_queue vertex_queue;
+	/**
+	 * Compute for each vertex of the map, the shortest path to the sources with
+	 * the parallel delta-stepping algorithm (Meyer and Sanders).
+	 * The vertices are gathered in buckets of width delta, that are processed in increasing order:
+	 * the edges lighter than delta of the vertices of the current bucket are relaxed concurrently
+	 * until the bucket is empty, then their heavy edges are relaxed.
+	 * A relaxation from bucket b never reaches a bucket beyond b + ceil(max_weight / delta), so the buckets
+	 * are stored in a cyclic array of ceil(max_weight / delta) + 1 buckets (plus a margin for rounding errors).
+	 * The distances are the same as those of dijkstra_compute_distances (up to rounding errors).
+	 * @param[in] sources the vertices from which the shortest paths are computed
+	 * @param[out] distance_to_source : the sums of the edge weights in the shortest paths
+	 * @param[in] delta the width of the buckets (the mean edge weight if not positive,
+	 * at least max_weight / 2^20 so that the number of buckets is bounded)
+	 */
+	void delta_stepping_compute_distances(
+			const std::vector<Vertex>& sources,
+			VertexAttribute<Scalar>& distance_to_source,
+			Scalar delta = Scalar(0))
+	{
+		std::vector<Scalar> weight;
+		cache_.gather_edge_values(edge_weight_, weight);
 
-		// Initialize the sources with a zero lenght path
-		for (auto& source : sources)
+		if (!(delta > Scalar(0)))
 		{
-			vertex_queue.push(std::make_pair(Scalar(0), source.dart.index));
-			distance_to_source[source] = Scalar(0);
-			path_to_source[source] = source;
+			float64 sum = 0.0;
+			for (Scalar w : weight)
+				sum += float64(w);
+			delta = weight.empty() ? Scalar(1) : Scalar(sum / float64(weight.size()));
+			if (!(delta > Scalar(0)))
+				delta = Scalar(1);
 		}
 
-		// The dijkstra flood
-		while (!vertex_queue.empty())
+		const uint32 nb_rows = cache_.nb_rows();
+		std::vector<std::atomic<Scalar>> distance(nb_rows);
+		parallel_foreach_range(nb_rows, [&] (uint32, uint32 begin, uint32 end)
 		{
-			Scalar dist = vertex_queue.top().first;
-			Vertex u = Vertex(Dart(vertex_queue.top().second));
+			for (uint32 i = begin; i < end; ++i)
+				distance[i].store(std::numeric_limits<Scalar>::max(), std::memory_order_relaxed);
+		});
 
-			vertex_queue.pop();
+		// the bucket indices are not bounded by the number of buckets (they grow with the distances):
+		// they are stored on 64 bits, and clamped so that the conversion of the quotient is defined
+		auto bucket_of = [&] (uint32 v) -> uint64
+		{
+			const Scalar max_bucket = Scalar(uint64(1) << 62);
+			return uint64(std::min(distance[v].load(std::memory_order_relaxed) / delta, max_bucket));
+		};
+
+		Scalar max_weight = Scalar(0);
+		for (Scalar w : weight)
+			max_weight = std::max(max_weight, w);
+		// the number of buckets is bounded: a delta too small is enlarged (the buckets are only coarser)
+		const Scalar max_nb_buckets = Scalar(1u << 20);
+		if (max_weight / delta > max_nb_buckets)
+			delta = max_weight / max_nb_buckets;
+		// (plus one bucket for the rounding errors of the sums of distances)
+		const uint32 nb_buckets = uint32(std::ceil(max_weight / delta)) + 2u;
+
+		// cyclic array of buckets of vertices, bucket b is stored at b % nb_buckets;
+		// in_bucket[v] - 1 is the last bucket in which v has been inserted (0 if v is not waiting in a bucket),
+		// settled[v] - 1 is the last bucket in which v has been processed
+		std::vector<std::vector<uint32>> buckets(nb_buckets);
+		std::vector<uint64> in_bucket(nb_rows, 0u);
+		std::vector<uint64> settled(nb_rows, 0u);
+
+		auto insert = [&] (uint32 v)
+		{
+			const uint64 b = bucket_of(v);
+			if (in_bucket[v] == b + 1u)
+				return;
+			in_bucket[v] = b + 1u;
+			buckets[b % nb_buckets].push_back(v);
+		};
+
+		for (Vertex s : sources)
+		{
+			const uint32 s_emb = map_.embedding(s);
+			distance[s_emb].store(Scalar(0), std::memory_order_relaxed);
+			insert(s_emb);
+		}
 
-			cache_.foreach_adjacent_vertex_through_edge(u, [&](Vertex v)
+		// relax concurrently the light (or heavy) edges of the given vertices
+		// and insert the vertices whose distance has been lowered in their bucket
+		std::vector<std::vector<uint32>> lowered;
+		auto relax = [&] (const std::vector<uint32>& vertices, bool light)
+		{
+			const uint32 nb = uint32(vertices.size());
+			const uint32 nb_ranges = nb_parallel_ranges(nb);
+			if (lowered.size() < nb_ranges)
+				lowered.resize(nb_ranges);
+			parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
 			{
-				Scalar distance_through_u = dist + edge_weight_[Edge(v.dart)];
-				if (distance_through_u < distance_to_source[v])
+				std::vector<uint32>& lowered_r = lowered[r];
+				for (uint32 i = begin; i < end; ++i)
 				{
-					distance_to_source[v] = distance_through_u;
-					path_to_source[v] = u;
-					vertex_queue.push(std::make_pair(distance_through_u, v.dart.index));
+					const uint32 u = vertices[i];
+					const Scalar dist = distance[u].load(std::memory_order_relaxed);
+					cache_.foreach_adjacency(u, [&] (uint32 slot, uint32 v)
+					{
+						const Scalar w = weight[slot];
+						if ((w <= delta) != light)
+							return;
+						const Scalar distance_through_u = dist + w;
+						Scalar current = distance[v].load(std::memory_order_relaxed);
+						while (distance_through_u < current)
+						{
+							if (distance[v].compare_exchange_weak(current, distance_through_u, std::memory_order_relaxed))
+							{
+								lowered_r.push_back(v);
+								break;
+							}
+						}
+					});
 				}
 			});
+			for (uint32 r = 0u; r < nb_ranges; ++r)
+			{
+				for (uint32 v : lowered[r])
+					insert(v);
+				lowered[r].clear();
+			}
+		};
+
+		std::vector<uint32> frontier;
+		std::vector<uint32> processed;
+		// the computation ends when a whole cycle of buckets is empty
+		for (uint64 b = 0u, nb_empty = 0u; nb_empty < nb_buckets; ++b)
+		{
+			std::vector<uint32>& bucket = buckets[b % nb_buckets];
+			if (bucket.empty())
+			{
+				++nb_empty;
+				continue;
+			}
+			nb_empty = 0u;
+
+			processed.clear();
+			while (!bucket.empty())
+			{
+				frontier.clear();
+				for (uint32 v : bucket)
+				{
+					// skip the vertices that have been moved to a lower bucket
+					if (bucket_of(v) != b)
+						continue;
+					in_bucket[v] = 0u;
+					frontier.push_back(v);
+					if (settled[v] != b + 1u)
+					{
+						settled[v] = b + 1u;
+						processed.push_back(v);
+					}
+				}
+				bucket.clear();
+				relax(frontier, true);
+			}
+			relax(processed, false);
 		}
+
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		parallel_foreach_range(container.end(), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (container.used(i))
+					distance_to_source[i] = i < nb_rows ? distance[i].load(std::memory_order_relaxed) : std::numeric_limits<Scalar>::max();
+			}
+		});
+	}
+
+	/**
+	 * @brief number of tasks used by parallel_foreach_distance_field to process nb_sources sources
+	 */
+	static uint32 nb_distance_field_tasks(uint32 nb_sources)
+	{
+		const uint32 nb_threads_pool = uint32(thread_pool()->nb_threads());
+		return std::max(1u, std::min(nb_sources, nb_threads_pool));
+	}
+
+	/**
+	 * Compute the distance field of each of the given sources concurrently on the thread pool.
+	 * The sources are distributed over t = nb_distance_field_tasks(sources.size()) tasks
+	 * (task k handles the sources k, k + t, k + 2t, ...) that each own a distance buffer.
+	 * f(i, k, distance) is called by the task k once the distance field of sources[i] is computed.
+	 * distance is indexed by the embeddings of the vertices; the unreachable vertices and
+	 * the unused lines hold std::numeric_limits<Scalar>::max().
+	 * The adjacency cache must be initialized; the edge weights are read once when the method is called.
+	 */
+	template <typename FUNC>
+	void parallel_foreach_distance_field(const std::vector<Vertex>& sources, const FUNC& f)
+	{
+		cgogn_message_assert(cache_.is_initialized(), "parallel_foreach_distance_field: the adjacency cache is not initialized");
+
+		const uint32 nb_sources = uint32(sources.size());
+		if (nb_sources == 0u)
+			return;
+
+		std::vector<Scalar> weight;
+		cache_.gather_edge_values(edge_weight_, weight);
+
+		const std::vector<uint32> source_embeddings = embeddings(sources);
+
+		const uint32 nb_rows = cache_.nb_rows();
+		const uint32 nb_tasks = nb_distance_field_tasks(nb_sources);
+		parallel_foreach_range(nb_tasks, nb_tasks, [&] (uint32 k, uint32, uint32)
+		{
+			std::vector<Scalar> distance(nb_rows);
+			Queues queues;
+			for (uint32 i = k; i < nb_sources; i += nb_tasks)
+			{
+				std::fill(distance.begin(), distance.end(), std::numeric_limits<Scalar>::max());
+				dijkstra({source_embeddings[i]}, weight, distance, queues, [] (uint32, uint32) {});
+				const std::vector<Scalar>& result = distance;
+				f(i, k, result);
+			}
+		});
 	}
 
 private:
@@ -212,6 +508,7 @@ private:
 	 * The algorithm makes a dijkstra flood of the graph using the scalar field values
 	 * in place of the shortest path distance computed in dijkstra_compute_distances().
 	 * The vertices are traversed in increasing value of their scalar field.
+	 * The keys of the flood are not monotone: a 4-ary heap is used whatever the selected queue.
 	 */
 	void dijkstra_to_morse_function(
 			std::vector<Vertex> minima,
@@ -221,13 +518,11 @@ private:
 		for(auto& d : morse_function)
 			d = Scalar(0);							// To mark unvisited vertices
 
-		using my_pair = std::pair<Scalar, unsigned int>;
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>, std::greater<my_pair> >;
-
-		my_queue vertex_queue;
+		DAryHeapQueue<Scalar, 4u> vertex_queue;
+		vertex_queue.reset(cache_.nb_rows());
 
 		for (auto source : minima)
-			vertex_queue.push(std::make_pair(Scalar(0), source.dart.index));
+			vertex_queue.push(map_.embedding(source), Scalar(0));
 
 		// Run dijkstra using distance_to_source in place of the estimated geodesic distances
 		// and fill the morse function with i/n where i is index of distance_to_source
@@ -236,17 +531,17 @@ private:
 		uint32 i = 1;
 		while(!vertex_queue.empty())
 		{
-			Vertex u = Vertex(Dart(vertex_queue.top().second));
-
-			vertex_queue.pop();
+			uint32 u;
+			Scalar value;
+			vertex_queue.pop(u, value);
 
 			morse_function[u] = Scalar(i)/n;		// Set the final value
 			++i;
 
-			cache_.foreach_adjacent_vertex_through_edge(u, [&](Vertex v)
+			cache_.foreach_adjacency(u, [&](uint32, uint32 v)
 			{
 				if(morse_function[v] == Scalar(0)) {	// If not visited
-					vertex_queue.push(std::make_pair(scalar_field[v], v.dart.index));
+					vertex_queue.push(v, scalar_field[v]);
 					morse_function[v] = Scalar(1);		// Set as visited
 				}
 			});
@@ -344,28 +639,34 @@ public:
 	}
 
 	/**
-		 * Build a scalar field that represent the sum of the distance of each vertex
-		 * to a given set of features (selected vertices) of the Map.
-		 * @param[in] features the vertices from which the shortest paths are computed
-		 * @param[out] scalar_field : the computed distance field
-		 */
+	 * Build a scalar field that represent the sum of the distance of each vertex
+	 * to a given set of features (selected vertices) of the Map.
+	 * The distance fields of the features are computed concurrently (see parallel_foreach_distance_field)
+	 * and summed in per task buffers, that are then reduced in the scalar field.
+	 * @param[in] features the vertices from which the shortest paths are computed
+	 * @param[out] scalar_field : the computed distance field
+	 */
 	void sum_of_distance_to_features(const std::vector<Vertex>& features,
 									 VertexAttribute<Scalar>& scalar_field)
 	{
-		VertexAttribute<Scalar> distance_to_feature =
-				map_.template add_attribute<Scalar, Vertex::ORBIT>("__distance_to_feature__");
+		const uint32 nb_tasks = nb_distance_field_tasks(uint32(features.size()));
+		std::vector<std::vector<Scalar>> sums(nb_tasks, std::vector<Scalar>(cache_.nb_rows(), Scalar(0)));
 
-		for (auto& s : scalar_field) s = Scalar(0);
+		parallel_foreach_distance_field(features, [&] (uint32, uint32 k, const std::vector<Scalar>& distance)
+		{
+			std::vector<Scalar>& sum = sums[k];
+			for (uint32 i = 0u, end = uint32(distance.size()); i < end; ++i)
+				sum[i] += distance[i];
+		});
 
-		for (Vertex f : features)
+		map_.parallel_foreach_cell([&] (Vertex v, uint32)
 		{
-			dijkstra_compute_distances({f}, distance_to_feature);
-			map_.foreach_cell([&](Vertex v)
-			{
-				scalar_field[v] += distance_to_feature[v];
-			});
-		}
-		map_.remove_attribute(distance_to_feature);
+			const uint32 emb = map_.embedding(v);
+			Scalar s = Scalar(0);
+			for (const std::vector<Scalar>& sum : sums)
+				s += sum[emb];
+			scalar_field[v] = s;
+		});
 	}
 
 	/**
@@ -428,6 +729,7 @@ private:
 	AdjacencyCache<MAP> cache_;
 	EdgeAttribute<Scalar> edge_weight_;
 	bool intern_edge_weight_;
+	ShortestPathQueue queue_;
 };
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_DISTANCE_FIELD_CPP_))
@@ -106,7 +106,7 @@ public:
 		Vertex A = central_vertex;
 
 		// Init B with the furthest vertice from A
-		distance_field_.dijkstra_compute_paths({A}, distance_to_A_, paths_);
+		distance_to_source(A, distance_to_A_);
 		Vertex B = distance_field_.find_maximum(distance_to_A_);
 		Scalar max_distance = distance_to_A_[B];
 
@@ -118,11 +118,11 @@ public:
 			current_distance = max_distance;
 
 			// Move A to the furthest vertices from B
-			distance_field_.dijkstra_compute_paths({B}, distance_to_B_, paths_);
+			distance_to_source(B, distance_to_B_);
 			A = distance_field_.find_maximum(distance_to_B_);
 
 			// Move B to the furthest vertices from A
-			distance_field_.dijkstra_compute_paths({A}, distance_to_A_, paths_);
+			distance_to_source(A, distance_to_A_);
 			B = distance_field_.find_maximum(distance_to_A_);
 			max_distance = distance_to_A_[B];
 		};
@@ -188,20 +188,31 @@ public:
 		scalar_field.critical_vertex_analysis();
 		std::vector<Vertex> maxima = scalar_field.get_maxima();
 
+		// Compute concurrently the maximum of the distance field of each of these maxima
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		std::vector<Scalar> maximal_distances(maxima.size());
+		distance_field_.parallel_foreach_distance_field(maxima, [&] (uint32 i, uint32, const std::vector<Scalar>& distance)
+		{
+			Scalar max = Scalar(0);
+			for (uint32 emb = 0u, end = uint32(distance.size()); emb < end; ++emb)
+			{
+				if (container.used(emb) && distance[emb] > max)
+					max = distance[emb];
+			}
+			maximal_distances[i] = max;
+		});
+
 		// Search the most central vertices in these maxima,
 		// i.e. whose distance field has a minimal diameter
 		Scalar min = std::numeric_limits<Scalar>::max();
 		Vertex min_vertex = maxima.front();
 
-		for (Vertex v : maxima)
+		for (uint32 i = 0u, end = uint32(maxima.size()); i < end; ++i)
 		{
-			distance_field_.distance_to_features({v}, distance_to_A_);
-			Vertex max_vertex = distance_field_.find_maximum(distance_to_A_);
-			Scalar max = distance_to_A_[max_vertex];
-			if (min > max)
+			if (min > maximal_distances[i])
 			{
-				min = max;
-				min_vertex = v;
+				min = maximal_distances[i];
+				min_vertex = maxima[i];
 			}
 		}
 		return min_vertex;
@@ -209,6 +220,23 @@ public:
 
 private:
 
+	/**
+	 * Build the distance field of a single source on the arrays of the adjacency cache
+	 * (see DistanceField::parallel_foreach_distance_field) and copy it in scalar_field.
+	 */
+	void distance_to_source(Vertex source, VertexAttribute<Scalar>& scalar_field)
+	{
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		distance_field_.parallel_foreach_distance_field({source}, [&] (uint32, uint32, const std::vector<Scalar>& distance)
+		{
+			for (uint32 emb = 0u, end = uint32(distance.size()); emb < end; ++emb)
+			{
+				if (container.used(emb))
+					scalar_field[emb] = distance[emb];
+			}
+		});
+	}
+
 	/**
 	 * Remove the vertices whose distance to local minima of the given scalar field
 	 * is below the threshold and (if any) add the source of the closest to the filtered set
@@ -0,0 +1,566 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_TOPOLOGY_MAP_PARTITION_H_
+#define CGOGN_TOPOLOGY_MAP_PARTITION_H_
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <type_traits>
+
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/morton_code.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/topology/dll.h>
+
+#include <cgogn/geometry/algos/centroid.h>
+
+namespace cgogn
+{
+
+namespace topology
+{
+
+/**
+ * class MapPartition : split the cells of a map (vertices, faces of a surface or volumes of a volume map)
+ * in k balanced regions, so that parallel processings can work per region: each region is a contiguous
+ * list of cells that is processed by a single task (see parallel_foreach_partition).
+ * The adjacency graph of the cells (vertices through edges, faces through edges, volumes through faces)
+ * is built once (in parallel) in compressed sparse row arrays. Two strategies are available:
+ * - compute(k): the graph is coarsened by heavy edge matchings until it has a few nodes per region,
+ *   the coarsest graph is partitioned by greedy region growing, then the partition is projected back
+ *   on the finer graphs and refined at each level by moving boundary cells (positive gains of cut edges
+ *   under the balance constraint);
+ * - compute(k, position): the cells are sorted (in parallel) along the Morton curve of their centroids
+ *   and cut into k sequences of (almost) the same size.
+ * For each region, the cells and the boundary cells (that are adjacent to another region) are given.
+ * The topology of the map must not change while the partition is used.
+ */
+template <typename MAP, typename CellType>
+class MapPartition
+{
+	using Vertex = typename MAP::Vertex;
+	template <typename T>
+	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+	template <typename T>
+	using CellAttribute = typename MAP::template Attribute<T, CellType::ORBIT>;
+
+	static_assert(std::is_same<CellType, typename MAP::Vertex>::value ||
+				  (MAP::DIMENSION == 2u && std::is_same<CellType, typename MAP::Face>::value) ||
+				  (MAP::DIMENSION == 3u && std::is_same<CellType, typename MAP::Volume>::value),
+				  "MapPartition is defined on the vertices, the faces of a surface or the volumes of a volume map");
+
+	// adjacency graph in CSR arrays, with the weights of the nodes and of the edges
+	struct Graph
+	{
+		std::vector<uint32> offsets_;
+		std::vector<uint32> adjacency_;
+		std::vector<uint32> edge_weights_;
+		std::vector<uint32> node_weights_;
+
+		inline uint32 nb_nodes() const { return uint32(node_weights_.size()); }
+	};
+
+public:
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MapPartition);
+
+	MapPartition(const MAP& map) :
+		map_(map),
+		edge_cut_(0u)
+	{
+		build_graph();
+	}
+
+	/**
+	 * @brief compute a partition in nb_partitions regions by multilevel graph partitioning
+	 * @param nb_partitions
+	 * @param imbalance the maximal relative excess of cells in a region 
+	 */
+	void compute(uint32 nb_partitions, float64 imbalance = 0.03)
+	{
+		cgogn_message_assert(nb_partitions > 0u, "MapPartition: at least one partition is needed");
+		multilevel_partition(nb_partitions, imbalance);
+		build_partitions(nb_partitions);
+	}
+
+	/**
+	 * @brief compute a partition in nb_partitions regions along a space-filling curve
+	 * @param nb_partitions
+	 * @param position the positions of the vertices (the cells are ordered by centroid)
+	 */
+	template <typename VEC3>
+	void compute(uint32 nb_partitions, const VertexAttribute<VEC3>& position)
+	{
+		cgogn_message_assert(nb_partitions > 0u, "MapPartition: at least one partition is needed");
+		space_filling_curve_partition(nb_partitions, position);
+		build_partitions(nb_partitions);
+	}
+
+	inline uint32 nb_partitions() const
+	{
+		return uint32(partition_cells_.size());
+	}
+
+	inline uint32 nb_cells() const
+	{
+		return uint32(cells_.size());
+	}
+
+	// the cells of the region p
+	inline const std::vector<CellType>& cells(uint32 p) const
+	{
+		return partition_cells_[p];
+	}
+
+	// the cells of the region p that are adjacent to a cell of another region
+	inline const std::vector<CellType>& boundary_cells(uint32 p) const
+	{
+		return boundary_cells_[p];
+	}
+
+	// the region of a cell
+	inline uint32 partition(CellType c) const
+	{
+		return partition_[dart_cell_[c.dart.index]];
+	}
+
+	// the number of pairs of adjacent cells that belong to different regions
+	inline uint32 edge_cut() const
+	{
+		return edge_cut_;
+	}
+
+	/**
+	 * @brief store the region of each cell in an attribute
+	 */
+	void label(CellAttribute<uint32>& attribute) const
+	{
+		parallel_foreach_range(nb_cells(), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				attribute[cells_[i]] = partition_[i];
+		});
+	}
+
+	/**
+	 * @brief apply f(p, cells(p)) on each region with the thread pool, one task per region
+	 */
+	template <typename FUNC>
+	void parallel_foreach_partition(const FUNC& f) const
+	{
+		const uint32 nb = nb_partitions();
+		parallel_foreach_range(nb, nb, [&] (uint32 p, uint32, uint32)
+		{
+			f(p, partition_cells_[p]);
+		});
+	}
+
+	/**
+	 * @brief apply f(c, p) on each cell c of each region p, a region being processed by a single task
+	 */
+	template <typename FUNC>
+	void parallel_foreach_cell(const FUNC& f) const
+	{
+		parallel_foreach_partition([&] (uint32 p, const std::vector<CellType>& cells)
+		{
+			for (CellType c : cells)
+				f(c, p);
+		});
+	}
+
+private:
+
+	template <typename FUNC, typename C = CellType,
+			  typename std::enable_if<std::is_same<C, typename MAP::Vertex>::value>::type* = nullptr>
+	inline void foreach_adjacent_cell(C c, const FUNC& f) const
+	{
+		map_.foreach_adjacent_vertex_through_edge(c, f);
+	}
+
+	template <typename FUNC, typename C = CellType,
+			  typename std::enable_if<!std::is_same<C, typename MAP::Vertex>::value && MAP::DIMENSION == 2u>::type* = nullptr>
+	inline void foreach_adjacent_cell(C c, const FUNC& f) const
+	{
+		map_.foreach_adjacent_face_through_edge(c, f);
+	}
+
+	template <typename FUNC, typename C = CellType,
+			  typename std::enable_if<!std::is_same<C, typename MAP::Vertex>::value && MAP::DIMENSION == 3u>::type* = nullptr>
+	inline void foreach_adjacent_cell(C c, const FUNC& f) const
+	{
+		map_.foreach_adjacent_volume_through_face(c, f);
+	}
+
+	template <typename VEC3, typename C = CellType,
+			  typename std::enable_if<std::is_same<C, typename MAP::Vertex>::value>::type* = nullptr>
+	inline VEC3 cell_position(C c, const VertexAttribute<VEC3>& position) const
+	{
+		return position[c];
+	}
+
+	template <typename VEC3, typename C = CellType,
+			  typename std::enable_if<!std::is_same<C, typename MAP::Vertex>::value>::type* = nullptr>
+	inline VEC3 cell_position(C c, const VertexAttribute<VEC3>& position) const
+	{
+		return geometry::centroid<VEC3>(map_, c, position);
+	}
+
+	void build_graph()
+	{
+		map_.foreach_cell([&] (CellType c) { cells_.push_back(c); });
+		const uint32 nb = nb_cells();
+
+		dart_cell_.assign(map_.topology_container().end(), INVALID_INDEX);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				map_.foreach_dart_of_orbit(cells_[i], [&] (Dart d) { dart_cell_[d.index] = i; });
+		});
+
+		Graph& g = graph_;
+		parallel_compute_offsets(nb, [&] (uint32 i)
+		{
+			uint32 degree = 0u;
+			foreach_adjacent_cell(cells_[i], [&] (CellType) { ++degree; });
+			return degree;
+		},
+		g.offsets_);
+
+		g.adjacency_.resize(g.offsets_[nb]);
+		g.edge_weights_.assign(g.offsets_[nb], 1u);
+		g.node_weights_.assign(nb, 1u);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				uint32 k = g.offsets_[i];
+				foreach_adjacent_cell(cells_[i], [&] (CellType c) { g.adjacency_[k++] = dart_cell_[c.dart.index]; });
+			}
+		});
+	}
+
+	/**
+	 * Heavy edge matching: each node is matched with its unmatched neighbor of heaviest edge (if any).
+	 * @param fine the graph to coarsen
+	 * @param coarse the coarsened graph
+	 * @param fine_to_coarse the node of the coarse graph of each node of the fine graph
+	 */
+	void coarsen(const Graph& fine, Graph& coarse, std::vector<uint32>& fine_to_coarse) const
+	{
+		const uint32 nb = fine.nb_nodes();
+		fine_to_coarse.assign(nb, INVALID_INDEX);
+		std::vector<uint32> coarse_to_fine;	// 2 fine nodes per coarse node (INVALID_INDEX if unmatched)
+		coarse_to_fine.reserve(nb);
+
+		for (uint32 u = 0u; u < nb; ++u)
+		{
+			if (fine_to_coarse[u] != INVALID_INDEX)
+				continue;
+			uint32 best = INVALID_INDEX;
+			uint32 best_weight = 0u;
+			for (uint32 k = fine.offsets_[u]; k < fine.offsets_[u + 1u]; ++k)
+			{
+				const uint32 v = fine.adjacency_[k];
+				if (v != u && fine_to_coarse[v] == INVALID_INDEX && fine.edge_weights_[k] > best_weight)
+				{
+					best = v;
+					best_weight = fine.edge_weights_[k];
+				}
+			}
+			const uint32 c = uint32(coarse_to_fine.size() / 2u);
+			fine_to_coarse[u] = c;
+			coarse_to_fine.push_back(u);
+			coarse_to_fine.push_back(best);
+			if (best != INVALID_INDEX)
+				fine_to_coarse[best] = c;
+		}
+
+		const uint32 nb_coarse = uint32(coarse_to_fine.size() / 2u);
+		coarse.offsets_.assign(nb_coarse + 1u, 0u);
+		coarse.adjacency_.clear();
+		coarse.edge_weights_.clear();
+		coarse.node_weights_.assign(nb_coarse, 0u);
+
+		// the edges toward a same coarse node are merged (position of the last edge toward each coarse node)
+		std::vector<uint32> position(nb_coarse, INVALID_INDEX);
+		for (uint32 c = 0u; c < nb_coarse; ++c)
+		{
+			const uint32 first = uint32(coarse.adjacency_.size());
+			for (uint32 j = 0u; j < 2u; ++j)
+			{
+				const uint32 u = coarse_to_fine[2u * c + j];
+				if (u == INVALID_INDEX)
+					continue;
+				coarse.node_weights_[c] += fine.node_weights_[u];
+				for (uint32 k = fine.offsets_[u]; k < fine.offsets_[u + 1u]; ++k)
+				{
+					const uint32 d = fine_to_coarse[fine.adjacency_[k]];
+					if (d == c)
+						continue;
+					if (position[d] != INVALID_INDEX && position[d] >= first)
+						coarse.edge_weights_[position[d]] += fine.edge_weights_[k];
+					else
+					{
+						position[d] = uint32(coarse.adjacency_.size());
+						coarse.adjacency_.push_back(d);
+						coarse.edge_weights_.push_back(fine.edge_weights_[k]);
+					}
+				}
+			}
+			coarse.offsets_[c + 1u] = uint32(coarse.adjacency_.size());
+		}
+	}
+
+	/**
+	 * Greedy region growing: the regions are grown one after the other (breadth first)
+	 * from the first unassigned node until they reach the target weight.
+	 */
+	void initial_partition(const Graph& g, uint32 nb_partitions, std::vector<uint32>& part) const
+	{
+		const uint32 nb = g.nb_nodes();
+		const uint64 total = std::accumulate(g.node_weights_.begin(), g.node_weights_.end(), uint64(0));
+		part.assign(nb, INVALID_INDEX);
+
+		std::vector<uint32> queue;
+		queue.reserve(nb);
+		uint32 next_seed = 0u;
+		uint64 assigned = 0u;
+		for (uint32 p = 0u; p + 1u < nb_partitions; ++p)
+		{
+			// the target is computed from the remaining weight to spread the rounding errors
+			const uint64 target = (total - assigned) / (nb_partitions - p);
+			uint64 weight = 0u;
+			queue.clear();
+			std::size_t head = 0u;
+			while (weight < target)
+			{
+				if (head == queue.size())
+				{
+					while (next_seed < nb && part[next_seed] != INVALID_INDEX)
+						++next_seed;
+					if (next_seed == nb)
+						break;
+					part[next_seed] = p;
+					queue.push_back(next_seed);
+					weight += g.node_weights_[next_seed];
+				}
+				const uint32 u = queue[head++];
+				for (uint32 k = g.offsets_[u]; k < g.offsets_[u + 1u] && weight < target; ++k)
+				{
+					const uint32 v = g.adjacency_[k];
+					if (part[v] == INVALID_INDEX)
+					{
+						part[v] = p;
+						queue.push_back(v);
+						weight += g.node_weights_[v];
+					}
+				}
+			}
+			assigned += weight;
+		}
+		for (uint32& p : part)
+		{
+			if (p == INVALID_INDEX)
+				p = nb_partitions - 1u;
+		}
+	}
+
+	/**
+	 * Move the boundary nodes to the adjacent region that reduces the most the weight of the cut edges,
+	 * while the regions remain under the maximal weight; the nodes of the regions that are over the maximal
+	 * weight are moved to the adjacent region of least weight whatever the gain.
+	 */
+	void refine(const Graph& g, uint32 nb_partitions, uint64 max_weight, std::vector<uint32>& part) const
+	{
+		const uint32 nb = g.nb_nodes();
+		std::vector<uint64> weight(nb_partitions, 0u);
+		for (uint32 u = 0u; u < nb; ++u)
+			weight[part[u]] += g.node_weights_[u];
+
+		std::vector<uint32> adjacent_parts;
+		std::vector<uint32> connection(nb_partitions, 0u);
+		for (uint32 pass = 0u; pass < 4u; ++pass)
+		{
+			uint32 nb_moves = 0u;
+			for (uint32 u = 0u; u < nb; ++u)
+			{
+				const uint32 p = part[u];
+				adjacent_parts.clear();
+				for (uint32 k = g.offsets_[u]; k < g.offsets_[u + 1u]; ++k)
+				{
+					const uint32 q = part[g.adjacency_[k]];
+					if (connection[q] == 0u)
+						adjacent_parts.push_back(q);
+					connection[q] += g.edge_weights_[k];
+				}
+
+				const uint32 w = g.node_weights_[u];
+				const bool overweight = weight[p] > max_weight;
+				uint32 best = p;
+				int64 best_gain = 0;
+				for (uint32 q : adjacent_parts)
+				{
+					if (q == p || weight[q] + w > max_weight)
+						continue;
+					const int64 gain = int64(connection[q]) - int64(connection[p]);
+					if (gain > best_gain || (overweight && (best == p || weight[q] < weight[best])))
+					{
+						best = q;
+						best_gain = gain;
+					}
+				}
+				for (uint32 q : adjacent_parts)
+					connection[q] = 0u;
+
+				if (best != p)
+				{
+					part[u] = best;
+					weight[p] -= w;
+					weight[best] += w;
+					++nb_moves;
+				}
+			}
+			if (nb_moves == 0u)
+				break;
+		}
+	}
+
+	void multilevel_partition(uint32 nb_partitions, float64 imbalance)
+	{
+		// coarsening
+		std::vector<Graph> graphs;
+		std::vector<std::vector<uint32>> fine_to_coarse;
+		const uint32 min_nb_nodes = std::max(64u, 16u * nb_partitions);
+		const Graph* g = &graph_;
+		while (g->nb_nodes() > min_nb_nodes)
+		{
+			Graph coarse;
+			std::vector<uint32> projection;
+			coarsen(*g, coarse, projection);
+			if (coarse.nb_nodes() > g->nb_nodes() - g->nb_nodes() / 10u)
+				break;
+			graphs.push_back(std::move(coarse));
+			fine_to_coarse.push_back(std::move(projection));
+			g = &graphs.back();
+		}
+
+		const uint64 total = nb_cells();
+		const uint64 max_weight = uint64(std::ceil(float64(total) / nb_partitions * (1.0 + imbalance)));
+
+		// initial partition of the coarsest graph, then projection and refinement
+		std::vector<uint32> part;
+		initial_partition(*g, nb_partitions, part);
+		refine(*g, nb_partitions, max_weight, part);
+		for (uint32 level = uint32(graphs.size()); level > 0u; --level)
+		{
+			const std::vector<uint32>& projection = fine_to_coarse[level - 1u];
+			std::vector<uint32> fine_part(projection.size());
+			for (uint32 u = 0u; u < uint32(projection.size()); ++u)
+				fine_part[u] = part[projection[u]];
+			part.swap(fine_part);
+			refine(level > 1u ? graphs[level - 2u] : graph_, nb_partitions, max_weight, part);
+		}
+		partition_.swap(part);
+	}
+
+	template <typename VEC3>
+	void space_filling_curve_partition(uint32 nb_partitions, const VertexAttribute<VEC3>& position)
+	{
+		const uint32 nb = nb_cells();
+
+		std::vector<VEC3> centroids(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				centroids[i] = cell_position(cells_[i], position);
+		});
+
+		const std::vector<uint64> codes = morton_codes(centroids);
+
+		std::vector<uint32> order(nb);
+		std::iota(order.begin(), order.end(), 0u);
+		parallel_sort(order, [&] (uint32 a, uint32 b)
+		{
+			return codes[a] < codes[b] || (codes[a] == codes[b] && a < b);
+		});
+
+		partition_.resize(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			partition_[order[i]] = uint32(uint64(i) * nb_partitions / nb);
+	}
+
+	void build_partitions(uint32 nb_partitions)
+	{
+		const Graph& g = graph_;
+		const uint32 nb = nb_cells();
+
+		partition_cells_.assign(nb_partitions, std::vector<CellType>());
+		boundary_cells_.assign(nb_partitions, std::vector<CellType>());
+		edge_cut_ = 0u;
+		for (uint32 i = 0u; i < nb; ++i)
+		{
+			const uint32 p = partition_[i];
+			partition_cells_[p].push_back(cells_[i]);
+			bool boundary = false;
+			for (uint32 k = g.offsets_[i]; k < g.offsets_[i + 1u]; ++k)
+			{
+				const uint32 j = g.adjacency_[k];
+				if (partition_[j] != p)
+				{
+					boundary = true;
+					if (j > i)
+						++edge_cut_;
+				}
+			}
+			if (boundary)
+				boundary_cells_[p].push_back(cells_[i]);
+		}
+	}
+
+	const MAP& map_;
+
+	std::vector<CellType> cells_;
+	std::vector<uint32> dart_cell_;		// the index of the cell of each dart
+	Graph graph_;
+	std::vector<uint32> partition_;		// the region of each cell
+	std::vector<std::vector<CellType>> partition_cells_;
+	std::vector<std::vector<CellType>> boundary_cells_;
+	uint32 edge_cut_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_MAP_PARTITION_CPP_))
+extern template class CGOGN_TOPLOGY_API MapPartition<CMap2<DefaultMapTraits>, CMap2<DefaultMapTraits>::Vertex>;
+extern template class CGOGN_TOPLOGY_API MapPartition<CMap2<DefaultMapTraits>, CMap2<DefaultMapTraits>::Face>;
+extern template class CGOGN_TOPLOGY_API MapPartition<CMap3<DefaultMapTraits>, CMap3<DefaultMapTraits>::Vertex>;
+extern template class CGOGN_TOPLOGY_API MapPartition<CMap3<DefaultMapTraits>, CMap3<DefaultMapTraits>::Volume>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_MAP_PARTITION_CPP_))
+
+} // namespace topology
+
+} // namespace cgogn
+
+#endif // CGOGN_TOPOLOGY_MAP_PARTITION_H_
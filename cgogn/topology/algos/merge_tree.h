@@ -0,0 +1,444 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_TOPOLOGY_MERGE_TREE_H_
+#define CGOGN_TOPOLOGY_MERGE_TREE_H_
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/topology/types/adjacency_cache.h>
+
+namespace cgogn
+{
+
+namespace topology
+{
+
+enum MergeTreeType : uint32
+{
+	JOIN_TREE = 0,	// components of the superlevel sets: the leaves are the maxima
+	SPLIT_TREE		// components of the sublevel sets: the leaves are the minima
+};
+
+/**
+ * class MergeTree : join tree or split tree of a scalar field defined on the vertices of a map.
+ * The vertices are sorted by scalar value (in parallel), equal values being ordered by embedding
+ * (simulation of simplicity). They are then swept from the maxima (join tree) or from the minima
+ * (split tree) and the connected components of the swept vertices are maintained in a union-find
+ * on the arrays of the adjacency cache: O(n log n) for the sort, almost linear for the sweep.
+ * - a vertex without swept neighbor is a leaf (an extremum) that creates a component,
+ * - a vertex adjacent to several components is a saddle where the components merge.
+ * When components merge, the elder one (whose extremum has been swept first) survives
+ * and the others are paired with the saddle (elder rule): these persistence pairs define
+ * the persistence diagram of the field.
+ * The extrema whose persistence is lower than a threshold are cancelled:
+ * their branch is merged in the branch that kills them and the saddles where only cancelled
+ * branches join become regular. The tree can be simplified again with another threshold
+ * without sorting the vertices again.
+ * The nodes of the tree are given by embeddings of vertices, that are also used to index the arrays.
+ */
+template <typename Scalar, typename MAP>
+class MergeTree
+{
+	using Vertex = typename MAP::Vertex;
+
+	template<typename T>
+	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+
+public:
+
+	// an arc of the tree: from its upper node (an extremum or a saddle) to its lower node
+	// (INVALID_INDEX for the root arc of a connected component); "upper" is given in the sweep order
+	struct Arc
+	{
+		uint32 upper_;
+		uint32 lower_;
+	};
+
+	// an extremum, the saddle where its branch merges in the branch of an elder extremum (the killer)
+	// and the absolute difference of their values
+	struct PersistencePair
+	{
+		uint32 extremum_;
+		uint32 saddle_;
+		uint32 killer_;
+		Scalar persistence_;
+	};
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MergeTree);
+
+	MergeTree(MAP& map,
+			  const AdjacencyCache<MAP>& cache,
+			  const VertexAttribute<Scalar>& scalar_field,
+			  MergeTreeType type) :
+		map_(map),
+		cache_(cache),
+		scalar_field_(scalar_field),
+		type_(type)
+	{}
+
+	/**
+	 * @brief sort the vertices and build the tree
+	 * @param persistence_threshold the extrema whose persistence is lower are cancelled
+	 */
+	void compute(Scalar persistence_threshold = Scalar(0))
+	{
+		sort_vertices();
+		simplify(persistence_threshold);
+	}
+
+	/**
+	 * @brief rebuild the tree with another persistence threshold (the vertices are not sorted again)
+	 */
+	void simplify(Scalar persistence_threshold)
+	{
+		cgogn_message_assert(!order_.empty() || map_.template nb_cells<Vertex::ORBIT>() == 0u,
+							 "MergeTree::simplify: call compute() first");
+		sweep(persistence_threshold);
+	}
+
+	inline MergeTreeType type() const
+	{
+		return type_;
+	}
+
+	// the embeddings of the vertices in the sweep order
+	inline const std::vector<uint32>& order() const
+	{
+		return order_;
+	}
+
+	// the position of the vertex of embedding v_emb in the sweep order
+	inline uint32 rank(uint32 v_emb) const
+	{
+		return rank_[v_emb];
+	}
+
+	// the extrema that are not cancelled, in the sweep order
+	inline const std::vector<uint32>& extrema() const
+	{
+		return extrema_;
+	}
+
+	// the saddles that are nodes of the simplified tree, in the sweep order
+	inline const std::vector<uint32>& saddles() const
+	{
+		return saddles_;
+	}
+
+	// all the persistence pairs (whatever the threshold), in the sweep order of their saddles
+	inline const std::vector<PersistencePair>& persistence_pairs() const
+	{
+		return pairs_;
+	}
+
+	inline uint32 nb_arcs() const
+	{
+		return uint32(arcs_.size());
+	}
+
+	inline const Arc& arc(uint32 a) const
+	{
+		return arcs_[a];
+	}
+
+	// the arc of the simplified tree that contains the vertex of embedding v_emb
+	inline uint32 vertex_arc(uint32 v_emb) const
+	{
+		return vertex_arc_[v_emb];
+	}
+
+	/**
+	 * @brief the extremum of the branch that contains the vertex of embedding v_emb in the simplified tree
+	 * (the branch of a vertex is the branch of the elder extremum of its component when it is swept)
+	 */
+	inline uint32 vertex_extremum(uint32 v_emb) const
+	{
+		return representative_[branch_[v_emb]];
+	}
+
+	/**
+	 * @brief the extremum that absorbs the branch of v_emb when the tree is simplified
+	 * (v_emb itself if it is not a cancelled extremum)
+	 */
+	inline uint32 representative(uint32 v_emb) const
+	{
+		return representative_[v_emb];
+	}
+
+	inline Vertex vertex(uint32 v_emb) const
+	{
+		return Vertex(cache_.vertex_dart(v_emb));
+	}
+
+	inline Scalar value(uint32 v_emb) const
+	{
+		return values_[v_emb];
+	}
+
+private:
+
+	/**
+	 * Sort the embeddings of the vertices in the sweep order:
+	 * increasing (value, embedding) for a split tree, decreasing for a join tree
+	 */
+	void sort_vertices()
+	{
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		const uint32 nb_rows = container.end();
+
+		values_.resize(nb_rows);
+		parallel_foreach_range(nb_rows, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (container.used(i))
+					values_[i] = scalar_field_[i];
+			}
+		});
+
+		order_.clear();
+		order_.reserve(map_.template nb_cells<Vertex::ORBIT>());
+		for (uint32 i = container.begin(); i != container.end(); container.next(i))
+			order_.push_back(i);
+
+		if (type_ == SPLIT_TREE)
+			parallel_sort(order_, [&] (uint32 a, uint32 b)
+			{
+				return values_[a] < values_[b] || (values_[a] == values_[b] && a < b);
+			});
+		else
+			parallel_sort(order_, [&] (uint32 a, uint32 b)
+			{
+				return values_[b] < values_[a] || (values_[a] == values_[b] && b < a);
+			});
+
+		const uint32 nb = uint32(order_.size());
+		rank_.assign(nb_rows, INVALID_INDEX);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				rank_[order_[i]] = i;
+		});
+	}
+
+	// union-find on the embeddings of the swept vertices (with path halving)
+	inline uint32 find(uint32 v_emb)
+	{
+		while (component_[v_emb] != v_emb)
+		{
+			component_[v_emb] = component_[component_[v_emb]];
+			v_emb = component_[v_emb];
+		}
+		return v_emb;
+	}
+
+	// union-find on the arcs (the arcs of the cancelled branches are merged in the arcs of their killers)
+	inline uint32 find_arc(uint32 a)
+	{
+		while (arc_parent_[a] != a)
+		{
+			arc_parent_[a] = arc_parent_[arc_parent_[a]];
+			a = arc_parent_[a];
+		}
+		return a;
+	}
+
+	inline uint32 new_arc(uint32 upper)
+	{
+		const uint32 a = uint32(arcs_.size());
+		arcs_.push_back(Arc{upper, INVALID_INDEX});
+		arc_parent_.push_back(a);
+		return a;
+	}
+
+	void sweep(Scalar persistence_threshold)
+	{
+		const uint32 nb_rows = uint32(rank_.size());
+		const uint32 nb = uint32(order_.size());
+
+		component_.assign(nb_rows, INVALID_INDEX);
+		component_extremum_.assign(nb_rows, INVALID_INDEX);
+		component_arc_.assign(nb_rows, INVALID_INDEX);
+		vertex_arc_.assign(nb_rows, INVALID_INDEX);
+		branch_.assign(nb_rows, INVALID_INDEX);
+		representative_.resize(nb_rows);
+		std::iota(representative_.begin(), representative_.end(), 0u);
+		arcs_.clear();
+		arc_parent_.clear();
+		pairs_.clear();
+		extrema_.clear();
+		saddles_.clear();
+
+		std::vector<uint32> leaves;
+		std::vector<uint32> roots;
+
+		for (uint32 i = 0u; i < nb; ++i)
+		{
+			const uint32 v = order_[i];
+
+			// the components of the swept neighbors of v
+			roots.clear();
+			cache_.foreach_adjacency(v, [&] (uint32, uint32 u)
+			{
+				if (rank_[u] < i)
+				{
+					const uint32 r = find(u);
+					if (std::find(roots.begin(), roots.end(), r) == roots.end())
+						roots.push_back(r);
+				}
+			});
+
+			if (roots.empty())
+			{
+				// a leaf
+				component_[v] = v;
+				component_extremum_[v] = v;
+				component_arc_[v] = new_arc(v);
+				vertex_arc_[v] = component_arc_[v];
+				branch_[v] = v;
+				leaves.push_back(v);
+				continue;
+			}
+
+			// the elder component is the one whose extremum has been swept first
+			uint32 elder = roots[0];
+			for (uint32 r : roots)
+			{
+				if (rank_[component_extremum_[r]] < rank_[component_extremum_[elder]])
+					elder = r;
+			}
+
+			bool node = false;
+			for (uint32 r : roots)
+			{
+				if (r == elder)
+					continue;
+				const uint32 extremum = component_extremum_[r];
+				const Scalar persistence = std::abs(values_[extremum] - values_[v]);
+				pairs_.push_back(PersistencePair{extremum, v, component_extremum_[elder], persistence});
+				if (persistence < persistence_threshold)
+					arc_parent_[find_arc(component_arc_[r])] = find_arc(component_arc_[elder]);
+				else
+					node = true;
+			}
+
+			if (node)
+			{
+				// a saddle of the simplified tree: the incoming arcs end at v
+				for (uint32 r : roots)
+				{
+					Arc& a = arcs_[find_arc(component_arc_[r])];
+					if (a.lower_ == INVALID_INDEX)
+						a.lower_ = v;
+				}
+				component_arc_[elder] = new_arc(v);
+				saddles_.push_back(v);
+			}
+
+			for (uint32 r : roots)
+				component_[r] = elder;
+			component_[v] = elder;
+			vertex_arc_[v] = component_arc_[elder];
+			branch_[v] = component_extremum_[elder];
+		}
+
+		// the killer of a cancelled extremum is swept before it and is paired later (or never)
+		for (auto it = pairs_.rbegin(); it != pairs_.rend(); ++it)
+		{
+			if (it->persistence_ < persistence_threshold)
+				representative_[it->extremum_] = representative_[it->killer_];
+		}
+		for (uint32 e : leaves)
+		{
+			if (representative_[e] == e)
+				extrema_.push_back(e);
+		}
+
+		// number the arcs of the simplified tree
+		std::vector<uint32> arc_index(arcs_.size(), INVALID_INDEX);
+		std::vector<Arc> arcs;
+		for (uint32 a = 0u; a < uint32(arcs_.size()); ++a)
+		{
+			if (find_arc(a) == a)
+			{
+				arc_index[a] = uint32(arcs.size());
+				arcs.push_back(arcs_[a]);
+			}
+		}
+		for (uint32 a = 0u; a < uint32(arcs_.size()); ++a)
+			arc_index[a] = arc_index[find_arc(a)];
+		arcs_.swap(arcs);
+
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const uint32 v = order_[i];
+				vertex_arc_[v] = arc_index[vertex_arc_[v]];
+			}
+		});
+	}
+
+private:
+
+	MAP& map_;
+	AdjacencyCache<MAP> cache_;
+	VertexAttribute<Scalar> scalar_field_;
+	MergeTreeType type_;
+
+	// indexed by the embeddings of the vertices
+	std::vector<Scalar> values_;
+	std::vector<uint32> rank_;
+	std::vector<uint32> component_;
+	std::vector<uint32> component_extremum_;
+	std::vector<uint32> component_arc_;
+	std::vector<uint32> vertex_arc_;
+	std::vector<uint32> branch_;
+	std::vector<uint32> representative_;
+
+	std::vector<uint32> order_;
+	std::vector<Arc> arcs_;
+	std::vector<uint32> arc_parent_;
+	std::vector<PersistencePair> pairs_;
+	std::vector<uint32> extrema_;
+	std::vector<uint32> saddles_;
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_MERGE_TREE_CPP_))
+extern template class CGOGN_TOPLOGY_API MergeTree<float32, CMap2<DefaultMapTraits>>;
+extern template class CGOGN_TOPLOGY_API MergeTree<float64, CMap2<DefaultMapTraits>>;
+extern template class CGOGN_TOPLOGY_API MergeTree<float32, CMap3<DefaultMapTraits>>;
+extern template class CGOGN_TOPLOGY_API MergeTree<float64, CMap3<DefaultMapTraits>>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_MERGE_TREE_CPP_))
+
+} // namespace topology
+
+} // namespace cgogn
+
+#endif // CGOGN_TOPOLOGY_MERGE_TREE_H_
@@ -24,8 +24,14 @@
 #ifndef CGOGN_TOPOLOGY_SCALAR_FIELD_H_
 #define CGOGN_TOPOLOGY_SCALAR_FIELD_H_
 
+#include <vector>
+#include <algorithm>
+
+#include <cgogn/core/utils/thread_pool.h>
+
 #include <cgogn/topology/types/adjacency_cache.h>
 #include <cgogn/topology/types/critical_point.h>
+#include <cgogn/topology/algos/merge_tree.h>
 
 namespace cgogn
 {
@@ -65,8 +71,6 @@ class ScalarField
 	using VertexAttribute = typename MAP::template VertexAttribute<T>;
 	using VertexMarkerNoUnmark = typename MAP::template CellMarkerNoUnmark<Vertex::ORBIT>;
 	using VertexMarker = typename MAP::template CellMarker<Vertex::ORBIT>;
-	using FaceMarker = typename MAP::template CellMarker<Face::ORBIT>;
-	using VolumeMarker = typename MAP::template CellMarker<Volume::ORBIT>;
 
 public:
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ScalarField);
@@ -106,6 +110,25 @@ public:
 
 private:
 
+	// a vertex of Link(v): its embedding, a dart, its side (Link+ or Link-) and a visit flag
+	struct LinkVertex
+	{
+		uint32 emb_;
+		Dart dart_;
+		bool sup_;
+		bool visited_;
+	};
+
+	// the buffers used to analyze a vertex (one per range of the parallel analysis):
+	// the vertices of Link(v), their embeddings and a traversal stack
+	// (a vertex adjacent to v through several edges is represented by its first occurrence)
+	struct Link
+	{
+		std::vector<LinkVertex> vertices_;
+		std::vector<uint32> embeddings_;
+		std::vector<Dart> stack_;
+	};
+
 	/**
 	 * @brief Classify the vertex of a 2-manifold by differential analysis of the scalar field.
 	 * @param v the vertex to analyze
@@ -114,7 +137,7 @@ private:
 	 * the scalar field values becomes greater or lower than the value in v.
 	 */
 	template <typename CONCRETE_MAP, typename std::enable_if<CONCRETE_MAP::DIMENSION == 2>::type* = nullptr>
-	CriticalPoint critical_vertex_analysis(Vertex v)
+	CriticalPoint critical_vertex_analysis(Vertex v, Link&)
 	{
 		Dart next = v.dart;
 		Dart prev;
@@ -219,50 +242,65 @@ private:
 		return nb_cc;
 	}
 
+	/**
+	 * @brief index of the (first) vertex of embedding emb in Link(v) (INVALID_INDEX if it is not in Link(v))
+	 * A link has a few vertices: a linear search is used.
+	 */
+	inline uint32 link_index(const Link& link, uint32 emb) const
+	{
+		auto it = std::find(link.embeddings_.begin(), link.embeddings_.end(), emb);
+		if (it == link.embeddings_.end())
+			return INVALID_INDEX;
+		return uint32(it - link.embeddings_.begin());
+	}
+
 	/**
 	 * @brief Count the number of connected components in Link+(v) or Link-(v)
-	 * @param link the set of vertices that belong to the link
-	 * @param link_marker a marker that should be set for the initial set of vertices
+	 * @param link the vertices that belong to the link
+	 * @param v_emb the embedding of the central vertex
+	 * @param sup the side of the link (Link+ or Link-) whose connected components are counted
 	 * @return the number of connected components
-	 * The algorithm traverses the connected components of Link(v) through adjacent edges.
-	 * The traversal are restricted to marked vertices (i.e. to Link+ or Link-).
+	 * The algorithm traverses the connected components of Link(v) through the faces incident to v:
+	 * two vertices u and w of the link are connected when they are the two neighbors of v in a face
+	 * incident to the edge (v,u). The result does not depend on the darts that represent the vertices.
+	 * The traversal are restricted to the vertices of the given side (i.e. to Link+ or Link-).
 	 */
 	template <typename CONCRETE_MAP, typename std::enable_if<CONCRETE_MAP::DIMENSION == 3>::type* = nullptr>
-	uint32 nb_marked_cc_in_link(std::vector<Dart>& link, VertexMarkerNoUnmark& link_marker)
+	uint32 nb_cc_in_link(Link& link, uint32 v_emb, bool sup)
 	{
+		std::vector<LinkVertex>& vertices = link.vertices_;
+		std::vector<Dart>& cc = link.stack_;
+
 		uint32 nb_cc = 0u;
-		while (!link.empty())
+		for (uint32 i = 0u, end = uint32(vertices.size()); i < end; ++i)
 		{
-			// Search a marked vertex in the link
-			// Such vertex belong to a not yet traversed connected component
-			Dart d;
-			do {
-				d = link.back();
-				link.pop_back();
-			} while (!link_marker.is_marked(Vertex(d)) && !link.empty());
-
-			// If a marked vertex has been found, its connected component is counted and unmarked
-			if (link_marker.is_marked(Vertex(d)))
+			// A not yet visited vertex of the side belongs to a not yet traversed connected component
+			const uint32 k = link_index(link, vertices[i].emb_);
+			if (vertices[k].visited_ || vertices[k].sup_ != sup)
+				continue;
+
+			++nb_cc;
+			// Traverse the connected component of k (vertices of the side connected to k)
+			vertices[k].visited_ = true;
+			cc.clear();
+			cc.push_back(vertices[k].dart_);
+			while (!cc.empty())
 			{
-				++nb_cc;
-				// Traverse the connected component of d (marked vertices connected to d)
-				std::vector<Dart> cc;
-				cc.push_back(d);
-				while (!cc.empty())
-				{
-					Dart e = cc.back();
-					link_marker.unmark(Vertex(e));
-					cc.pop_back();
+				const Dart e = cc.back();
+				cc.pop_back();
 
-					map_.foreach_incident_face(Edge(e), [&](Face f)
+				map_.foreach_incident_face(Edge(e), [&](Face f)
+				{
+					// f.dart belongs to the edge (v,u): the other neighbor of v in the face
+					// is the origin of phi_1(f.dart) or of phi1(phi1(f.dart))
+					const Dart d = map_.embedding(Vertex(f.dart)) == v_emb ? map_.phi_1(f.dart) : map_.phi1(map_.phi1(f.dart));
+					const uint32 w = link_index(link, map_.embedding(Vertex(d)));
+					if (w != INVALID_INDEX && !vertices[w].visited_ && vertices[w].sup_ == sup)
 					{
-						// The vertex of dart adj is adjacent to the vertex of e through an edge and
-						// the dart phi2(adj) belongs to the central vertex C
-						Dart adj = map_.phi2(map_.phi_1(map_.phi_1(f.dart)));
-						if (link_marker.is_marked(Vertex(adj)))
-							cc.push_back(adj);
-					});
-				}
+						vertices[w].visited_ = true;
+						cc.push_back(vertices[w].dart_);
+					}
+				});
 			}
 		}
 		return nb_cc;
@@ -271,40 +309,33 @@ private:
 	/**
 	 * @brief Classify the vertex of a 3-manifold by differential analysis of the scalar field.
 	 * @param v the vertex to analyze
+	 * @param link the buffers used to store Link(v)
 	 * @return the vertex classification
 	 * The algorithm traverse Link(v) and build Link+(v) and Link-(v) :
-	 * Both sets are stored in vectors of Dart and theirs vertices marked.
-	 * Then the vectors and markers are used to count the numbers of connected components.
+	 * both sets are stored in a small array (instead of map markers)
+	 * that is then used to count the numbers of connected components.
 	 */
 	template <typename CONCRETE_MAP, typename std::enable_if<CONCRETE_MAP::DIMENSION == 3>::type* = nullptr>
-	CriticalPoint critical_vertex_analysis(Vertex v)
+	CriticalPoint critical_vertex_analysis(Vertex v, Link& link)
 	{
-		VertexMarkerNoUnmark sup_link_marker(map_);
-		VertexMarkerNoUnmark inf_link_marker(map_);
+		std::vector<LinkVertex>& vertices = link.vertices_;
+		vertices.clear();
+		link.embeddings_.clear();
 
-		std::vector<Dart> sup_link;
-		std::vector<Dart> inf_link;
-
-		// Mark and store the vertices that belong to the Link+(v) and Link-(v)
+		// Store the vertices that belong to the Link+(v) and Link-(v)
 		Scalar center_value = scalar_field_[v];
 		cache_.foreach_adjacent_vertex_through_edge(v, [&](Vertex u)
 		{
 			Scalar value = scalar_field_[u];
-			if (value < center_value)
-			{
-				inf_link_marker.mark(u);
-				inf_link.push_back(u.dart);
-			}
-			else
-			{
-				sup_link_marker.mark(u);
-				sup_link.push_back(u.dart);
-			}
+			const uint32 emb = map_.embedding(u);
+			link.embeddings_.push_back(emb);
+			vertices.push_back(LinkVertex{emb, u.dart, !(value < center_value), false});
 		});
 
 		// Count the number of connected components in the inf and sup links
-		uint32 nb_inf = nb_marked_cc_in_link<CONCRETE_MAP>(inf_link, inf_link_marker);
-		uint32 nb_sup = nb_marked_cc_in_link<CONCRETE_MAP>(sup_link, sup_link_marker);
+		const uint32 v_emb = map_.embedding(v);
+		uint32 nb_inf = nb_cc_in_link<CONCRETE_MAP>(link, v_emb, false);
+		uint32 nb_sup = nb_cc_in_link<CONCRETE_MAP>(link, v_emb, true);
 
 		// All vertices of the Link are in Link-(v)
 		if (nb_inf == 1 && nb_sup == 0)
@@ -335,6 +366,9 @@ public:
 
 	/**
 	 * @brief Find and analyze all critical points of the scalar field
+	 * The vertices are analyzed in parallel, on consecutive ranges of the traversal order:
+	 * the critical points found in each range are appended in the order of the ranges,
+	 * so that the sets of critical points are the same as those of a sequential traversal.
 	 */
 	void critical_vertex_analysis()
 	{
@@ -342,196 +376,173 @@ public:
 		minima_.clear();
 		saddles_.clear();
 
-		map_.foreach_cell([&](Vertex v)
+		std::vector<Vertex> vertices;
+		vertices.reserve(map_.template nb_cells<Vertex::ORBIT>());
+		map_.foreach_cell([&](Vertex v) { vertices.push_back(v); });
+
+		const uint32 nb = uint32(vertices.size());
+		const uint32 nb_ranges = nb_parallel_ranges(nb);
+		std::vector<std::vector<Vertex>> maxima(nb_ranges);
+		std::vector<std::vector<Vertex>> minima(nb_ranges);
+		std::vector<std::vector<Vertex>> saddles(nb_ranges);
+
+		parallel_foreach_range(nb, nb_ranges, [&] (uint32 r, uint32 begin, uint32 end)
 		{
-			CriticalPoint type = critical_vertex_analysis<MAP>(v);
-			vertex_type_[v] = type.v_;
-			if (type.v_ == CriticalPoint::Type::MAXIMUM)
-				maxima_.push_back(v);
-			if (type.v_ == CriticalPoint::Type::MINIMUM)
-				minima_.push_back(v);
-			else if (type.v_ == CriticalPoint::Type::SADDLE  ||
-					 type.v_ == CriticalPoint::Type::SADDLE1 ||
-					 type.v_ == CriticalPoint::Type::SADDLE2)
-				saddles_.push_back(v);
+			Link link;
+			for (uint32 i = begin; i < end; ++i)
+			{
+				Vertex v = vertices[i];
+				CriticalPoint type = critical_vertex_analysis<MAP>(v, link);
+				vertex_type_[v] = type.v_;
+				if (type.v_ == CriticalPoint::Type::MAXIMUM)
+					maxima[r].push_back(v);
+				if (type.v_ == CriticalPoint::Type::MINIMUM)
+					minima[r].push_back(v);
+				else if (type.v_ == CriticalPoint::Type::SADDLE  ||
+						 type.v_ == CriticalPoint::Type::SADDLE1 ||
+						 type.v_ == CriticalPoint::Type::SADDLE2)
+					saddles[r].push_back(v);
+			}
 		});
+
+		for (uint32 r = 0u; r < nb_ranges; ++r)
+		{
+			maxima_.insert(maxima_.end(), maxima[r].begin(), maxima[r].end());
+			minima_.insert(minima_.end(), minima[r].begin(), minima[r].end());
+			saddles_.insert(saddles_.end(), saddles[r].begin(), saddles[r].end());
+		}
 		vertex_type_computed_ = true;
 	}
 
 private:
 
+	/**
+	 * @brief label the vertices of the level sets with the indices of their maxima
+	 * The level set of a maximum is the leaf arc of the maximum in the (simplified) join tree,
+	 * i.e. the component of the superlevel sets that contains the maximum, until it merges with another one.
+	 * @param join_tree the join tree of the scalar field
+	 * @param level_set the index in join_tree.extrema() of the maximum of each vertex
+	 * (INVALID_INDEX for the vertices that are not in a level set), indexed by the embeddings of the vertices
+	 */
+	void level_set_labels(const MergeTree<Scalar, MAP>& join_tree, std::vector<uint32>& level_set) const
+	{
+		const std::vector<uint32>& maxima = join_tree.extrema();
+		std::vector<uint32> arc_level_set(join_tree.nb_arcs(), INVALID_INDEX);
+		for (uint32 k = 0u; k < uint32(maxima.size()); ++k)
+			arc_level_set[join_tree.vertex_arc(maxima[k])] = k;
+
+		const std::vector<uint32>& order = join_tree.order();
+		level_set.assign(cache_.nb_rows(), INVALID_INDEX);
+		parallel_foreach_range(uint32(order.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+				level_set[order[i]] = arc_level_set[join_tree.vertex_arc(order[i])];
+		});
+	}
+
 	/**
 	 * @brief extract_level_sets
 	 * @param level_lines
+	 * @param persistence_threshold
 	 */
 	template <typename CONCRETE_MAP, typename std::enable_if<CONCRETE_MAP::DIMENSION == 2>::type* = nullptr>
-	void extract_level_sets(std::vector<Edge>& level_lines)
+	void extract_level_sets(std::vector<Edge>& level_lines, Scalar persistence_threshold)
 	{
-		cgogn_message_assert(vertex_type_computed_,"Call critical_vertex_analysis() before this function");
-		VertexMarker vertex_marker(map_);
-		FaceMarker face_marker(map_);
-		std::vector<Face> level_set_faces;
-
-		using my_pair = std::pair<Scalar, unsigned int>;
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair> >;
-
-		my_queue level_sets_queue;
-		my_queue vertex_queue;
-
-		// Add all local maxima as level set sources and store the vertex classification
-		for (Vertex v : maxima_)
-			level_sets_queue.push(std::make_pair(scalar_field_[v], v.dart.index));
+		MergeTree<Scalar, MAP> join_tree(map_, cache_, scalar_field_, JOIN_TREE);
+		join_tree.compute(persistence_threshold);
 
-		// Build the level set of the next local maxima
-		while (!level_sets_queue.empty()) {
-			// Initialize a flood front for this level set
-			my_pair p = level_sets_queue.top();
-			level_sets_queue.pop();
-			vertex_queue.push(p);
+		std::vector<uint32> level_set;
+		level_set_labels(join_tree, level_set);
 
-			Scalar saddle_value = Scalar(0);
-
-			// While the flood front is not empty
-			while (!vertex_queue.empty())
+		// The faces incident to the vertices of a level set define its interior and closure:
+		// their edges whose both vertices are outside the level set are its level lines
+		std::vector<std::vector<Edge>> lines(join_tree.extrema().size());
+		std::vector<uint32> labels;
+		map_.foreach_cell([&] (Face f)
+		{
+			labels.clear();
+			map_.foreach_incident_vertex(f, [&] (Vertex v)
 			{
-				Vertex u = Vertex(Dart(vertex_queue.top().second));
-				vertex_queue.pop();
-
-				// We are still in the current level set
-				if (!vertex_marker.is_marked(u) && scalar_field_[u] > saddle_value) {
-					// We reach a saddle (the nearest one)
-					if (vertex_type_[u] == CriticalPoint::Type::SADDLE) {
-						saddle_value = scalar_field_[u];
-					}
-					else {
-						vertex_marker.mark(u);
-						// Extend the front of the level set
-						cache_.foreach_adjacent_vertex_through_edge(u, [&] (Vertex v)
-						{
-							if (!vertex_marker.is_marked(v) && scalar_field_[v] > saddle_value)
-							{
-								vertex_queue.push(std::make_pair(scalar_field_[v], v.dart.index));
-							}
-						});
-						map_.foreach_incident_face(u, [&] (Face f)
-						{
-							if (!face_marker.is_marked(f))
-							{
-								level_set_faces.push_back(f);
-								face_marker.mark(f);
-							}
-						});
-					}
-				}
-			}
-			// The marked vertices and faces define the interior and closure of the level set
-			for (Face f : level_set_faces)
+				const uint32 l = level_set[map_.embedding(v)];
+				if (l != INVALID_INDEX && std::find(labels.begin(), labels.end(), l) == labels.end())
+					labels.push_back(l);
+			});
+			for (uint32 l : labels)
 			{
-				map_.foreach_incident_edge(f, [&](Edge e)
+				map_.foreach_incident_edge(f, [&] (Edge e)
 				{
 					std::pair<Vertex, Vertex> p = map_.vertices(e);
-					if (!vertex_marker.is_marked(p.first) && !vertex_marker.is_marked(p.second))
-						level_lines.push_back(e);
+					if (level_set[map_.embedding(p.first)] != l && level_set[map_.embedding(p.second)] != l)
+						lines[l].push_back(e);
 				});
 			}
-			level_set_faces.clear();
-			vertex_marker.unmark_all();
-			face_marker.unmark_all();
-		}
+		});
+
+		for (const std::vector<Edge>& l : lines)
+			level_lines.insert(level_lines.end(), l.begin(), l.end());
 	}
 
 	/**
 	 * @brief extract_level_sets
 	 * @param level_lines
+	 * @param persistence_threshold
 	 */
 	template <typename CONCRETE_MAP, typename std::enable_if<CONCRETE_MAP::DIMENSION == 3>::type* = nullptr>
-	void extract_level_sets(std::vector<Edge>& level_lines)
+	void extract_level_sets(std::vector<Edge>& level_lines, Scalar persistence_threshold)
 	{
-		cgogn_message_assert(vertex_type_computed_,"Call critical_vertex_analysis() before this function");
-		VertexMarker vertex_marker(map_);
-		VolumeMarker volume_marker(map_);
-		std::vector<Volume> level_set_volumes;
+		MergeTree<Scalar, MAP> join_tree(map_, cache_, scalar_field_, JOIN_TREE);
+		join_tree.compute(persistence_threshold);
 
-		using my_pair = std::pair<Scalar, unsigned int>;
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair> >;
+		std::vector<uint32> level_set;
+		level_set_labels(join_tree, level_set);
 
-		my_queue level_sets_queue;
-		my_queue vertex_queue;
-
-		// Add all local maxima as level set sources and store the vertex classification
-		for (Vertex v : maxima_)
-			level_sets_queue.push(std::make_pair(scalar_field_[v], v.dart.index));
-
-		// Build the level set of the next local maxima
-		while (!level_sets_queue.empty()) {
-			// Initialize a flood front for this level set
-			my_pair p = level_sets_queue.top();
-			level_sets_queue.pop();
-			vertex_queue.push(p);
-
-			Scalar saddle_value = Scalar(0);
-
-			// While the flood front is not empty
-			while (!vertex_queue.empty())
+		// The volumes incident to the vertices of a level set define its interior and closure:
+		// the edges of their faces whose vertices are all outside the level set are its level lines
+		std::vector<std::vector<Edge>> lines(join_tree.extrema().size());
+		std::vector<uint32> labels;
+		map_.foreach_cell([&] (Volume vol)
+		{
+			labels.clear();
+			map_.foreach_incident_vertex(vol, [&] (Vertex v)
 			{
-				Vertex u = Vertex(Dart(vertex_queue.top().second));
-				vertex_queue.pop();
-
-				// We are still in the current level set
-				if (!vertex_marker.is_marked(u) && scalar_field_[u] > saddle_value) {
-					// We reach a saddle (the nearest one)
-					if (vertex_type_[u] == CriticalPoint::Type::SADDLE1 ||
-						vertex_type_[u] == CriticalPoint::Type::SADDLE2) {
-						saddle_value = scalar_field_[u];
-					}
-					else {
-						vertex_marker.mark(u);
-						// Extend the front of the level set
-						cache_.foreach_adjacent_vertex_through_edge(u, [&] (Vertex v)
-						{
-							if (!vertex_marker.is_marked(v) && scalar_field_[v] > saddle_value)
-							{
-								vertex_queue.push(std::make_pair(scalar_field_[v], v.dart.index));
-							}
-						});
-						map_.foreach_incident_volume(u, [&] (Volume vol)
-						{
-							if (!volume_marker.is_marked(vol))
-							{
-								level_set_volumes.push_back(vol);
-								volume_marker.mark(vol);
-							}
-						});
-					}
-				}
-			}
-			// The marked vertices and faces define the interior and closure of the level set
-			for (Volume vol : level_set_volumes)
+				const uint32 l = level_set[map_.embedding(v)];
+				if (l != INVALID_INDEX && std::find(labels.begin(), labels.end(), l) == labels.end())
+					labels.push_back(l);
+			});
+			for (uint32 l : labels)
 			{
-				map_.foreach_incident_face(vol, [&](Face f)
+				map_.foreach_incident_face(vol, [&] (Face f)
 				{
 					bool boundary_face = true;
 					map_.foreach_incident_vertex(f, [&] (Vertex v)
 					{
-						if (vertex_marker.is_marked(v)) boundary_face = false;
+						if (level_set[map_.embedding(v)] == l) boundary_face = false;
 					});
 					if (boundary_face)
 						map_.foreach_incident_edge(f, [&] (Edge e)
 						{
-							level_lines.push_back(e);
+							lines[l].push_back(e);
 						});
 				});
 			}
-			level_set_volumes.clear();
-			vertex_marker.unmark_all();
-			volume_marker.unmark_all();
-		}
+		});
+
+		for (const std::vector<Edge>& l : lines)
+			level_lines.insert(level_lines.end(), l.begin(), l.end());
 	}
 
 public:
-	void extract_level_sets(std::vector<Edge>& level_lines)
+
+	/**
+	 * @brief extract the level lines that bound the level sets of the maxima
+	 * (the level sets are given by the join tree of the scalar field, see level_set_labels)
+	 * @param level_lines
+	 * @param persistence_threshold the maxima whose persistence is lower are cancelled:
+	 * their level sets are merged in the level sets that absorb them
+	 */
+	void extract_level_sets(std::vector<Edge>& level_lines, Scalar persistence_threshold = Scalar(0))
 	{
-		extract_level_sets<MAP>(level_lines);
+		extract_level_sets<MAP>(level_lines, persistence_threshold);
 	}
 
 	void extract_ascending_1_manifold(std::vector<Edge>& edges_set)
@@ -730,142 +741,71 @@ public:
 		}
 	}
 
-	void extract_ascending_3_manifold(std::vector<Vertex>& boundary)
-	{
-		cgogn_message_assert(vertex_type_computed_,"Call critical_vertex_analysis() before this function");
-
-		VertexAttribute<uint32> manifold_id = map_.template add_attribute<uint32, Vertex::ORBIT>("manifold_id");
-
-		// Classify the vertices as inner vertex or boundary vertex of the ascending manifolds A3
-		VertexMarker inner_vertex(map_);		// Vertex in Int(A3)
-		VertexMarker boundary_vertex(map_);		// Vertex in Boundary(A3)
-
-		using my_pair = std::pair<Scalar, unsigned int>;
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>, std::greater<my_pair> >;
-
-		// To classify the vertices in ascending order of the scalar field values
-		// i.e. to sweep the ascending 3-manifold from minima to saddles and from saddles to maxima
-		my_queue vertex_queue;
-
-		// Initialize the manifold id to zero (not set)
-		for (uint32& id : manifold_id)
-			id = 0u;
+private:
 
-		// Initialize the manifold id count
-		uint32 manifold_id_count = 1;
+	/**
+	 * @brief sweep the vertices in the order of a merge tree to classify them as inner vertex or boundary vertex
+	 * of the 3-manifolds that grow from the leaves of the tree (ascending manifolds for a split tree,
+	 * descending manifolds for a join tree).
+	 * A vertex is inner if its swept neighbors that are inner vertices belong to a unique 3-manifold.
+	 * A vertex without such neighbor starts a new 3-manifold.
+	 * A 3-manifold that starts at a cancelled extremum is merged in the 3-manifold that absorbs it.
+	 * @param tree the merge tree of the scalar field
+	 * @param boundary the boundary vertices
+	 */
+	void extract_3_manifold(const MergeTree<Scalar, MAP>& tree, std::vector<Vertex>& boundary) const
+	{
+		const std::vector<uint32>& order = tree.order();
 
-		// Put all vertices in the priority queue
-		map_.foreach_cell([&](Vertex v) {
-			vertex_queue.push(std::make_pair(scalar_field_[v], v.dart.index));
-		});
+		// The 3-manifold of the inner vertices (INVALID_INDEX for the boundary vertices)
+		std::vector<uint32> manifold(cache_.nb_rows(), INVALID_INDEX);
+		std::vector<uint32> neighbor_manifolds;
 
-		// While the sweep front is not empty
-		std::cout << "extract_ascending_3_manifold: ";
-		while (!vertex_queue.empty())
+		for (uint32 i = 0u; i < uint32(order.size()); ++i)
 		{
-			Vertex v = Vertex(Dart(vertex_queue.top().second));
-			vertex_queue.pop();
-
-			uint32 min_id = manifold_id_count + 1u;
-			uint32 max_id = 0u;
-
-			// Search the minimal and maximal manifold id present in the intesection Int(A3) /\ link-(v)
-			Scalar center_value = scalar_field_[v];
-			cache_.foreach_adjacent_vertex_through_edge(v, [&](Vertex u)
+			const uint32 v = order[i];
+			neighbor_manifolds.clear();
+			cache_.foreach_adjacency(v, [&] (uint32, uint32 u)
 			{
-				if (scalar_field_[u] < center_value && inner_vertex.is_marked(u))
-				{
-					min_id = std::min(min_id, manifold_id[u]);
-					max_id = std::max(max_id, manifold_id[u]);
-				}
+				const uint32 m = manifold[u];
+				if (tree.rank(u) < i && m != INVALID_INDEX &&
+					std::find(neighbor_manifolds.begin(), neighbor_manifolds.end(), m) == neighbor_manifolds.end())
+					neighbor_manifolds.push_back(m);
 			});
 
-			if (max_id == 0u) {		// isolated vertex => init new 3-manifold
-				std::cout << "+";
-				++manifold_id_count;
-				manifold_id[v] = manifold_id_count;
-				inner_vertex.mark(v);
-			}
-			if (min_id == max_id) { // a unique ascending 3-manifold in the link => inner vertex
-				manifold_id[v] = min_id;
-				inner_vertex.mark(v);
-			}
-			else {					// min_id != max_id => at least two 3-manifold in the link => boundary vertex
-				boundary_vertex.mark(v);
-				boundary.push_back(v);
-			}
-		};
-		std::cout << std::endl;
-		map_.remove_attribute(manifold_id);
+			if (neighbor_manifolds.empty())				// isolated vertex => new 3-manifold
+				manifold[v] = tree.representative(v);
+			else if (neighbor_manifolds.size() == 1u)	// a unique 3-manifold in the link => inner vertex
+				manifold[v] = neighbor_manifolds[0];
+			else										// at least two 3-manifolds in the link => boundary vertex
+				boundary.push_back(tree.vertex(v));
+		}
 	}
 
-	void extract_descending_3_manifold(std::vector<Vertex>& boundary)
-	{
-		cgogn_message_assert(vertex_type_computed_,"Call critical_vertex_analysis() before this function");
-
-		VertexAttribute<uint32> manifold_id = map_.template add_attribute<uint32, Vertex::ORBIT>("manifold_id");
-
-		// Classify the vertices as inner vertex or boundary vertex of the ascending manifolds A3
-		VertexMarker inner_vertex(map_);		// Vertex in Int(A3)
-		VertexMarker boundary_vertex(map_);		// Vertex in Boundary(A3)
-
-		using my_pair = std::pair<Scalar, unsigned int>;
-		using my_queue = std::priority_queue<my_pair, std::vector<my_pair>>;
-
-		// To classify the vertices in ascending order of the scalar field values
-		// i.e. to sweep the ascending 3-manifold from minima to saddles and from saddles to maxima
-		my_queue vertex_queue;
-
-		// Initialize the manifold id to zero (not set)
-		for (uint32& id : manifold_id)
-			id = 0u;
-
-		// Initialize the manifold id count
-		uint32 manifold_id_count = 1;
-
-		// Put all vertices in the priority queue
-		map_.foreach_cell([&](Vertex v) {
-			vertex_queue.push(std::make_pair(scalar_field_[v], v.dart.index));
-		});
-
-		// While the sweep front is not empty
-		std::cout << "extract_descending_3_manifold: ";
-		while (!vertex_queue.empty())
-		{
-			Vertex v = Vertex(Dart(vertex_queue.top().second));
-			vertex_queue.pop();
-
-			uint32 min_id = manifold_id_count + 1u;
-			uint32 max_id = 0u;
+public:
 
-			// Search the minimal and maximal manifold id present in the intesection Int(A3) /\ link+(v)
-			Scalar center_value = scalar_field_[v];
-			cache_.foreach_adjacent_vertex_through_edge(v, [&](Vertex u)
-			{
-				if (scalar_field_[u] > center_value && inner_vertex.is_marked(u))
-				{
-					min_id = std::min(min_id, manifold_id[u]);
-					max_id = std::max(max_id, manifold_id[u]);
-				}
-			});
+	/**
+	 * @brief extract the boundary of the ascending 3-manifolds, that grow from the minima
+	 * @param boundary
+	 * @param persistence_threshold the minima whose persistence (in the split tree) is lower are cancelled
+	 */
+	void extract_ascending_3_manifold(std::vector<Vertex>& boundary, Scalar persistence_threshold = Scalar(0))
+	{
+		MergeTree<Scalar, MAP> split_tree(map_, cache_, scalar_field_, SPLIT_TREE);
+		split_tree.compute(persistence_threshold);
+		extract_3_manifold(split_tree, boundary);
+	}
 
-			if (max_id == 0u) {		// isolated vertex => init new 3-manifold
-				std::cout << "+";
-				++manifold_id_count;
-				manifold_id[v] = manifold_id_count;
-				inner_vertex.mark(v);
-			}
-			if (min_id == max_id) { // a unique ascending 3-manifold in the link => inner vertex
-				manifold_id[v] = min_id;
-				inner_vertex.mark(v);
-			}
-			else {					// min_id != max_id => at least two 3-manifold in the link => boundary vertex
-				boundary_vertex.mark(v);
-				boundary.push_back(v);
-			}
-		};
-		std::cout << std::endl;
-		map_.remove_attribute(manifold_id);
+	/**
+	 * @brief extract the boundary of the descending 3-manifolds, that grow from the maxima
+	 * @param boundary
+	 * @param persistence_threshold the maxima whose persistence (in the join tree) is lower are cancelled
+	 */
+	void extract_descending_3_manifold(std::vector<Vertex>& boundary, Scalar persistence_threshold = Scalar(0))
+	{
+		MergeTree<Scalar, MAP> join_tree(map_, cache_, scalar_field_, JOIN_TREE);
+		join_tree.compute(persistence_threshold);
+		extract_3_manifold(join_tree, boundary);
 	}
 
 private:
@@ -809,7 +809,6 @@ public:
 	{
 		EdgeAttribute<Scalar> length = map_.template add_attribute<Scalar, Edge::ORBIT>("lenght");
 		EdgeAttribute<Scalar> edgeangle = map_.template add_attribute<Scalar, Edge::ORBIT>("edgeangle");
-		EdgeAttribute<Scalar> edgeaera = map_.template add_attribute<Scalar, Edge::ORBIT>("edgeaera");
 
 		VertexAttribute<Scalar> kmax = map_.template add_attribute<Scalar, Vertex::ORBIT>("kmax");
 		VertexAttribute<Scalar> kmin = map_.template add_attribute<Scalar, Vertex::ORBIT>("kmin");
@@ -821,13 +820,12 @@ public:
 		compute_length(length);
 
 		cgogn::geometry::compute_angle_between_face_normals<Vec3, MAP>(map_, vertex_position_, edgeangle);
-		cgogn::geometry::compute_incident_faces_area<Vec3, Edge, MAP>(map_, vertex_position_, edgeaera);
 
 		Scalar meanEdgeLength = cgogn::geometry::mean_edge_length<Vec3>(map_, vertex_position_);
 
 		Scalar radius = Scalar(2.0) * meanEdgeLength;
 
-		cgogn::geometry::compute_curvature<Vec3>(map_,radius, vertex_position_, vertex_normal, edgeangle,edgeaera,kmax,kmin,Kmax,Kmin,knormal);
+		cgogn::geometry::compute_curvature<Vec3>(map_,radius, vertex_position_, vertex_normal, edgeangle,kmax,kmin,Kmax,Kmin,knormal);
 
 		//compute kmean
 		VertexAttribute<Scalar> kmean = map_.template add_attribute<Scalar, Vertex::ORBIT>("kmean");
@@ -898,7 +896,6 @@ public:
 
 		map_.remove_attribute(length);
 		map_.remove_attribute(edgeangle);
-		map_.remove_attribute(edgeaera);
 		map_.remove_attribute(kmax);
 		map_.remove_attribute(kmin);
 		map_.remove_attribute(vertex_normal);
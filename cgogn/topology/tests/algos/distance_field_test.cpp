@@ -0,0 +1,233 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <queue>
+#include <random>
+#include <limits>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <cgogn/topology/algos/distance_field.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+template <typename T>
+using EdgeAttribute = CMap2::EdgeAttribute<T>;
+using DistanceField = cgogn::topology::DistanceField<float64, CMap2>;
+
+class DistanceField_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	EdgeAttribute<float64> weight_;
+	std::vector<Vertex> sources_;
+
+	// random weights spread over two orders of magnitude (light and heavy edges for delta-stepping)
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		weight_ = map2_.add_attribute<float64, Edge::ORBIT>("weight");
+		std::mt19937 generator(42u);
+		std::uniform_real_distribution<float64> exponent(-1.0, 1.0);
+		map2_.foreach_cell([&] (Edge e) { weight_[e] = std::pow(10.0, exponent(generator)); });
+
+		uint32 i = 0u;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (i++ % 2000u == 0u)
+				sources_.push_back(v);
+		});
+	}
+
+	// reference dijkstra on the traversals of the map
+	void reference_distances(VertexAttribute<float64>& distance)
+	{
+		reference_distances(sources_, distance);
+	}
+
+	void reference_distances(const std::vector<Vertex>& sources, VertexAttribute<float64>& distance)
+	{
+		using Entry = std::pair<float64, Vertex>;
+		auto greater = [] (const Entry& a, const Entry& b) { return a.first > b.first; };
+		std::priority_queue<Entry, std::vector<Entry>, decltype(greater)> queue(greater);
+
+		distance.set_all_values(std::numeric_limits<float64>::max());
+		for (Vertex s : sources)
+		{
+			distance[s] = 0.0;
+			queue.push(std::make_pair(0.0, s));
+		}
+		while (!queue.empty())
+		{
+			const Entry top = queue.top();
+			queue.pop();
+			if (top.first > distance[top.second])
+				continue;
+			map2_.foreach_adjacent_vertex_through_edge(top.second, [&] (Vertex u)
+			{
+				const float64 d = top.first + weight_[Edge(u.dart)];
+				if (d < distance[u])
+				{
+					distance[u] = d;
+					queue.push(std::make_pair(d, u));
+				}
+			});
+		}
+	}
+
+	void expect_same_distances(const VertexAttribute<float64>& expected, const VertexAttribute<float64>& distance)
+	{
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			EXPECT_NEAR(distance[v], expected[v], 1e-9 * std::max(1.0, expected[v]));
+		});
+	}
+};
+
+TEST_F(DistanceField_TEST, QueuesSameAsReference)
+{
+	cgogn::topology::AdjacencyCache<CMap2> cache(map2_);
+	cache.init();
+	DistanceField distance_field(map2_, cache, weight_);
+	EXPECT_EQ(distance_field.queue(), cgogn::topology::RADIX_HEAP);
+
+	VertexAttribute<float64> expected = map2_.add_attribute<float64, Vertex::ORBIT>("expected");
+	reference_distances(expected);
+
+	VertexAttribute<float64> distance = map2_.add_attribute<float64, Vertex::ORBIT>("distance");
+	VertexAttribute<Vertex> previous = map2_.add_attribute<Vertex, Vertex::ORBIT>("previous");
+	for (cgogn::topology::ShortestPathQueue queue : { cgogn::topology::BINARY_HEAP, cgogn::topology::FOUR_ARY_HEAP, cgogn::topology::RADIX_HEAP })
+	{
+		distance_field.set_queue(queue);
+		distance_field.dijkstra_compute_paths(sources_, distance, previous);
+		expect_same_distances(expected, distance);
+
+		// the paths are made of edges of the map
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (distance[v] == 0.0)
+				return;
+			bool found = false;
+			map2_.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u)
+			{
+				if (map2_.same_cell(u, previous[v]) && std::abs(distance[u] + weight_[Edge(u.dart)] - distance[v]) <= 1e-9 * distance[v])
+					found = true;
+			});
+			EXPECT_TRUE(found);
+		});
+	}
+}
+
+TEST_F(DistanceField_TEST, DeltaSteppingSameAsReference)
+{
+	cgogn::topology::AdjacencyCache<CMap2> cache(map2_);
+	cache.init();
+	DistanceField distance_field(map2_, cache, weight_);
+
+	VertexAttribute<float64> expected = map2_.add_attribute<float64, Vertex::ORBIT>("expected");
+	reference_distances(expected);
+
+	// the default delta (mean weight), then deltas smaller and larger than all the weights
+	// (1e-30 is enlarged, it would give more buckets than a uint32 can count)
+	VertexAttribute<float64> distance = map2_.add_attribute<float64, Vertex::ORBIT>("distance");
+	for (float64 delta : { 0.0, 0.05, 0.7, 20.0, 1e-30 })
+	{
+		distance_field.delta_stepping_compute_distances(sources_, distance, delta);
+		expect_same_distances(expected, distance);
+	}
+}
+
+TEST_F(DistanceField_TEST, ParallelForeachDistanceFieldSameAsReference)
+{
+	cgogn::topology::AdjacencyCache<CMap2> cache(map2_);
+	cache.init();
+	DistanceField distance_field(map2_, cache, weight_);
+
+	// each source is processed once by one of the tasks
+	const uint32 nb_sources = uint32(sources_.size());
+	const uint32 nb_tasks = DistanceField::nb_distance_field_tasks(nb_sources);
+	std::vector<std::vector<float64>> fields(nb_sources);
+	std::vector<uint32> task(nb_sources, nb_tasks);
+	distance_field.parallel_foreach_distance_field(sources_, [&] (uint32 i, uint32 k, const std::vector<float64>& distance)
+	{
+		task[i] = k;
+		fields[i] = distance;
+	});
+
+	VertexAttribute<float64> expected = map2_.add_attribute<float64, Vertex::ORBIT>("expected");
+	for (uint32 i = 0u; i < nb_sources; ++i)
+	{
+		EXPECT_EQ(i % nb_tasks, task[i]);
+		reference_distances({sources_[i]}, expected);
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			EXPECT_NEAR(fields[i][map2_.embedding(v)], expected[v], 1e-9 * std::max(1.0, expected[v]));
+		});
+	}
+}
+
+TEST_F(DistanceField_TEST, SumOfDistanceToFeaturesSameAsReference)
+{
+	cgogn::topology::AdjacencyCache<CMap2> cache(map2_);
+	cache.init();
+	DistanceField distance_field(map2_, cache, weight_);
+
+	// many more features than threads: each task sums several distance fields in its buffer
+	std::vector<Vertex> features;
+	uint32 i = 0u;
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		if (i++ % 64u == 0u)
+			features.push_back(v);
+	});
+
+	VertexAttribute<float64> distance = map2_.add_attribute<float64, Vertex::ORBIT>("distance");
+	VertexAttribute<float64> expected = map2_.add_attribute<float64, Vertex::ORBIT>("expected");
+	expected.set_all_values(0.0);
+	for (Vertex f : features)
+	{
+		reference_distances({f}, distance);
+		map2_.foreach_cell([&] (Vertex v) { expected[v] += distance[v]; });
+	}
+
+	distance_field.sum_of_distance_to_features(features, distance);
+	map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_NEAR(distance[v], expected[v], 1e-9 * std::max(1.0, expected[v]));
+	});
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+
+#include <limits>
+#include <vector>
+
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <cgogn/topology/algos/features.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+using Vertex = CMap3::Vertex;
+using Edge = CMap3::Edge;
+template <typename T>
+using VertexAttribute = CMap3::VertexAttribute<T>;
+template <typename T>
+using EdgeAttribute = CMap3::EdgeAttribute<T>;
+using AdjacencyCache = cgogn::topology::AdjacencyCache<CMap3>;
+using DistanceField = cgogn::topology::DistanceField<float64, CMap3>;
+using ScalarField = cgogn::topology::ScalarField<float64, CMap3>;
+using FeaturesFinder = cgogn::topology::FeaturesFinder<float64, CMap3>;
+
+class Features_TEST : public testing::Test
+{
+protected:
+
+	CMap3 map3_;
+	EdgeAttribute<float64> length_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_volume<Vec3>(map3_, std::string(DEFAULT_MESH_PATH) + std::string("tet/hand.tet"));
+		VertexAttribute<Vec3> position = map3_.get_attribute<Vec3, Vertex::ORBIT>("position");
+		length_ = map3_.add_attribute<float64, Edge::ORBIT>("length");
+		map3_.foreach_cell([&] (Edge e)
+		{
+			const std::pair<Vertex, Vertex> v = map3_.vertices(e);
+			length_[e] = (position[v.first] - position[v.second]).norm();
+		});
+	}
+};
+
+// central_vertex computes the distance fields of the maxima of the distance to boundary concurrently:
+// the result is compared with one sequential dijkstra per maximum
+TEST_F(Features_TEST, CentralVertexSameAsSequential)
+{
+	AdjacencyCache cache(map3_);
+	cache.init();
+
+	DistanceField distance_field(map3_, cache, length_);
+	VertexAttribute<float64> distance = map3_.add_attribute<float64, Vertex::ORBIT>("distance");
+	distance_field.distance_to_boundary(distance);
+	ScalarField scalar_field(map3_, cache, distance);
+	scalar_field.critical_vertex_analysis();
+	const std::vector<Vertex> maxima = scalar_field.get_maxima();
+	ASSERT_GT(maxima.size(), 1u);
+
+	float64 min = std::numeric_limits<float64>::max();
+	Vertex expected;
+	for (Vertex v : maxima)
+	{
+		distance_field.distance_to_features({v}, distance);
+		const float64 max = distance[distance_field.find_maximum(distance)];
+		if (min > max)
+		{
+			min = max;
+			expected = v;
+		}
+	}
+
+	FeaturesFinder features_finder(map3_, cache, length_);
+	EXPECT_TRUE(map3_.same_cell(expected, features_finder.central_vertex()));
+}
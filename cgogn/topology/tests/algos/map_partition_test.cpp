@@ -0,0 +1,182 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cmath>
+#include <functional>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <cgogn/topology/algos/map_partition.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using CMap3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+
+/**
+ * check a partition against the adjacency given by the map: each cell is in a single region,
+ * partition(c) is the region whose cells(p) contains c, the boundary cells of each region are
+ * its cells that have an adjacent cell in another region, and the edge cut is the number of such pairs.
+ * @param max_size the maximal number of cells of a region
+ * @return the number of pairs of adjacent cells
+ */
+template <typename MAP, typename CellType, typename ADJACENCY>
+uint32 check_partition(const MAP& map, const cgogn::topology::MapPartition<MAP, CellType>& partition, uint32 nb_partitions, uint32 max_size, const ADJACENCY& adjacency)
+{
+	EXPECT_EQ(partition.nb_partitions(), nb_partitions);
+	EXPECT_EQ(partition.nb_cells(), map.template nb_cells<CellType::ORBIT>());
+
+	typename MAP::template CellMarker<CellType::ORBIT> visited(map);
+	uint32 nb_cells = 0u;
+	for (uint32 p = 0u; p < nb_partitions; ++p)
+	{
+		EXPECT_FALSE(partition.cells(p).empty());
+		EXPECT_LE(uint32(partition.cells(p).size()), max_size);
+		for (CellType c : partition.cells(p))
+		{
+			EXPECT_FALSE(visited.is_marked(c));
+			visited.mark(c);
+			EXPECT_EQ(partition.partition(c), p);
+			++nb_cells;
+		}
+	}
+	EXPECT_EQ(nb_cells, partition.nb_cells());
+
+	uint32 nb_pairs = 0u;
+	uint32 nb_cut_pairs = 0u;
+	for (uint32 p = 0u; p < nb_partitions; ++p)
+	{
+		std::vector<cgogn::Dart> boundary;
+		for (CellType c : partition.cells(p))
+		{
+			bool is_boundary = false;
+			adjacency(c, [&] (CellType d)
+			{
+				++nb_pairs;
+				if (partition.partition(d) != p)
+				{
+					++nb_cut_pairs;
+					is_boundary = true;
+				}
+			});
+			if (is_boundary)
+				boundary.push_back(c.dart);
+		}
+		std::vector<cgogn::Dart> boundary_cells;
+		for (CellType c : partition.boundary_cells(p))
+			boundary_cells.push_back(c.dart);
+		EXPECT_EQ(boundary_cells, boundary);
+	}
+	// each pair is seen from both sides
+	EXPECT_EQ(nb_cut_pairs, 2u * partition.edge_cut());
+	EXPECT_GT(partition.edge_cut(), 0u);
+
+	typename MAP::template Attribute<uint32, CellType::ORBIT> label =
+		const_cast<MAP&>(map).template add_attribute<uint32, CellType::ORBIT>("partition");
+	partition.label(label);
+	map.foreach_cell([&] (CellType c) { EXPECT_EQ(label[c], partition.partition(c)); });
+	const_cast<MAP&>(map).remove_attribute(label);
+
+	return nb_pairs / 2u;
+}
+
+/**
+ * check both strategies: the multilevel partition is balanced up to the imbalance, the partition along
+ * the space-filling curve is balanced up to one cell, and both cut few adjacencies (the regions are compact)
+ */
+template <typename MAP, typename CellType, typename ADJACENCY>
+void check_strategies(const MAP& map, const typename MAP::template VertexAttribute<Vec3>& position, const ADJACENCY& adjacency)
+{
+	const uint32 nb_partitions = 8u;
+	const float64 imbalance = 0.03;
+	const uint32 nb_cells = map.template nb_cells<CellType::ORBIT>();
+
+	cgogn::topology::MapPartition<MAP, CellType> partition(map);
+
+	partition.compute(nb_partitions, imbalance);
+	const uint32 max_size = uint32(std::ceil(float64(nb_cells) / nb_partitions * (1.0 + imbalance)));
+	const uint32 nb_pairs = check_partition(map, partition, nb_partitions, max_size, adjacency);
+	const uint32 multilevel_edge_cut = partition.edge_cut();
+	EXPECT_LT(multilevel_edge_cut, nb_pairs / 5u);
+
+	partition.compute(nb_partitions, position);
+	check_partition(map, partition, nb_partitions, (nb_cells + nb_partitions - 1u) / nb_partitions, adjacency);
+	for (uint32 p = 0u; p < nb_partitions; ++p)
+		EXPECT_GE(uint32(partition.cells(p).size()), nb_cells / nb_partitions);
+	EXPECT_LT(partition.edge_cut(), nb_pairs / 5u);
+	// the refinement of the multilevel partition cuts less than the geometric cut
+	EXPECT_LE(multilevel_edge_cut, partition.edge_cut());
+
+	// a single region has no boundary
+	partition.compute(1u);
+	EXPECT_EQ(partition.nb_partitions(), 1u);
+	EXPECT_EQ(uint32(partition.cells(0u).size()), nb_cells);
+	EXPECT_TRUE(partition.boundary_cells(0u).empty());
+	EXPECT_EQ(partition.edge_cut(), 0u);
+}
+
+class MapPartition_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	CMap3 map3_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+		cgogn::io::import_volume<Vec3>(map3_, std::string(DEFAULT_MESH_PATH) + std::string("tet/hand.tet"));
+	}
+};
+
+TEST_F(MapPartition_TEST, CMap2)
+{
+	using Vertex = CMap2::Vertex;
+	using Face = CMap2::Face;
+	const CMap2::VertexAttribute<Vec3> position = map2_.get_attribute<Vec3, Vertex::ORBIT>("position");
+	ASSERT_TRUE(position.is_valid());
+
+	check_strategies<CMap2, Vertex>(map2_, position, [&] (Vertex v, const std::function<void(Vertex)>& f) { map2_.foreach_adjacent_vertex_through_edge(v, f); });
+	check_strategies<CMap2, Face>(map2_, position, [&] (Face f, const std::function<void(Face)>& g) { map2_.foreach_adjacent_face_through_edge(f, g); });
+}
+
+TEST_F(MapPartition_TEST, CMap3)
+{
+	using Vertex = CMap3::Vertex;
+	using Volume = CMap3::Volume;
+	const CMap3::VertexAttribute<Vec3> position = map3_.get_attribute<Vec3, Vertex::ORBIT>("position");
+	ASSERT_TRUE(position.is_valid());
+
+	check_strategies<CMap3, Vertex>(map3_, position, [&] (Vertex v, const std::function<void(Vertex)>& f) { map3_.foreach_adjacent_vertex_through_edge(v, f); });
+	check_strategies<CMap3, Volume>(map3_, position, [&] (Volume w, const std::function<void(Volume)>& f) { map3_.foreach_adjacent_volume_through_face(w, f); });
+}
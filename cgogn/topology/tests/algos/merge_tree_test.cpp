@@ -0,0 +1,298 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cmath>
+#include <algorithm>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/modeling/tiling/triangular_grid.h>
+
+#include <cgogn/topology/algos/merge_tree.h>
+#include <cgogn/topology/algos/scalar_field.h>
+
+#include <gtest/gtest.h>
+
+using namespace cgogn::numerics;
+
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using MergeTree = cgogn::topology::MergeTree<float64, CMap2>;
+using ScalarField = cgogn::topology::ScalarField<float64, CMap2>;
+
+/**
+ * A field made of three well separated bumps of heights 3, 2 and 1 on a triangular grid:
+ * its maxima are the centers of the bumps and the saddles between them have values below 0.3,
+ * so that the persistence of the two lower maxima in the join tree is close to their heights.
+ */
+class MergeTree_TEST : public testing::Test
+{
+protected:
+
+	static const uint32 SIZE = 40u;
+
+	CMap2 map2_;
+	cgogn::topology::AdjacencyCache<CMap2> cache_;
+	VertexAttribute<float64> field_;
+	VertexAttribute<float64> opposite_field_;
+	std::vector<uint32> peaks_; // embeddings of the centers of the bumps, by decreasing height
+
+	MergeTree_TEST() : cache_(map2_)
+	{}
+
+	void SetUp() override
+	{
+		field_ = map2_.add_attribute<float64, Vertex::ORBIT>("field");
+		opposite_field_ = map2_.add_attribute<float64, Vertex::ORBIT>("opposite_field");
+		cgogn::modeling::TriangularGrid<CMap2> grid(map2_, SIZE, SIZE);
+
+		const float64 centers[3][2] = { { 10.0, 10.0 }, { 30.0, 10.0 }, { 20.0, 30.0 } };
+		const float64 heights[3] = { 3.0, 2.0, 1.0 };
+		for (uint32 i = 0u; i <= SIZE; ++i)
+		{
+			for (uint32 j = 0u; j <= SIZE; ++j)
+			{
+				const Vertex v = grid.vertices()[i * (SIZE + 1u) + j];
+				float64 f = 0.0;
+				for (uint32 k = 0u; k < 3u; ++k)
+				{
+					const float64 dx = float64(j) - centers[k][0];
+					const float64 dy = float64(i) - centers[k][1];
+					f += heights[k] * std::exp(-(dx * dx + dy * dy) / 32.0);
+				}
+				field_[v] = f;
+				opposite_field_[v] = -f;
+			}
+		}
+		for (uint32 k = 0u; k < 3u; ++k)
+			peaks_.push_back(map2_.embedding(grid.vertices()[uint32(centers[k][1]) * (SIZE + 1u) + uint32(centers[k][0])]));
+
+		cache_.init();
+	}
+
+	// the number of connected components of the vertices that are not in the given set
+	uint32 nb_components_without(const std::vector<Vertex>& removed)
+	{
+		std::vector<bool> visited(cache_.nb_rows(), false);
+		for (Vertex v : removed)
+			visited[map2_.embedding(v)] = true;
+		uint32 nb = 0u;
+		std::vector<uint32> stack;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			if (visited[map2_.embedding(v)])
+				return;
+			++nb;
+			stack.push_back(map2_.embedding(v));
+			visited[stack.back()] = true;
+			while (!stack.empty())
+			{
+				const uint32 u = stack.back();
+				stack.pop_back();
+				cache_.foreach_adjacency(u, [&] (uint32, uint32 w)
+				{
+					if (!visited[w])
+					{
+						visited[w] = true;
+						stack.push_back(w);
+					}
+				});
+			}
+		});
+		return nb;
+	}
+
+	static std::vector<uint32> sorted(std::vector<uint32> v)
+	{
+		std::sort(v.begin(), v.end());
+		return v;
+	}
+
+	void check_tree(const MergeTree& tree)
+	{
+		const std::vector<MergeTree::PersistencePair>& pairs = tree.persistence_pairs();
+		ASSERT_EQ(pairs.size(), 2u);
+
+		// elder rule: the lower maxima are killed, the highest one is never paired
+		std::vector<uint32> killed;
+		for (const MergeTree::PersistencePair& p : pairs)
+		{
+			killed.push_back(p.extremum_);
+			EXPECT_NE(p.extremum_, peaks_[0]);
+			EXPECT_LT(tree.rank(p.killer_), tree.rank(p.extremum_));
+			EXPECT_LT(tree.rank(p.extremum_), tree.rank(p.saddle_));
+			EXPECT_NEAR(p.persistence_, std::abs(tree.value(p.extremum_) - tree.value(p.saddle_)), 1e-12);
+			EXPECT_LT(std::abs(tree.value(p.saddle_)), 0.3);
+		}
+		EXPECT_EQ(sorted(killed), sorted({ peaks_[1], peaks_[2] }));
+		// the pairs are sorted by saddle, the persistences are close to the heights of the bumps
+		EXPECT_LT(tree.rank(pairs[0].saddle_), tree.rank(pairs[1].saddle_));
+		const float64 persistence_2 = pairs[0].extremum_ == peaks_[1] ? pairs[0].persistence_ : pairs[1].persistence_;
+		const float64 persistence_3 = pairs[0].extremum_ == peaks_[2] ? pairs[0].persistence_ : pairs[1].persistence_;
+		EXPECT_NEAR(persistence_2, 2.0, 0.3);
+		EXPECT_NEAR(persistence_3, 1.0, 0.3);
+	}
+
+	// the extremum of the branch of each vertex is one of the given extrema
+	void check_branches(const MergeTree& tree, const std::vector<uint32>& extrema)
+	{
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			const uint32 e = tree.vertex_extremum(map2_.embedding(v));
+			EXPECT_NE(std::find(extrema.begin(), extrema.end(), e), extrema.end());
+			EXPECT_LT(tree.vertex_arc(map2_.embedding(v)), tree.nb_arcs());
+		});
+	}
+};
+
+TEST_F(MergeTree_TEST, JoinTree)
+{
+	MergeTree tree(map2_, cache_, field_, cgogn::topology::JOIN_TREE);
+	tree.compute();
+	EXPECT_EQ(tree.type(), cgogn::topology::JOIN_TREE);
+	EXPECT_EQ(tree.order().size(), std::size_t(map2_.nb_cells<Vertex::ORBIT>()));
+	EXPECT_EQ(tree.order().front(), peaks_[0]);
+	for (uint32 i = 1u; i < uint32(tree.order().size()); ++i)
+		EXPECT_GE(tree.value(tree.order()[i - 1u]), tree.value(tree.order()[i]));
+
+	// 3 leaf arcs and an arc from each of the 2 saddles
+	EXPECT_EQ(tree.extrema(), std::vector<uint32>(peaks_));
+	EXPECT_EQ(tree.saddles().size(), 2u);
+	EXPECT_EQ(tree.nb_arcs(), 5u);
+	check_tree(tree);
+	check_branches(tree, peaks_);
+	for (uint32 e : peaks_)
+	{
+		EXPECT_EQ(tree.representative(e), e);
+		EXPECT_EQ(tree.vertex_extremum(e), e);
+		EXPECT_EQ(tree.arc(tree.vertex_arc(e)).upper_, e);
+	}
+}
+
+TEST_F(MergeTree_TEST, SplitTree)
+{
+	// the split tree of the opposite field is the join tree of the field
+	MergeTree tree(map2_, cache_, opposite_field_, cgogn::topology::SPLIT_TREE);
+	tree.compute();
+	EXPECT_EQ(tree.type(), cgogn::topology::SPLIT_TREE);
+	EXPECT_EQ(tree.order().front(), peaks_[0]);
+	for (uint32 i = 1u; i < uint32(tree.order().size()); ++i)
+		EXPECT_LE(tree.value(tree.order()[i - 1u]), tree.value(tree.order()[i]));
+
+	EXPECT_EQ(tree.extrema(), std::vector<uint32>(peaks_));
+	EXPECT_EQ(tree.saddles().size(), 2u);
+	EXPECT_EQ(tree.nb_arcs(), 5u);
+	check_tree(tree);
+	check_branches(tree, peaks_);
+}
+
+TEST_F(MergeTree_TEST, Simplify)
+{
+	MergeTree tree(map2_, cache_, field_, cgogn::topology::JOIN_TREE);
+
+	// the lowest maximum is cancelled: its branch is absorbed, one saddle remains
+	tree.compute(1.5);
+	EXPECT_EQ(tree.extrema(), std::vector<uint32>({ peaks_[0], peaks_[1] }));
+	EXPECT_EQ(tree.saddles().size(), 1u);
+	EXPECT_EQ(tree.nb_arcs(), 3u);
+	EXPECT_NE(tree.representative(peaks_[2]), peaks_[2]);
+	EXPECT_NE(std::find(tree.extrema().begin(), tree.extrema().end(), tree.representative(peaks_[2])), tree.extrema().end());
+	check_branches(tree, tree.extrema());
+	// the persistence pairs do not depend on the threshold
+	check_tree(tree);
+
+	// all the lower maxima are cancelled: a single arc
+	tree.simplify(10.0);
+	EXPECT_EQ(tree.extrema(), std::vector<uint32>({ peaks_[0] }));
+	EXPECT_TRUE(tree.saddles().empty());
+	EXPECT_EQ(tree.nb_arcs(), 1u);
+	EXPECT_EQ(tree.representative(peaks_[1]), peaks_[0]);
+	EXPECT_EQ(tree.representative(peaks_[2]), peaks_[0]);
+	check_branches(tree, tree.extrema());
+
+	// back to the unsimplified tree
+	tree.simplify(0.0);
+	EXPECT_EQ(tree.extrema(), std::vector<uint32>(peaks_));
+	EXPECT_EQ(tree.nb_arcs(), 5u);
+	check_branches(tree, peaks_);
+}
+
+TEST_F(MergeTree_TEST, ScalarFieldManifolds)
+{
+	ScalarField scalar_field(map2_, cache_, field_);
+	ScalarField opposite_scalar_field(map2_, cache_, opposite_field_);
+
+	// the boundaries of the descending manifolds of the field separate the 3 maxima
+	std::vector<Vertex> boundary;
+	scalar_field.extract_descending_3_manifold(boundary);
+	EXPECT_FALSE(boundary.empty());
+	EXPECT_EQ(nb_components_without(boundary), 3u);
+	for (Vertex v : boundary)
+		EXPECT_EQ(std::find(peaks_.begin(), peaks_.end(), map2_.embedding(v)), peaks_.end());
+
+	// the ascending manifolds of the opposite field are the same
+	std::vector<Vertex> opposite_boundary;
+	opposite_scalar_field.extract_ascending_3_manifold(opposite_boundary);
+	EXPECT_EQ(opposite_boundary.size(), boundary.size());
+	EXPECT_EQ(nb_components_without(opposite_boundary), 3u);
+
+	// cancelling the lowest maximum merges its manifold, cancelling both lower ones leaves a single manifold
+	boundary.clear();
+	scalar_field.extract_descending_3_manifold(boundary, 1.5);
+	EXPECT_EQ(nb_components_without(boundary), 2u);
+	boundary.clear();
+	scalar_field.extract_descending_3_manifold(boundary, 10.0);
+	EXPECT_TRUE(boundary.empty());
+	opposite_boundary.clear();
+	opposite_scalar_field.extract_ascending_3_manifold(opposite_boundary, 10.0);
+	EXPECT_TRUE(opposite_boundary.empty());
+}
+
+TEST_F(MergeTree_TEST, ScalarFieldLevelSets)
+{
+	ScalarField scalar_field(map2_, cache_, field_);
+
+	// the level lines surround the level sets of the maxima: their vertices are below the maxima
+	// and out of the level sets, i.e. not higher than the saddles where the level sets end
+	std::vector<Edge> level_lines;
+	scalar_field.extract_level_sets(level_lines);
+	EXPECT_FALSE(level_lines.empty());
+	for (Edge e : level_lines)
+	{
+		const std::pair<Vertex, Vertex> vv = map2_.vertices(e);
+		EXPECT_LT(field_[vv.first], 0.3);
+		EXPECT_LT(field_[vv.second], 0.3);
+	}
+
+	// fewer level sets when the lower maxima are cancelled, none when the level set of the maximum is the whole map
+	std::vector<Edge> simplified_level_lines;
+	scalar_field.extract_level_sets(simplified_level_lines, 1.5);
+	EXPECT_FALSE(simplified_level_lines.empty());
+	EXPECT_LT(simplified_level_lines.size(), level_lines.size());
+	simplified_level_lines.clear();
+	scalar_field.extract_level_sets(simplified_level_lines, 10.0);
+	EXPECT_TRUE(simplified_level_lines.empty());
+}
@@ -0,0 +1,238 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cmath>
+#include <vector>
+
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/bounding_box.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <cgogn/topology/algos/scalar_field.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+using Vertex = CMap3::Vertex;
+using Edge = CMap3::Edge;
+using Face = CMap3::Face;
+template <typename T>
+using VertexAttribute = CMap3::VertexAttribute<T>;
+using VertexMarker = CMap3::CellMarker<Vertex::ORBIT>;
+using AdjacencyCache = cgogn::topology::AdjacencyCache<CMap3>;
+using ScalarField = cgogn::topology::ScalarField<float64, CMap3>;
+using CriticalPoint = cgogn::topology::CriticalPoint;
+
+/**
+ * Critical vertices of a wavy field on tetrahedral meshes: the parallel analysis of ScalarField
+ * is compared with a sequential classification of each vertex that stores Link+(v) and Link-(v)
+ * in vertex markers of the map.
+ */
+class ScalarField_TEST : public testing::TestWithParam<std::string>
+{
+protected:
+
+	CMap3 map3_;
+	VertexAttribute<Vec3> position_;
+	VertexAttribute<float64> field_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_volume<Vec3>(map3_, std::string(DEFAULT_MESH_PATH) + GetParam());
+		position_ = map3_.get_attribute<Vec3, Vertex::ORBIT>("position");
+		field_ = map3_.add_attribute<float64, Vertex::ORBIT>("field");
+
+		cgogn::geometry::AABB<Vec3> bb;
+		cgogn::geometry::compute_AABB(position_, bb);
+		const float64 k = 12.0 / bb.max_size();
+		map3_.foreach_cell([&] (Vertex v)
+		{
+			const Vec3& p = position_[v];
+			field_[v] = std::sin(k * p[0]) * std::cos(k * p[1]) + std::sin(k * p[2]);
+		});
+	}
+
+	// connected components of the marked vertices of link: two vertices are connected
+	// when they are the two neighbors of v in a face incident to v
+	uint32 nb_marked_cc_in_link(Vertex v, std::vector<cgogn::Dart>& link, VertexMarker& link_marker)
+	{
+		uint32 nb_cc = 0u;
+		while (!link.empty())
+		{
+			cgogn::Dart d;
+			do {
+				d = link.back();
+				link.pop_back();
+			} while (!link_marker.is_marked(Vertex(d)) && !link.empty());
+
+			if (link_marker.is_marked(Vertex(d)))
+			{
+				++nb_cc;
+				link_marker.unmark(Vertex(d));
+				std::vector<cgogn::Dart> cc;
+				cc.push_back(d);
+				while (!cc.empty())
+				{
+					cgogn::Dart e = cc.back();
+					cc.pop_back();
+					map3_.foreach_incident_face(Edge(e), [&] (Face f)
+					{
+						// a dart of the edge (v,w) whose origin is the other neighbor w of v in f
+						cgogn::Dart adj = map3_.same_cell(Vertex(f.dart), v) ? map3_.phi_1(f.dart) : map3_.phi2(map3_.phi1(f.dart));
+						if (link_marker.is_marked(Vertex(adj)))
+						{
+							link_marker.unmark(Vertex(adj));
+							cc.push_back(adj);
+						}
+					});
+				}
+			}
+		}
+		return nb_cc;
+	}
+
+	CriticalPoint::Type classify(const AdjacencyCache& cache, Vertex v)
+	{
+		VertexMarker sup_marker(map3_);
+		VertexMarker inf_marker(map3_);
+		std::vector<cgogn::Dart> sup_link;
+		std::vector<cgogn::Dart> inf_link;
+		cache.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u)
+		{
+			if (field_[u] < field_[v])
+			{
+				inf_marker.mark(u);
+				inf_link.push_back(u.dart);
+			}
+			else
+			{
+				sup_marker.mark(u);
+				sup_link.push_back(u.dart);
+			}
+		});
+
+		const uint32 nb_inf = nb_marked_cc_in_link(v, inf_link, inf_marker);
+		const uint32 nb_sup = nb_marked_cc_in_link(v, sup_link, sup_marker);
+		if (nb_inf == 1u && nb_sup == 0u)
+			return CriticalPoint::Type::MAXIMUM;
+		if (nb_inf == 0u && nb_sup == 1u)
+			return CriticalPoint::Type::MINIMUM;
+		if (nb_inf == 1u && nb_sup == 1u)
+			return CriticalPoint::Type::REGULAR;
+		if (nb_sup == 1u && nb_inf < 10u)
+			return CriticalPoint::Type::SADDLE1;
+		if (nb_inf == 1u && nb_sup < 10u)
+			return CriticalPoint::Type::SADDLE2;
+		return CriticalPoint::Type::UNKNOWN;
+	}
+};
+
+TEST_P(ScalarField_TEST, ParallelSameAsSequential)
+{
+	AdjacencyCache cache(map3_);
+	cache.init();
+	ScalarField scalar_field(map3_, cache, field_);
+	scalar_field.critical_vertex_analysis();
+	VertexAttribute<CriticalPoint::Type> vertex_type =
+		map3_.get_attribute<CriticalPoint::Type, Vertex::ORBIT>("vertex_type_for_field");
+	ASSERT_TRUE(vertex_type.is_valid());
+
+	auto embeddings = [&] (const std::vector<Vertex>& vertices)
+	{
+		std::vector<uint32> emb;
+		for (Vertex v : vertices)
+			emb.push_back(map3_.embedding(v));
+		return emb;
+	};
+
+	std::vector<uint32> maxima;
+	std::vector<uint32> minima;
+	std::vector<uint32> saddles;
+	map3_.foreach_cell([&] (Vertex v)
+	{
+		const CriticalPoint::Type type = classify(cache, v);
+		EXPECT_EQ(vertex_type[v], type);
+		if (type == CriticalPoint::Type::MAXIMUM)
+			maxima.push_back(map3_.embedding(v));
+		else if (type == CriticalPoint::Type::MINIMUM)
+			minima.push_back(map3_.embedding(v));
+		else if (type == CriticalPoint::Type::SADDLE1 || type == CriticalPoint::Type::SADDLE2)
+			saddles.push_back(map3_.embedding(v));
+	});
+
+	// the critical vertices are listed in the order of a sequential traversal
+	EXPECT_GT(maxima.size() + minima.size(), 2u);
+	EXPECT_EQ(embeddings(scalar_field.get_maxima()), maxima);
+	EXPECT_EQ(embeddings(scalar_field.get_minima()), minima);
+	EXPECT_EQ(embeddings(scalar_field.get_saddles()), saddles);
+}
+
+// The link of a vertex is connected: a vertex lower (resp. greater) than all its
+// neighbors has a single connected component in its link and must be a minimum (resp. maximum)
+TEST_P(ScalarField_TEST, StrictExtremaAreClassified)
+{
+	AdjacencyCache cache(map3_);
+	cache.init();
+	ScalarField scalar_field(map3_, cache, field_);
+	scalar_field.critical_vertex_analysis();
+	VertexAttribute<CriticalPoint::Type> vertex_type =
+		map3_.get_attribute<CriticalPoint::Type, Vertex::ORBIT>("vertex_type_for_field");
+	ASSERT_TRUE(vertex_type.is_valid());
+
+	uint32 nb_extrema = 0u;
+	map3_.foreach_cell([&] (Vertex v)
+	{
+		bool is_min = true;
+		bool is_max = true;
+		cache.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u)
+		{
+			is_min &= field_[v] < field_[u];
+			is_max &= field_[v] > field_[u];
+		});
+		if (is_min)
+		{
+			++nb_extrema;
+			EXPECT_EQ(CriticalPoint::Type::MINIMUM, vertex_type[v]);
+		}
+		if (is_max)
+		{
+			++nb_extrema;
+			EXPECT_EQ(CriticalPoint::Type::MAXIMUM, vertex_type[v]);
+		}
+	});
+	EXPECT_GT(nb_extrema, 2u);
+}
+
+INSTANTIATE_TEST_CASE_P(
+	ScalarField,
+	ScalarField_TEST,
+	testing::Values("tet/horse.tet", "tet/hand.tet", "tet/liver.tet")
+);
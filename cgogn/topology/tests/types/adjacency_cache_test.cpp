@@ -0,0 +1,159 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <algorithm>
+
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <cgogn/topology/types/adjacency_cache.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+template <typename T>
+using EdgeAttribute = CMap2::EdgeAttribute<T>;
+using AdjacencyCache = cgogn::topology::AdjacencyCache<CMap2>;
+
+class AdjacencyCache_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+
+	void SetUp() override
+	{
+		cgogn::io::import_surface<Vec3>(map2_, std::string(DEFAULT_MESH_PATH) + std::string("off/aneurysm_3D.off"));
+	}
+
+	// the rows of the cache and the traversals of the map give the same neighbors in the same order
+	void check_cache(const AdjacencyCache& cache)
+	{
+		uint32 nb_slots = 0u;
+		map2_.foreach_cell([&] (Vertex v)
+		{
+			const uint32 emb = map2_.embedding(v);
+			std::vector<uint32> expected;
+			map2_.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u) { expected.push_back(map2_.embedding(u)); });
+
+			std::vector<uint32> neighbors;
+			cache.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u) { neighbors.push_back(map2_.embedding(u)); });
+			std::vector<uint32> slots;
+			cache.foreach_adjacency(emb, [&] (uint32 slot, uint32 u)
+			{
+				slots.push_back(u);
+				EXPECT_EQ(cache.neighbor_embedding(slot), u);
+				EXPECT_EQ(map2_.embedding(Vertex(cache.neighbor(slot))), u);
+				if (cache.has_edge_ids())
+					EXPECT_EQ(cache.edge(slot), map2_.embedding(Edge(cache.neighbor(slot))));
+			});
+
+			EXPECT_EQ(cache.degree(v), uint32(expected.size()));
+			EXPECT_EQ(neighbors, expected);
+			EXPECT_EQ(slots, expected);
+			EXPECT_TRUE(map2_.same_cell(Vertex(cache.vertex_dart(emb)), v));
+			nb_slots += cache.degree(v);
+		});
+		EXPECT_LE(nb_slots, cache.nb_slots());
+	}
+};
+
+TEST_F(AdjacencyCache_TEST, Init)
+{
+	AdjacencyCache cache(map2_);
+	EXPECT_FALSE(cache.is_initialized());
+	cache.init();
+	EXPECT_TRUE(cache.is_initialized());
+	EXPECT_FALSE(cache.has_edge_ids());
+	EXPECT_EQ(cache.nb_rows(), map2_.const_attribute_container<Vertex::ORBIT>().end());
+	EXPECT_EQ(cache.nb_slots(), 2u * map2_.nb_cells<Edge::ORBIT>());
+	check_cache(cache);
+
+	// the edge embeddings are stored in the slots when the edges are embedded
+	EdgeAttribute<float64> length = map2_.add_attribute<float64, Edge::ORBIT>("length");
+	uint32 i = 0u;
+	map2_.foreach_cell([&] (Edge e) { length[e] = float64(i++); });
+	cache.init();
+	EXPECT_TRUE(cache.has_edge_ids());
+	check_cache(cache);
+
+	std::vector<float64> values;
+	cache.gather_edge_values(length, values);
+	ASSERT_EQ(values.size(), std::size_t(cache.nb_slots()));
+	for (uint32 k = 0u; k < cache.nb_slots(); ++k)
+		EXPECT_EQ(values[k], length[Edge(cache.neighbor(k))]);
+
+	// the copies share the arrays
+	AdjacencyCache copy(cache);
+	EXPECT_TRUE(copy.is_initialized());
+	EXPECT_EQ(copy.nb_slots(), cache.nb_slots());
+}
+
+TEST_F(AdjacencyCache_TEST, UpdateAndCompact)
+{
+	AdjacencyCache cache(map2_);
+	cache.init();
+	const uint32 nb_initial_slots = cache.nb_slots();
+
+	// cut a few edges: the inserted vertices get new rows, the ends of the cut edges change their neighbors
+	std::vector<Edge> edges;
+	map2_.foreach_cell([&] (Edge e)
+	{
+		if (edges.size() < 10u)
+			edges.push_back(e);
+	});
+	for (Edge e : edges)
+	{
+		const std::pair<Vertex, Vertex> ends = map2_.vertices(e);
+		const Vertex v = map2_.cut_edge(e);
+		cache.update({v, ends.first, ends.second});
+	}
+	EXPECT_GE(cache.nb_rows(), map2_.const_attribute_container<Vertex::ORBIT>().end());
+	EXPECT_GT(cache.nb_slots(), nb_initial_slots);
+	check_cache(cache);
+
+	// removing the obsolete slots keeps the adjacency
+	cache.compact();
+	EXPECT_EQ(cache.nb_slots(), 2u * map2_.nb_cells<Edge::ORBIT>());
+	check_cache(cache);
+
+	// the cache compacts itself when more than half of the slots are obsolete (here after the second update)
+	std::vector<Vertex> vertices;
+	map2_.foreach_cell([&] (Vertex v) { vertices.push_back(v); });
+	cache.update(vertices);
+	EXPECT_EQ(cache.nb_slots(), 4u * map2_.nb_cells<Edge::ORBIT>());
+	check_cache(cache);
+	cache.update(vertices);
+	EXPECT_EQ(cache.nb_slots(), 2u * map2_.nb_cells<Edge::ORBIT>());
+	check_cache(cache);
+}
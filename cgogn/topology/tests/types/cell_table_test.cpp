@@ -0,0 +1,195 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <cgogn/io/map_import.h>
+
+#include <cgogn/modeling/tiling/triangular_grid.h>
+
+#include <cgogn/topology/types/cell_table.h>
+
+#include <gtest/gtest.h>
+
+#define DEFAULT_MESH_PATH CGOGN_STR(CGOGN_TEST_MESHES_PATH)
+
+using namespace cgogn::numerics;
+
+using Vec3 = Eigen::Vector3d;
+using CMap2 = cgogn::CMap2<cgogn::DefaultMapTraits>;
+using CMap3 = cgogn::CMap3<cgogn::DefaultMapTraits>;
+
+/**
+ * check a table against the relation given by the map: same related cells in the same order,
+ * rows, embeddings of the related cells, and boundary flags given by is_boundary(c)
+ */
+template <typename MAP, typename FromCell, typename ToCell, typename RELATION, typename BOUNDARY>
+void check_table(const MAP& map, const cgogn::topology::CellTable<MAP, FromCell, ToCell>& table, const RELATION& relation, const BOUNDARY& is_boundary)
+{
+	EXPECT_TRUE(table.is_initialized());
+	EXPECT_EQ(table.has_cell_embeddings(), map.template is_embedded<ToCell>());
+
+	uint32 nb_slots = 0u;
+	uint32 nb_boundary = 0u;
+	uint32 nb_inner = 0u;
+	map.foreach_cell([&] (FromCell c)
+	{
+		std::vector<cgogn::Dart> expected;
+		relation(c, [&] (ToCell u) { expected.push_back(u.dart); });
+
+		std::vector<cgogn::Dart> cells;
+		table.foreach_cell(c, [&] (ToCell u) { cells.push_back(u.dart); });
+		EXPECT_EQ(cells, expected);
+		EXPECT_EQ(table.degree(c), uint32(expected.size()));
+
+		const uint32 r = table.row(c);
+		ASSERT_LT(r, table.nb_rows());
+		EXPECT_TRUE(map.same_cell(FromCell(table.row_dart(r)), c));
+		uint32 i = 0u;
+		table.foreach_slot(r, [&] (uint32 slot)
+		{
+			EXPECT_EQ(table.cell(slot).dart, expected[i++]);
+			if (table.has_cell_embeddings())
+				EXPECT_EQ(table.cell_embedding(slot), map.embedding(table.cell(slot)));
+		});
+
+		const bool boundary = is_boundary(c);
+		EXPECT_EQ(table.is_incident_to_boundary(c), boundary);
+		EXPECT_EQ(table.is_boundary_row(r), boundary);
+		if (boundary)
+			++nb_boundary;
+		else
+			++nb_inner;
+		nb_slots += table.degree(c);
+	});
+	EXPECT_EQ(nb_slots, table.nb_slots());
+	// the meshes have a boundary
+	EXPECT_GT(nb_boundary, 0u);
+	EXPECT_GT(nb_inner, 0u);
+}
+
+class CellTable_TEST : public testing::Test
+{
+protected:
+
+	CMap2 map2_;
+	CMap3 map3_;
+
+	// a grid (with a boundary) and a tetrahedral mesh (whose boundary is closed by boundary volumes)
+	void SetUp() override
+	{
+		map2_.add_attribute<uint32, CMap2::Vertex::ORBIT>("vertex_id");
+		cgogn::modeling::TriangularGrid<CMap2> grid(map2_, 20u, 20u);
+		cgogn::io::import_volume<Vec3>(map3_, std::string(DEFAULT_MESH_PATH) + std::string("tet/hand.tet"));
+	}
+};
+
+TEST_F(CellTable_TEST, CMap2)
+{
+	using Vertex = CMap2::Vertex;
+	using Edge = CMap2::Edge;
+	using Face = CMap2::Face;
+
+	auto vertex_boundary = [&] (Vertex v) { return map2_.is_incident_to_boundary(v); };
+	auto face_boundary = [&] (Face f)
+	{
+		bool boundary = false;
+		map2_.foreach_incident_edge(f, [&] (Edge e) { boundary = boundary || map2_.is_incident_to_boundary(e); });
+		return boundary;
+	};
+
+	// the faces are checked without then with an embedding (rows indexed by dart or by embedding)
+	for (uint32 i = 0u; i < 2u; ++i)
+	{
+		cgogn::topology::IncidenceTable<CMap2, Face, Vertex> face_vertices(map2_);
+		face_vertices.init();
+		check_table(map2_, face_vertices, [&] (Face f, const std::function<void(Vertex)>& g) { map2_.foreach_incident_vertex(f, g); }, face_boundary);
+
+		cgogn::topology::IncidenceTable<CMap2, Vertex, Face> vertex_faces(map2_);
+		vertex_faces.init();
+		check_table(map2_, vertex_faces, [&] (Vertex v, const std::function<void(Face)>& g) { map2_.foreach_incident_face(v, g); }, vertex_boundary);
+
+		cgogn::topology::AdjacencyTable<CMap2, Face, Edge> face_faces(map2_);
+		face_faces.init();
+		check_table(map2_, face_faces, [&] (Face f, const std::function<void(Face)>& g) { map2_.foreach_adjacent_face_through_edge(f, g); }, face_boundary);
+
+		// the names of the traversals of the map
+		uint32 nb = 0u;
+		map2_.foreach_cell([&] (Face f)
+		{
+			face_vertices.foreach_incident_vertex(f, [&] (Vertex) { ++nb; });
+			face_faces.foreach_adjacent_face_through_edge(f, [&] (Face) { ++nb; });
+		});
+		map2_.foreach_cell([&] (Vertex v) { vertex_faces.foreach_incident_face(v, [&] (Face) { ++nb; }); });
+		EXPECT_EQ(nb, face_vertices.nb_slots() + face_faces.nb_slots() + vertex_faces.nb_slots());
+
+		if (i == 0u)
+			map2_.add_attribute<uint32, Face::ORBIT>("face_id");
+	}
+}
+
+TEST_F(CellTable_TEST, CMap3)
+{
+	using Vertex = CMap3::Vertex;
+	using Face = CMap3::Face;
+	using Volume = CMap3::Volume;
+
+	auto vertex_boundary = [&] (Vertex v) { return map3_.is_incident_to_boundary(v); };
+	auto volume_boundary = [&] (Volume w)
+	{
+		bool boundary = false;
+		map3_.foreach_incident_face(w, [&] (Face f) { boundary = boundary || map3_.is_incident_to_boundary(f); });
+		return boundary;
+	};
+
+	// the volumes are checked without then with an embedding (rows indexed by dart or by embedding)
+	for (uint32 i = 0u; i < 2u; ++i)
+	{
+		cgogn::topology::IncidenceTable<CMap3, Volume, Vertex> volume_vertices(map3_);
+		volume_vertices.init();
+		check_table(map3_, volume_vertices, [&] (Volume w, const std::function<void(Vertex)>& g) { map3_.foreach_incident_vertex(w, g); }, volume_boundary);
+
+		cgogn::topology::IncidenceTable<CMap3, Vertex, Volume> vertex_volumes(map3_);
+		vertex_volumes.init();
+		check_table(map3_, vertex_volumes, [&] (Vertex v, const std::function<void(Volume)>& g) { map3_.foreach_incident_volume(v, g); }, vertex_boundary);
+
+		cgogn::topology::AdjacencyTable<CMap3, Volume, Face> volume_volumes(map3_);
+		volume_volumes.init();
+		check_table(map3_, volume_volumes, [&] (Volume w, const std::function<void(Volume)>& g) { map3_.foreach_adjacent_volume_through_face(w, g); }, volume_boundary);
+
+		uint32 nb = 0u;
+		map3_.foreach_cell([&] (Volume w)
+		{
+			volume_vertices.foreach_incident_vertex(w, [&] (Vertex) { ++nb; });
+			volume_volumes.foreach_adjacent_volume_through_face(w, [&] (Volume) { ++nb; });
+		});
+		map3_.foreach_cell([&] (Vertex v) { vertex_volumes.foreach_incident_volume(v, [&] (Volume) { ++nb; }); });
+		EXPECT_EQ(nb, volume_vertices.nb_slots() + volume_volumes.nb_slots() + vertex_volumes.nb_slots());
+
+		if (i == 0u)
+			map3_.add_attribute<uint32, Volume::ORBIT>("volume_id");
+	}
+}
@@ -24,7 +24,11 @@
 #ifndef CGOGN_TOPOLOGY_TYPES_ADJACENCY_CACHE_H_
 #define CGOGN_TOPOLOGY_TYPES_ADJACENCY_CACHE_H_
 
+#include <vector>
+#include <memory>
+
 #include <cgogn/topology/dll.h>
+#include <cgogn/core/utils/thread_pool.h>
 #include <cgogn/core/cmap/cmap3.h>
 
 namespace cgogn
@@ -33,29 +37,61 @@ namespace cgogn
 namespace topology
 {
 
+/**
+ * Vertex adjacency of a map stored in compressed sparse row (CSR) arrays.
+ * The neighbors of each vertex (through its edges) are stored contiguously in slots:
+ * for each slot, the dart of the neighbor vertex (a dart of the edge, as given by
+ * map.foreach_adjacent_vertex_through_edge), the embedding of the neighbor and,
+ * if the edges are embedded when the cache is built, the embedding of the edge.
+ * The rows are indexed by the embeddings of the vertices and keep a dart of their vertex.
+ * Values associated with the edges (e.g. weights) can be gathered in arrays co-located with the slots
+ * (see gather_edge_values and foreach_adjacency).
+ * After a local modification of the topology, update() rebuilds the rows of the given vertices
+ * at the end of the arrays; the arrays are compacted when too many slots are obsolete.
+ * The copies of a cache share the same arrays.
+ */
 template <typename MAP>
 class AdjacencyCache
 {
 	using Vertex = typename MAP::Vertex;
-	using VertexArray = std::vector<Vertex>;
+	using Edge = typename MAP::Edge;
 	template<typename T>
-	using VertexAttribute = typename MAP::template VertexAttribute<T>;
+	using EdgeAttribute = typename MAP::template EdgeAttribute<T>;
+
+	struct Row
+	{
+		uint32 first_;
+		uint32 nb_;
+		Dart dart_;
+	};
+
+	struct Data
+	{
+		std::vector<Row> rows_;
+		std::vector<Dart> neighbors_;
+		std::vector<uint32> neighbor_embeddings_;
+		std::vector<uint32> edges_;
+		uint32 nb_obsolete_ = 0u;
+		bool edge_ids_ = false;
+		bool initialized_ = false;
+	};
 
 public:
 
 	inline AdjacencyCache(MAP& map) :
-		map_(map)
+		map_(map),
+		data_(std::make_shared<Data>())
 	{
 	}
 
 	inline AdjacencyCache(const AdjacencyCache& other) :
 		map_(other.map_),
-		adjacency_(other.adjacency_)
+		data_(other.data_)
 	{}
 
 	inline AdjacencyCache(AdjacencyCache&& other) :
 		map_(other.map_),
-		adjacency_(std::move(other.adjacency_))
+		data_(other.data_)
 	{}
 
 	const AdjacencyCache& operator=(AdjacencyCache&&) = delete;
@@ -64,28 +100,248 @@ public:
 	inline ~AdjacencyCache()
 	{}
 
+	/**
+	 * @brief build the adjacency of all the vertices of the map (in parallel)
+	 */
 	void init()
 	{
-		map_.add_attribute(adjacency_, "__adjacency__");
-		map_.foreach_cell([&](Vertex v)
+		Data& data = *data_;
+
+		std::vector<Vertex> vertices;
+		vertices.reserve(map_.template nb_cells<Vertex::ORBIT>());
+		map_.foreach_cell([&] (Vertex v) { vertices.push_back(v); });
+		const uint32 nb = uint32(vertices.size());
+
+		data.rows_.assign(map_.template const_attribute_container<Vertex::ORBIT>().end(), Row{0u, 0u, Dart()});
+
+		// degrees, then offsets in the order of the traversal
+		std::vector<uint32> offsets;
+		parallel_compute_offsets(nb, [&] (uint32 i)
 		{
-			map_.foreach_adjacent_vertex_through_edge(v, [&](Vertex u)
+			uint32 degree = 0u;
+			map_.foreach_adjacent_vertex_through_edge(vertices[i], [&] (Vertex) { ++degree; });
+			return degree;
+		},
+		offsets);
+
+		const uint32 nb_slots = offsets[nb];
+		const bool edge_ids = map_.template is_embedded<Edge>();
+		data.edge_ids_ = edge_ids;
+		data.neighbors_.resize(nb_slots);
+		data.neighbor_embeddings_.resize(nb_slots);
+		data.edges_.clear();
+		if (edge_ids)
+			data.edges_.resize(nb_slots);
+
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
 			{
-				adjacency_[v].push_back(u);
-			});
+				const Vertex v = vertices[i];
+				data.rows_[map_.embedding(v)] = Row{offsets[i], offsets[i + 1u] - offsets[i], v.dart};
+				uint32 k = offsets[i];
+				map_.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u)
+				{
+					data.neighbors_[k] = u.dart;
+					data.neighbor_embeddings_[k] = map_.embedding(u);
+					if (edge_ids)
+						data.edges_[k] = map_.embedding(Edge(u.dart));
+					++k;
+				});
+			}
 		});
+
+		data.nb_obsolete_ = 0u;
+		data.initialized_ = true;
+	}
+
+	/**
+	 * @brief rebuild the rows of the given vertices after a modification of the topology
+	 * @param vertices the vertices whose set of adjacent vertices (or edges) changed,
+	 * including the vertices created by the modification
+	 */
+	void update(const std::vector<Vertex>& vertices)
+	{
+		cgogn_message_assert(is_initialized(), "AdjacencyCache::update: the cache is not initialized");
+		Data& data = *data_;
+
+		const uint32 nb_lines = map_.template const_attribute_container<Vertex::ORBIT>().end();
+		if (data.rows_.size() < nb_lines)
+			data.rows_.resize(nb_lines, Row{0u, 0u, Dart()});
+
+		const bool edge_ids = data.edge_ids_;
+		for (Vertex v : vertices)
+		{
+			Row& row = data.rows_[map_.embedding(v)];
+			data.nb_obsolete_ += row.nb_;
+			row.first_ = uint32(data.neighbors_.size());
+			row.dart_ = v.dart;
+			map_.foreach_adjacent_vertex_through_edge(v, [&] (Vertex u)
+			{
+				data.neighbors_.push_back(u.dart);
+				data.neighbor_embeddings_.push_back(map_.embedding(u));
+				if (edge_ids)
+					data.edges_.push_back(map_.embedding(Edge(u.dart)));
+			});
+			row.nb_ = uint32(data.neighbors_.size()) - row.first_;
+		}
+
+		if (2u * data.nb_obsolete_ > uint32(data.neighbors_.size()))
+			compact();
+	}
+
+	/**
+	 * @brief remove the obsolete slots (and the rows of the removed vertices)
+	 */
+	void compact()
+	{
+		Data& data = *data_;
+		const auto& container = map_.template const_attribute_container<Vertex::ORBIT>();
+		const bool edge_ids = data.edge_ids_;
+
+		std::vector<Dart> neighbors;
+		std::vector<uint32> neighbor_embeddings;
+		std::vector<uint32> edges;
+		const std::size_t nb_slots = data.neighbors_.size() - data.nb_obsolete_;
+		neighbors.reserve(nb_slots);
+		neighbor_embeddings.reserve(nb_slots);
+		if (edge_ids)
+			edges.reserve(nb_slots);
+
+		for (uint32 i = 0u; i < uint32(data.rows_.size()); ++i)
+		{
+			Row& row = data.rows_[i];
+			if (i >= container.end() || !container.used(i))
+			{
+				row = Row{0u, 0u, Dart()};
+				continue;
+			}
+			const uint32 first = uint32(neighbors.size());
+			for (uint32 k = row.first_; k < row.first_ + row.nb_; ++k)
+			{
+				neighbors.push_back(data.neighbors_[k]);
+				neighbor_embeddings.push_back(data.neighbor_embeddings_[k]);
+				if (edge_ids)
+					edges.push_back(data.edges_[k]);
+			}
+			row.first_ = first;
+		}
+
+		data.neighbors_.swap(neighbors);
+		data.neighbor_embeddings_.swap(neighbor_embeddings);
+		data.edges_.swap(edges);
+		data.nb_obsolete_ = 0u;
+	}
+
+	inline bool is_initialized() const
+	{
+		return data_->initialized_;
+	}
+
+	/**
+	 * @brief true if the embeddings of the edges are stored in the slots
+	 */
+	inline bool has_edge_ids() const
+	{
+		return data_->edge_ids_;
+	}
+
+	// number of slots of the arrays (including the obsolete ones), i.e. size of the co-located arrays
+	inline uint32 nb_slots() const
+	{
+		return uint32(data_->neighbors_.size());
+	}
+
+	// number of rows, i.e. size of the arrays indexed by the embeddings of the vertices
+	inline uint32 nb_rows() const
+	{
+		return uint32(data_->rows_.size());
+	}
+
+	inline uint32 degree(Vertex v) const
+	{
+		return row(map_.embedding(v)).nb_;
+	}
+
+	// a dart of the vertex of embedding v_emb
+	inline Dart vertex_dart(uint32 v_emb) const
+	{
+		return row(v_emb).dart_;
+	}
+
+	inline Dart neighbor(uint32 slot) const
+	{
+		return data_->neighbors_[slot];
+	}
+
+	inline uint32 neighbor_embedding(uint32 slot) const
+	{
+		return data_->neighbor_embeddings_[slot];
+	}
+
+	inline uint32 edge(uint32 slot) const
+	{
+		cgogn_message_assert(has_edge_ids(), "AdjacencyCache: the edges were not embedded when the cache was built");
+		return data_->edges_[slot];
 	}
 
 	template <typename FUNC>
 	inline void foreach_adjacent_vertex_through_edge(Vertex v, const FUNC& f) const
 	{
 		static_assert(is_func_parameter_same<FUNC, Vertex>::value, "Wrong function cell parameter type");
-		for (Vertex u : adjacency_[v]) f(u);
+		const Data& data = *data_;
+		const Row& r = row(map_.embedding(v));
+		for (uint32 k = r.first_, end = r.first_ + r.nb_; k < end; ++k)
+			f(Vertex(data.neighbors_[k]));
+	}
+
+	/**
+	 * @brief call f(slot, neighbor_embedding) for each neighbor of the vertex of embedding v_emb
+	 */
+	template <typename FUNC>
+	inline void foreach_adjacency(uint32 v_emb, const FUNC& f) const
+	{
+		const Data& data = *data_;
+		const Row& r = row(v_emb);
+		for (uint32 k = r.first_, end = r.first_ + r.nb_; k < end; ++k)
+			f(k, data.neighbor_embeddings_[k]);
+	}
+
+	/**
+	 * @brief copy the values of an edge attribute in an array co-located with the slots
+	 */
+	template <typename T>
+	void gather_edge_values(const EdgeAttribute<T>& attribute, std::vector<T>& values) const
+	{
+		const Data& data = *data_;
+		const uint32 nb = nb_slots();
+		values.resize(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			if (has_edge_ids())
+			{
+				for (uint32 k = begin; k < end; ++k)
+					values[k] = attribute[data.edges_[k]];
+			}
+			else
+			{
+				for (uint32 k = begin; k < end; ++k)
+					values[k] = attribute[Edge(data.neighbors_[k])];
+			}
+		});
 	}
 
 private:
+
+	// the rows cover the vertices that existed when the cache was built or updated
+	inline const Row& row(uint32 v_emb) const
+	{
+		cgogn_message_assert(v_emb < data_->rows_.size(), "AdjacencyCache: vertex created after the cache was built, call update() with it");
+		return data_->rows_[v_emb];
+	}
+
 	MAP& map_;
-	VertexAttribute<VertexArray> adjacency_;
+	std::shared_ptr<Data> data_;
 };
 
 
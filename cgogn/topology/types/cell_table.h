@@ -0,0 +1,488 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_TOPOLOGY_TYPES_CELL_TABLE_H_
+#define CGOGN_TOPOLOGY_TYPES_CELL_TABLE_H_
+
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <functional>
+
+#include <cgogn/topology/dll.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/cmap/cmap3.h>
+
+namespace cgogn
+{
+
+namespace topology
+{
+
+/**
+ * dimension of the cells of type CellType in the map (0: vertex, 1: edge, 2: face, 3: volume)
+ */
+template <typename MAP, typename CellType>
+struct cell_dimension
+{
+	static const uint32 value =
+		std::is_same<CellType, typename MAP::Vertex>::value ? 0u :
+		std::is_same<CellType, typename MAP::Edge>::value ? 1u :
+		std::is_same<CellType, typename MAP::Face>::value ? 2u : 3u;
+};
+
+/**
+ * Relation between the cells of type FromCell and the cells of type ToCell of a map stored in
+ * compressed sparse row (CSR) arrays: for each FromCell, the related cells are stored contiguously in slots
+ * (dart of the related cell and, if the ToCell are embedded when the table is built, its embedding).
+ * The rows are indexed by the embeddings of the FromCell if they are embedded, and keep a dart of their cell.
+ * The table is built once in parallel from any relation (see init) and then traversed without any marker.
+ * The boundary is explicit: a row is flagged as boundary if its cell has a dart d such that d or phi<DIM>(d)
+ * is a boundary dart, i.e. if some of its related cells may be missing because they would lie in the boundary.
+ * The table must be rebuilt after a modification of the topology. The copies of a table share the same arrays.
+ * See IncidenceTable and AdjacencyTable for the relations given by the traversals of the maps.
+ */
+template <typename MAP, typename FromCell, typename ToCell>
+class CellTable
+{
+	struct Row
+	{
+		uint32 first_;
+		uint32 nb_;
+		Dart dart_;
+	};
+
+	struct Data
+	{
+		std::vector<Row> rows_;
+		std::vector<uint8> boundary_;			// boundary flag of each row
+		std::vector<uint32> dart_rows_;			// row of each dart (if the FromCell are not embedded)
+		std::vector<Dart> cells_;				// the related cells (slots)
+		std::vector<uint32> cell_embeddings_;	// the embeddings of the related cells (if they are embedded)
+		bool from_embedded_ = false;
+		bool to_embedded_ = false;
+		bool initialized_ = false;
+	};
+
+public:
+
+	inline CellTable(const MAP& map) :
+		map_(map),
+		data_(std::make_shared<Data>())
+	{}
+
+	inline CellTable(const CellTable& other) :
+		map_(other.map_),
+		data_(other.data_)
+	{}
+
+	inline CellTable(CellTable&& other) :
+		map_(other.map_),
+		data_(other.data_)
+	{}
+
+	const CellTable& operator=(CellTable&&) = delete;
+	const CellTable& operator=(const CellTable&) = delete;
+
+	inline ~CellTable()
+	{}
+
+	/**
+	 * @brief build the table of all the FromCell of the map (in parallel)
+	 * @param relation a function relation(c, f) that calls f(ToCell) on each cell related to the FromCell c
+	 * (it is called twice per cell, from the threads of the thread pool)
+	 */
+	template <typename RELATION>
+	void init(const RELATION& relation)
+	{
+		Data& data = *data_;
+
+		std::vector<FromCell> cells;
+		cells.reserve(map_.template nb_cells<FromCell::ORBIT>());
+		map_.foreach_cell([&] (FromCell c) { cells.push_back(c); });
+		const uint32 nb = uint32(cells.size());
+
+		data.from_embedded_ = map_.template is_embedded<FromCell>();
+		data.to_embedded_ = map_.template is_embedded<ToCell>();
+		const uint32 nb_rows = data.from_embedded_ ? map_.template const_attribute_container<FromCell::ORBIT>().end() : nb;
+		data.rows_.assign(nb_rows, Row{0u, 0u, Dart()});
+		data.boundary_.assign(nb_rows, 0u);
+		if (data.from_embedded_)
+			data.dart_rows_.clear();
+		else
+			data.dart_rows_.assign(map_.topology_container().end(), INVALID_INDEX);
+
+		// number of related cells, then offsets in the order of the traversal
+		std::vector<uint32> offsets;
+		parallel_compute_offsets(nb, [&] (uint32 i)
+		{
+			uint32 degree = 0u;
+			relation(cells[i], [&] (ToCell) { ++degree; });
+			return degree;
+		},
+		offsets);
+
+		const uint32 nb_slots = offsets[nb];
+		data.cells_.resize(nb_slots);
+		data.cell_embeddings_.clear();
+		if (data.to_embedded_)
+			data.cell_embeddings_.resize(nb_slots);
+
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const FromCell c = cells[i];
+				uint32 r = i;
+				if (data.from_embedded_)
+					r = map_.embedding(c);
+				else
+					map_.foreach_dart_of_orbit(c, [&] (Dart d) { data.dart_rows_[d.index] = i; });
+
+				data.rows_[r] = Row{offsets[i], offsets[i + 1u] - offsets[i], c.dart};
+				bool boundary = false;
+				map_.foreach_dart_of_orbit(c, [&] (Dart d)
+				{
+					boundary = boundary || map_.is_boundary(d) || map_.is_boundary(phi_dim(d));
+				});
+				data.boundary_[r] = boundary ? 1u : 0u;
+
+				uint32 k = offsets[i];
+				relation(c, [&] (ToCell u)
+				{
+					data.cells_[k] = u.dart;
+					if (data.to_embedded_)
+						data.cell_embeddings_[k] = map_.embedding(u);
+					++k;
+				});
+			}
+		});
+
+		data.initialized_ = true;
+	}
+
+	inline bool is_initialized() const
+	{
+		return data_->initialized_;
+	}
+
+	// true if the embeddings of the related cells are stored in the slots
+	inline bool has_cell_embeddings() const
+	{
+		return data_->to_embedded_;
+	}
+
+	// number of slots, i.e. size of the arrays co-located with the slots
+	inline uint32 nb_slots() const
+	{
+		return uint32(data_->cells_.size());
+	}
+
+	// number of rows, i.e. size of the arrays indexed by the rows (embeddings of the FromCell if they are embedded)
+	inline uint32 nb_rows() const
+	{
+		return uint32(data_->rows_.size());
+	}
+
+	// row of a cell (its embedding if the FromCell are embedded)
+	inline uint32 row(FromCell c) const
+	{
+		const Data& data = *data_;
+		if (data.from_embedded_)
+		{
+			cgogn_message_assert(map_.embedding(c) < data.rows_.size(), "CellTable: cell created after the table was built");
+			return map_.embedding(c);
+		}
+		cgogn_message_assert(c.dart.index < data.dart_rows_.size(), "CellTable: cell created after the table was built");
+		return data.dart_rows_[c.dart.index];
+	}
+
+	inline uint32 degree(FromCell c) const
+	{
+		return data_->rows_[row(c)].nb_;
+	}
+
+	// a dart of the cell of row r
+	inline Dart row_dart(uint32 r) const
+	{
+		return data_->rows_[r].dart_;
+	}
+
+	inline bool is_boundary_row(uint32 r) const
+	{
+		return data_->boundary_[r] != 0u;
+	}
+
+	inline bool is_incident_to_boundary(FromCell c) const
+	{
+		return is_boundary_row(row(c));
+	}
+
+	inline ToCell cell(uint32 slot) const
+	{
+		return ToCell(data_->cells_[slot]);
+	}
+
+	inline uint32 cell_embedding(uint32 slot) const
+	{
+		cgogn_message_assert(has_cell_embeddings(), "CellTable: the related cells were not embedded when the table was built");
+		return data_->cell_embeddings_[slot];
+	}
+
+	/**
+	 * @brief call f(ToCell) for each cell related to c
+	 */
+	template <typename FUNC>
+	inline void foreach_cell(FromCell c, const FUNC& f) const
+	{
+		static_assert(is_func_parameter_same<FUNC, ToCell>::value, "Wrong function cell parameter type");
+		const Data& data = *data_;
+		const Row& r = data.rows_[row(c)];
+		for (uint32 k = r.first_, end = r.first_ + r.nb_; k < end; ++k)
+			f(ToCell(data.cells_[k]));
+	}
+
+	/**
+	 * @brief call f(slot) for each cell related to the cell of row r
+	 */
+	template <typename FUNC>
+	inline void foreach_slot(uint32 r, const FUNC& f) const
+	{
+		const Row& rw = data_->rows_[r];
+		for (uint32 k = rw.first_, end = rw.first_ + rw.nb_; k < end; ++k)
+			f(k);
+	}
+
+	/**
+	 * @brief copy the values of an attribute of the related cells in an array co-located with the slots
+	 */
+	template <typename T>
+	void gather_cell_values(const typename MAP::template Attribute<T, ToCell::ORBIT>& attribute, std::vector<T>& values) const
+	{
+		const Data& data = *data_;
+		const uint32 nb = nb_slots();
+		values.resize(nb);
+		parallel_foreach_range(nb, [&] (uint32, uint32 begin, uint32 end)
+		{
+			if (has_cell_embeddings())
+			{
+				for (uint32 k = begin; k < end; ++k)
+					values[k] = attribute[data.cell_embeddings_[k]];
+			}
+			else
+			{
+				for (uint32 k = begin; k < end; ++k)
+					values[k] = attribute[ToCell(data.cells_[k])];
+			}
+		});
+	}
+
+protected:
+
+	template <typename M = MAP, typename std::enable_if<M::DIMENSION == 2u>::type* = nullptr>
+	inline Dart phi_dim(Dart d) const
+	{
+		return map_.phi2(d);
+	}
+
+	template <typename M = MAP, typename std::enable_if<M::DIMENSION == 3u>::type* = nullptr>
+	inline Dart phi_dim(Dart d) const
+	{
+		return map_.phi3(d);
+	}
+
+	const MAP& map_;
+	std::shared_ptr<Data> data_;
+};
+
+/**
+ * Table of the cells of type ToCell incident to the cells of type FromCell, as given by the
+ * map.foreach_incident_* traversals (that skip the boundary cells), that it replaces with the same names.
+ */
+template <typename MAP, typename FromCell, typename ToCell>
+class IncidenceTable : public CellTable<MAP, FromCell, ToCell>
+{
+	using Inherit = CellTable<MAP, FromCell, ToCell>;
+
+	template <uint32 D>
+	using Dim = std::integral_constant<uint32, D>;
+	static const uint32 TO_DIM = cell_dimension<MAP, ToCell>::value;
+
+	static_assert(cell_dimension<MAP, FromCell>::value != TO_DIM, "IncidenceTable: the cells must have different dimensions");
+
+public:
+
+	inline IncidenceTable(const MAP& map) : Inherit(map)
+	{}
+
+	/**
+	 * @brief build the table (in parallel)
+	 */
+	void init()
+	{
+		Inherit::init([this] (FromCell c, const std::function<void(ToCell)>& f) { incident_cells(c, f, Dim<TO_DIM>()); });
+	}
+
+	template <typename FUNC>
+	inline void foreach_incident_vertex(FromCell c, const FUNC& f) const
+	{
+		static_assert(TO_DIM == 0u, "IncidenceTable: the table does not store the incident vertices");
+		this->foreach_cell(c, f);
+	}
+
+	template <typename FUNC>
+	inline void foreach_incident_edge(FromCell c, const FUNC& f) const
+	{
+		static_assert(TO_DIM == 1u, "IncidenceTable: the table does not store the incident edges");
+		this->foreach_cell(c, f);
+	}
+
+	template <typename FUNC>
+	inline void foreach_incident_face(FromCell c, const FUNC& f) const
+	{
+		static_assert(TO_DIM == 2u, "IncidenceTable: the table does not store the incident faces");
+		this->foreach_cell(c, f);
+	}
+
+	template <typename FUNC>
+	inline void foreach_incident_volume(FromCell c, const FUNC& f) const
+	{
+		static_assert(TO_DIM == 3u, "IncidenceTable: the table does not store the incident volumes");
+		this->foreach_cell(c, f);
+	}
+
+private:
+
+	template <typename FUNC>
+	inline void incident_cells(FromCell c, const FUNC& f, Dim<0u>) const { this->map_.foreach_incident_vertex(c, f); }
+	template <typename FUNC>
+	inline void incident_cells(FromCell c, const FUNC& f, Dim<1u>) const { this->map_.foreach_incident_edge(c, f); }
+	template <typename FUNC>
+	inline void incident_cells(FromCell c, const FUNC& f, Dim<2u>) const { this->map_.foreach_incident_face(c, f); }
+	template <typename FUNC>
+	inline void incident_cells(FromCell c, const FUNC& f, Dim<3u>) const { this->map_.foreach_incident_volume(c, f); }
+};
+
+/**
+ * Table of the cells of type CellType adjacent to each cell of type CellType through the cells of type Through,
+ * as given by the map.foreach_adjacent_*_through_* traversals (that skip the boundary cells), that it replaces
+ * with the same names.
+ */
+template <typename MAP, typename CellType, typename Through>
+class AdjacencyTable : public CellTable<MAP, CellType, CellType>
+{
+	using Inherit = CellTable<MAP, CellType, CellType>;
+
+	template <uint32 D>
+	using Dim = std::integral_constant<uint32, D>;
+	static const uint32 CELL_DIM = cell_dimension<MAP, CellType>::value;
+	static const uint32 THROUGH_DIM = cell_dimension<MAP, Through>::value;
+
+	static_assert(CELL_DIM != THROUGH_DIM, "AdjacencyTable: the cells must have different dimensions");
+
+public:
+
+	inline AdjacencyTable(const MAP& map) : Inherit(map)
+	{}
+
+	/**
+	 * @brief build the table (in parallel)
+	 */
+	void init()
+	{
+		Inherit::init([this] (CellType c, const std::function<void(CellType)>& f) { adjacent_cells(c, f, Dim<CELL_DIM>(), Dim<THROUGH_DIM>()); });
+	}
+
+	template <typename FUNC>
+	inline void foreach_adjacent_vertex_through_edge(CellType c, const FUNC& f) const { check<0u, 1u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_vertex_through_face(CellType c, const FUNC& f) const { check<0u, 2u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_vertex_through_volume(CellType c, const FUNC& f) const { check<0u, 3u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_edge_through_vertex(CellType c, const FUNC& f) const { check<1u, 0u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_edge_through_face(CellType c, const FUNC& f) const { check<1u, 2u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_edge_through_volume(CellType c, const FUNC& f) const { check<1u, 3u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_face_through_vertex(CellType c, const FUNC& f) const { check<2u, 0u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_face_through_edge(CellType c, const FUNC& f) const { check<2u, 1u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_face_through_volume(CellType c, const FUNC& f) const { check<2u, 3u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_volume_through_vertex(CellType c, const FUNC& f) const { check<3u, 0u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_volume_through_edge(CellType c, const FUNC& f) const { check<3u, 1u>(); this->foreach_cell(c, f); }
+	template <typename FUNC>
+	inline void foreach_adjacent_volume_through_face(CellType c, const FUNC& f) const { check<3u, 2u>(); this->foreach_cell(c, f); }
+
+private:
+
+	template <uint32 C, uint32 T>
+	static inline void check()
+	{
+		static_assert(C == CELL_DIM && T == THROUGH_DIM, "AdjacencyTable: the table does not store this adjacency");
+	}
+
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<0u>, Dim<1u>) const { this->map_.foreach_adjacent_vertex_through_edge(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<0u>, Dim<2u>) const { this->map_.foreach_adjacent_vertex_through_face(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<0u>, Dim<3u>) const { this->map_.foreach_adjacent_vertex_through_volume(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<1u>, Dim<0u>) const { this->map_.foreach_adjacent_edge_through_vertex(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<1u>, Dim<2u>) const { this->map_.foreach_adjacent_edge_through_face(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<1u>, Dim<3u>) const { this->map_.foreach_adjacent_edge_through_volume(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<2u>, Dim<0u>) const { this->map_.foreach_adjacent_face_through_vertex(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<2u>, Dim<1u>) const { this->map_.foreach_adjacent_face_through_edge(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<2u>, Dim<3u>) const { this->map_.foreach_adjacent_face_through_volume(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<3u>, Dim<0u>) const { this->map_.foreach_adjacent_volume_through_vertex(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<3u>, Dim<1u>) const { this->map_.foreach_adjacent_volume_through_edge(c, f); }
+	template <typename FUNC>
+	inline void adjacent_cells(CellType c, const FUNC& f, Dim<3u>, Dim<2u>) const { this->map_.foreach_adjacent_volume_through_face(c, f); }
+};
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_TYPES_CELL_TABLE_CPP_))
+extern template class CGOGN_TOPLOGY_API IncidenceTable<CMap2<DefaultMapTraits>, CMap2<DefaultMapTraits>::Face, CMap2<DefaultMapTraits>::Vertex>;
+extern template class CGOGN_TOPLOGY_API IncidenceTable<CMap2<DefaultMapTraits>, CMap2<DefaultMapTraits>::Vertex, CMap2<DefaultMapTraits>::Face>;
+extern template class CGOGN_TOPLOGY_API AdjacencyTable<CMap2<DefaultMapTraits>, CMap2<DefaultMapTraits>::Face, CMap2<DefaultMapTraits>::Edge>;
+extern template class CGOGN_TOPLOGY_API IncidenceTable<CMap3<DefaultMapTraits>, CMap3<DefaultMapTraits>::Volume, CMap3<DefaultMapTraits>::Vertex>;
+extern template class CGOGN_TOPLOGY_API IncidenceTable<CMap3<DefaultMapTraits>, CMap3<DefaultMapTraits>::Vertex, CMap3<DefaultMapTraits>::Volume>;
+extern template class CGOGN_TOPLOGY_API AdjacencyTable<CMap3<DefaultMapTraits>, CMap3<DefaultMapTraits>::Volume, CMap3<DefaultMapTraits>::Face>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_TOPOLOGY_TYPES_CELL_TABLE_CPP_))
+
+} // namespace topology
+
+} // namespace cgogn
+
+#endif // CGOGN_TOPOLOGY_TYPES_CELL_TABLE_H_
@@ -0,0 +1,348 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_TOPOLOGY_TYPES_SHORTEST_PATH_QUEUE_H_
+#define CGOGN_TOPOLOGY_TYPES_SHORTEST_PATH_QUEUE_H_
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <cstring>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/assert.h>
+#include <cgogn/core/basic/dart.h>
+
+namespace cgogn
+{
+
+namespace topology
+{
+
+/**
+ * The priority queues of the shortest path computations.
+ * They manage elements identified by indices in [0, n) (e.g. the embeddings of the vertices)
+ * with a key (e.g. an estimated distance), and share the same interface:
+ * - reset(n) empties the queue and prepares it for the indices of [0, n)
+ * - empty()
+ * - push(i, key) inserts i with the given key or lowers the key of i if it is already in the queue
+ * - pop(i, key) removes an element with a minimal key
+ * The lazy queues (BINARY_HEAP, RADIX_HEAP) insert a duplicate when a key is lowered:
+ * the popped keys must be compared with the current key of the element to skip the outdated entries.
+ */
+enum ShortestPathQueue : uint32
+{
+	BINARY_HEAP = 0,	// binary heap with duplicates (std::push_heap / std::pop_heap)
+	FOUR_ARY_HEAP,		// indexed 4-ary heap with decrease-key
+	RADIX_HEAP			// radix heap with duplicates, for monotone keys (e.g. dijkstra)
+};
+
+/**
+ * binary heap with duplicates
+ */
+template <typename Scalar>
+class BinaryHeapQueue
+{
+	using Entry = std::pair<Scalar, uint32>;
+
+public:
+
+	inline void reset(uint32)
+	{
+		heap_.clear();
+	}
+
+	inline bool empty() const
+	{
+		return heap_.empty();
+	}
+
+	inline void push(uint32 i, Scalar key)
+	{
+		heap_.push_back(Entry(key, i));
+		std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+	}
+
+	inline void pop(uint32& i, Scalar& key)
+	{
+		std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+		key = heap_.back().first;
+		i = heap_.back().second;
+		heap_.pop_back();
+	}
+
+private:
+
+	std::vector<Entry> heap_;
+};
+
+/**
+ * indexed d-ary heap with decrease-key:
+ * each element is at most once in the heap, the keys can be pushed in any order.
+ */
+template <typename Scalar, uint32 ARITY = 4u>
+class DAryHeapQueue
+{
+	static_assert(ARITY >= 2u, "DAryHeapQueue: the arity must be at least 2");
+
+	using Entry = std::pair<Scalar, uint32>;
+
+public:
+
+	inline void reset(uint32 n)
+	{
+		for (const Entry& e : heap_)
+			position_[e.second] = INVALID_INDEX;
+		heap_.clear();
+		if (position_.size() < n)
+			position_.resize(n, INVALID_INDEX);
+	}
+
+	inline bool empty() const
+	{
+		return heap_.empty();
+	}
+
+	inline void push(uint32 i, Scalar key)
+	{
+		uint32 pos = position_[i];
+		if (pos == INVALID_INDEX)
+		{
+			pos = uint32(heap_.size());
+			heap_.push_back(Entry(key, i));
+		}
+		else if (key < heap_[pos].first)
+			heap_[pos].first = key;
+		else
+			return;
+		sift_up(pos);
+	}
+
+	inline void pop(uint32& i, Scalar& key)
+	{
+		key = heap_.front().first;
+		i = heap_.front().second;
+		position_[i] = INVALID_INDEX;
+		const Entry last = heap_.back();
+		heap_.pop_back();
+		if (!heap_.empty())
+		{
+			heap_.front() = last;
+			position_[last.second] = 0u;
+			sift_down(0u);
+		}
+	}
+
+private:
+
+	inline void sift_up(uint32 pos)
+	{
+		const Entry e = heap_[pos];
+		while (pos > 0u)
+		{
+			const uint32 parent = (pos - 1u) / ARITY;
+			if (!(e.first < heap_[parent].first))
+				break;
+			heap_[pos] = heap_[parent];
+			position_[heap_[pos].second] = pos;
+			pos = parent;
+		}
+		heap_[pos] = e;
+		position_[e.second] = pos;
+	}
+
+	inline void sift_down(uint32 pos)
+	{
+		const Entry e = heap_[pos];
+		const uint32 size = uint32(heap_.size());
+		for (;;)
+		{
+			const uint32 first = pos * ARITY + 1u;
+			if (first >= size)
+				break;
+			const uint32 last = std::min(first + ARITY, size);
+			uint32 child = first;
+			for (uint32 c = first + 1u; c < last; ++c)
+			{
+				if (heap_[c].first < heap_[child].first)
+					child = c;
+			}
+			if (!(heap_[child].first < e.first))
+				break;
+			heap_[pos] = heap_[child];
+			position_[heap_[pos].second] = pos;
+			pos = child;
+		}
+		heap_[pos] = e;
+		position_[e.second] = pos;
+	}
+
+	std::vector<Entry> heap_;
+	std::vector<uint32> position_;
+};
+
+/**
+ * radix heap with duplicates (Ahuja, Mehlhorn, Orlin and Tarjan):
+ * the pushed keys must not be lower than the last popped key, which is the case in dijkstra.
+ * The keys are unsigned integers or non-negative floating point numbers,
+ * whose bit patterns have the same order than their values.
+ */
+template <typename Scalar>
+class RadixHeapQueue
+{
+	static_assert(std::is_floating_point<Scalar>::value || std::is_unsigned<Scalar>::value,
+				  "RadixHeapQueue: the keys must be floating point numbers or unsigned integers");
+
+	using Key = typename std::conditional<sizeof(Scalar) <= 4u, uint32, uint64>::type;
+	static const uint32 NB_BITS = 8u * uint32(sizeof(Key));
+
+	struct Entry
+	{
+		Key key_;
+		uint32 index_;
+	};
+
+public:
+
+	RadixHeapQueue() :
+		last_(0u),
+		size_(0u)
+	{}
+
+	inline void reset(uint32)
+	{
+		for (auto& b : buckets_)
+			b.clear();
+		last_ = 0u;
+		size_ = 0u;
+	}
+
+	inline bool empty() const
+	{
+		return size_ == 0u;
+	}
+
+	inline void push(uint32 i, Scalar key)
+	{
+		const Key k = to_key(key, std::is_floating_point<Scalar>());
+		cgogn_message_assert(k >= last_, "RadixHeapQueue: the keys must be monotone");
+		buckets_[bucket(k)].push_back(Entry{k, i});
+		++size_;
+	}
+
+	inline void pop(uint32& i, Scalar& key)
+	{
+		if (buckets_[0u].empty())
+		{
+			// the first non empty bucket holds the minimal key: its elements are redistributed
+			// in the lower buckets, relative to this new minimum
+			uint32 b = 1u;
+			while (buckets_[b].empty())
+				++b;
+			std::vector<Entry>& bucket_b = buckets_[b];
+			Key min = bucket_b.front().key_;
+			for (const Entry& e : bucket_b)
+				min = std::min(min, e.key_);
+			last_ = min;
+			for (const Entry& e : bucket_b)
+				buckets_[bucket(e.key_)].push_back(e);
+			bucket_b.clear();
+		}
+		const Entry e = buckets_[0u].back();
+		buckets_[0u].pop_back();
+		--size_;
+		i = e.index_;
+		key = to_scalar(e.key_, std::is_floating_point<Scalar>());
+	}
+
+private:
+
+	// index of the bucket of k: number of significant bits of (k xor last_)
+	inline uint32 bucket(Key k) const
+	{
+		return nb_significant_bits(k ^ last_);
+	}
+
+#if defined(__GNUC__) || defined(__clang__)
+	static inline uint32 nb_significant_bits(uint32 x)
+	{
+		return x == 0u ? 0u : 32u - uint32(__builtin_clz(x));
+	}
+
+	static inline uint32 nb_significant_bits(uint64 x)
+	{
+		return x == 0u ? 0u : 64u - uint32(__builtin_clzll(x));
+	}
+#else
+	template <typename T>
+	static inline uint32 nb_significant_bits(T x)
+	{
+		uint32 b = 0u;
+		while (x != 0u)
+		{
+			++b;
+			x >>= 1u;
+		}
+		return b;
+	}
+#endif
+
+	static inline Key to_key(Scalar s, std::true_type)
+	{
+		// -0 and the (invalid) negative keys are mapped to 0
+		if (!(s > Scalar(0)))
+			return Key(0u);
+		Key k;
+		std::memcpy(&k, &s, sizeof(Key));
+		return k;
+	}
+
+	static inline Key to_key(Scalar s, std::false_type)
+	{
+		return Key(s);
+	}
+
+	static inline Scalar to_scalar(Key k, std::true_type)
+	{
+		Scalar s;
+		std::memcpy(&s, &k, sizeof(Key));
+		return s;
+	}
+
+	static inline Scalar to_scalar(Key k, std::false_type)
+	{
+		return Scalar(k);
+	}
+
+	std::array<std::vector<Entry>, NB_BITS + 1u> buckets_;
+	Key last_;
+	uint32 size_;
+};
+
+} // namespace topology
+
+} // namespace cgogn
+
+#endif // CGOGN_TOPOLOGY_TYPES_SHORTEST_PATH_QUEUE_H_